@@ -32,6 +32,9 @@ enum SL_AnimationFlag : unsigned
 template<typename data_t>
 class SL_AnimationKeyList
 {
+    // Allow cached keyframes to be copied in bulk
+    friend class SL_SceneFileCache;
+
   private:
     /**
      * @brief numPositions contains the total number of position keys.
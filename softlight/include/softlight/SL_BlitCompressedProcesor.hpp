@@ -24,12 +24,19 @@ struct SL_TextureView;
  * resolution and fit the backbuffer. Fixed-point calculation is used to avoid
  * precision errors and increase ALU throughput. Benchmarks on x86 and ARM has
  * shown that floating-point logic performs worse in this area.
+ *
+ * The destination is divided into square tiles which are distributed across
+ * threads. RGB-565 to 8-bit RGBA conversion is performed using SIMD.
 -----------------------------------------------------------------------------*/
 struct SL_BlitCompressedProcessor
 {
     enum : uint_fast32_t
     {
-        NUM_FIXED_BITS = 16u
+        NUM_FIXED_BITS = 16u,
+
+        // Width & height of a blitted tile, in destination pixels
+        TILE_SHIFT     = 5u,
+        TILE_SIZE      = 1u << TILE_SHIFT
     };
 
     // 32 bits
@@ -54,6 +61,15 @@ struct SL_BlitCompressedProcessor
 
     // 224-288 bits total, 28-36 bytes
 
+    // Retrieve the destination rectangle of a tile, returning FALSE if the
+    // tile lies outside of the destination texture.
+    bool tile_bounds(
+        uint_fast32_t tileId,
+        uint_fast32_t& outX0,
+        uint_fast32_t& outY0,
+        uint_fast32_t& outX1,
+        uint_fast32_t& outY1) const noexcept;
+
     // Blit a single R channel
     template<typename inColor_type>
     void blit_src_r() noexcept;
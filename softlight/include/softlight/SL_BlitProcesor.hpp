@@ -11,6 +11,7 @@
  * Forward Declarations
 -----------------------------------------------------------------------------*/
 struct SL_TextureView;
+enum SL_BlitFilter : uint8_t;
 
 
 
@@ -24,13 +25,22 @@ struct SL_TextureView;
  * Texture blitting uses nearest-neighbor filtering to increase or decrease the
  * resolution and fit the backbuffer. Fixed-point calculation is used to avoid
  * precision errors and increase ALU throughput. Benchmarks on x86 and ARM has
- * shown that floating-point logic performs worse in this area.
+ * shown that floating-point logic performs worse in this area. Bilinear and
+ * box filtering are available for smoother scaling.
+ *
+ * The destination is divided into square tiles which are distributed across
+ * threads, keeping the source & destination texels of each tile resident in
+ * cache. Common conversions to 8-bit RGBA are performed using SIMD.
 -----------------------------------------------------------------------------*/
 struct SL_BlitProcessor
 {
     enum : uint_fast32_t
     {
-        NUM_FIXED_BITS = 16u
+        NUM_FIXED_BITS = 16u,
+
+        // Width & height of a blitted tile, in destination pixels
+        TILE_SHIFT     = 5u,
+        TILE_SIZE      = 1u << TILE_SHIFT
     };
 
     // 32 bits
@@ -53,7 +63,19 @@ struct SL_BlitProcessor
     const SL_TextureView* mSrcTex;
     SL_TextureView* mDstTex;
 
-    // 224-288 bits total, 28-36 bytes
+    // 8 bits
+    SL_BlitFilter mFilter;
+
+    // 232-296 bits total, 29-37 bytes
+
+    // Retrieve the destination rectangle of a tile, returning FALSE if the
+    // tile lies outside of the destination texture.
+    bool tile_bounds(
+        uint_fast32_t tileId,
+        uint_fast32_t& outX0,
+        uint_fast32_t& outY0,
+        uint_fast32_t& outX1,
+        uint_fast32_t& outY1) const noexcept;
 
     // Blit a single R channel
     template<typename inColor_type>
@@ -71,10 +93,14 @@ struct SL_BlitProcessor
     template<typename inColor_type>
     void blit_src_rgba() noexcept;
 
-    // Blit all 4 color components
+    // Nearest-neighbor scaling
     template<class BlitOp>
     void blit_nearest() noexcept;
 
+    // Bilinear or box scaling, performed in floating-point
+    template<typename inColor_type, unsigned inChannels>
+    void blit_filtered() noexcept;
+
     void execute() noexcept;
 };
 
@@ -0,0 +1,59 @@
+#ifndef SL_BLOCK_COMPRESS_PROCESSOR_HPP
+#define SL_BLOCK_COMPRESS_PROCESSOR_HPP
+
+#include <cstdint>
+
+#include "softlight/SL_Swizzle.hpp" // SL_TexelOrder
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+struct SL_TextureView;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Block Compress Processor converts textures to and from
+ * block-compressed formats. Rows of 4x4 blocks are interleaved across
+ * threads.
+ *
+ * Encoding reads textures with 8-bit channels (R, RG, RGB, or RGBA). Blocks
+ * along the right and bottom edges of a texture repeat its last column and
+ * row. Decoding writes R8 for BC4, RG8 for BC5, and RGBA8 for BC1 and BC3.
+-----------------------------------------------------------------------------*/
+struct SL_BlockCompressProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 48 bits
+    SL_TexelOrder mTexelOrder; // order of the uncompressed texture
+    bool mDecompress;
+
+    // 112-176 bits
+    const SL_TextureView* mSrcTex;
+    SL_TextureView* mDstTex;
+
+    // 112-176 bits total, 16-24 bytes (with padding)
+
+    template <typename color_type, typename block_type, SL_TexelOrder order>
+    void encode_blocks() noexcept;
+
+    template <typename block_type, SL_TexelOrder order>
+    void decode_blocks() noexcept;
+
+    template <typename block_type>
+    void encode() noexcept;
+
+    template <typename block_type>
+    void decode() noexcept;
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_BLOCK_COMPRESS_PROCESSOR_HPP */
@@ -145,6 +145,8 @@ class SL_Camera
 
     friend class SceneFileLoader;
 
+    friend class SL_SceneFileCache;
+
   public:
     /**
      * @brief Default SL_Camera aspect width.
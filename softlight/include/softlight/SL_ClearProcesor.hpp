@@ -9,6 +9,8 @@
 
 
 
+class SL_FastClear;
+class SL_HiZBuffer;
 struct SL_TextureView;
 
 
@@ -16,6 +18,7 @@ struct SL_TextureView;
 /**----------------------------------------------------------------------------
  * @brief The Clear Processor helps to assign all texels in a texture to a
  * single color. This helps distribute color clearing across multiple threads.
+ * It also resolves deferred framebuffer clears.
 -----------------------------------------------------------------------------*/
 struct SL_ClearProcessor
 {
@@ -23,11 +26,18 @@ struct SL_ClearProcessor
     uint16_t mThreadId;
     uint16_t mNumThreads;
 
-    // 64-128 bits
+    // 160-320 bits
     const void* mTexture;
     SL_TextureView* mBackBuffer;
+    SL_HiZBuffer* mDepthHiZ; // optional, only set when clearing depth
 
-    // 96-160 bits total, 12-20 bytes
+    // Optional, when set the pending clears of each tile are written into
+    // the color attachments at "mBackBuffer" and depth attachment at
+    // "mDepthBuffer" instead.
+    SL_FastClear* mFastClear;
+    SL_TextureView* mDepthBuffer;
+
+    // 192-352 bits total, 24-44 bytes
 
     // clear all 4 color components
     template<typename color_type>
@@ -69,13 +69,20 @@ enum SL_ColorDataType : uint8_t
     SL_COLOR_RGBA_4444,
     SL_COLOR_RGBA_1010102,
 
+    // Block-compressed formats store each 4x4 group of texels in a single
+    // block. They require the inclusion of "SL_ColorBlock.hpp"
+    SL_COLOR_BC1, // RGB with 1-bit alpha, 8 bytes per block
+    SL_COLOR_BC3, // RGBA, 16 bytes per block
+    SL_COLOR_BC4, // R, 8 bytes per block
+    SL_COLOR_BC5, // RG, 16 bytes per block
+
     SL_COLOR_RGB_DEFAULT = SL_COLOR_RGB_8U
 };
 
 
 
 /*-------------------------------------
- * Number of bytes per color
+ * Number of bytes per color, or per 4x4 block of a block-compressed color
 -------------------------------------*/
 size_t sl_bytes_per_color(SL_ColorDataType p) noexcept;
 
@@ -103,6 +110,36 @@ constexpr bool sl_is_compressed_color(SL_ColorDataType p) noexcept
 
 
 
+/*-------------------------------------
+ * Block-compressed format check
+-------------------------------------*/
+constexpr bool sl_is_block_compressed_color(SL_ColorDataType p) noexcept
+{
+    return
+        (p == SL_COLOR_BC1) ||
+        (p == SL_COLOR_BC3) ||
+        (p == SL_COLOR_BC4) ||
+        (p == SL_COLOR_BC5);
+}
+
+
+
+/*-------------------------------------
+ * Determine the block-compressed format with the same channels as an 8-bit
+ * color format. Other formats are returned unmodified.
+-------------------------------------*/
+constexpr SL_ColorDataType sl_block_compressed_color_for(SL_ColorDataType p) noexcept
+{
+    return
+        (p == SL_COLOR_R_8U)    ? SL_COLOR_BC4 :
+        (p == SL_COLOR_RG_8U)   ? SL_COLOR_BC5 :
+        (p == SL_COLOR_RGB_8U)  ? SL_COLOR_BC1 :
+        (p == SL_COLOR_RGBA_8U) ? SL_COLOR_BC3 :
+        p;
+}
+
+
+
 /*-----------------------------------------------------------------------------
  * Internal limits of color type ranges
 -----------------------------------------------------------------------------*/
@@ -0,0 +1,254 @@
+#ifndef SL_COLOR_BLOCK_HPP
+#define SL_COLOR_BLOCK_HPP
+
+#include <cstdint>
+
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "softlight/SL_Color.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block-Compressed Types
+ *
+ * Each block stores a 4x4 group of texels. Texels within a block are indexed
+ * in row-major order, starting from the block's top-left corner (i = x + 4*y).
+-----------------------------------------------------------------------------*/
+/**
+ * @brief BC1 Block
+ *
+ * Two RGB565 endpoints and a 2-bit palette index per texel. When color0 is
+ * greater than color1, the palette contains the endpoints and two colors
+ * between them. Otherwise the palette contains the endpoints, their midpoint,
+ * and transparent black.
+ */
+struct alignas(alignof(uint32_t)) SL_BlockBC1
+{
+    typedef SL_ColorRGBA8 color_type;
+
+    uint16_t color0;
+    uint16_t color1;
+    uint32_t indices;
+};
+
+static_assert(sizeof(SL_BlockBC1) == 8, "BC1 blocks are not 8 bytes.");
+
+
+
+/**
+ * @brief BC4 Block
+ *
+ * Two 8-bit endpoints and a 3-bit palette index per texel. When red0 is
+ * greater than red1, the palette contains the endpoints and six values
+ * between them. Otherwise the palette contains the endpoints, four values
+ * between them, 0, and 255.
+ */
+struct alignas(alignof(uint8_t)) SL_BlockBC4
+{
+    typedef SL_ColorR8 color_type;
+
+    uint8_t red0;
+    uint8_t red1;
+    uint8_t indices[6];
+};
+
+static_assert(sizeof(SL_BlockBC4) == 8, "BC4 blocks are not 8 bytes.");
+
+
+
+/**
+ * @brief BC3 Block
+ *
+ * A BC4 block of alpha values followed by a BC1 block of colors. The color
+ * block is always decoded using four opaque colors.
+ */
+struct alignas(alignof(uint32_t)) SL_BlockBC3
+{
+    typedef SL_ColorRGBA8 color_type;
+
+    SL_BlockBC4 alpha;
+    SL_BlockBC1 color;
+};
+
+static_assert(sizeof(SL_BlockBC3) == 16, "BC3 blocks are not 16 bytes.");
+
+
+
+/**
+ * @brief BC5 Block
+ *
+ * Two independent BC4 blocks for the red and green channels.
+ */
+struct alignas(alignof(uint8_t)) SL_BlockBC5
+{
+    typedef SL_ColorRG8 color_type;
+
+    SL_BlockBC4 red;
+    SL_BlockBC4 green;
+};
+
+static_assert(sizeof(SL_BlockBC5) == 16, "BC5 blocks are not 16 bytes.");
+
+
+
+/*-----------------------------------------------------------------------------
+ * Single-Texel Decoding
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Expand an RGB565 endpoint to 8 bits per channel
+-------------------------------------*/
+inline LS_INLINE SL_ColorRGBA8 sl_unpack_bc_endpoint(uint16_t c) noexcept
+{
+    const unsigned r = (c >> 11u) & 0x1Fu;
+    const unsigned g = (c >> 5u) & 0x3Fu;
+    const unsigned b = c & 0x1Fu;
+
+    return SL_ColorRGBA8{
+        (uint8_t)((r << 3u) | (r >> 2u)),
+        (uint8_t)((g << 2u) | (g >> 4u)),
+        (uint8_t)((b << 3u) | (b >> 2u)),
+        (uint8_t)255u
+    };
+}
+
+
+
+/*-------------------------------------
+ * Calculate one of the interpolated colors of a BC1 palette
+-------------------------------------*/
+inline LS_INLINE SL_ColorRGBA8 sl_mix_bc_endpoints(const SL_ColorRGBA8& c0, const SL_ColorRGBA8& c1, unsigned w0, unsigned w1) noexcept
+{
+    const unsigned total = w0 + w1;
+
+    return SL_ColorRGBA8{
+        (uint8_t)((w0 * c0.v[0] + w1 * c1.v[0]) / total),
+        (uint8_t)((w0 * c0.v[1] + w1 * c1.v[1]) / total),
+        (uint8_t)((w0 * c0.v[2] + w1 * c1.v[2]) / total),
+        (uint8_t)255u
+    };
+}
+
+
+
+/*-------------------------------------
+ * Decode a single BC1 color. BC3 blocks always use the 4-color palette.
+-------------------------------------*/
+template <bool alwaysOpaque = false>
+inline LS_INLINE SL_ColorRGBA8 sl_decode_bc1_texel(const SL_BlockBC1& block, unsigned i) noexcept
+{
+    const unsigned      index = (block.indices >> (i * 2u)) & 0x03u;
+    const SL_ColorRGBA8 c0    = sl_unpack_bc_endpoint(block.color0);
+    const SL_ColorRGBA8 c1    = sl_unpack_bc_endpoint(block.color1);
+
+    if (index < 2u)
+    {
+        return index ? c1 : c0;
+    }
+
+    if (alwaysOpaque || block.color0 > block.color1)
+    {
+        return (index == 2u) ? sl_mix_bc_endpoints(c0, c1, 2u, 1u) : sl_mix_bc_endpoints(c0, c1, 1u, 2u);
+    }
+
+    return (index == 2u) ? sl_mix_bc_endpoints(c0, c1, 1u, 1u) : SL_ColorRGBA8{0, 0, 0, 0};
+}
+
+
+
+/*-------------------------------------
+ * Decode a single BC4 value
+-------------------------------------*/
+inline LS_INLINE uint8_t sl_decode_bc4_texel(const SL_BlockBC4& block, unsigned i) noexcept
+{
+    // 3-bit indices may straddle two bytes
+    const unsigned bitOffset  = i * 3u;
+    const unsigned byteOffset = bitOffset >> 3u;
+    const unsigned bits       = (unsigned)block.indices[byteOffset] | ((byteOffset < 5u ? (unsigned)block.indices[byteOffset+1u] : 0u) << 8u);
+    const unsigned index      = (bits >> (bitOffset & 0x07u)) & 0x07u;
+    const unsigned r0         = block.red0;
+    const unsigned r1         = block.red1;
+
+    if (index < 2u)
+    {
+        return (uint8_t)(index ? r1 : r0);
+    }
+
+    if (r0 > r1)
+    {
+        return (uint8_t)(((8u - index) * r0 + (index - 1u) * r1) / 7u);
+    }
+
+    if (index < 6u)
+    {
+        return (uint8_t)(((6u - index) * r0 + (index - 1u) * r1) / 5u);
+    }
+
+    return (uint8_t)((index == 6u) ? 0u : 255u);
+}
+
+
+
+/*-------------------------------------
+ * Decode the texel at (x, y) within a block
+-------------------------------------*/
+inline LS_INLINE SL_ColorRGBA8 sl_decode_texel(const SL_BlockBC1& block, unsigned x, unsigned y) noexcept
+{
+    return sl_decode_bc1_texel<false>(block, x + 4u * y);
+}
+
+inline LS_INLINE SL_ColorRGBA8 sl_decode_texel(const SL_BlockBC3& block, unsigned x, unsigned y) noexcept
+{
+    const unsigned i = x + 4u * y;
+    SL_ColorRGBA8 c = sl_decode_bc1_texel<true>(block.color, i);
+    c.v[3] = sl_decode_bc4_texel(block.alpha, i);
+    return c;
+}
+
+inline LS_INLINE SL_ColorR8 sl_decode_texel(const SL_BlockBC4& block, unsigned x, unsigned y) noexcept
+{
+    return SL_ColorR8{sl_decode_bc4_texel(block, x + 4u * y)};
+}
+
+inline LS_INLINE SL_ColorRG8 sl_decode_texel(const SL_BlockBC5& block, unsigned x, unsigned y) noexcept
+{
+    const unsigned i = x + 4u * y;
+    return SL_ColorRG8{sl_decode_bc4_texel(block.red, i), sl_decode_bc4_texel(block.green, i)};
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Full-Block Decoding
+ *
+ * Each palette is calculated once and all 16 texels are looked up at once
+ * using byte shuffles on SSSE3 and NEON. Output texels are in row-major order.
+-----------------------------------------------------------------------------*/
+void sl_decode_block(const SL_BlockBC1& block, SL_ColorRGBA8 outTexels[16]) noexcept;
+
+void sl_decode_block(const SL_BlockBC3& block, SL_ColorRGBA8 outTexels[16]) noexcept;
+
+void sl_decode_block(const SL_BlockBC4& block, SL_ColorR8 outTexels[16]) noexcept;
+
+void sl_decode_block(const SL_BlockBC5& block, SL_ColorRG8 outTexels[16]) noexcept;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Full-Block Encoding
+ *
+ * Endpoints are chosen from the bounding box of each block's texels, then
+ * every texel is assigned its nearest palette entry. BC1 blocks switch to the
+ * 3-color palette when any texel has an alpha below 128.
+-----------------------------------------------------------------------------*/
+void sl_encode_block(const SL_ColorRGBA8 inTexels[16], SL_BlockBC1& outBlock) noexcept;
+
+void sl_encode_block(const SL_ColorRGBA8 inTexels[16], SL_BlockBC3& outBlock) noexcept;
+
+void sl_encode_block(const SL_ColorR8 inTexels[16], SL_BlockBC4& outBlock) noexcept;
+
+void sl_encode_block(const SL_ColorRG8 inTexels[16], SL_BlockBC5& outBlock) noexcept;
+
+
+
+#endif /* SL_COLOR_BLOCK_HPP */
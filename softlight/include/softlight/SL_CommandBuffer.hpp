@@ -0,0 +1,279 @@
+
+#ifndef SL_COMMAND_BUFFER_HPP
+#define SL_COMMAND_BUFFER_HPP
+
+#include <cstddef> // size_t
+#include <cstdint>
+
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Setup.hpp" // SL_AlignedVector
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+namespace ls
+{
+namespace math
+{
+    template <typename T>
+    union vec4_t;
+}
+}
+
+struct SL_TextureView;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Types of commands which can be recorded
+-----------------------------------------------------------------------------*/
+enum SL_CommandType : uint8_t
+{
+    SL_COMMAND_DRAW,
+    SL_COMMAND_DRAW_MULTIPLE,
+    SL_COMMAND_CLEAR,
+    SL_COMMAND_BLIT,
+    SL_COMMAND_UPDATE_UNIFORMS
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Command Parameters
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Draw one or more meshes stored within a command buffer
+--------------------------------------*/
+struct SL_DrawCommand
+{
+    size_t shaderId;
+    size_t fboId;
+    size_t firstMesh;
+    size_t numMeshes;
+    size_t numInstances;
+};
+
+
+
+/*--------------------------------------
+ * Clear a framebuffer's color and/or depth attachments
+--------------------------------------*/
+struct SL_ClearCommand
+{
+    size_t fboId;
+    unsigned attachmentId;
+    bool clearColor;
+    bool clearDepth;
+    double color[4];
+    double depth;
+};
+
+
+
+/*--------------------------------------
+ * Blit a texture into another texture or an external buffer
+--------------------------------------*/
+struct SL_BlitCommand
+{
+    size_t outTextureId;
+    size_t inTextureId;
+    SL_TextureView* pOutBuffer; // used instead of outTextureId if non-null
+    bool fullSize; // ignore the source & destination rectangles
+    uint16_t srcX0;
+    uint16_t srcY0;
+    uint16_t srcX1;
+    uint16_t srcY1;
+    uint16_t dstX0;
+    uint16_t dstY0;
+    uint16_t dstX1;
+    uint16_t dstY1;
+};
+
+
+
+/*--------------------------------------
+ * Copy bytes stored within a command buffer into a uniform buffer
+--------------------------------------*/
+struct SL_UniformCommand
+{
+    size_t uboId;
+    size_t uboOffset;
+    size_t firstByte;
+    size_t numBytes;
+};
+
+
+
+/*--------------------------------------
+ * Generic recorded command
+--------------------------------------*/
+struct SL_Command
+{
+    SL_CommandType type;
+
+    union
+    {
+        SL_DrawCommand draw;
+        SL_ClearCommand clear;
+        SL_BlitCommand blit;
+        SL_UniformCommand uniforms;
+    };
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Command Buffer records draws, clears, blits, and uniform updates
+ * for later execution by an SL_Context.
+ *
+ * All mesh and uniform data is copied into the command buffer while
+ * recording, allowing the source data to be modified immediately afterwards.
+ * Resources referenced by ID (shaders, framebuffers, textures, and vertex
+ * data) are read when the command buffer is executed.
+-----------------------------------------------------------------------------*/
+class SL_CommandBuffer
+{
+  private:
+    SL_AlignedVector<SL_Command> mCommands;
+
+    SL_AlignedVector<SL_Mesh> mMeshes;
+
+    SL_AlignedVector<unsigned char> mPayload;
+
+  public:
+    ~SL_CommandBuffer() noexcept = default;
+
+    SL_CommandBuffer() noexcept;
+
+    SL_CommandBuffer(const SL_CommandBuffer&) = default;
+
+    SL_CommandBuffer(SL_CommandBuffer&&) noexcept = default;
+
+    SL_CommandBuffer& operator=(const SL_CommandBuffer&) = default;
+
+    SL_CommandBuffer& operator=(SL_CommandBuffer&&) noexcept = default;
+
+    void clear() noexcept;
+
+    bool empty() const noexcept;
+
+    size_t size() const noexcept;
+
+    const SL_Command& command(size_t index) const noexcept;
+
+    const SL_Mesh* meshes() const noexcept;
+
+    const unsigned char* payload() const noexcept;
+
+    void draw(const SL_Mesh& m, size_t shaderId, size_t fboId) noexcept;
+
+    void draw_multiple(const SL_Mesh* meshes, size_t numMeshes, size_t shaderId, size_t fboId) noexcept;
+
+    void draw_instanced(const SL_Mesh& m, size_t numInstances, size_t shaderId, size_t fboId) noexcept;
+
+    void blit(size_t outTextureId, size_t inTextureId) noexcept;
+
+    void blit(
+        size_t outTextureId,
+        size_t inTextureId,
+        uint16_t srcX0,
+        uint16_t srcY0,
+        uint16_t srcX1,
+        uint16_t srcY1,
+        uint16_t dstX0,
+        uint16_t dstY0,
+        uint16_t dstX1,
+        uint16_t dstY1) noexcept;
+
+    void blit(SL_TextureView& buffer, size_t textureId) noexcept;
+
+    void blit(
+        SL_TextureView& buffer,
+        size_t textureId,
+        uint16_t srcX0,
+        uint16_t srcY0,
+        uint16_t srcX1,
+        uint16_t srcY1,
+        uint16_t dstX0,
+        uint16_t dstY0,
+        uint16_t dstX1,
+        uint16_t dstY1) noexcept;
+
+    void clear_color_buffer(size_t fboId, unsigned attachmentId, const ls::math::vec4_t<double>& color) noexcept;
+
+    void clear_depth_buffer(size_t fboId, double depth) noexcept;
+
+    void clear_framebuffer(size_t fboId, unsigned attachmentId, const ls::math::vec4_t<double>& color, double depth) noexcept;
+
+    void update_uniforms(size_t uboId, const void* pData, size_t offset, size_t numBytes) noexcept;
+
+    template <typename data_t>
+    void update_uniforms(size_t uboId, const data_t& data, size_t offset = 0) noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Determine if any commands were recorded
+-------------------------------------*/
+inline bool SL_CommandBuffer::empty() const noexcept
+{
+    return mCommands.empty();
+}
+
+
+
+/*-------------------------------------
+ * Number of recorded commands
+-------------------------------------*/
+inline size_t SL_CommandBuffer::size() const noexcept
+{
+    return mCommands.size();
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a recorded command
+-------------------------------------*/
+inline const SL_Command& SL_CommandBuffer::command(size_t index) const noexcept
+{
+    return mCommands[index];
+}
+
+
+
+/*-------------------------------------
+ * Retrieve all meshes referenced by draw commands
+-------------------------------------*/
+inline const SL_Mesh* SL_CommandBuffer::meshes() const noexcept
+{
+    return mMeshes.data();
+}
+
+
+
+/*-------------------------------------
+ * Retrieve all bytes referenced by uniform updates
+-------------------------------------*/
+inline const unsigned char* SL_CommandBuffer::payload() const noexcept
+{
+    return mPayload.data();
+}
+
+
+
+/*-------------------------------------
+ * Record a typed uniform update
+-------------------------------------*/
+template <typename data_t>
+inline void SL_CommandBuffer::update_uniforms(size_t uboId, const data_t& data, size_t offset) noexcept
+{
+    update_uniforms(uboId, &data, offset, sizeof(data_t));
+}
+
+
+
+#endif /* SL_COMMAND_BUFFER_HPP */
@@ -0,0 +1,114 @@
+
+#ifndef SL_COMMAND_QUEUE_HPP
+#define SL_COMMAND_QUEUE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory> // std::shared_ptr
+#include <mutex>
+#include <thread>
+
+#include "softlight/SL_CommandBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+class SL_Context;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief A Fence is signaled once all commands of a submitted command buffer
+ * have finished executing.
+-----------------------------------------------------------------------------*/
+class SL_Fence
+{
+  private:
+    mutable std::mutex mLock;
+
+    mutable std::condition_variable mSignal;
+
+    bool mSignaled;
+
+  public:
+    ~SL_Fence() noexcept = default;
+
+    SL_Fence() noexcept;
+
+    SL_Fence(const SL_Fence&) = delete;
+
+    SL_Fence(SL_Fence&&) = delete;
+
+    SL_Fence& operator=(const SL_Fence&) = delete;
+
+    SL_Fence& operator=(SL_Fence&&) = delete;
+
+    void signal() noexcept;
+
+    bool signaled() const noexcept;
+
+    void wait() const noexcept;
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Command Queue executes submitted command buffers, in order, on a
+ * dedicated thread which dispatches work to a context's processor pool.
+-----------------------------------------------------------------------------*/
+class SL_CommandQueue
+{
+  private:
+    struct SL_Submission
+    {
+        SL_CommandBuffer commands;
+        std::shared_ptr<SL_Fence> fence;
+    };
+
+    SL_Context* mContext;
+
+    std::mutex mLock;
+
+    // Signaled when new work is available or the queue is shutting down
+    std::condition_variable mPendingSignal;
+
+    // Signaled each time the queue runs out of work
+    std::condition_variable mIdleSignal;
+
+    std::deque<SL_Submission> mPending;
+
+    bool mExecuting;
+
+    bool mRunning;
+
+    std::thread mThread;
+
+    void execute_submissions() noexcept;
+
+  public:
+    ~SL_CommandQueue() noexcept;
+
+    SL_CommandQueue(SL_Context& context) noexcept;
+
+    SL_CommandQueue(const SL_CommandQueue&) = delete;
+
+    SL_CommandQueue(SL_CommandQueue&&) = delete;
+
+    SL_CommandQueue& operator=(const SL_CommandQueue&) = delete;
+
+    SL_CommandQueue& operator=(SL_CommandQueue&&) = delete;
+
+    std::shared_ptr<SL_Fence> submit(const SL_CommandBuffer& commands) noexcept;
+
+    std::shared_ptr<SL_Fence> submit(SL_CommandBuffer&& commands) noexcept;
+
+    bool busy() noexcept;
+
+    void wait() noexcept;
+};
+
+
+
+#endif /* SL_COMMAND_QUEUE_HPP */
@@ -15,6 +15,23 @@
     #define SL_VERTEX_CACHE_SIZE 8
 #endif /* SL_VERTEX_CACHE_SIZE */
 
+// Indexed triangles are split into batches of contiguous primitives. Each
+// unique vertex within a batch is only run through the vertex shader once.
+#ifndef SL_VERTEX_REUSE_ENABLED
+    #define SL_VERTEX_REUSE_ENABLED 1
+#endif /* SL_VERTEX_REUSE_ENABLED */
+
+// Number of triangles in each batch of vertices. Must be a power of 2.
+#ifndef SL_VERTEX_BATCH_SIZE
+    #define SL_VERTEX_BATCH_SIZE 64
+#endif /* SL_VERTEX_BATCH_SIZE */
+
+// Number of vertices passed to each invocation of a batched vertex shader.
+// Must be either 4 (SSE/NEON) or 8 (AVX).
+#ifndef SL_VERTEX_SHADER_BATCH_SIZE
+    #define SL_VERTEX_SHADER_BATCH_SIZE 8
+#endif /* SL_VERTEX_SHADER_BATCH_SIZE */
+
 
 
 /*-----------------------------------------------------------------------------
@@ -28,6 +45,49 @@
     #define SL_CONSERVE_MEMORY 0
 #endif /* SL_CONSERVE_MEMORY */
 
+// Triangles can be rasterized either by interleaving scanlines across threads
+// or by assigning each thread a set of screen-space tiles. Tiles keep the
+// depth & color texels of a region resident in a thread's cache.
+#ifndef SL_TILED_RASTERIZATION_ENABLED
+    #define SL_TILED_RASTERIZATION_ENABLED 1
+#endif /* SL_TILED_RASTERIZATION_ENABLED */
+
+// Tile dimensions, in pixels, are (1 << SL_RASTER_TILE_SHIFT).
+#ifndef SL_RASTER_TILE_SHIFT
+    #define SL_RASTER_TILE_SHIFT 6
+#endif /* SL_RASTER_TILE_SHIFT */
+
+// Framebuffers can track the min/max depth of every 8x8 block of pixels so
+// the tiled rasterizer may reject occluded triangles before any per-pixel
+// depth testing occurs.
+#ifndef SL_HIZ_ENABLED
+    #define SL_HIZ_ENABLED SL_TILED_RASTERIZATION_ENABLED
+#endif /* SL_HIZ_ENABLED */
+
+// Default amount of screen area, in multiples of the framebuffer's size,
+// which can be binned by all threads before the adaptive flush policy invokes
+// the rasterizer early. Adjustable at runtime through SL_ProcessorPool.
+#ifndef SL_BIN_COVERAGE_LIMIT
+    #define SL_BIN_COVERAGE_LIMIT 4
+#endif /* SL_BIN_COVERAGE_LIMIT */
+
+// Number of times an idle rendering thread polls for more work before it
+// sleeps. Adjustable at runtime through SL_ProcessorPool.
+#ifndef SL_WAIT_SPIN_BUDGET
+    #define SL_WAIT_SPIN_BUDGET 4096
+#endif /* SL_WAIT_SPIN_BUDGET */
+
+
+
+/*-----------------------------------------------------------------------------
+ * Fragment Processing Configuration
+-----------------------------------------------------------------------------*/
+// Number of fragments passed to each invocation of a batched fragment shader.
+// Must be either 4 (SSE/NEON) or 8 (AVX).
+#ifndef SL_FRAGMENT_BATCH_SIZE
+    #define SL_FRAGMENT_BATCH_SIZE 8
+#endif /* SL_FRAGMENT_BATCH_SIZE */
+
 
 
 /*-----------------------------------------------------------------------------
@@ -54,9 +114,30 @@ enum SL_ShaderLimits
 
     // Maximum possible amount of fragment operations running while
     // simultaneously allowing vertex processing.
-    SL_VERT_PROCESSOR_MAX_BUFFERS = 8
+    SL_VERT_PROCESSOR_MAX_BUFFERS = 8,
+
+    // Width & height of a screen-space tile used for rasterization.
+    SL_RASTER_TILE_SIZE           = 1 << SL_RASTER_TILE_SHIFT,
+
+    // Width & height of a block within a hierarchical depth buffer.
+    SL_HIZ_BLOCK_SHIFT            = 3,
+    SL_HIZ_BLOCK_SIZE             = 1 << SL_HIZ_BLOCK_SHIFT,
+
+    // Number of SIMD lanes in a batch of vertices.
+    SL_SHADER_VERT_BATCH_SIZE     = SL_VERTEX_SHADER_BATCH_SIZE,
+
+    // Number of SIMD lanes in a batch of fragments.
+    SL_SHADER_FRAG_BATCH_SIZE     = SL_FRAGMENT_BATCH_SIZE
 };
 
+static_assert(SL_VERTEX_SHADER_BATCH_SIZE == 4 || SL_VERTEX_SHADER_BATCH_SIZE == 8, "Vertex shader batches must contain either 4 or 8 vertices.");
+
+static_assert(SL_FRAGMENT_BATCH_SIZE == 4 || SL_FRAGMENT_BATCH_SIZE == 8, "Fragment batches must contain either 4 or 8 fragments.");
+
+static_assert(!SL_HIZ_ENABLED || SL_TILED_RASTERIZATION_ENABLED, "Hierarchical depth buffers are maintained by the tiled rasterizer.");
+
+static_assert(!SL_HIZ_ENABLED || (SL_RASTER_TILE_SHIFT >= SL_HIZ_BLOCK_SHIFT && SL_RASTER_TILE_SHIFT <= SL_HIZ_BLOCK_SHIFT+3), "Raster tiles must contain between 1 and 64 depth blocks.");
+
 
 
 #endif /* SL_CONFIG_HPP */
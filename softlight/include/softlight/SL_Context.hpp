@@ -19,6 +19,9 @@
 /*-----------------------------------------------------------------------------
  * Forward declarations
 -----------------------------------------------------------------------------*/
+class SL_CommandBuffer;
+class SL_CommandQueue;
+class SL_Fence;
 class SL_Framebuffer;
 struct SL_FragmentShader;
 class SL_IndexBuffer;
@@ -30,6 +33,9 @@ class SL_UniformBuffer;
 class SL_VertexArray;
 class SL_VertexBuffer;
 struct SL_VertexShader;
+enum SL_BlitFilter : uint8_t;
+enum SL_MipFilter : uint8_t;
+enum class SL_TexelOrder;
 
 
 
@@ -81,6 +87,10 @@ class SL_Context
 
     SL_ProcessorPool mProcessors;
 
+    std::unique_ptr<SL_CommandQueue> mCommandQueue;
+
+    void resolve_fast_clears(const SL_TextureView& texture) noexcept;
+
   public:
     ~SL_Context() noexcept;
 
@@ -120,6 +130,30 @@ class SL_Context
 
     void destroy_texture(std::size_t index);
 
+    /*
+     * Allocate and generate a chain of mip levels for a texture, in parallel.
+     * Passing 0 for the number of levels generates every level down to 1x1.
+     * Returns the error code of SL_Texture::init_mips() on failure.
+     */
+    int generate_mips(std::size_t textureId, SL_MipFilter filter, SL_TexelOrder order, uint16_t numLevels = 0) noexcept;
+
+    /*
+     * Compress a texture with 8-bit channels (R, RG, RGB, or RGBA) into a
+     * block-compressed texture, in parallel. The output texture is
+     * reallocated to match the input's dimensions. "order" is the texel order
+     * of the input. Returns 0 on success, -1 if the block type or texture IDs
+     * are invalid, -2 if the input format can't be compressed, or -3 if the
+     * output could not be allocated.
+     */
+    int compress_texture(std::size_t outTextureId, std::size_t inTextureId, SL_ColorDataType blockType, SL_TexelOrder order) noexcept;
+
+    /*
+     * Decompress a block-compressed texture, in parallel. BC1 and BC3
+     * produce RGBA8 texels, BC4 produces R8, and BC5 produces RG8. "order" is
+     * the texel order of the output. Return codes match compress_texture().
+     */
+    int decompress_texture(std::size_t outTextureId, std::size_t inTextureId, SL_TexelOrder order) noexcept;
+
     /*
      *
      */
@@ -224,11 +258,29 @@ class SL_Context
      */
     void draw_instanced(const SL_Mesh& meshes, size_t numInstances, size_t shaderId, size_t fboId) noexcept;
 
+    /*
+     * Render a list of meshes using a depth prepass. Meshes are first
+     * rasterized without color outputs, varyings, or blending to populate the
+     * depth buffer. They are then re-rendered with SL_DEPTH_TEST_EQUAL and
+     * depth writes disabled so the fragment shader runs once per visible
+     * pixel. The shader's own pipeline state is left unchanged.
+     *
+     * This is intended for opaque geometry. Shaders which were not created
+     * with SL_FragmentShader::neverDiscards are drawn normally, without a
+     * prepass. The depth buffer should be cleared before a prepassed draw.
+     */
+    void draw_prepassed(const SL_Mesh* meshes, size_t numMeshes, size_t shaderId, size_t fboId) noexcept;
+
     /*
      *
      */
     void blit(size_t outTextureId, size_t inTextureId) noexcept;
 
+    /*
+     * Blit an entire texture, resampling it with the given filter.
+     */
+    void blit(size_t outTextureId, size_t inTextureId, SL_BlitFilter filter) noexcept;
+
     /*
      *
      */
@@ -244,11 +296,34 @@ class SL_Context
         uint16_t dstX1,
         uint16_t dstY1) noexcept;
 
+    /*
+     * Blit a region of a texture, resampling it with the given filter.
+     * Filtering is only applied to uncompressed color formats.
+     */
+    void blit(
+        size_t outTextureId,
+        size_t inTextureId,
+        uint16_t srcX0,
+        uint16_t srcY0,
+        uint16_t srcX1,
+        uint16_t srcY1,
+        uint16_t dstX0,
+        uint16_t dstY0,
+        uint16_t dstX1,
+        uint16_t dstY1,
+        SL_BlitFilter filter) noexcept;
+
     /*
      *
      */
     void blit(SL_TextureView& buffer, size_t textureId) noexcept;
 
+    /*
+     * Blit an entire texture to a buffer, resampling it with the given
+     * filter.
+     */
+    void blit(SL_TextureView& buffer, size_t textureId, SL_BlitFilter filter) noexcept;
+
     /*
      *
      */
@@ -264,6 +339,23 @@ class SL_Context
         uint16_t dstX1,
         uint16_t dstY1) noexcept;
 
+    /*
+     * Blit a region of a texture to a buffer, resampling it with the given
+     * filter. Filtering is only applied to uncompressed color formats.
+     */
+    void blit(
+        SL_TextureView& buffer,
+        size_t textureId,
+        uint16_t srcX0,
+        uint16_t srcY0,
+        uint16_t srcX1,
+        uint16_t srcY1,
+        uint16_t dstX0,
+        uint16_t dstY0,
+        uint16_t dstX1,
+        uint16_t dstY1,
+        SL_BlitFilter filter) noexcept;
+
     /*
      *
      */
@@ -294,6 +386,53 @@ class SL_Context
      */
     void clear_framebuffer(size_t fboId, const std::array<unsigned, 4>& bufferIndices, const std::array<ls::math::vec4_t<double>, 4>& colors, double depth) noexcept;
 
+    /*
+     * Write any clears which are still pending within a framebuffer that has
+     * fast clears enabled. This must be called before its attachments are
+     * sampled by a shader, or read outside of the context. Blits, mip
+     * generation, and texture compression resolve the framebuffers of the
+     * textures they access automatically.
+     */
+    void resolve_framebuffer(size_t fboId) noexcept;
+
+    /*
+     * Average the samples of a multisampled color attachment into a
+     * single-sampled texture, in parallel. The output texture must match the
+     * attachment's width, height, and color type. Returns 0 on success, -1
+     * if the framebuffer is not multisampled, -2 if the attachment doesn't
+     * exist, or -3 if the output texture is incompatible.
+     *
+     * Only filled triangles are rasterized per-sample. Points, lines, and
+     * wireframes only write to the first sample of each pixel.
+     */
+    int resolve_samples(size_t fboId, unsigned colorIndex, size_t outTextureId) noexcept;
+
+    /*
+     * Execute all commands within a command buffer on the calling thread.
+     */
+    void execute(const SL_CommandBuffer& commands) noexcept;
+
+    /*
+     * Queue a command buffer for execution on a background thread. Command
+     * buffers execute in the order they were submitted. The returned fence is
+     * signaled once all commands have completed.
+     *
+     * Resources referenced by a submission must not be modified through the
+     * references returned by this context until its fence has been signaled.
+     * Creating or destroying resources, changing the processor settings, and
+     * immediate draws, blits, and clears wait for all pending submissions
+     * before executing.
+     */
+    std::shared_ptr<SL_Fence> submit(const SL_CommandBuffer& commands) noexcept;
+
+    std::shared_ptr<SL_Fence> submit(SL_CommandBuffer&& commands) noexcept;
+
+    /*
+     * Block the calling thread until all submitted command buffers have
+     * completed.
+     */
+    void finish() const noexcept;
+
     /*
      *
      */
@@ -303,6 +442,56 @@ class SL_Context
      *
      */
     unsigned num_threads(unsigned inNumThreads) noexcept;
+
+    /*
+     * Retrieve the average number of times each transformed vertex was
+     * referenced by a primitive. Returns 0 if no vertices were processed.
+     */
+    float vertex_reuse_ratio() const noexcept;
+
+    /*
+     *
+     */
+    void reset_vertex_stats() noexcept;
+
+    /*
+     * Set the maximum number of primitives which can be binned before the
+     * rasterizer gets invoked. Values of 0, or values larger than the number
+     * of bins which fit a pipeline's varyings, use as many bins as possible.
+     */
+    uint32_t bin_capacity() const noexcept;
+
+    void bin_capacity(uint32_t maxBinnedPrims) noexcept;
+
+    /*
+     * The adaptive flush policy also invokes the rasterizer once the binned
+     * triangles cover "bin_coverage_limit()" multiples of the framebuffer's
+     * area.
+     */
+    SL_BinFlushPolicy bin_flush_policy() const noexcept;
+
+    void bin_flush_policy(SL_BinFlushPolicy policy) noexcept;
+
+    float bin_coverage_limit() const noexcept;
+
+    void bin_coverage_limit(float numScreens) noexcept;
+
+    /*
+     * Retrieve the number of times binned primitives were sent to the
+     * rasterizer, and why.
+     */
+    SL_BinFlushCounts bin_flush_counts() const noexcept;
+
+    void reset_bin_flush_stats() noexcept;
+
+    /*
+     * Set the number of times idle rendering threads poll for work before
+     * sleeping. Lower values reduce CPU usage between draws at the cost of
+     * wake-up latency.
+     */
+    uint32_t spin_budget() const noexcept;
+
+    void spin_budget(uint32_t numSpins) noexcept;
 };
 
 
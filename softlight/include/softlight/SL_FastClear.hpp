@@ -0,0 +1,164 @@
+#ifndef SL_FAST_CLEAR_HPP
+#define SL_FAST_CLEAR_HPP
+
+#include <cstdint>
+
+#include "lightsky/utils/Pointer.h"
+
+#include "softlight/SL_Config.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+struct SL_TextureView;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Fast-Clear Limits
+-----------------------------------------------------------------------------*/
+enum SL_FastClearLimits : uint32_t
+{
+    // Color attachments use the indices [0, 3], depth is stored after them.
+    SL_FAST_CLEAR_DEPTH_ATTACHMENT = 4,
+    SL_FAST_CLEAR_MAX_ATTACHMENTS  = 5,
+
+    // Largest texel which can be cleared (4 doubles).
+    SL_FAST_CLEAR_MAX_TEXEL_BYTES  = 32
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Deferred Framebuffer Clears
+ *
+ * This class records which attachments of every rasterization tile still
+ * need to be cleared, along with the value of each clear. Clearing a
+ * framebuffer only marks its tiles, the texels of a tile are written when
+ * the rasterizer first renders into it. Tiles which are never rendered to
+ * must be resolved before their attachments are read elsewhere.
+ *
+ * Each tile may only be resolved by one thread at a time.
+-----------------------------------------------------------------------------*/
+class SL_FastClear
+{
+  private:
+    uint16_t mTilesX;
+
+    uint16_t mTilesY;
+
+    // Attachments which may have unresolved tiles
+    uint8_t mPendingMask;
+
+    ls::utils::UniqueAlignedArray<uint8_t> mTiles;
+
+    alignas(alignof(uint64_t)) uint8_t mValues[SL_FAST_CLEAR_MAX_ATTACHMENTS][SL_FAST_CLEAR_MAX_TEXEL_BYTES];
+
+    void resolve_attachments(uint16_t tileX, uint16_t tileY, SL_TextureView* pColors, SL_TextureView* pDepth) noexcept;
+
+  public:
+    ~SL_FastClear() noexcept;
+
+    SL_FastClear() noexcept;
+
+    SL_FastClear(const SL_FastClear& c) noexcept;
+
+    SL_FastClear(SL_FastClear&& c) noexcept;
+
+    SL_FastClear& operator=(const SL_FastClear& c) noexcept;
+
+    SL_FastClear& operator=(SL_FastClear&& c) noexcept;
+
+    int init(uint16_t width, uint16_t height) noexcept;
+
+    void terminate() noexcept;
+
+    bool valid() const noexcept;
+
+    uint16_t tiles_x() const noexcept;
+
+    uint16_t tiles_y() const noexcept;
+
+    uint8_t pending() const noexcept;
+
+    uint8_t pending(uint16_t tileX, uint16_t tileY) const noexcept;
+
+    void clear(unsigned attachmentId, const void* pValue, unsigned bytesPerTexel) noexcept;
+
+    void resolve_tile(uint16_t tileX, uint16_t tileY, SL_TextureView* pColors, SL_TextureView* pDepth) noexcept;
+
+    void resolve(SL_TextureView* pColors, SL_TextureView* pDepth, uint16_t numThreads, uint16_t threadId) noexcept;
+
+    void resolve(SL_TextureView* pColors, SL_TextureView* pDepth) noexcept;
+
+    void mark_resolved() noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Determine if clears can be deferred
+-------------------------------------*/
+inline bool SL_FastClear::valid() const noexcept
+{
+    return mTiles != nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Number of horizontal raster tiles
+-------------------------------------*/
+inline uint16_t SL_FastClear::tiles_x() const noexcept
+{
+    return mTilesX;
+}
+
+
+
+/*-------------------------------------
+ * Number of vertical raster tiles
+-------------------------------------*/
+inline uint16_t SL_FastClear::tiles_y() const noexcept
+{
+    return mTilesY;
+}
+
+
+
+/*-------------------------------------
+ * Bit-mask of attachments which may still need to be cleared
+-------------------------------------*/
+inline uint8_t SL_FastClear::pending() const noexcept
+{
+    return mPendingMask;
+}
+
+
+
+/*-------------------------------------
+ * Bit-mask of attachments which need to be cleared within a tile
+-------------------------------------*/
+inline uint8_t SL_FastClear::pending(uint16_t tileX, uint16_t tileY) const noexcept
+{
+    return mTiles[tileX + mTilesX * tileY];
+}
+
+
+
+/*-------------------------------------
+ * Write any pending clears into a tile
+-------------------------------------*/
+inline void SL_FastClear::resolve_tile(uint16_t tileX, uint16_t tileY, SL_TextureView* pColors, SL_TextureView* pDepth) noexcept
+{
+    if (pending(tileX, tileY))
+    {
+        resolve_attachments(tileX, tileY, pColors, pDepth);
+    }
+}
+
+
+
+#endif /* SL_FAST_CLEAR_HPP */
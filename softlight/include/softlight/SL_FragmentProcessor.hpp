@@ -19,15 +19,14 @@ namespace ls
     }
 }
 
-template <typename data_t>
-union SL_BinCounter;
-
 struct SL_FragCoord; // SL_ShaderProcessor.hpp
 struct SL_FragmentBin; // SL_ShaderProcessor.hpp
 struct SL_FboOutputFunctions;
 class SL_ViewportState;
 struct SL_Shader;
+class SL_TaskRange; // SL_TaskQueue.hpp
 class SL_Texture;
+struct SL_TileBinLists; // SL_ShaderUtil.hpp
 
 
 
@@ -45,12 +44,22 @@ struct SL_FragmentProcessor
     SL_RenderMode mMode;
     uint32_t mNumProcessors;
     uint_fast32_t mNumBins;
+    uint32_t mBinStride;
     const SL_Shader* mShader;
     SL_FboOutputFunctions* mFragFuncs;
-    SL_BinCounter<uint32_t>* mBinIds;
+    uint32_t* mBinIds;
     const SL_FragmentBin* mBins;
     SL_FragCoord* mQueues;
 
+    // Per-thread ranges of screen-space tiles which can be stolen by idle
+    // threads (tiled triangle rasterization), or of the point bins owned by
+    // each thread.
+    SL_TaskRange* mTileRanges;
+
+    // Bins overlapping each screen-space tile, shared by all threads (tiled
+    // triangle rasterization).
+    const SL_TileBinLists* mTileBins;
+
     virtual ~SL_FragmentProcessor() noexcept {}
 
     template <typename depth_type>
@@ -59,6 +68,15 @@ struct SL_FragmentProcessor
     template <typename depth_type>
     void flush_tri_fragments(const SL_FragmentBin& bin, uint_fast32_t numQueuedFrags, SL_FragCoord* const outCoords) const noexcept;
 
+    template <typename depth_type>
+    void flush_tri_fragment_batches(const SL_FragmentBin& bin, uint_fast32_t numQueuedFrags, const SL_FragCoord* const outCoords) const noexcept;
+
+    template <typename depth_type>
+    void flush_tri_quads(const SL_FragmentBin& bin, uint_fast32_t numQueuedFrags, SL_FragCoord* const outCoords) const noexcept;
+
+    // Depth is written per-sample during rasterization
+    void flush_tri_samples(const SL_FragmentBin& bin, uint_fast32_t numQueuedFrags, SL_FragCoord* const outCoords) const noexcept;
+
     virtual void execute() noexcept = 0;
 };
 
@@ -76,4 +94,16 @@ extern template void SL_FragmentProcessor::flush_tri_fragments<double>(const SL_
 
 
 
+extern template void SL_FragmentProcessor::flush_tri_fragment_batches<ls::math::half>(const SL_FragmentBin&, uint_fast32_t, const SL_FragCoord* const) const noexcept;
+extern template void SL_FragmentProcessor::flush_tri_fragment_batches<float>(const SL_FragmentBin&, uint_fast32_t, const SL_FragCoord* const) const noexcept;
+extern template void SL_FragmentProcessor::flush_tri_fragment_batches<double>(const SL_FragmentBin&, uint_fast32_t, const SL_FragCoord* const) const noexcept;
+
+
+
+extern template void SL_FragmentProcessor::flush_tri_quads<ls::math::half>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
+extern template void SL_FragmentProcessor::flush_tri_quads<float>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
+extern template void SL_FragmentProcessor::flush_tri_quads<double>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
+
+
+
 #endif /* SL_FRAGMENT_PROCESSOR_HPP */
@@ -9,6 +9,8 @@
 #include "lightsky/utils/Assertions.h"
 #include "lightsky/utils/Copy.h" // utils::fast_memset, fast_fill
 
+#include "softlight/SL_FastClear.hpp"
+#include "softlight/SL_HiZBuffer.hpp"
 #include "softlight/SL_Texture.hpp"
 
 
@@ -37,8 +39,13 @@ enum SL_FboLimits
 {
     SL_FBO_MIN_COLOR_ATTACHMENTS = 1,
     SL_FBO_MAX_COLOR_ATTACHMENTS = 4,
+
+    // Multisampled attachments store one layer per sample
+    SL_FBO_MAX_SAMPLES = 4,
 };
 
+static_assert((unsigned)SL_FBO_MAX_COLOR_ATTACHMENTS == (unsigned)SL_FAST_CLEAR_DEPTH_ATTACHMENT, "Fast clears must track every color attachment.");
+
 
 
 enum SL_FboOutputMask
@@ -70,6 +77,9 @@ struct SL_FboOutputFunctions
     SL_FboOutputMask outputMask;
     SL_TextureView* pColorAttachments;
     SL_TextureView* pDepthAttachment;
+    SL_HiZBuffer* pDepthHiZ;
+    SL_FastClear* pFastClear; // only set while clears are pending
+    uint16_t numSamples; // 1 unless attachments are multisampled
 
     union
     {
@@ -94,6 +104,12 @@ class SL_Framebuffer
 
     SL_TextureView mDepth;
 
+    SL_HiZBuffer mDepthHiZ;
+
+    SL_FastClear mFastClear;
+
+    void realloc_fast_clears() noexcept;
+
   public:
     ~SL_Framebuffer() noexcept;
 
@@ -132,11 +148,31 @@ class SL_Framebuffer
 
     SL_TextureView& get_depth_buffer() noexcept;
 
+    const SL_HiZBuffer& get_depth_hierarchy() const noexcept;
+
+    SL_HiZBuffer& get_depth_hierarchy() noexcept;
+
     template <typename float_type>
     void clear_depth_buffer(const float_type depthVal) noexcept;
 
     void clear_depth_buffer() noexcept;
 
+    bool fast_clears() const noexcept;
+
+    int fast_clears(bool enabled) noexcept;
+
+    const SL_FastClear& get_fast_clears() const noexcept;
+
+    SL_FastClear& get_fast_clears() noexcept;
+
+    void fast_clear_color_buffer(unsigned index, const void* pColor) noexcept;
+
+    void fast_clear_depth_buffer(const void* pDepth) noexcept;
+
+    void resolve_fast_clears() noexcept;
+
+    unsigned num_samples() const noexcept;
+
     int valid() const noexcept;
 
     void terminate() noexcept;
@@ -247,9 +283,12 @@ void SL_Framebuffer::clear_depth_buffer(const float_type depthVal) noexcept
 
     LS_DEBUG_ASSERT(mDepth.bytesPerTexel == sizeof(float_type)); // insurance
 
+    // Every sample of a multisampled depth buffer is cleared
+    const size_t numItems = (size_t)mDepth.width * (size_t)mDepth.height * (size_t)mDepth.depth;
+
     if (sizeof(float_type) == sizeof(uint32_t))
     {
-        const size_t numBytes = mDepth.width*mDepth.height* sizeof(float_type);
+        const size_t numBytes = numItems * sizeof(float_type);
         union
         {
             float_type f;
@@ -259,7 +298,7 @@ void SL_Framebuffer::clear_depth_buffer(const float_type depthVal) noexcept
     }
     else if (sizeof(float_type) == sizeof(uint64_t))
     {
-        const size_t numBytes = mDepth.width*mDepth.height* sizeof(float_type);
+        const size_t numBytes = numItems * sizeof(float_type);
         union
         {
             float_type f;
@@ -269,8 +308,10 @@ void SL_Framebuffer::clear_depth_buffer(const float_type depthVal) noexcept
     }
     else
     {
-        ls::utils::fast_fill<float_type>(reinterpret_cast<float_type*>(mDepth.pTexels), depthVal, mDepth.width*mDepth.height);
+        ls::utils::fast_fill<float_type>(reinterpret_cast<float_type*>(mDepth.pTexels), depthVal, numItems);
     }
+
+    mDepthHiZ.clear((float)depthVal);
 }
 
 
@@ -284,6 +325,7 @@ inline void SL_Framebuffer::clear_depth_buffer() noexcept
     {
         const uint64_t numBytes = mDepth.bytesPerTexel * mDepth.width * mDepth.height * mDepth.depth;
         ls::utils::fast_memset(mDepth.pTexels, 0, numBytes);
+        mDepthHiZ.clear(0.f);
     }
 }
 
@@ -309,6 +351,68 @@ inline SL_TextureView& SL_Framebuffer::get_depth_buffer() noexcept
 
 
 
+/*-------------------------------------
+ * Retrieve the hierarchical depth buffer
+-------------------------------------*/
+inline const SL_HiZBuffer& SL_Framebuffer::get_depth_hierarchy() const noexcept
+{
+    return mDepthHiZ;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the hierarchical depth buffer. This must be invalidated after
+ * writing to the depth buffer through put_depth_pixel().
+-------------------------------------*/
+inline SL_HiZBuffer& SL_Framebuffer::get_depth_hierarchy() noexcept
+{
+    return mDepthHiZ;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the number of samples per pixel. Multisampled attachments store
+ * each sample in a separate layer.
+-------------------------------------*/
+inline unsigned SL_Framebuffer::num_samples() const noexcept
+{
+    return (mDepth.pTexels && mDepth.depth > 1) ? (unsigned)mDepth.depth : 1u;
+}
+
+
+
+/*-------------------------------------
+ * Determine if clears are deferred until tiles are rendered to
+-------------------------------------*/
+inline bool SL_Framebuffer::fast_clears() const noexcept
+{
+    return mFastClear.valid();
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the pending clears of each tile (const)
+-------------------------------------*/
+inline const SL_FastClear& SL_Framebuffer::get_fast_clears() const noexcept
+{
+    return mFastClear;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the pending clears of each tile
+-------------------------------------*/
+inline SL_FastClear& SL_Framebuffer::get_fast_clears() noexcept
+{
+    return mFastClear;
+}
+
+
+
 /*-------------------------------------
  * Place a single pixel onto the depth buffer
 -------------------------------------*/
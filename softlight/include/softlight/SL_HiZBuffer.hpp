@@ -0,0 +1,274 @@
+
+#ifndef SL_HIZ_BUFFER_HPP
+#define SL_HIZ_BUFFER_HPP
+
+#include <cstdint>
+
+#include "lightsky/utils/Pointer.h"
+
+#include "softlight/SL_Config.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+namespace ls
+{
+namespace math
+{
+struct half;
+}
+}
+
+struct SL_TextureView;
+
+struct SL_DepthFuncLT;
+struct SL_DepthFuncLE;
+struct SL_DepthFuncGT;
+struct SL_DepthFuncGE;
+struct SL_DepthFuncEQ;
+struct SL_DepthFuncNE;
+struct SL_DepthFuncOFF;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Conservative range of depth values within a region of a depth buffer.
+-----------------------------------------------------------------------------*/
+struct SL_DepthRange
+{
+    float minDepth;
+    float maxDepth;
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Depth error permitted between a primitive's vertices and the fragments
+ * interpolated from them.
+-----------------------------------------------------------------------------*/
+constexpr float SL_HIZ_EQUAL_TOLERANCE = 1.f / 4096.f;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Hierarchical depth-rejection tests
+ *
+ * Each test returns true if no depth value in the range [triMin, triMax] can
+ * pass a depth test against any texel within the input depth range.
+-----------------------------------------------------------------------------*/
+template <class DepthCmpFunc>
+struct SL_HiZRejectFunc
+{
+    constexpr bool operator()(float, float, const SL_DepthRange&) const noexcept
+    {
+        return false;
+    }
+};
+
+
+
+template <>
+struct SL_HiZRejectFunc<SL_DepthFuncLT>
+{
+    constexpr bool operator()(float triMin, float, const SL_DepthRange& r) const noexcept
+    {
+        return triMin >= r.maxDepth;
+    }
+};
+
+
+
+template <>
+struct SL_HiZRejectFunc<SL_DepthFuncLE>
+{
+    constexpr bool operator()(float triMin, float, const SL_DepthRange& r) const noexcept
+    {
+        return triMin > r.maxDepth;
+    }
+};
+
+
+
+template <>
+struct SL_HiZRejectFunc<SL_DepthFuncGT>
+{
+    constexpr bool operator()(float, float triMax, const SL_DepthRange& r) const noexcept
+    {
+        return triMax <= r.minDepth;
+    }
+};
+
+
+
+template <>
+struct SL_HiZRejectFunc<SL_DepthFuncGE>
+{
+    constexpr bool operator()(float, float triMax, const SL_DepthRange& r) const noexcept
+    {
+        return triMax < r.minDepth;
+    }
+};
+
+
+
+template <>
+struct SL_HiZRejectFunc<SL_DepthFuncEQ>
+{
+    constexpr bool operator()(float triMin, float triMax, const SL_DepthRange& r) const noexcept
+    {
+        // Interpolated depth can round slightly outside of a primitive's
+        // vertex depths. Equality tests must not reject those fragments.
+        return (triMax + SL_HIZ_EQUAL_TOLERANCE) < r.minDepth || (triMin - SL_HIZ_EQUAL_TOLERANCE) > r.maxDepth;
+    }
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Hierarchical Depth Buffer
+ *
+ * This class tracks the minimum and maximum depth of every 8x8 block of
+ * pixels within a depth buffer, along with the range of every rasterization
+ * tile. Primitives whose depth range cannot pass a depth test within a block
+ * can be skipped entirely by the rasterizer.
+ *
+ * All ranges are conservative. Any code which writes into a depth buffer
+ * without updating its blocks must call invalidate().
+-----------------------------------------------------------------------------*/
+class SL_HiZBuffer
+{
+  private:
+    uint16_t mBlocksX;
+
+    uint16_t mBlocksY;
+
+    uint16_t mTilesX;
+
+    uint16_t mTilesY;
+
+    ls::utils::UniqueAlignedArray<SL_DepthRange> mBlocks;
+
+    ls::utils::UniqueAlignedArray<SL_DepthRange> mTiles;
+
+  public:
+    ~SL_HiZBuffer() noexcept;
+
+    SL_HiZBuffer() noexcept;
+
+    SL_HiZBuffer(const SL_HiZBuffer& h) noexcept;
+
+    SL_HiZBuffer(SL_HiZBuffer&& h) noexcept;
+
+    SL_HiZBuffer& operator=(const SL_HiZBuffer& h) noexcept;
+
+    SL_HiZBuffer& operator=(SL_HiZBuffer&& h) noexcept;
+
+    int init(uint16_t width, uint16_t height) noexcept;
+
+    void terminate() noexcept;
+
+    bool valid() const noexcept;
+
+    uint16_t blocks_x() const noexcept;
+
+    uint16_t blocks_y() const noexcept;
+
+    uint16_t tiles_x() const noexcept;
+
+    uint16_t tiles_y() const noexcept;
+
+    const SL_DepthRange& block(uint16_t x, uint16_t y) const noexcept;
+
+    const SL_DepthRange& tile(uint16_t x, uint16_t y) const noexcept;
+
+    void clear(float depth) noexcept;
+
+    void clear(float depth, uint16_t numThreads, uint16_t threadId) noexcept;
+
+    void invalidate() noexcept;
+
+    template <typename depth_type>
+    void update_tile(const SL_TextureView& depthBuffer, uint16_t tileX, uint16_t tileY, uint64_t dirtyBlocks) noexcept;
+};
+
+
+
+extern template void SL_HiZBuffer::update_tile<ls::math::half>(const SL_TextureView&, uint16_t, uint16_t, uint64_t) noexcept;
+extern template void SL_HiZBuffer::update_tile<float>(const SL_TextureView&, uint16_t, uint16_t, uint64_t) noexcept;
+extern template void SL_HiZBuffer::update_tile<double>(const SL_TextureView&, uint16_t, uint16_t, uint64_t) noexcept;
+
+
+
+/*-------------------------------------
+ * Determine if there is data to test against
+-------------------------------------*/
+inline bool SL_HiZBuffer::valid() const noexcept
+{
+    return mBlocks != nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Number of horizontal 8x8 blocks
+-------------------------------------*/
+inline uint16_t SL_HiZBuffer::blocks_x() const noexcept
+{
+    return mBlocksX;
+}
+
+
+
+/*-------------------------------------
+ * Number of vertical 8x8 blocks
+-------------------------------------*/
+inline uint16_t SL_HiZBuffer::blocks_y() const noexcept
+{
+    return mBlocksY;
+}
+
+
+
+/*-------------------------------------
+ * Number of horizontal raster tiles
+-------------------------------------*/
+inline uint16_t SL_HiZBuffer::tiles_x() const noexcept
+{
+    return mTilesX;
+}
+
+
+
+/*-------------------------------------
+ * Number of vertical raster tiles
+-------------------------------------*/
+inline uint16_t SL_HiZBuffer::tiles_y() const noexcept
+{
+    return mTilesY;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the depth range of an 8x8 block
+-------------------------------------*/
+inline const SL_DepthRange& SL_HiZBuffer::block(uint16_t x, uint16_t y) const noexcept
+{
+    return mBlocks[x + mBlocksX * y];
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the depth range of a raster tile
+-------------------------------------*/
+inline const SL_DepthRange& SL_HiZBuffer::tile(uint16_t x, uint16_t y) const noexcept
+{
+    return mTiles[x + mTilesX * y];
+}
+
+
+
+#endif /* SL_HIZ_BUFFER_HPP */
@@ -0,0 +1,130 @@
+#ifndef SL_HYBRID_WAIT_HPP
+#define SL_HYBRID_WAIT_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "lightsky/setup/Api.h" // LS_INLINE
+#include "lightsky/setup/CPU.h" // cpu_yield()
+#include "lightsky/setup/OS.h" // LS_OS_LINUX
+
+#if !defined(LS_OS_LINUX)
+    #include <condition_variable>
+    #include <mutex>
+#endif
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Hybrid spin-then-park synchronization for the shader processors.
+ *
+ * Waiting threads spin on a condition for a bounded number of iterations,
+ * then sleep in the kernel (a futex on Linux, a condition variable
+ * elsewhere) until another thread signals a change of state. Any thread
+ * which modifies the state of a waited-upon condition must call
+ * notify_all() afterwards.
+-----------------------------------------------------------------------------*/
+class alignas(64) SL_HybridWait
+{
+  private:
+    // Incremented on every notification so parked threads can detect
+    // signals which arrived before they went to sleep.
+    alignas(64) std::atomic<uint32_t> mEpoch;
+
+    std::atomic<uint32_t> mNumParked;
+
+    #if !defined(LS_OS_LINUX)
+        std::mutex mLock;
+
+        std::condition_variable mCond;
+    #endif
+
+    void park(uint32_t epoch) noexcept;
+
+    void wake() noexcept;
+
+  public:
+    ~SL_HybridWait() noexcept = default;
+
+    SL_HybridWait() noexcept;
+
+    SL_HybridWait(const SL_HybridWait&) = delete;
+
+    SL_HybridWait(SL_HybridWait&&) = delete;
+
+    SL_HybridWait& operator=(const SL_HybridWait&) = delete;
+
+    SL_HybridWait& operator=(SL_HybridWait&&) = delete;
+
+    /**
+     * @brief Block the current thread while a condition remains true.
+     *
+     * @param cond
+     * A callable object which returns true while the current thread must
+     * continue waiting.
+     *
+     * @param spinBudget
+     * The number of times the condition is polled before the current thread
+     * sleeps. A budget of 0 parks the thread immediately.
+     */
+    template <typename WaitCondition>
+    void wait(const WaitCondition& cond, uint32_t spinBudget) noexcept;
+
+    /**
+     * @brief Wake all threads parked within wait() so they may re-evaluate
+     * their conditions.
+     */
+    void notify_all() noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Spin, then park
+-------------------------------------*/
+template <typename WaitCondition>
+inline void SL_HybridWait::wait(const WaitCondition& cond, uint32_t spinBudget) noexcept
+{
+    for (uint32_t i = 0; i < spinBudget; ++i)
+    {
+        if (!cond())
+        {
+            return;
+        }
+
+        ls::setup::cpu_yield();
+    }
+
+    while (true)
+    {
+        // The epoch must be read before the condition. Any notification
+        // which arrives afterwards will prevent park() from sleeping.
+        const uint32_t epoch = mEpoch.load(std::memory_order_seq_cst);
+
+        if (!cond())
+        {
+            return;
+        }
+
+        park(epoch);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Signal a change of state
+-------------------------------------*/
+inline LS_INLINE void SL_HybridWait::notify_all() noexcept
+{
+    mEpoch.fetch_add(1u, std::memory_order_seq_cst);
+
+    if (mNumParked.load(std::memory_order_seq_cst))
+    {
+        wake();
+    }
+}
+
+
+
+#endif /* SL_HYBRID_WAIT_HPP */
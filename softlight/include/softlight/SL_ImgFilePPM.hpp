@@ -6,6 +6,14 @@
 
 #include "softlight/SL_Color.hpp"
 #include "softlight/SL_Setup.hpp"
+#include "softlight/SL_Swizzle.hpp" // SL_TexelOrder
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+class SL_Texture;
 
 
 
@@ -213,5 +221,29 @@ SL_ColorRGB8* sl_img_load_ppm(sl_lowp_t& w, sl_lowp_t& h, const char* const pFil
 
 
 
+/*------------------------------------------------------------------------------
+ * Load Images Into Textures
+ *
+ * Binary PPM files are mapped into memory and decoded directly into the
+ * texture's storage, without an intermediate image buffer. Images with more
+ * than 255 values per component are loaded as SL_COLOR_RGB_16U, all others
+ * as SL_COLOR_RGB_8U. Channels and rows are stored in the same order as
+ * images loaded through SL_ImgFile.
+ *
+ * Returns 0 on success, -1 if the file could not be opened, -2 if it is not a
+ * binary PPM image, -3 if its pixel data is truncated, or -4 if texture
+ * memory could not be allocated. The texture is unmodified on failure.
+------------------------------------------------------------------------------*/
+int sl_img_load_ppm(SL_Texture& outTex, const char* const pFilename, SL_TexelOrder texelOrder = SL_TexelOrder::ORDERED) noexcept;
+
+
+
+/*------------------------------------------------------------------------------
+ * Determine if a file name has a PPM extension
+------------------------------------------------------------------------------*/
+bool sl_img_is_ppm(const char* const pFilename) noexcept;
+
+
+
 #endif /* SL_IMAGE_FILE_PPM_HPP */
 
@@ -3,6 +3,7 @@
 #define SL_INDEXBUFFER_HPP
 
 #include <cstddef> // ptrdiff_t
+#include <memory> // std::shared_ptr
 
 #include "lightsky/utils/Copy.h"
 #include "lightsky/utils/Pointer.h"
@@ -29,6 +30,12 @@ class SL_IndexBuffer
 
     ls::utils::UniqueAlignedArray<unsigned char> mBuffer;
 
+    // Memory owned elsewhere, such as a mapped file, which *this has adopted
+    std::shared_ptr<unsigned char> mExternal;
+
+    // Points to either mBuffer or mExternal
+    unsigned char* mData;
+
   public:
     ~SL_IndexBuffer() noexcept;
 
@@ -44,6 +51,8 @@ class SL_IndexBuffer
 
     int init(uint32_t numElements, SL_DataType type, const void* pData = nullptr) noexcept;
 
+    int adopt(uint32_t numElements, SL_DataType type, const std::shared_ptr<unsigned char>& pData) noexcept;
+
     void terminate() noexcept;
 
     SL_DataType type() const noexcept;
@@ -117,7 +126,7 @@ inline unsigned SL_IndexBuffer::bytes_per_element() const noexcept
 inline void* SL_IndexBuffer::element(const ptrdiff_t index) noexcept
 {
     const ptrdiff_t offset = index * mBytesPerId;
-    return mBuffer.get() + offset;
+    return mData + offset;
 }
 
 
@@ -128,7 +137,7 @@ inline void* SL_IndexBuffer::element(const ptrdiff_t index) noexcept
 inline const void* SL_IndexBuffer::element(const ptrdiff_t index) const noexcept
 {
     const ptrdiff_t offset = index * mBytesPerId;
-    return mBuffer.get() + offset;
+    return mData + offset;
 }
 
 
@@ -157,7 +166,7 @@ inline size_t SL_IndexBuffer::index(const size_t index) const noexcept
 --------------------------------------*/
 inline void* SL_IndexBuffer::data() noexcept
 {
-    return mBuffer.get();
+    return mData;
 }
 
 
@@ -167,7 +176,7 @@ inline void* SL_IndexBuffer::data() noexcept
 --------------------------------------*/
 inline const void* SL_IndexBuffer::data() const noexcept
 {
-    return mBuffer.get();
+    return mData;
 }
 
 
@@ -177,7 +186,7 @@ inline const void* SL_IndexBuffer::data() const noexcept
 --------------------------------------*/
 inline void SL_IndexBuffer::assign(const void* pInputData, ptrdiff_t offset, std::size_t count) noexcept
 {
-    ls::utils::fast_memcpy(&mBuffer[0]+offset, pInputData, count*mBytesPerId);
+    ls::utils::fast_memcpy(mData+offset, pInputData, count*mBytesPerId);
 }
 
 
@@ -187,7 +196,7 @@ inline void SL_IndexBuffer::assign(const void* pInputData, ptrdiff_t offset, std
 --------------------------------------*/
 inline bool SL_IndexBuffer::valid() const noexcept
 {
-    return mBuffer != nullptr;
+    return mData != nullptr;
 }
 
 
@@ -0,0 +1,111 @@
+#ifndef SL_MAPPED_FILE_HPP
+#define SL_MAPPED_FILE_HPP
+
+#include <cstddef> // size_t
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Read-only view of a file, mapped into the address space of the
+ * current process.
+ *
+ * Pages of a mapped file are loaded by the OS on first access and may be
+ * shared with other processes reading the same file. Mappings are
+ * copy-on-write: modifying the mapped memory creates private copies of the
+ * affected pages and never writes back into the file.
+-----------------------------------------------------------------------------*/
+class SL_MappedFile
+{
+  private:
+    size_t mNumBytes;
+
+    char* mData;
+
+  public:
+    ~SL_MappedFile() noexcept;
+
+    SL_MappedFile() noexcept;
+
+    SL_MappedFile(const SL_MappedFile&) = delete;
+
+    SL_MappedFile(SL_MappedFile&& f) noexcept;
+
+    SL_MappedFile& operator=(const SL_MappedFile&) = delete;
+
+    SL_MappedFile& operator=(SL_MappedFile&& f) noexcept;
+
+    /**
+     * @brief Map an entire file into memory.
+     *
+     * @param pFilename
+     * A path to the file which should be mapped.
+     *
+     * @return 0 if the file was mapped, -1 if the file could not be opened,
+     * -2 if the file is empty, or -3 if the file could not be mapped.
+     */
+    int open(const char* pFilename) noexcept;
+
+    /**
+     * @brief Unmap the current file. All pointers into the mapped memory
+     * are invalidated.
+     */
+    void close() noexcept;
+
+    /**
+     * @brief Hint to the OS that the entire mapping will be read soon,
+     * allowing pages to be read ahead of their first access.
+     */
+    void prefetch() const noexcept;
+
+    bool valid() const noexcept;
+
+    size_t size() const noexcept;
+
+    char* data() noexcept;
+
+    const char* data() const noexcept;
+};
+
+
+
+/*-------------------------------------
+ * Check if a file is mapped
+-------------------------------------*/
+inline bool SL_MappedFile::valid() const noexcept
+{
+    return mData != nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Number of bytes in the mapped file
+-------------------------------------*/
+inline size_t SL_MappedFile::size() const noexcept
+{
+    return mNumBytes;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the mapped bytes
+-------------------------------------*/
+inline char* SL_MappedFile::data() noexcept
+{
+    return mData;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the mapped bytes (const)
+-------------------------------------*/
+inline const char* SL_MappedFile::data() const noexcept
+{
+    return mData;
+}
+
+
+
+#endif /* SL_MAPPED_FILE_HPP */
@@ -0,0 +1,58 @@
+
+#ifndef SL_MIP_PROCESSOR_HPP
+#define SL_MIP_PROCESSOR_HPP
+
+#include <cstdint>
+
+#include "softlight/SL_Swizzle.hpp" // SL_TexelOrder
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+enum SL_MipFilter : uint8_t;
+struct SL_TextureView;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Mip Processor generates a single mip level from the level above
+ * it. Rows of the destination level are interleaved across threads.
+ *
+ * Texels are filtered in floating-point and converted back into the
+ * texture's native format. Compressed color formats are not supported.
+-----------------------------------------------------------------------------*/
+struct SL_MipProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 40 bits
+    SL_MipFilter mFilter;
+    SL_TexelOrder mTexelOrder;
+
+    // 64-128 bits
+    const SL_TextureView* mSrcTex;
+    SL_TextureView* mDstTex;
+
+    // 136-200 bits total, 20-28 bytes (with padding)
+
+    // Average each 2x2 block of source texels
+    template <typename color_type, SL_TexelOrder order>
+    void downsample_box() noexcept;
+
+    // Separable 6-tap Kaiser-windowed sinc
+    template <typename color_type, SL_TexelOrder order>
+    void downsample_kaiser() noexcept;
+
+    template <typename color_type>
+    void downsample() noexcept;
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_MIP_PROCESSOR_HPP */
@@ -17,6 +17,8 @@ class SL_PointProcessor final : public SL_VertexProcessor
     void process_verts(
         const SL_Mesh& m,
         size_t instanceId,
+        size_t begin,
+        size_t end,
         const ls::math::mat4_t<float>& scissorMat,
         const ls::math::vec4_t<float>& viewportDims
     ) noexcept;
@@ -2,6 +2,10 @@
 #ifndef SL_POINT_RASTERIZER_HPP
 #define SL_POINT_RASTERIZER_HPP
 
+#include <cstdint>
+
+#include "lightsky/setup/Api.h" // LS_INLINE
+
 #include "softlight/SL_FragmentProcessor.hpp"
 #include "softlight/SL_ViewportState.hpp"
 
@@ -34,6 +38,16 @@ struct SL_DepthFuncOFF;
 
 
 
+/*-------------------------------------
+ * Width & height, in pixels, of a rasterized point.
+-------------------------------------*/
+inline LS_INLINE int32_t sl_point_sprite_size(float pointSize) noexcept
+{
+    return (pointSize > 1.5f) ? (int32_t)(pointSize + 0.5f) : 1;
+}
+
+
+
 /*-----------------------------------------------------------------------------
  * Encapsulation of fragment processing for points.
 -----------------------------------------------------------------------------*/
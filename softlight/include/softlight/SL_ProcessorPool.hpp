@@ -4,6 +4,7 @@
 
 #include <array>
 #include <atomic>
+#include <vector>
 
 #include "lightsky/utils/Pointer.h" // Pointer, AlignedPointerDeleter
 
@@ -30,13 +31,22 @@ union vec4_t;
 } // ls namespace
 
 class SL_Context;
+class SL_FastClear;
+struct SL_FboOutputFunctions;
 struct SL_FragCoord;
 struct SL_FragmentBin;
 class SL_Framebuffer;
+class SL_HiZBuffer;
+class SL_HybridWait;
 struct SL_Mesh;
 struct SL_Shader;
 struct SL_ShaderProcessor;
+class SL_TaskRange;
+class SL_Texture;
 struct SL_TextureView;
+enum SL_BlitFilter : uint8_t;
+enum SL_MipFilter : uint8_t;
+enum class SL_TexelOrder;
 
 
 
@@ -54,12 +64,44 @@ class SL_ProcessorPool
 
     ls::utils::UniqueAlignedPointer<SL_BinCounterAtomic<uint_fast64_t>> mShadingSemaphore;
 
+    ls::utils::UniqueAlignedPointer<SL_HybridWait> mWaitSignal;
+
     ls::utils::UniqueAlignedArray<SL_FragCoord> mFragQueues;
 
+    ls::utils::UniqueAlignedPointer<SL_VertexReuseStats> mVertexStats;
+
+    ls::utils::UniqueAlignedPointer<SL_BinFlushStats> mFlushStats;
+
+    // One range of vertex batches per thread, followed by one set of
+    // per-thread tile ranges for each vertex processing buffer.
+    ls::utils::UniqueAlignedArray<SL_TaskRange> mTaskRanges;
+
+    // Per-tile lists of the bins overlapping each tile. Allocated on the
+    // first tiled draw & grown to fit the bins, tiles, and overlaps of later
+    // draws.
+    SL_TileBinLists mTileBins;
+
+    // Index of the first vertex batch within each mesh of a draw call.
+    std::vector<uint32_t> mBatchOffsets;
+
     ls::utils::UniqueAlignedArray<ThreadedWorker> mWorkers;
 
     unsigned mNumThreads;
 
+    uint32_t mBinCapacity;
+
+    SL_BinFlushPolicy mFlushPolicy;
+
+    float mBinCoverageLimit;
+
+    uint32_t mSpinBudget;
+
+    SL_TileBinLists* reserve_tile_bins(uint32_t maxBins, uint32_t numTiles) noexcept;
+
+    void distribute_vertex_batches(const SL_Mesh* meshes, size_t numMeshes, size_t numInstances) noexcept;
+
+    void run_vertex_processors(const SL_Context& c, const SL_Mesh* meshes, size_t numMeshes, size_t numInstances, const SL_Shader& s, const SL_FboOutputFunctions& fboOutputs) noexcept;
+
   public:
     ~SL_ProcessorPool() noexcept;
 
@@ -83,6 +125,10 @@ class SL_ProcessorPool
 
     void wait() noexcept;
 
+    uint32_t spin_budget() const noexcept;
+
+    void spin_budget(uint32_t numSpins) noexcept;
+
     void execute() noexcept;
 
     void run_shader_processors(const SL_Context& c, const SL_Mesh& m, size_t numInstances, const SL_Shader& s, SL_Framebuffer& fbo) noexcept;
@@ -91,6 +137,26 @@ class SL_ProcessorPool
 
     void clear_fragment_bins() noexcept;
 
+    float vertex_reuse_ratio() const noexcept;
+
+    void reset_vertex_stats() noexcept;
+
+    uint32_t bin_capacity() const noexcept;
+
+    void bin_capacity(uint32_t maxBinnedPrims) noexcept;
+
+    SL_BinFlushPolicy bin_flush_policy() const noexcept;
+
+    void bin_flush_policy(SL_BinFlushPolicy policy) noexcept;
+
+    float bin_coverage_limit() const noexcept;
+
+    void bin_coverage_limit(float numScreens) noexcept;
+
+    SL_BinFlushCounts bin_flush_counts() const noexcept;
+
+    void reset_bin_flush_stats() noexcept;
+
     void run_blit_processors(
         const SL_TextureView* inTex,
         SL_TextureView* outTex,
@@ -101,7 +167,8 @@ class SL_ProcessorPool
         uint16_t dstX0,
         uint16_t dstY0,
         uint16_t dstX1,
-        uint16_t dstY1
+        uint16_t dstY1,
+        SL_BlitFilter filter
     ) noexcept;
 
     void run_blit_compressed_processors(
@@ -117,15 +184,23 @@ class SL_ProcessorPool
         uint16_t dstY1
     ) noexcept;
 
-    void run_clear_processors(const void* inColor, SL_TextureView* outTex) noexcept;
+    void run_clear_processors(const void* inColor, SL_TextureView* outTex, SL_HiZBuffer* depthHiZ = nullptr) noexcept;
+
+    void run_clear_processors(const void* inColor, const void* depth, SL_TextureView* colorBuf, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ = nullptr) noexcept;
+
+    void run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_TextureView*, 2>& colorBufs, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ = nullptr) noexcept;
 
-    void run_clear_processors(const void* inColor, const void* depth, SL_TextureView* colorBuf, SL_TextureView* depthBuf) noexcept;
+    void run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_TextureView*, 3>& colorBufs, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ = nullptr) noexcept;
 
-    void run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_TextureView*, 2>& colorBufs, SL_TextureView* depthBuf) noexcept;
+    void run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_TextureView*, 4>& colorBufs, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ = nullptr) noexcept;
 
-    void run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_TextureView*, 3>& colorBufs, SL_TextureView* depthBuf) noexcept;
+    void run_resolve_processors(SL_FastClear* fastClear, SL_TextureView* colorBufs, SL_TextureView* depthBuf) noexcept;
 
-    void run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_TextureView*, 4>& colorBufs, SL_TextureView* depthBuf) noexcept;
+    void run_mip_processors(SL_Texture& tex, SL_MipFilter filter, SL_TexelOrder order) noexcept;
+
+    void run_sample_resolve_processors(const SL_TextureView* inTex, SL_TextureView* outTex) noexcept;
+
+    void run_block_compress_processors(const SL_TextureView* inTex, SL_TextureView* outTex, SL_TexelOrder order, bool decompress) noexcept;
 };
 
 
@@ -140,6 +215,86 @@ inline unsigned SL_ProcessorPool::concurrency() const noexcept
 
 
 
+/*--------------------------------------
+ * Retrieve the number of times idle threads poll before sleeping
+--------------------------------------*/
+inline uint32_t SL_ProcessorPool::spin_budget() const noexcept
+{
+    return mSpinBudget;
+}
+
+
+
+/*--------------------------------------
+ * Set the number of times idle threads poll before sleeping
+--------------------------------------*/
+inline void SL_ProcessorPool::spin_budget(uint32_t numSpins) noexcept
+{
+    mSpinBudget = numSpins;
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the maximum number of primitives binned before a flush
+--------------------------------------*/
+inline uint32_t SL_ProcessorPool::bin_capacity() const noexcept
+{
+    return mBinCapacity;
+}
+
+
+
+/*--------------------------------------
+ * Set the maximum number of primitives binned before a flush
+--------------------------------------*/
+inline void SL_ProcessorPool::bin_capacity(uint32_t maxBinnedPrims) noexcept
+{
+    mBinCapacity = maxBinnedPrims;
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the bin flushing policy
+--------------------------------------*/
+inline SL_BinFlushPolicy SL_ProcessorPool::bin_flush_policy() const noexcept
+{
+    return mFlushPolicy;
+}
+
+
+
+/*--------------------------------------
+ * Set the bin flushing policy
+--------------------------------------*/
+inline void SL_ProcessorPool::bin_flush_policy(SL_BinFlushPolicy policy) noexcept
+{
+    mFlushPolicy = policy;
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the screen coverage which triggers an adaptive flush
+--------------------------------------*/
+inline float SL_ProcessorPool::bin_coverage_limit() const noexcept
+{
+    return mBinCoverageLimit;
+}
+
+
+
+/*--------------------------------------
+ * Set the screen coverage which triggers an adaptive flush
+--------------------------------------*/
+inline void SL_ProcessorPool::bin_coverage_limit(float numScreens) noexcept
+{
+    mBinCoverageLimit = numScreens;
+}
+
+
+
 /*-------------------------------------
  * Run the processor threads
 -------------------------------------*/
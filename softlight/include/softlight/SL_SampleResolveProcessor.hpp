@@ -0,0 +1,44 @@
+#ifndef SL_SAMPLE_RESOLVE_PROCESSOR_HPP
+#define SL_SAMPLE_RESOLVE_PROCESSOR_HPP
+
+#include <cstdint>
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+struct SL_TextureView;
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Sample Resolve Processor averages the samples of a multisampled
+ * attachment into a single-sampled texture. Rows of the destination texture
+ * are interleaved across threads.
+ *
+ * Each sample of the source is stored in a separate layer. Texels are
+ * averaged in floating-point and converted back into the texture's native
+ * format. Compressed color formats are not supported.
+-----------------------------------------------------------------------------*/
+struct SL_SampleResolveProcessor
+{
+    // 32 bits
+    uint16_t mThreadId;
+    uint16_t mNumThreads;
+
+    // 64-128 bits
+    const SL_TextureView* mSrcTex;
+    SL_TextureView* mDstTex;
+
+    // 96-160 bits total, 12-20 bytes (with padding)
+
+    template <typename color_type>
+    void resolve_samples() noexcept;
+
+    void execute() noexcept;
+};
+
+
+
+#endif /* SL_SAMPLE_RESOLVE_PROCESSOR_HPP */
@@ -2,11 +2,15 @@
 #ifndef SL_SAMPLER_HPP
 #define SL_SAMPLER_HPP
 
+#include <cmath> // std::log2
+
 #include "lightsky/setup/Types.h"
 
 #include "lightsky/math/scalar_utils.h"
 #include "lightsky/math/fixed.h"
+#include "lightsky/math/vec2.h"
 
+#include "softlight/SL_ColorBlock.hpp"
 #include "softlight/SL_Texture.hpp"
 
 
@@ -373,4 +377,237 @@ inline LS_INLINE color_type sl_sample_trilinear(const SL_Texture& tex, float x,
 
 
 
+/*-----------------------------------------------------------------------------
+ * Texture view sampling (used to sample individual mip levels)
+-----------------------------------------------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TexelOrder::ORDERED>
+inline LS_INLINE color_type sl_sample_nearest(const SL_TextureView& tex, float x, float y) noexcept
+{
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const uint_fast32_t xi = ls::math::min<uint_fast32_t>((uint_fast32_t)((float)tex.width * wrapMode(x)), tex.width-1u);
+    const uint_fast32_t yi = ls::math::min<uint_fast32_t>((uint_fast32_t)((float)tex.height * wrapMode(y)), tex.height-1u);
+
+    return reinterpret_cast<const color_type*>(tex.pTexels)[sl_texel_index<order>(tex, xi, yi)];
+}
+
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TexelOrder::ORDERED>
+inline LS_INLINE color_type sl_sample_bilinear(const SL_TextureView& tex, float x, float y) noexcept
+{
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const color_type* const pTexels = reinterpret_cast<const color_type*>(tex.pTexels);
+    const uint_fast32_t     maxX    = tex.width - 1u;
+    const uint_fast32_t     maxY    = tex.height - 1u;
+    const float             xf      = wrapMode(x) * (float)tex.width;
+    const float             yf      = wrapMode(y) * (float)tex.height;
+    const uint_fast32_t     xi0     = ls::math::min<uint_fast32_t>((uint_fast32_t)xf, maxX);
+    const uint_fast32_t     yi0     = ls::math::min<uint_fast32_t>((uint_fast32_t)yf, maxY);
+    const uint_fast32_t     xi1     = ls::math::min<uint_fast32_t>(xi0+1u, maxX);
+    const uint_fast32_t     yi1     = ls::math::min<uint_fast32_t>(yi0+1u, maxY);
+    const float             dx      = xf - (float)xi0;
+    const float             dy      = yf - (float)yi0;
+    const float             omdx    = 1.f - dx;
+    const float             omdy    = 1.f - dy;
+    const auto&&            pixel0  = color_cast<float, typename color_type::value_type>(pTexels[sl_texel_index<order>(tex, xi0, yi0)]);
+    const auto&&            pixel1  = color_cast<float, typename color_type::value_type>(pTexels[sl_texel_index<order>(tex, xi0, yi1)]);
+    const auto&&            pixel2  = color_cast<float, typename color_type::value_type>(pTexels[sl_texel_index<order>(tex, xi1, yi0)]);
+    const auto&&            pixel3  = color_cast<float, typename color_type::value_type>(pTexels[sl_texel_index<order>(tex, xi1, yi1)]);
+    const auto&&            weight0 = pixel0 * omdx * omdy;
+    const auto&&            weight1 = pixel1 * omdx * dy;
+    const auto&&            weight2 = pixel2 * dx * omdy;
+    const auto&&            weight3 = pixel3 * dx * dy;
+
+    const auto&& ret = ls::math::sum(weight0, weight1, weight2, weight3);
+
+    return color_cast<typename color_type::value_type, float>(ret);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Block-compressed texture sampling
+ *
+ * Only the texels being sampled are decoded. The block type must match the
+ * texture's format (SL_BlockBC1 for SL_COLOR_BC1, etc.). Sampling returns
+ * the block type's color_type.
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Fetch a single texel from a block-compressed texture
+-------------------------------------*/
+template <typename block_type>
+inline LS_INLINE typename block_type::color_type sl_block_texel(const SL_TextureView& tex, uint_fast32_t x, uint_fast32_t y, uint_fast32_t z = 0) noexcept
+{
+    const block_type& block = reinterpret_cast<const block_type*>(tex.pTexels)[sl_block_index(tex, x, y, z)];
+    return sl_decode_texel(block, (unsigned)(x & 3u), (unsigned)(y & 3u));
+}
+
+
+
+template <typename block_type, class WrapMode>
+inline LS_INLINE typename block_type::color_type sl_sample_nearest_block(const SL_TextureView& tex, float x, float y) noexcept
+{
+    typedef typename block_type::color_type color_type;
+
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const uint_fast32_t xi = ls::math::min<uint_fast32_t>((uint_fast32_t)((float)tex.width * wrapMode(x)), tex.width-1u);
+    const uint_fast32_t yi = ls::math::min<uint_fast32_t>((uint_fast32_t)((float)tex.height * wrapMode(y)), tex.height-1u);
+
+    return sl_block_texel<block_type>(tex, xi, yi);
+}
+
+template <typename block_type, class WrapMode>
+inline LS_INLINE typename block_type::color_type sl_sample_bilinear_block(const SL_TextureView& tex, float x, float y) noexcept
+{
+    typedef typename block_type::color_type color_type;
+    typedef typename color_type::value_type value_type;
+
+    if (SL_WrapMode::SL_IsWrapModeBorder<WrapMode>::value && (x < 0.f || x >= 1.f || y < 0.f || y >= 1.f))
+    {
+        return color_type{0};
+    }
+
+    constexpr WrapMode wrapMode;
+
+    const uint_fast32_t maxX    = tex.width - 1u;
+    const uint_fast32_t maxY    = tex.height - 1u;
+    const float         xf      = wrapMode(x) * (float)tex.width;
+    const float         yf      = wrapMode(y) * (float)tex.height;
+    const uint_fast32_t xi0     = ls::math::min<uint_fast32_t>((uint_fast32_t)xf, maxX);
+    const uint_fast32_t yi0     = ls::math::min<uint_fast32_t>((uint_fast32_t)yf, maxY);
+    const uint_fast32_t xi1     = ls::math::min<uint_fast32_t>(xi0+1u, maxX);
+    const uint_fast32_t yi1     = ls::math::min<uint_fast32_t>(yi0+1u, maxY);
+    const float         dx      = xf - (float)xi0;
+    const float         dy      = yf - (float)yi0;
+    const float         omdx    = 1.f - dx;
+    const float         omdy    = 1.f - dy;
+    const auto&&        pixel0  = color_cast<float, value_type>(sl_block_texel<block_type>(tex, xi0, yi0));
+    const auto&&        pixel1  = color_cast<float, value_type>(sl_block_texel<block_type>(tex, xi0, yi1));
+    const auto&&        pixel2  = color_cast<float, value_type>(sl_block_texel<block_type>(tex, xi1, yi0));
+    const auto&&        pixel3  = color_cast<float, value_type>(sl_block_texel<block_type>(tex, xi1, yi1));
+    const auto&&        weight0 = pixel0 * omdx * omdy;
+    const auto&&        weight1 = pixel1 * omdx * dy;
+    const auto&&        weight2 = pixel2 * dx * omdy;
+    const auto&&        weight3 = pixel3 * dx * dy;
+
+    const auto&& ret = ls::math::sum(weight0, weight1, weight2, weight3);
+
+    return color_cast<value_type, float>(ret);
+}
+
+
+
+template <typename block_type, class WrapMode>
+inline LS_INLINE typename block_type::color_type sl_sample_nearest_block(const SL_Texture& tex, float x, float y) noexcept
+{
+    return sl_sample_nearest_block<block_type, WrapMode>(tex.view(), x, y);
+}
+
+template <typename block_type, class WrapMode>
+inline LS_INLINE typename block_type::color_type sl_sample_bilinear_block(const SL_Texture& tex, float x, float y) noexcept
+{
+    return sl_sample_bilinear_block<block_type, WrapMode>(tex.view(), x, y);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Mipmap filtering
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Calculate the level-of-detail for a texture from the screen-space
+ * derivatives of its texture coordinates. Derivatives can be taken across a
+ * 2x2 quad of fragments.
+-------------------------------------*/
+inline LS_INLINE float sl_calc_mip_lod(const SL_Texture& tex, float dudx, float dvdx, float dudy, float dvdy) noexcept
+{
+    const float w    = (float)tex.width();
+    const float h    = (float)tex.height();
+    const float lenX = (dudx*w)*(dudx*w) + (dvdx*h)*(dvdx*h);
+    const float lenY = (dudy*w)*(dudy*w) + (dvdy*h)*(dvdy*h);
+
+    // log2(sqrt(n)) == 0.5*log2(n). Magnified textures always use level 0.
+    return 0.5f * std::log2(ls::math::max(ls::math::max(lenX, lenY), 1.f));
+}
+
+inline LS_INLINE float sl_calc_mip_lod(const SL_Texture& tex, const ls::math::vec2& dUVdx, const ls::math::vec2& dUVdy) noexcept
+{
+    return sl_calc_mip_lod(tex, dUVdx[0], dUVdx[1], dUVdy[0], dUVdy[1]);
+}
+
+
+
+/*-------------------------------------
+ * Nearest-neighbor filtering within the nearest mip level
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TexelOrder::ORDERED>
+inline LS_INLINE color_type sl_sample_nearest_lod(const SL_Texture& tex, float x, float y, float lod) noexcept
+{
+    const float    maxLod = (float)(tex.num_mips() - 1u);
+    const uint16_t level  = (uint16_t)(ls::math::clamp(lod, 0.f, maxLod) + 0.5f);
+
+    return sl_sample_nearest<color_type, WrapMode, order>(tex.mip(level), x, y);
+}
+
+
+
+/*-------------------------------------
+ * Bilinear filtering within the nearest mip level
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TexelOrder::ORDERED>
+inline LS_INLINE color_type sl_sample_bilinear_lod(const SL_Texture& tex, float x, float y, float lod) noexcept
+{
+    const float    maxLod = (float)(tex.num_mips() - 1u);
+    const uint16_t level  = (uint16_t)(ls::math::clamp(lod, 0.f, maxLod) + 0.5f);
+
+    return sl_sample_bilinear<color_type, WrapMode, order>(tex.mip(level), x, y);
+}
+
+
+
+/*-------------------------------------
+ * Bilinear filtering within, and linear filtering between, the two nearest
+ * mip levels. Textures without mips fall back to bilinear filtering.
+-------------------------------------*/
+template <typename color_type, class WrapMode, SL_TexelOrder order = SL_TexelOrder::ORDERED>
+inline LS_INLINE color_type sl_sample_mipmap(const SL_Texture& tex, float x, float y, float lod) noexcept
+{
+    const uint16_t maxLevel = (uint16_t)(tex.num_mips() - 1u);
+    const float    l        = ls::math::clamp(lod, 0.f, (float)maxLevel);
+    const uint16_t level0   = (uint16_t)l;
+    const uint16_t level1   = ls::math::min<uint16_t>(level0+1u, maxLevel);
+    const float    t        = l - (float)level0;
+
+    const color_type&& c0 = sl_sample_bilinear<color_type, WrapMode, order>(tex.mip(level0), x, y);
+    if (level0 == level1 || t <= 0.f)
+    {
+        return c0;
+    }
+
+    const color_type&& c1 = sl_sample_bilinear<color_type, WrapMode, order>(tex.mip(level1), x, y);
+
+    const auto&& weight0 = color_cast<float, typename color_type::value_type>(c0) * (1.f - t);
+    const auto&& weight1 = color_cast<float, typename color_type::value_type>(c1) * t;
+
+    return color_cast<typename color_type::value_type, float>(weight0 + weight1);
+}
+
+
+
 #endif /* SL_SAMPLER_HPP */
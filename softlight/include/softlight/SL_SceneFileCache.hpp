@@ -0,0 +1,413 @@
+#ifndef SL_SCENE_FILE_CACHE_HPP
+#define SL_SCENE_FILE_CACHE_HPP
+
+#include <cstdint>
+#include <memory> // std::shared_ptr
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "softlight/SL_SceneFileLoader.hpp" // SL_SceneLoadOpts, SL_VaoGroup
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward declarations
+-----------------------------------------------------------------------------*/
+template <typename data_t>
+class SL_AnimationKeyList;
+
+class SL_Camera;
+class SL_MappedFile;
+class SL_SceneGraph;
+class SL_Texture;
+class SL_Transform;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Scene Cache Format
+-----------------------------------------------------------------------------*/
+enum SL_SceneCacheLimits : uint32_t
+{
+    // Incremented whenever the layout of a cache file changes
+    SL_SCENE_CACHE_VERSION = 1,
+
+    // Vertex and index data begin on a page boundary so they can be used
+    // directly from a mapped file.
+    SL_SCENE_CACHE_PAGE_SIZE = 4096,
+
+    // All other sections are aligned to a cache line
+    SL_SCENE_CACHE_SECTION_ALIGNMENT = 64
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * Sections of a cache file. Each section is a tightly packed array of
+ * fixed-size records, or a list of strings.
+-----------------------------------------------------------------------------*/
+enum SL_SceneCacheSection : uint32_t
+{
+    SL_SCENE_CACHE_VAO_GROUPS,
+    SL_SCENE_CACHE_VAOS,
+    SL_SCENE_CACHE_VBOS,
+    SL_SCENE_CACHE_IBOS,
+    SL_SCENE_CACHE_TEXTURES,
+    SL_SCENE_CACHE_NODES,
+    SL_SCENE_CACHE_NODE_PARENTS,
+    SL_SCENE_CACHE_NODE_NAMES,
+    SL_SCENE_CACHE_BASE_TRANSFORMS,
+    SL_SCENE_CACHE_CURRENT_TRANSFORMS,
+    SL_SCENE_CACHE_MODEL_MATRICES,
+    SL_SCENE_CACHE_NODE_MESH_COUNTS,
+    SL_SCENE_CACHE_NODE_MESH_IDS,
+    SL_SCENE_CACHE_MESHES,
+    SL_SCENE_CACHE_MATERIALS,
+    SL_SCENE_CACHE_MESH_BOUNDS,
+    SL_SCENE_CACHE_MESH_SKELETONS,
+    SL_SCENE_CACHE_INV_BONE_TRANSFORMS,
+    SL_SCENE_CACHE_BONE_OFFSETS,
+    SL_SCENE_CACHE_CAMERAS,
+    SL_SCENE_CACHE_ANIMATIONS,
+    SL_SCENE_CACHE_ANIMATION_NAMES,
+    SL_SCENE_CACHE_ANIMATION_TRACKS,
+    SL_SCENE_CACHE_NODE_ANIM_COUNTS,
+    SL_SCENE_CACHE_ANIM_CHANNELS,
+    SL_SCENE_CACHE_ANIM_KEYS,
+
+    SL_SCENE_CACHE_NUM_SECTIONS
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * Location of a section within a cache file.
+-----------------------------------------------------------------------------*/
+struct SL_SceneCacheSectionInfo
+{
+    uint64_t offset;
+    uint64_t numBytes;
+    uint64_t count;
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * Header placed at the beginning of every cache file.
+ *
+ * The size and modification time of the source file, along with the load
+ * options used to import it, determine if a cache is still valid.
+-----------------------------------------------------------------------------*/
+struct SL_SceneCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+
+    // Caches are not portable between platforms of different endianness.
+    uint32_t byteOrder;
+    uint32_t loadOpts;
+
+    uint64_t sourceBytes;
+    int64_t sourceTime;
+
+    SL_SceneCacheSectionInfo sections[SL_SCENE_CACHE_NUM_SECTIONS];
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Scene Cache Records
+ *
+ * Every record uses fixed-width types so a cache does not depend on the
+ * size of size_t or on the padding of in-memory structures.
+-----------------------------------------------------------------------------*/
+struct SL_SceneCacheVaoGroup
+{
+    uint32_t vertType;
+    uint32_t numVboBytes;
+    uint32_t vboOffset;
+    uint32_t meshOffset;
+    uint32_t baseVert;
+};
+
+struct SL_SceneCacheBinding
+{
+    uint32_t dimens;
+    uint32_t type;
+    int64_t offset;
+    int64_t stride;
+};
+
+struct SL_SceneCacheVao
+{
+    uint64_t vboId;
+    uint64_t iboId;
+    uint64_t numBindings;
+    SL_SceneCacheBinding bindings[8];
+};
+
+// Vertex and index buffers. Offsets are relative to the beginning of the
+// file and are aligned to SL_SCENE_CACHE_PAGE_SIZE.
+struct SL_SceneCacheBuffer
+{
+    uint64_t offset;
+    uint64_t numBytes;
+    uint64_t count;
+    uint32_t type;
+    uint32_t padding;
+};
+
+struct SL_SceneCacheNode
+{
+    uint64_t type;
+    uint64_t dataId;
+};
+
+struct SL_SceneCacheTransform
+{
+    uint32_t flags;
+    uint32_t type;
+    float position[3];
+    float scaling[3];
+    float orientation[4];
+    float modelMat[16];
+};
+
+struct SL_SceneCacheMesh
+{
+    uint64_t vaoId;
+    uint64_t elementBegin;
+    uint64_t elementEnd;
+    uint32_t mode;
+    uint32_t materialId;
+};
+
+// Textures reference entries of the SL_SCENE_CACHE_TEXTURES section.
+struct SL_SceneCacheMaterial
+{
+    uint32_t textures[SL_MATERIAL_MAX_TEXTURES];
+    float ambient[4];
+    float diffuse[4];
+    float specular[4];
+    float shininess;
+};
+
+struct SL_SceneCacheBounds
+{
+    float maxPoint[4];
+    float minPoint[4];
+};
+
+struct SL_SceneCacheSkeleton
+{
+    uint64_t index;
+    uint64_t count;
+};
+
+struct SL_SceneCacheCamera
+{
+    uint32_t isDirty;
+    uint32_t projType;
+    float fov;
+    float aspectW;
+    float aspectH;
+    float zNear;
+    float zFar;
+    float projection[16];
+};
+
+// Tracks of an animation are stored contiguously, beginning at "firstTrack."
+struct SL_SceneCacheAnimation
+{
+    uint32_t playMode;
+    uint32_t numTracks;
+    uint64_t firstTrack;
+    float totalTicks;
+    float ticksPerSec;
+};
+
+struct SL_SceneCacheAnimTrack
+{
+    uint64_t channelId;
+    uint64_t trackId;
+    uint64_t transformId;
+};
+
+// Keyframes of a channel begin at "keyOffset" within the
+// SL_SCENE_CACHE_ANIM_KEYS section. Position, scale, then orientation keys
+// are stored as an array of times followed by an array of values.
+struct SL_SceneCacheAnimChannel
+{
+    uint32_t animMode;
+    uint32_t numPosFrames;
+    uint32_t numScaleFrames;
+    uint32_t numOrientFrames;
+    uint64_t keyOffset;
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * Results of reading or writing a cache file.
+-----------------------------------------------------------------------------*/
+enum SL_SceneCacheStatus : int
+{
+    SL_SCENE_CACHE_SUCCESS         = 0,
+    SL_SCENE_CACHE_FILE_NOT_FOUND  = -1,
+    SL_SCENE_CACHE_INVALID_HEADER  = -2,
+    SL_SCENE_CACHE_STALE           = -3,
+    SL_SCENE_CACHE_CORRUPT         = -4,
+    SL_SCENE_CACHE_WRITE_ERROR     = -5,
+    SL_SCENE_CACHE_OUT_OF_MEMORY   = -6
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief Binary cache for imported scene files.
+ *
+ * Caches contain everything the scene file loader produces after an import:
+ * vertex and index buffers, the node hierarchy and transformations,
+ * materials, bones, cameras, and animation tracks. Textures are stored as
+ * references to their original image files.
+ *
+ * Loading a cache maps the file into memory. Vertex and index buffers adopt
+ * the mapped pages directly, matrices and keyframes are filled with one bulk
+ * copy per array, and all other records are converted in a single pass.
+ * Caches are tied to the platform which wrote them and must be
+ * regenerated whenever SL_SCENE_CACHE_VERSION changes.
+-----------------------------------------------------------------------------*/
+class SL_SceneFileCache
+{
+  private:
+    std::shared_ptr<SL_MappedFile> mFile;
+
+    static void save_transform(const SL_Transform& t, SL_SceneCacheTransform& outTransform) noexcept;
+
+    static void load_transform(const SL_SceneCacheTransform& t, SL_Transform& outTransform) noexcept;
+
+    static void save_camera(const SL_Camera& c, SL_SceneCacheCamera& outCamera) noexcept;
+
+    static void load_camera(const SL_SceneCacheCamera& c, SL_Camera& outCamera) noexcept;
+
+    template <typename data_t>
+    static void save_keys(const SL_AnimationKeyList<data_t>& keys, std::vector<char>& outKeys) noexcept;
+
+    template <typename data_t>
+    static const char* load_keys(const char* pKeys, uint32_t numFrames, SL_AnimationKeyList<data_t>& outKeys) noexcept;
+
+    int load_textures(
+        const SL_SceneCacheHeader& header,
+        const SL_SceneLoadOpts& opts,
+        SL_SceneGraph& outGraph,
+        std::vector<const SL_Texture*>& outTextures,
+        std::unordered_map<std::string, const SL_Texture*>& outTexPaths
+    ) noexcept;
+
+    int load_buffers(const SL_SceneCacheHeader& header, SL_SceneGraph& outGraph) noexcept;
+
+    int load_nodes(const SL_SceneCacheHeader& header, SL_SceneGraph& outGraph) noexcept;
+
+    int load_meshes(const SL_SceneCacheHeader& header, const std::vector<const SL_Texture*>& textures, SL_SceneGraph& outGraph) noexcept;
+
+    int load_animations(const SL_SceneCacheHeader& header, SL_SceneGraph& outGraph) noexcept;
+
+  public:
+    ~SL_SceneFileCache() noexcept;
+
+    SL_SceneFileCache() noexcept;
+
+    SL_SceneFileCache(const SL_SceneFileCache&) = delete;
+
+    SL_SceneFileCache(SL_SceneFileCache&& c) noexcept;
+
+    SL_SceneFileCache& operator=(const SL_SceneFileCache&) = delete;
+
+    SL_SceneFileCache& operator=(SL_SceneFileCache&& c) noexcept;
+
+    /**
+     * @brief Release the mapping of the most recently loaded cache.
+     *
+     * Buffers which adopted memory from the cache keep it mapped until they
+     * are destroyed.
+     */
+    void unload() noexcept;
+
+    /**
+     * @brief Write an imported scene into a cache file.
+     *
+     * The cache is written into a temporary file which replaces any existing
+     * cache once complete, so readers never observe a partial file.
+     *
+     * @param cachePath
+     * The path of the cache file to write.
+     *
+     * @param sourcePath
+     * The path of the scene file which was imported. Its size and
+     * modification time are recorded to detect stale caches.
+     *
+     * @param opts
+     * The load options used to import the source file.
+     *
+     * @param graph
+     * The imported scene graph.
+     *
+     * @param vaoGroups
+     * Vertex types of each VAO in the scene graph.
+     *
+     * @param texPaths
+     * Mapping of image file paths to the textures loaded from them.
+     *
+     * @return SL_SCENE_CACHE_SUCCESS if the cache was written, an error code
+     * if not.
+     */
+    SL_SceneCacheStatus save(
+        const std::string& cachePath,
+        const std::string& sourcePath,
+        const SL_SceneLoadOpts& opts,
+        const SL_SceneGraph& graph,
+        const std::vector<SL_VaoGroup>& vaoGroups,
+        const std::unordered_map<std::string, const SL_Texture*>& texPaths
+    ) noexcept;
+
+    /**
+     * @brief Load a scene from a cache file.
+     *
+     * @param cachePath
+     * The path of the cache file to read.
+     *
+     * @param sourcePath
+     * The path of the scene file which the cache was generated from. The
+     * cache is considered stale if this file has changed. An empty path
+     * skips this check.
+     *
+     * @param opts
+     * The load options which the cache must have been generated with.
+     *
+     * @param outGraph
+     * The scene graph which will contain the cached scene. Its current
+     * contents are replaced.
+     *
+     * @param outVaoGroups
+     * Receives the vertex types of each VAO in the scene graph.
+     *
+     * @param outTexPaths
+     * Receives the mapping of image file paths to loaded textures.
+     *
+     * @return SL_SCENE_CACHE_SUCCESS if the scene was loaded, an error code
+     * if the cache is missing, stale, or invalid.
+     */
+    SL_SceneCacheStatus load(
+        const std::string& cachePath,
+        const std::string& sourcePath,
+        const SL_SceneLoadOpts& opts,
+        SL_SceneGraph& outGraph,
+        std::vector<SL_VaoGroup>& outVaoGroups,
+        std::unordered_map<std::string, const SL_Texture*>& outTexPaths
+    ) noexcept;
+};
+
+
+
+#endif /* SL_SCENE_FILE_CACHE_HPP */
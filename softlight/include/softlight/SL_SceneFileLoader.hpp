@@ -3,6 +3,7 @@
 #define SL_SCENE_GRAPH_LOADER_HPP
 
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility> // std::pair
 #include <vector>
@@ -85,6 +86,21 @@ struct SL_SceneFileMeta
 
 
 
+/**----------------------------------------------------------------------------
+ * A unique texture referenced by the materials of a scene. Textures are
+ * allocated while materials are imported, then decoded on worker threads
+ * while vertex data is imported.
+-----------------------------------------------------------------------------*/
+struct SL_SceneTextureJob
+{
+    std::string path;
+    const aiTexture* pEmbeddedTex;
+    SL_Texture* pTexture;
+    bool loaded;
+};
+
+
+
 /*-----------------------------------------------------------------------------
  * @brief SL_SceneLoadOpts Structure
  *
@@ -125,6 +141,12 @@ struct SL_SceneLoadOpts
     // transformed UV mapping is in the CPU cache (will increase CPU cycles
     // spent calculating UVs while potentially decreasing memory bandwidth).
     bool swizzleTexels;
+
+    // Block-compress textures with 8-bit channels after they're loaded (R8 to
+    // BC4, RG8 to BC5, RGB8 to BC1, RGBA8 to BC3). Shaders must sample these
+    // textures using "sl_sample_nearest_block()" or
+    // "sl_sample_bilinear_block()."
+    bool compressTextures;
 };
 
 
@@ -141,6 +163,7 @@ struct SL_SceneLoadOpts
  *     genSmoothNormals: TRUE
  *     genTangents:      FALSE
  *     swizzleTexels:    FALSE
+ *     compressTextures: FALSE
  *
  * @return A SL_SceneLoadOpts structure, containing standard data-modification
  * options which will affect a scene being loaded.
@@ -280,17 +303,38 @@ class SL_SceneFileLoader
 
     bool allocate_gpu_data() noexcept;
 
-    int import_materials(const aiScene* const pScene) noexcept;
+    int import_materials(const aiScene* const pScene, std::vector<SL_SceneTextureJob>& outTextureJobs) noexcept;
 
     void import_texture_path(
         const aiScene* const pScene,
         const unsigned materialIndex,
         const int slotType,
-        SL_ImgFile& imgLoader,
+        std::vector<SL_SceneTextureJob>& textureJobs,
         std::unordered_map<std::string, const SL_Texture*>& loadedTextures
     ) noexcept;
 
-    SL_Texture* load_texture_at_path(const std::string& path, SL_ImgFile& imgLoader, const aiTexture* pEmbeddedTex = nullptr) noexcept;
+    bool load_texture_at_path(SL_SceneTextureJob& job, SL_ImgFile& imgLoader) const noexcept;
+
+    /**
+     * @brief Decode all textures referenced by a scene's materials using
+     * one or more worker threads.
+     *
+     * @param textureJobs
+     * The textures which were allocated while importing materials. This
+     * array must remain valid until wait_for_textures() is called.
+     *
+     * @param outThreads
+     * Receives the threads decoding each texture.
+     */
+    void decode_textures(std::vector<SL_SceneTextureJob>& textureJobs, std::vector<std::thread>& outThreads) noexcept;
+
+    /**
+     * @brief Wait for all textures to be decoded, then release any which
+     * failed to load and detach them from their materials.
+     *
+     * @return TRUE if all textures loaded successfully, FALSE if not.
+     */
+    bool wait_for_textures(std::vector<SL_SceneTextureJob>& textureJobs, std::vector<std::thread>& threads) noexcept;
 
     bool import_mesh_data(const aiScene* const pScene, const SL_SceneLoadOpts& opts) noexcept;
 
@@ -458,6 +502,24 @@ class SL_SceneFileLoader
      */
     bool load(const std::string& filename, SL_SceneLoadOpts opts = sl_default_scene_load_opts()) noexcept;
 
+    /**
+     * @brief Load a 3D mesh file through a binary scene cache.
+     *
+     * If the cache is valid for the file and load options, the scene is
+     * read from the cache without importing the original file. Otherwise
+     * the file is imported and the cache is rewritten for subsequent loads.
+     *
+     * @param filename
+     * A string object containing the relative path name to a file that
+     * should be loadable into memory.
+     *
+     * @param cachePath
+     * The path of the cache file to read from, or write to.
+     *
+     * @return true if the file was successfully loaded. False if not.
+     */
+    bool load(const std::string& filename, const std::string& cachePath, SL_SceneLoadOpts opts = sl_default_scene_load_opts()) noexcept;
+
     /**
      * @brief Import in-memory mesh data, preloaded from a file.
      *
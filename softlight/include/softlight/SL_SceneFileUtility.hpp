@@ -268,7 +268,7 @@ char* sl_calc_mesh_geometry_tangent_packed(
 char* sl_calc_mesh_geometry_bone_id(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept;
 
 
@@ -280,7 +280,7 @@ char* sl_calc_mesh_geometry_bone_id(
 char* sl_calc_mesh_geometry_bone_id_packed(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept;
 
 
@@ -292,7 +292,7 @@ char* sl_calc_mesh_geometry_bone_id_packed(
 char* sl_calc_mesh_geometry_bone_weight(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept;
 
 
@@ -304,7 +304,7 @@ char* sl_calc_mesh_geometry_bone_weight(
 char* sl_calc_mesh_geometry_bone_weight_packed(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept;
 
 
@@ -317,7 +317,7 @@ unsigned sl_upload_mesh_vertices(
     const uint32_t baseVert,
     char* const pVbo,
     const SL_CommonVertType vertTypes,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept;
 
 
@@ -52,6 +52,36 @@ struct SL_VertexParam
 
 
 
+/*-------------------------------------
+ * Parameters which go into a batched vert shader.
+ *
+ * Vertices are stored in SoA form so each lane of a SIMD register maps to a
+ * single vertex. Positions and varyings are indexed as
+ * [vector][component][lane]. Attributes can be fetched using
+ * SL_VertexBuffer::gather().
+-------------------------------------*/
+struct SL_VertexBatchParam
+{
+    const SL_UniformBuffer* pUniforms;
+
+    // Bit N is set if lane N contains a vertex which will be used. Inactive
+    // lanes contain duplicates of an active vertex and can be shaded normally.
+    uint32_t laneMask;
+
+    size_t instanceId;
+    const SL_VertexArray* pVao;
+    const SL_VertexBuffer* pVbo;
+
+    alignas(sizeof(float)*SL_SHADER_VERT_BATCH_SIZE) uint32_t vertId[SL_SHADER_VERT_BATCH_SIZE];
+
+    // Clip-space position output
+    alignas(sizeof(float)*SL_SHADER_VERT_BATCH_SIZE) float position[4][SL_SHADER_VERT_BATCH_SIZE];
+
+    alignas(sizeof(float)*SL_SHADER_VERT_BATCH_SIZE) float pVaryings[SL_SHADER_MAX_VARYING_VECTORS][4][SL_SHADER_VERT_BATCH_SIZE];
+};
+
+
+
 /*-------------------------------------
  * Vertex Shader Configuration.
 -------------------------------------*/
@@ -61,6 +91,14 @@ struct SL_VertexShader
     SL_CullMode cullMode;
 
     ls::math::vec4_t<float> (*shader)(SL_VertexParam& vertParams);
+
+    // Optional batched variant of "shader," used for triangles. Lines and
+    // points are always transformed with the scalar function.
+    void (*batchShader)(SL_VertexBatchParam& batchParams) = nullptr;
+
+    // Width & height, in pixels, of the square rasterized for each point.
+    // This is fixed per-shader; every point in a draw has the same size.
+    float pointSize = 1.f;
 };
 
 
@@ -83,6 +121,95 @@ struct SL_FragmentParam
 
 
 
+/*-------------------------------------
+ * Parameters which go into a batched frag shader.
+ *
+ * Fragments are stored in SoA form so each lane of a SIMD register maps to a
+ * single fragment. Varyings and outputs are indexed as
+ * [vector][component][lane].
+-------------------------------------*/
+struct SL_FragmentBatchParam
+{
+    const SL_UniformBuffer* pUniforms;
+
+    // Bit N is set if lane N contains a rasterized fragment. Inactive lanes
+    // contain duplicates of an active fragment and can be shaded normally.
+    uint32_t laneMask;
+
+    alignas(sizeof(float)*SL_SHADER_FRAG_BATCH_SIZE) int32_t x[SL_SHADER_FRAG_BATCH_SIZE];
+    alignas(sizeof(float)*SL_SHADER_FRAG_BATCH_SIZE) int32_t y[SL_SHADER_FRAG_BATCH_SIZE];
+    alignas(sizeof(float)*SL_SHADER_FRAG_BATCH_SIZE) float   depth[SL_SHADER_FRAG_BATCH_SIZE];
+
+    alignas(sizeof(float)*SL_SHADER_FRAG_BATCH_SIZE) float pVaryings[SL_SHADER_MAX_VARYING_VECTORS][4][SL_SHADER_FRAG_BATCH_SIZE];
+
+    alignas(sizeof(float)*SL_SHADER_FRAG_BATCH_SIZE) float pOutputs[SL_SHADER_MAX_FRAG_OUTPUTS][4][SL_SHADER_FRAG_BATCH_SIZE];
+};
+
+
+
+/*-------------------------------------
+ * Parameters which go into a quad frag shader.
+ *
+ * Triangle fragments are shaded in 2x2 quads so screen-space derivatives can
+ * be calculated by differencing neighboring lanes. Lanes are ordered as
+ * (x, y), (x+1, y), (x, y+1), (x+1, y+1). Varyings are interpolated for all
+ * lanes, including "helper" lanes which are outside of a triangle or failed
+ * the depth test. Outputs from helper lanes are discarded.
+-------------------------------------*/
+struct SL_FragmentQuadParam
+{
+    const SL_UniformBuffer* pUniforms;
+
+    // Bit N is set if lane N contains a rasterized fragment. All other lanes
+    // are helpers which only exist to calculate derivatives.
+    uint32_t laneMask;
+
+    SL_FragCoordXYZ coord[4];
+
+    alignas(sizeof(ls::math::vec4)*2) ls::math::vec4 pVaryings[4][SL_SHADER_MAX_VARYING_VECTORS];
+
+    alignas(sizeof(ls::math::vec4)) ls::math::vec4 pOutputs[4][SL_SHADER_MAX_FRAG_OUTPUTS];
+
+    // Horizontal difference of any per-lane value within a quad.
+    template <typename T>
+    static constexpr T dFdx(const T (&values)[4], unsigned lane) noexcept
+    {
+        return values[(lane & 2u) + 1u] - values[lane & 2u];
+    }
+
+    // Vertical difference of any per-lane value within a quad.
+    template <typename T>
+    static constexpr T dFdy(const T (&values)[4], unsigned lane) noexcept
+    {
+        return values[(lane & 1u) + 2u] - values[lane & 1u];
+    }
+
+    inline ls::math::vec4 dFdx(unsigned varying, unsigned lane) const noexcept
+    {
+        return pVaryings[(lane & 2u) + 1u][varying] - pVaryings[lane & 2u][varying];
+    }
+
+    inline ls::math::vec4 dFdy(unsigned varying, unsigned lane) const noexcept
+    {
+        return pVaryings[(lane & 1u) + 2u][varying] - pVaryings[lane & 1u][varying];
+    }
+
+    inline ls::math::vec4 fwidth(unsigned varying, unsigned lane) const noexcept
+    {
+        const ls::math::vec4&& dx = dFdx(varying, lane);
+        const ls::math::vec4&& dy = dFdy(varying, lane);
+
+        return ls::math::vec4{
+            ls::math::abs(dx[0]) + ls::math::abs(dy[0]),
+            ls::math::abs(dx[1]) + ls::math::abs(dy[1]),
+            ls::math::abs(dx[2]) + ls::math::abs(dy[2]),
+            ls::math::abs(dx[3]) + ls::math::abs(dy[3])
+        };
+    }
+};
+
+
+
 /*-------------------------------------
  * Fragment Shader Configuration.
 -------------------------------------*/
@@ -95,6 +222,22 @@ struct SL_FragmentShader
     SL_DepthMask depthMask;
 
     bool (*shader)(SL_FragmentParam& perFragParams);
+
+    // Optional batched variant of "shader," used for triangle fragments. It
+    // must return a bitmask of the lanes which produced outputs. Lines and
+    // points are always shaded with the scalar function.
+    uint32_t (*batchShader)(SL_FragmentBatchParam& batchParams) = nullptr;
+
+    // Optional variant of "shader," used for triangle fragments which need
+    // screen-space derivatives. It takes priority over "batchShader" and must
+    // return a bitmask of the lanes which produced outputs.
+    uint32_t (*quadShader)(SL_FragmentQuadParam& quadParams) = nullptr;
+
+    // Set if the shader(s) never reject a fragment. This allows
+    // SL_Context::draw_prepassed() to fill the depth buffer without running
+    // the shader. Shaders which discard fragments, such as alpha-tested
+    // geometry, are drawn in a single pass.
+    bool neverDiscards = false;
 };
 
 
@@ -108,8 +251,18 @@ struct SL_Shader
 
     ls::math::vec4_t<float> (*pVertShader)(SL_VertexParam& vertParams);
 
+    void (*pVertBatchShader)(SL_VertexBatchParam& batchParams);
+
     bool (*pFragShader)(SL_FragmentParam& perFragParams);
 
+    uint32_t (*pFragBatchShader)(SL_FragmentBatchParam& batchParams);
+
+    uint32_t (*pFragQuadShader)(SL_FragmentQuadParam& quadParams);
+
+    float pointSize;
+
+    bool fragNeverDiscards;
+
     // Shared pointers are only changed in the move and copy operators
     SL_UniformBuffer* pUniforms;
 };
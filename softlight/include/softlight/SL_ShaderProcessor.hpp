@@ -6,9 +6,12 @@
 
 #include "softlight/SL_BlitProcesor.hpp"
 #include "softlight/SL_BlitCompressedProcesor.hpp"
+#include "softlight/SL_BlockCompressProcessor.hpp"
 #include "softlight/SL_ClearProcesor.hpp"
 #include "softlight/SL_LineProcessor.hpp"
+#include "softlight/SL_MipProcessor.hpp"
 #include "softlight/SL_PointProcessor.hpp"
+#include "softlight/SL_SampleResolveProcessor.hpp"
 #include "softlight/SL_TriProcessor.hpp"
 
 
@@ -27,11 +30,16 @@ enum SL_ShaderType : uint8_t
     SL_POINT_PROCESSOR,
     SL_BLIT_PROCESSOR,
     SL_BLIT_COMPRESSED_PROCESSOR,
-    SL_CLEAR_PROCESSOR
+    SL_CLEAR_PROCESSOR,
+    SL_MIP_PROCESSOR,
+    SL_SAMPLE_RESOLVE_PROCESSOR,
+    SL_BLOCK_COMPRESS_PROCESSOR
 };
 
 SL_ShaderType sl_processor_type_for_draw_mode(SL_RenderMode drawMode) noexcept;
 
+unsigned sl_vertices_per_primitive(SL_RenderMode drawMode) noexcept;
+
 
 
 /*-----------------------------------------------------------------------------
@@ -50,6 +58,9 @@ struct SL_ShaderProcessor
         SL_BlitProcessor mBlitter;
         SL_BlitCompressedProcessor mBlitterCompressed;
         SL_ClearProcessor mClear;
+        SL_MipProcessor mMipGenerator;
+        SL_SampleResolveProcessor mSampleResolver;
+        SL_BlockCompressProcessor mBlockCompressor;
     };
 
     // 2144 bits (268 bytes), padding not included
@@ -103,6 +114,18 @@ inline void SL_ShaderProcessor::operator()() noexcept
         case SL_CLEAR_PROCESSOR:
             mClear.execute();
             break;
+
+        case SL_MIP_PROCESSOR:
+            mMipGenerator.execute();
+            break;
+
+        case SL_SAMPLE_RESOLVE_PROCESSOR:
+            mSampleResolver.execute();
+            break;
+
+        case SL_BLOCK_COMPRESS_PROCESSOR:
+            mBlockCompressor.execute();
+            break;
     }
 }
 
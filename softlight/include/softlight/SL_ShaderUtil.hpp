@@ -7,6 +7,7 @@
 #define SL_SHADERUTIL_HPP
 
 #include <atomic>
+#include <cstddef> // offsetof
 #include <cstdlib> // size_t
 
 #include "lightsky/setup/Api.h"
@@ -15,6 +16,8 @@
 #include "lightsky/math/scalar_utils.h"
 #include "lightsky/math/vec4.h"
 
+#include "lightsky/utils/Pointer.h"
+
 #include "softlight/SL_Config.hpp"
 
 
@@ -232,6 +235,91 @@ void sl_calc_indexed_parition2(size_t count, size_t numThreads, size_t threadId,
 
 
 
+/**
+ * @brief Calculate the number of rasterization tiles required to cover a
+ * framebuffer's width or height.
+ *
+ * @param numPixels
+ * The width or height of a framebuffer, in pixels.
+ *
+ * @return The number of tiles, of SL_RASTER_TILE_SIZE pixels, needed to cover
+ * the input dimension.
+ */
+template <typename data_t>
+constexpr LS_INLINE data_t sl_num_raster_tiles(const data_t numPixels) noexcept
+{
+    return (data_t)((numPixels + (data_t)(SL_RASTER_TILE_SIZE-1)) >> SL_RASTER_TILE_SHIFT);
+}
+
+
+
+/**
+ * @brief Determine which thread owns a screen-space rasterization tile.
+ *
+ * Tiles are distributed round-robin in row-major order so neighboring tiles,
+ * both horizontally and vertically, are generally owned by different threads.
+ *
+ * @param tileX
+ * The horizontal index of a tile.
+ *
+ * @param tileY
+ * The vertical index of a tile.
+ *
+ * @param tilesPerRow
+ * The number of tiles spanning the width of a framebuffer.
+ *
+ * @param numThreads
+ * The number of threads which are currently being used for rendering.
+ *
+ * @return The ID of the thread responsible for rasterizing the input tile.
+ */
+template <typename data_t>
+constexpr LS_INLINE data_t sl_raster_tile_owner(
+    const data_t tileX,
+    const data_t tileY,
+    const data_t tilesPerRow,
+    const data_t numThreads) noexcept
+{
+    return (tileX + tileY * tilesPerRow) % numThreads;
+}
+
+
+
+/**
+ * @brief Retrieve the offset from a tile to the next tile, within the same
+ * row, which is owned by a thread.
+ *
+ * @param tileX
+ * The horizontal index of the first tile to check.
+ *
+ * @param tileY
+ * The vertical index of the tile row to check.
+ *
+ * @param tilesPerRow
+ * The number of tiles spanning the width of a framebuffer.
+ *
+ * @param numThreads
+ * The number of threads which are currently being used for rendering.
+ *
+ * @param threadId
+ * The current thread's ID (0-based index).
+ *
+ * @return The number of tiles to skip from "tileX" before reaching a tile
+ * owned by "threadId". Subsequent tiles are owned every "numThreads" tiles.
+ */
+template <typename data_t>
+constexpr LS_INLINE data_t sl_raster_tile_offset(
+    const data_t tileX,
+    const data_t tileY,
+    const data_t tilesPerRow,
+    const data_t numThreads,
+    const data_t threadId) noexcept
+{
+    return (numThreads-1) - ((tileX + tileY * tilesPerRow + (numThreads-1-threadId)) % numThreads);
+}
+
+
+
 /*-----------------------------------------------------------------------------
  * Depth-Test Operations
 -----------------------------------------------------------------------------*/
@@ -622,7 +710,12 @@ static_assert(sizeof(SL_TransformedVert) == sizeof(ls::math::vec4)*5, "Unexpecte
 /*-----------------------------------------------------------------------------
  * Intermediate Fragment Storage for Binning
  *
- * Aligned to 32 bytes to ensure aligned loads/stores when using AVX
+ * Aligned to 32 bytes to ensure aligned loads/stores when using AVX.
+ *
+ * Bins are tightly packed using a stride from sl_frag_bin_stride(). Only the
+ * varyings used by the current pipeline are stored, with each vertex's
+ * varyings placed contiguously: mVaryings[varyingId + numVaryings*vertId].
+ * Never index an array of bins directly, use sl_frag_bin() instead.
 -----------------------------------------------------------------------------*/
 struct alignas(sizeof(ls::math::vec4)*2) SL_FragmentBin
 {
@@ -632,20 +725,74 @@ struct alignas(sizeof(ls::math::vec4)*2) SL_FragmentBin
     // 4-byte floats * 4-element vector * 3 barycentric coordinates = 48 bytes
     ls::math::vec4 mBarycentricCoords[SL_SHADER_MAX_SCREEN_COORDS];
 
-    // 4-byte floats * 4-element vector * 3-vectors-per-tri * 4 varyings-per-vertex = 192 bytes
-    ls::math::vec4 mVaryings[SL_SHADER_MAX_SCREEN_COORDS * SL_SHADER_MAX_VARYING_VECTORS];
-
     // 8 bytes
     uint_fast64_t primIndex;
 
     // 8 bytes
     uint_fast64_t pad0;
 
-    // 304 bytes = 2432 bits
+    // 4-byte floats * 4-element vector * 3-vectors-per-tri * 0-4 varyings-per-vertex = 0-192 bytes
+    ls::math::vec4 mVaryings[SL_SHADER_MAX_SCREEN_COORDS * SL_SHADER_MAX_VARYING_VECTORS];
+
+    // 112-304 bytes used, 128-320 bytes allocated
 };
 
 static_assert(sizeof(SL_FragmentBin) == sizeof(ls::math::vec4)*20, "Unexpected size of SL_FragmentBin. Please update all varying memcpy routines.");
 
+static_assert(offsetof(SL_FragmentBin, mVaryings) == sizeof(ls::math::vec4)*7, "Unexpected offset of SL_FragmentBin varyings.");
+
+
+
+/*-------------------------------------
+ * Number of bytes between fragment bins which contain a number of varyings
+-------------------------------------*/
+constexpr LS_INLINE size_t sl_frag_bin_stride(size_t numVaryings) noexcept
+{
+    return (offsetof(SL_FragmentBin, mVaryings) + sizeof(ls::math::vec4)*SL_SHADER_MAX_SCREEN_COORDS*numVaryings + alignof(SL_FragmentBin)-1) & ~(alignof(SL_FragmentBin)-1);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a bin from a tightly-packed array of bins
+-------------------------------------*/
+inline LS_INLINE const SL_FragmentBin& sl_frag_bin(const SL_FragmentBin* pBins, size_t binStride, size_t binId) noexcept
+{
+    return *reinterpret_cast<const SL_FragmentBin*>(reinterpret_cast<const unsigned char*>(pBins) + binStride*binId);
+}
+
+
+
+inline LS_INLINE SL_FragmentBin& sl_frag_bin(SL_FragmentBin* pBins, size_t binStride, size_t binId) noexcept
+{
+    return *reinterpret_cast<SL_FragmentBin*>(reinterpret_cast<unsigned char*>(pBins) + binStride*binId);
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Fragment bin capacity
+ *
+ * Each vertex processing buffer holds as many bytes of bins as
+ * SL_SHADER_MAX_BINNED_PRIMS bins with all varyings enabled. Pipelines using
+ * fewer varyings can fit more primitives within the same memory.
+-----------------------------------------------------------------------------*/
+enum : size_t
+{
+    SL_FRAG_BIN_BUFFER_SIZE   = sizeof(SL_FragmentBin) * SL_SHADER_MAX_BINNED_PRIMS,
+    SL_SHADER_MAX_BIN_INDICES = SL_FRAG_BIN_BUFFER_SIZE / sl_frag_bin_stride(0)
+};
+
+
+
+/*-------------------------------------
+ * Maximum number of bins which fit into a vertex processing buffer
+-------------------------------------*/
+constexpr LS_INLINE size_t sl_frag_bin_capacity(size_t numVaryings) noexcept
+{
+    return SL_FRAG_BIN_BUFFER_SIZE / sl_frag_bin_stride(numVaryings);
+}
+
 
 
 /*-----------------------------------------------------------------------------
@@ -653,11 +800,122 @@ static_assert(sizeof(SL_FragmentBin) == sizeof(ls::math::vec4)*20, "Unexpected s
 -----------------------------------------------------------------------------*/
 struct SL_VertProcessBuffer
 {
-    SL_BinCounterAtomic<int_fast64_t> mFragProcessors;               // shared number of threads performing rasterization
-    SL_BinCounterAtomic<uint32_t> mBinsUsed;                         // number of filled fragment bins
-    SL_BinCounter<uint32_t> mBinIds[SL_SHADER_MAX_BINNED_PRIMS];     // shared array of fragment bin IDs
-    SL_BinCounter<uint32_t> mTempBinIds[SL_SHADER_MAX_BINNED_PRIMS]; // pre-allocated storage for a radix sort
-    SL_FragmentBin mFragBins[SL_SHADER_MAX_BINNED_PRIMS];            // shared array of bins (indexed using mBinIds)
+    SL_BinCounterAtomic<int_fast64_t> mFragProcessors;   // shared number of threads performing rasterization
+    SL_BinCounterAtomic<uint32_t> mBinsUsed;             // number of filled fragment bins
+    SL_BinCounterAtomic<uint32_t> mCoverageFlush;        // non-zero if a flush was requested before the bins filled up
+    uint32_t mBinIds[SL_SHADER_MAX_BIN_INDICES];         // shared array of fragment bin IDs
+    uint32_t mTempBinIds[SL_SHADER_MAX_BIN_INDICES];     // pre-allocated storage for a radix sort
+
+    // shared array of variable-sized bins (indexed using mBinIds). The tail
+    // ensures references to the last bin of any size remain in-bounds.
+    alignas(alignof(SL_FragmentBin)) unsigned char mFragBins[SL_FRAG_BIN_BUFFER_SIZE + sizeof(SL_FragmentBin)];
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Range of screen-space tiles overlapped by a fragment bin, gathered once per
+ * flush before tiled rasterization.
+-----------------------------------------------------------------------------*/
+struct SL_TileBin
+{
+    uint32_t binId;
+    uint16_t x0;
+    uint16_t x1;
+    uint16_t y0;
+    uint16_t y1;
+
+    #if SL_HIZ_ENABLED
+    // Range of 8x8 depth blocks & depth values covered by a bin
+    uint16_t bx0;
+    uint16_t bx1;
+    uint16_t by0;
+    uint16_t by1;
+    float    minZ;
+    float    maxZ;
+    #endif
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Lists of the bins which overlap each screen-space tile. These are built by
+ * the thread which sorts bins during a flush, then read by all threads while
+ * they rasterize tiles. Owned by the processor pool.
+-----------------------------------------------------------------------------*/
+struct SL_TileBinLists
+{
+    // Tile range of each visible bin, in rasterization order
+    ls::utils::UniqueAlignedArray<SL_TileBin> bins;
+
+    // Index of each tile's first element within "binIds," followed by the
+    // total number of elements
+    ls::utils::UniqueAlignedArray<uint32_t> tileOffsets;
+
+    // Indices into "bins," grouped by tile
+    ls::utils::UniqueAlignedArray<uint32_t> binIds;
+
+    uint32_t maxBins;
+
+    uint32_t maxTiles;
+
+    uint32_t maxBinIds;
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Counters used to measure post-transform vertex reuse.
+-----------------------------------------------------------------------------*/
+struct SL_VertexReuseStats
+{
+    SL_BinCounterAtomic<uint_fast64_t> mNumVertsReferenced; // vertices referenced by all processed primitives
+    SL_BinCounterAtomic<uint_fast64_t> mNumVertsShaded;     // number of vertex shader invocations
+};
+
+
+
+/*-----------------------------------------------------------------------------
+ * Fragment bin flushing
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Determines when binned primitives are sent to the rasterizer. Bins are
+ * always flushed once they reach capacity. The adaptive policy also flushes
+ * them once the binned primitives cover a large enough area of the screen.
+-------------------------------------*/
+enum SL_BinFlushPolicy : uint8_t
+{
+    SL_BIN_FLUSH_ON_CAPACITY,
+    SL_BIN_FLUSH_ADAPTIVE,
+
+    SL_BIN_FLUSH_DEFAULT = SL_BIN_FLUSH_ADAPTIVE
+};
+
+
+
+/*-------------------------------------
+ * Counters used to measure how often the vertex processors invoke the
+ * rasterizer.
+-------------------------------------*/
+struct SL_BinFlushStats
+{
+    SL_BinCounterAtomic<uint_fast64_t> mNumFlushes;         // number of times the rasterizer was invoked
+    SL_BinCounterAtomic<uint_fast64_t> mNumBinsFlushed;     // number of primitives sent to the rasterizer
+    SL_BinCounterAtomic<uint_fast64_t> mNumCapacityFlushes; // flushes caused by the bins filling up
+    SL_BinCounterAtomic<uint_fast64_t> mNumCoverageFlushes; // early flushes caused by the binned screen area
+};
+
+
+
+/*-------------------------------------
+ * Snapshot of the bin flushing counters
+-------------------------------------*/
+struct SL_BinFlushCounts
+{
+    uint64_t numFlushes;
+    uint64_t numBinsFlushed;
+    uint64_t numCapacityFlushes;
+    uint64_t numCoverageFlushes;
 };
 
 
@@ -686,8 +944,16 @@ struct SL_FragCoord
 
     SL_FragCoordXYZ coord[SL_SHADER_MAX_QUEUED_FRAGS];
     // 256 bits / 32 bytes
+
+    // Coverage of each lane when fragments are queued as 2x2 quads
+    uint8_t quadMask[SL_SHADER_MAX_QUEUED_FRAGS / 4];
+
+    // Samples covered by each fragment of a multisampled framebuffer
+    uint8_t sampleMask[SL_SHADER_MAX_QUEUED_FRAGS];
 };
 
+static_assert(SL_SHADER_MAX_QUEUED_FRAGS % 4 == 0, "Fragment queues must be able to hold a whole number of 2x2 quads.");
+
 
 
 #endif /* SL_SHADERUTIL_HPP */
@@ -0,0 +1,170 @@
+#ifndef SL_TASK_QUEUE_HPP
+#define SL_TASK_QUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "lightsky/setup/Api.h" // LS_INLINE
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief A lock-free, per-thread queue of contiguous task indices.
+ *
+ * Each rendering thread owns one range of tasks and removes them from the
+ * front, in order, to preserve data locality. Idle threads steal tasks from
+ * the back of other threads' ranges. Ranges only shrink once reset, so
+ * threads are finished once every range has been emptied.
+-----------------------------------------------------------------------------*/
+class alignas(64) SL_TaskRange
+{
+  private:
+    // The first task (inclusive) is stored in the lower 32 bits and the
+    // last task (exclusive) is stored in the upper 32 bits.
+    alignas(64) std::atomic<uint64_t> mTasks;
+
+    static constexpr LS_INLINE uint64_t pack(uint32_t begin, uint32_t end) noexcept
+    {
+        return (uint64_t)begin | ((uint64_t)end << 32u);
+    }
+
+  public:
+    ~SL_TaskRange() noexcept = default;
+
+    SL_TaskRange() noexcept :
+        mTasks{0}
+    {}
+
+    SL_TaskRange(const SL_TaskRange&) = delete;
+
+    SL_TaskRange(SL_TaskRange&&) = delete;
+
+    SL_TaskRange& operator=(const SL_TaskRange&) = delete;
+
+    SL_TaskRange& operator=(SL_TaskRange&&) = delete;
+
+    /**
+     * @brief Assign a new range of tasks. This must not be called while other
+     * threads can access the range.
+     */
+    inline LS_INLINE void reset(uint32_t begin, uint32_t end) noexcept
+    {
+        mTasks.store(pack(begin, end), std::memory_order_release);
+    }
+
+    /**
+     * @brief Retrieve the remaining tasks without removing them. Used when a
+     * range is only ever read by its owning thread.
+     */
+    inline LS_INLINE void bounds(uint32_t& outBegin, uint32_t& outEnd) const noexcept
+    {
+        const uint64_t tasks = mTasks.load(std::memory_order_acquire);
+        outBegin = (uint32_t)tasks;
+        outEnd   = (uint32_t)(tasks >> 32u);
+    }
+
+    /**
+     * @brief Remove the first remaining task. Used by the owning thread.
+     *
+     * @return TRUE if a task was placed into "outTask", FALSE if the range
+     * was empty.
+     */
+    inline bool pop_front(uint32_t& outTask) noexcept
+    {
+        uint64_t tasks = mTasks.load(std::memory_order_acquire);
+
+        while (true)
+        {
+            const uint32_t begin = (uint32_t)tasks;
+            const uint32_t end   = (uint32_t)(tasks >> 32u);
+
+            if (begin >= end)
+            {
+                return false;
+            }
+
+            if (mTasks.compare_exchange_weak(tasks, pack(begin+1u, end), std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                outTask = begin;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Remove the last remaining task. Used by stealing threads.
+     *
+     * @return TRUE if a task was placed into "outTask", FALSE if the range
+     * was empty.
+     */
+    inline bool pop_back(uint32_t& outTask) noexcept
+    {
+        uint64_t tasks = mTasks.load(std::memory_order_acquire);
+
+        while (true)
+        {
+            const uint32_t begin = (uint32_t)tasks;
+            const uint32_t end   = (uint32_t)(tasks >> 32u);
+
+            if (begin >= end)
+            {
+                return false;
+            }
+
+            if (mTasks.compare_exchange_weak(tasks, pack(begin, end-1u), std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                outTask = end-1u;
+                return true;
+            }
+        }
+    }
+};
+
+
+
+/**
+ * @brief Retrieve the next task for a thread, first from its own range of
+ * tasks, then by stealing from the ranges of other threads.
+ *
+ * @param pRanges
+ * An array containing one task range per thread.
+ *
+ * @param numThreads
+ * The number of threads which are currently being used for rendering.
+ *
+ * @param threadId
+ * The current thread's ID (0-based index).
+ *
+ * @param outRangeId
+ * Output to store the ID of the thread which originally owned the task.
+ *
+ * @param outTask
+ * Output to store the task index, relative to the range it was taken from.
+ *
+ * @return TRUE if a task was found, FALSE if all tasks have been processed.
+ */
+inline bool sl_acquire_task(SL_TaskRange* pRanges, uint32_t numThreads, uint32_t threadId, uint32_t& outRangeId, uint32_t& outTask) noexcept
+{
+    if (pRanges[threadId].pop_front(outTask))
+    {
+        outRangeId = threadId;
+        return true;
+    }
+
+    for (uint32_t i = 1; i < numThreads; ++i)
+    {
+        const uint32_t victim = (threadId + i) % numThreads;
+
+        if (pRanges[victim].pop_back(outTask))
+        {
+            outRangeId = victim;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+#endif /* SL_TASK_QUEUE_HPP */
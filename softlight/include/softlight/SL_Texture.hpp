@@ -20,6 +20,47 @@ class SL_ImgFile;
 
 
 
+/*-----------------------------------------------------------------------------
+ * Texture Utilities
+-----------------------------------------------------------------------------*/
+enum SL_TextureLimits : uint16_t
+{
+    SL_TEXTURE_MAX_MIP_LEVELS = 16 // enough for a 65535x65535 texture
+};
+
+
+
+enum SL_MipFilter : uint8_t
+{
+    SL_MIP_FILTER_BOX,    // 2x2 average
+    SL_MIP_FILTER_KAISER, // 6x6 Kaiser-windowed sinc, sharper than a box
+
+    SL_MIP_FILTER_DEFAULT = SL_MIP_FILTER_BOX
+};
+
+
+
+enum SL_BlitFilter : uint8_t
+{
+    SL_BLIT_FILTER_NEAREST,  // single texel, no filtering
+    SL_BLIT_FILTER_BILINEAR, // 2x2 weighted average
+    SL_BLIT_FILTER_BOX,      // average of every texel covered by a pixel
+
+    SL_BLIT_FILTER_DEFAULT = SL_BLIT_FILTER_NEAREST
+};
+
+
+
+/*-------------------------------------
+ * Calculate the number of mip levels needed to reduce a texture to 1x1
+-------------------------------------*/
+constexpr uint16_t sl_calc_mip_levels(uint16_t w, uint16_t h) noexcept
+{
+    return (w > 1 || h > 1) ? (uint16_t)(1u + sl_calc_mip_levels((uint16_t)(w >> 1), (uint16_t)(h >> 1))) : (uint16_t)1u;
+}
+
+
+
 /**----------------------------------------------------------------------------
  * @brief Texture data container
  *
@@ -69,16 +110,89 @@ inline void sl_texture_view_from_buffer(SL_TextureView& outView, uint16_t w, uin
 
 
 
+/*-------------------------------------
+ * Allocate zero-initialized storage for a texture. Buffers are padded and
+ * aligned the same way as those allocated by SL_Texture::init() so they can
+ * be filled in either texel order, then handed to SL_Texture::adopt().
+-------------------------------------*/
+void* sl_texture_allocate(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d = 1) noexcept;
+
+
+
+/*-------------------------------------
+ * Free a buffer from sl_texture_allocate() which was never adopted
+-------------------------------------*/
+void sl_texture_free(void* pTexels) noexcept;
+
+
+
+/*-------------------------------------
+ * Convert an X/Y coordinate into an index within a texture view. Swizzled
+ * views are indexed using their padded width so mip levels which are not a
+ * multiple of SL_TEXELS_PER_CHUNK remain addressable.
+-------------------------------------*/
+template <SL_TexelOrder order = SL_TexelOrder::ORDERED>
+inline LS_INLINE ptrdiff_t sl_texel_index(const SL_TextureView& view, uint_fast32_t x, uint_fast32_t y) noexcept
+{
+    if (order == SL_TexelOrder::SWIZZLED)
+    {
+        const uint_fast32_t w = ((uint_fast32_t)view.width + (SL_TEXELS_PER_CHUNK-1u)) & ~(uint_fast32_t)(SL_TEXELS_PER_CHUNK-1u);
+        return (ptrdiff_t)sl_swizzle_2d_index<SL_TEXELS_PER_CHUNK, SL_TEXEL_SHIFTS_PER_CHUNK>(x, y, w);
+    }
+
+    return (ptrdiff_t)(x + (uint_fast32_t)view.width * y);
+}
+
+
+
+/*-------------------------------------
+ * Convert an X/Y/Z coordinate into an index within a texture view.
+-------------------------------------*/
+template <SL_TexelOrder order = SL_TexelOrder::ORDERED>
+inline LS_INLINE ptrdiff_t sl_texel_index(const SL_TextureView& view, uint_fast32_t x, uint_fast32_t y, uint_fast32_t z) noexcept
+{
+    if (order == SL_TexelOrder::SWIZZLED)
+    {
+        const uint_fast32_t w = ((uint_fast32_t)view.width + (SL_TEXELS_PER_CHUNK-1u)) & ~(uint_fast32_t)(SL_TEXELS_PER_CHUNK-1u);
+        const uint_fast32_t h = ((uint_fast32_t)view.height + (SL_TEXELS_PER_CHUNK-1u)) & ~(uint_fast32_t)(SL_TEXELS_PER_CHUNK-1u);
+        return (ptrdiff_t)sl_swizzle_3d_index<SL_TEXELS_PER_CHUNK, SL_TEXEL_SHIFTS_PER_CHUNK>(x, y, z, w, h);
+    }
+
+    return (ptrdiff_t)(x + (uint_fast32_t)view.width * (y + (uint_fast32_t)view.height * z));
+}
+
+
+
+/*-------------------------------------
+ * Convert an X/Y/Z texel coordinate into the index of the 4x4 block which
+ * contains it. Block-compressed textures always store their blocks in
+ * row-major order, regardless of texel order.
+-------------------------------------*/
+inline LS_INLINE ptrdiff_t sl_block_index(const SL_TextureView& view, uint_fast32_t x, uint_fast32_t y, uint_fast32_t z = 0) noexcept
+{
+    const uint_fast32_t blocksX = ((uint_fast32_t)view.width + 3u) >> 2u;
+    const uint_fast32_t blocksY = ((uint_fast32_t)view.height + 3u) >> 2u;
+    return (ptrdiff_t)((x >> 2u) + blocksX * ((y >> 2u) + blocksY * z));
+}
+
+
+
 /**----------------------------------------------------------------------------
  * @brief Generic texture Class
  *
- * This class contains an owning reference to texture view data.
+ * This class contains an owning reference to texture view data, along with
+ * an optional chain of mip levels. Level 0 is always the base texture.
 -----------------------------------------------------------------------------*/
 class alignas(sizeof(uint64_t)) SL_Texture
 {
   private:
     SL_TextureView mView;
 
+    // Mip levels 1 through (mNumMips-1)
+    SL_TextureView* mMips;
+
+    uint16_t mNumMips;
+
   public:
     ~SL_Texture() noexcept;
 
@@ -122,8 +236,22 @@ class alignas(sizeof(uint64_t)) SL_Texture
 
     int init(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder = SL_TexelOrder::ORDERED) noexcept;
 
+    // Take ownership of a buffer from sl_texture_allocate() instead of
+    // copying it. Returns -1 if the buffer is NULL.
+    int adopt(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d, void* pTexels) noexcept;
+
     void terminate() noexcept;
 
+    int init_mips(uint16_t numLevels = 0) noexcept;
+
+    void terminate_mips() noexcept;
+
+    uint16_t num_mips() const noexcept;
+
+    const SL_TextureView& mip(uint16_t level) const noexcept;
+
+    SL_TextureView& mip(uint16_t level) noexcept;
+
     SL_ColorDataType type() const noexcept;
 
     const void* data() const noexcept;
@@ -183,6 +311,18 @@ class alignas(sizeof(uint64_t)) SL_Texture
 
 
 
+/*-------------------------------------
+ * Replace a texture with 8-bit channels by its block-compressed equivalent
+ * (R8 to BC4, RG8 to BC5, RGB8 to BC1, RGBA8 to BC3) on the calling thread.
+ * "order" is the current texel order of the texture. Returns 0 on success,
+ * -1 if the texture has no block-compressed equivalent, or -2 if the
+ * compressed texture could not be allocated. Use
+ * SL_Context::compress_texture() to compress across all threads instead.
+-------------------------------------*/
+int sl_texture_compress(SL_Texture& tex, SL_TexelOrder order) noexcept;
+
+
+
 /*-------------------------------------
  * Convert an X/Y coordinate to a Z-ordered coordinate.
 -------------------------------------*/
@@ -353,6 +493,36 @@ inline LS_INLINE uint32_t SL_Texture::channels() const noexcept
 
 
 
+/*-------------------------------------
+ * Get the number of mip levels, including the base level
+-------------------------------------*/
+inline LS_INLINE uint16_t SL_Texture::num_mips() const noexcept
+{
+    return mNumMips;
+}
+
+
+
+/*-------------------------------------
+ * Get a mip level (const)
+-------------------------------------*/
+inline LS_INLINE const SL_TextureView& SL_Texture::mip(uint16_t level) const noexcept
+{
+    return level ? mMips[level-1u] : mView;
+}
+
+
+
+/*-------------------------------------
+ * Get a mip level
+-------------------------------------*/
+inline LS_INLINE SL_TextureView& SL_Texture::mip(uint16_t level) noexcept
+{
+    return level ? mMips[level-1u] : mView;
+}
+
+
+
 /*-------------------------------------
  * Get the texture mView.type
 -------------------------------------*/
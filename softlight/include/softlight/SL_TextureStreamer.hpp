@@ -0,0 +1,207 @@
+#ifndef SL_TEXTURE_STREAMER_HPP
+#define SL_TEXTURE_STREAMER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lightsky/utils/Pointer.h"
+
+#include "softlight/SL_Color.hpp" // SL_ColorDataType
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Forward Declarations
+-----------------------------------------------------------------------------*/
+class SL_Context;
+
+
+
+/**----------------------------------------------------------------------------
+ * Residency of a streamed texture.
+-----------------------------------------------------------------------------*/
+enum SL_TextureStreamStatus : int
+{
+    // The placeholder is bound while the image is decoded.
+    SL_TEXTURE_STREAM_PENDING,
+
+    // The image was decoded and will be bound during the next update().
+    SL_TEXTURE_STREAM_DECODED,
+
+    // The decoded image is bound to the texture.
+    SL_TEXTURE_STREAM_RESIDENT,
+
+    // The image could not be loaded. The placeholder remains bound.
+    SL_TEXTURE_STREAM_FAILED,
+
+    // The handle does not refer to a request.
+    SL_TEXTURE_STREAM_INVALID = -1
+};
+
+
+
+enum SL_TextureStreamProp : size_t
+{
+    SL_TEXTURE_STREAM_INVALID_HANDLE = (size_t)-1
+};
+
+
+
+/**----------------------------------------------------------------------------
+ * @brief The Texture Streamer loads image files into textures without
+ * blocking the thread which requested them.
+ *
+ * Each request creates a texture in the streamer's context and immediately
+ * binds a 1x1 placeholder texel to it. Images are decoded, converted, and
+ * swizzled on background threads into a staging texture. Calling update()
+ * binds finished images by swapping the staged texels into their textures,
+ * which costs a few pointer assignments. Textures keep their address and
+ * context index throughout, so materials and uniforms may reference them
+ * before their images arrive.
+ *
+ * Requests and updates must be made from the thread which owns the context.
+ * Textures must not be destroyed while their request is pending.
+-----------------------------------------------------------------------------*/
+class SL_TextureStreamer
+{
+  private:
+    struct SL_TextureStream
+    {
+        std::string path;
+
+        SL_TexelOrder texelOrder;
+
+        SL_Texture* pTexture;
+
+        SL_Texture staged;
+
+        SL_TextureStreamStatus status;
+    };
+
+    SL_Context* mContext;
+
+    mutable std::mutex mLock;
+
+    // Signaled when new requests are available or the streamer is shutting
+    // down
+    std::condition_variable mPendingSignal;
+
+    // Signaled each time a request has been decoded
+    std::condition_variable mDecodedSignal;
+
+    // Requests are never relocated so workers can decode without holding
+    // the lock.
+    std::vector<ls::utils::Pointer<SL_TextureStream>> mStreams;
+
+    std::deque<size_t> mPending;
+
+    std::vector<size_t> mDecoded;
+
+    size_t mNumDecoding;
+
+    bool mRunning;
+
+    std::vector<std::thread> mThreads;
+
+    void decode_textures() noexcept;
+
+  public:
+    /**
+     * @brief Destructor
+     *
+     * Waits for the current decodes to finish. Pending requests are
+     * abandoned and keep their placeholders.
+     */
+    ~SL_TextureStreamer() noexcept;
+
+    /**
+     * @brief Constructor
+     *
+     * @param context
+     * The context which will own all streamed textures.
+     *
+     * @param numThreads
+     * The number of background threads which decode images.
+     */
+    SL_TextureStreamer(SL_Context& context, unsigned numThreads = 1) noexcept;
+
+    SL_TextureStreamer(const SL_TextureStreamer&) = delete;
+
+    SL_TextureStreamer(SL_TextureStreamer&&) = delete;
+
+    SL_TextureStreamer& operator=(const SL_TextureStreamer&) = delete;
+
+    SL_TextureStreamer& operator=(SL_TextureStreamer&&) = delete;
+
+    /**
+     * @brief Request an image file be loaded into a new texture.
+     *
+     * @param path
+     * The path of the image file to load.
+     *
+     * @param placeholderType
+     * The color format of the placeholder texture. This should match the
+     * format any shaders will sample the texture with until its image is
+     * bound.
+     *
+     * @param pPlaceholderTexel
+     * A pointer to a single texel of type "placeholderType" which fills the
+     * placeholder. A NULL pointer leaves the placeholder zeroed.
+     *
+     * @param texelOrder
+     * The order in which texels of the loaded image will be stored.
+     *
+     * @return A handle to the streamed texture, or
+     * SL_TEXTURE_STREAM_INVALID_HANDLE if a texture could not be created.
+     */
+    size_t request(
+        const std::string& path,
+        SL_ColorDataType placeholderType = SL_COLOR_RGBA_8U,
+        const void* pPlaceholderTexel = nullptr,
+        SL_TexelOrder texelOrder = SL_TexelOrder::ORDERED
+    ) noexcept;
+
+    /**
+     * @brief Bind all decoded images to their textures.
+     *
+     * The context is synchronized beforehand if any images are bound, so
+     * in-flight draws never observe a texture being swapped.
+     *
+     * @return The number of textures which became resident.
+     */
+    size_t update() noexcept;
+
+    /**
+     * @brief Block until every request has been decoded or has failed.
+     * Decoded images are not bound until update() is called.
+     */
+    void wait() noexcept;
+
+    /**
+     * @brief Retrieve the status of a streamed texture.
+     */
+    SL_TextureStreamStatus status(size_t handle) const noexcept;
+
+    /**
+     * @brief Retrieve the index of a streamed texture within the context.
+     *
+     * @return The index of the texture, or SL_TEXTURE_STREAM_INVALID_HANDLE
+     * if the texture no longer exists.
+     */
+    size_t texture_id(size_t handle) const noexcept;
+
+    /**
+     * @brief Retrieve a streamed texture. The returned texture holds its
+     * placeholder until the texture becomes resident.
+     */
+    const SL_Texture* texture(size_t handle) const noexcept;
+};
+
+
+
+#endif /* SL_TEXTURE_STREAMER_HPP */
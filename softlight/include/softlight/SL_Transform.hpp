@@ -60,6 +60,8 @@ class alignas(sizeof(ls::math::vec4)*4) SL_Transform
 {
     friend class slscript::SL_SceneGraphScript<LS_SCRIPT_HASH_FUNC("SL_SceneGraph"), SL_SceneGraph*>;
 
+    friend class SL_SceneFileCache;
+
   private:
     /**
      * @brief Meta-information container.
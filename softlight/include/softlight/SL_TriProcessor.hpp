@@ -12,6 +12,9 @@
 class SL_TriProcessor final : public SL_VertexProcessor
 {
   private:
+    uint_fast64_t mNumVertsReferenced;
+    uint_fast64_t mNumVertsShaded;
+
     void push_bin(size_t primIndex, const SL_TransformedVert& v0, const SL_TransformedVert& v1, const SL_TransformedVert& v2) noexcept;
 
     void clip_and_process_tris(
@@ -26,6 +29,18 @@ class SL_TriProcessor final : public SL_VertexProcessor
     void process_verts(
         const SL_Mesh& m,
         size_t instanceId,
+        size_t begin,
+        size_t end,
+        const ls::math::mat4_t<float>& scissorMat,
+        const ls::math::vec4_t<float>& viewportDims
+    ) noexcept;
+
+    template <bool usingIndices>
+    void process_vert_batches(
+        const SL_Mesh& m,
+        size_t instanceId,
+        size_t begin,
+        size_t end,
         const ls::math::mat4_t<float>& scissorMat,
         const ls::math::vec4_t<float>& viewportDims
     ) noexcept;
@@ -41,6 +56,8 @@ class SL_TriProcessor final : public SL_VertexProcessor
 extern template void SL_TriProcessor::process_verts<true>(
     const SL_Mesh&,
     size_t,
+    size_t,
+    size_t,
     const ls::math::mat4_t<float>&,
     const ls::math::vec4_t<float>&
 ) noexcept;
@@ -50,6 +67,30 @@ extern template void SL_TriProcessor::process_verts<true>(
 extern template void SL_TriProcessor::process_verts<false>(
     const SL_Mesh&,
     size_t,
+    size_t,
+    size_t,
+    const ls::math::mat4_t<float>&,
+    const ls::math::vec4_t<float>&
+) noexcept;
+
+
+
+extern template void SL_TriProcessor::process_vert_batches<true>(
+    const SL_Mesh&,
+    size_t,
+    size_t,
+    size_t,
+    const ls::math::mat4_t<float>&,
+    const ls::math::vec4_t<float>&
+) noexcept;
+
+
+
+extern template void SL_TriProcessor::process_vert_batches<false>(
+    const SL_Mesh&,
+    size_t,
+    size_t,
+    size_t,
     const ls::math::mat4_t<float>&,
     const ls::math::vec4_t<float>&
 ) noexcept;
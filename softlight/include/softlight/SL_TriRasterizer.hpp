@@ -23,6 +23,7 @@ struct SL_FragmentBin; // SL_ShaderProcessor.hpp
 class SL_Framebuffer;
 struct SL_Shader;
 struct SL_TextureView;
+struct SL_TileBinLists; // SL_ShaderUtil.hpp
 
 struct SL_DepthFuncLT;
 struct SL_DepthFuncLE;
@@ -48,11 +49,38 @@ struct SL_TriRasterizer final : public SL_FragmentProcessor
     void render_wireframe(const SL_TextureView& depthBuffer) const noexcept;
 
     template <class DepthCmpFunc, typename depth_type>
-    void render_triangle(const SL_TextureView& depthBuffer) const noexcept;
+    void render_triangle_region(
+        const SL_FragmentBin& bin,
+        const SL_TextureView& depthBuffer,
+        const ls::math::vec4_t<int32_t>& region,
+        int32_t yOffset,
+        int32_t increment
+    ) const noexcept;
+
+    template <class DepthCmpFunc, typename depth_type>
+    void render_triangle_quads(
+        const SL_FragmentBin& bin,
+        const SL_TextureView& depthBuffer,
+        const ls::math::vec4_t<int32_t>& region,
+        int32_t yOffset,
+        int32_t increment
+    ) const noexcept;
+
+    template <class DepthCmpFunc, typename depth_type>
+    void render_triangle_msaa(
+        const SL_FragmentBin& bin,
+        const SL_TextureView& depthBuffer,
+        const ls::math::vec4_t<int32_t>& region,
+        int32_t yOffset,
+        int32_t increment
+    ) const noexcept;
 
     template <class DepthCmpFunc, typename depth_type>
     void render_triangle_simd(const SL_TextureView& depthBuffer) const noexcept;
 
+    template <class DepthCmpFunc, typename depth_type>
+    void render_triangle_tiled(const SL_TextureView& depthBuffer) const noexcept;
+
     template <class DepthCmpFunc>
     void dispatch_bins() noexcept;
 
@@ -61,6 +89,23 @@ struct SL_TriRasterizer final : public SL_FragmentProcessor
 
 
 
+/*-----------------------------------------------------------------------------
+ * Group the visible bins of a flush by the screen-space tiles they overlap.
+ * This is run once per flush, by a single thread, before any tiles are
+ * rasterized. "tileLists" must have room for "numBins" bins and every tile
+ * in the depth buffer.
+-----------------------------------------------------------------------------*/
+void sl_bin_raster_tiles(
+    SL_TileBinLists& tileLists,
+    const SL_FragmentBin* pBins,
+    size_t binStride,
+    const uint32_t* pBinIds,
+    uint32_t numBins,
+    const SL_TextureView& depthBuffer,
+    bool useMsaa) noexcept;
+
+
+
 extern template void SL_TriRasterizer::render_wireframe<SL_DepthFuncLT, ls::math::half>(const SL_TextureView&) const noexcept;
 extern template void SL_TriRasterizer::render_wireframe<SL_DepthFuncLT, float>(const SL_TextureView&) const noexcept;
 extern template void SL_TriRasterizer::render_wireframe<SL_DepthFuncLT, double>(const SL_TextureView&) const noexcept;
@@ -91,36 +136,6 @@ extern template void SL_TriRasterizer::render_wireframe<SL_DepthFuncOFF, double>
 
 
 
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncLT, ls::math::half>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncLT, float>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncLT, double>(const SL_TextureView&) const noexcept;
-
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncLE, ls::math::half>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncLE, float>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncLE, double>(const SL_TextureView&) const noexcept;
-
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncGT, ls::math::half>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncGT, float>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncGT, double>(const SL_TextureView&) const noexcept;
-
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncGE, ls::math::half>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncGE, float>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncGE, double>(const SL_TextureView&) const noexcept;
-
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncEQ, ls::math::half>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncEQ, float>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncEQ, double>(const SL_TextureView&) const noexcept;
-
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncNE, ls::math::half>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncNE, float>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncNE, double>(const SL_TextureView&) const noexcept;
-
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncOFF, ls::math::half>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncOFF, float>(const SL_TextureView&) const noexcept;
-extern template void SL_TriRasterizer::render_triangle<SL_DepthFuncOFF, double>(const SL_TextureView&) const noexcept;
-
-
-
 extern template void SL_TriRasterizer::render_triangle_simd<SL_DepthFuncLT, ls::math::half>(const SL_TextureView&) const noexcept;
 extern template void SL_TriRasterizer::render_triangle_simd<SL_DepthFuncLT, float>(const SL_TextureView&) const noexcept;
 extern template void SL_TriRasterizer::render_triangle_simd<SL_DepthFuncLT, double>(const SL_TextureView&) const noexcept;
@@ -151,6 +166,36 @@ extern template void SL_TriRasterizer::render_triangle_simd<SL_DepthFuncOFF, dou
 
 
 
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLT, ls::math::half>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLT, float>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLT, double>(const SL_TextureView&) const noexcept;
+
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLE, ls::math::half>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLE, float>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLE, double>(const SL_TextureView&) const noexcept;
+
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGT, ls::math::half>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGT, float>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGT, double>(const SL_TextureView&) const noexcept;
+
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGE, ls::math::half>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGE, float>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGE, double>(const SL_TextureView&) const noexcept;
+
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncEQ, ls::math::half>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncEQ, float>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncEQ, double>(const SL_TextureView&) const noexcept;
+
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncNE, ls::math::half>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncNE, float>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncNE, double>(const SL_TextureView&) const noexcept;
+
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncOFF, ls::math::half>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncOFF, float>(const SL_TextureView&) const noexcept;
+extern template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncOFF, double>(const SL_TextureView&) const noexcept;
+
+
+
 extern template void SL_TriRasterizer::dispatch_bins<SL_DepthFuncLT>() noexcept;
 extern template void SL_TriRasterizer::dispatch_bins<SL_DepthFuncLE>() noexcept;
 extern template void SL_TriRasterizer::dispatch_bins<SL_DepthFuncGT>() noexcept;
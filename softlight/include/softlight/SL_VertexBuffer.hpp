@@ -3,8 +3,11 @@
 #define SL_VERTEXBUFFER_HPP
 
 #include <cstddef> // ptrdiff_t
+#include <cstdint>
 #include <memory>
 
+#include "lightsky/setup/Arch.h"
+
 #include "lightsky/utils/Copy.h"
 #include "lightsky/utils/Pointer.h"
 
@@ -17,6 +20,12 @@ class SL_VertexBuffer
 
     ls::utils::Pointer<unsigned char[], ls::utils::AlignedDeleter> mBuffer;
 
+    // Memory owned elsewhere, such as a mapped file, which *this has adopted
+    std::shared_ptr<unsigned char> mExternal;
+
+    // Points to either mBuffer or mExternal
+    unsigned char* mData;
+
   public:
     ~SL_VertexBuffer() noexcept;
 
@@ -32,6 +41,8 @@ class SL_VertexBuffer
 
     int init(size_t numBytes, const void* pData = nullptr) noexcept;
 
+    int adopt(size_t numBytes, const std::shared_ptr<unsigned char>& pData) noexcept;
+
     void terminate() noexcept;
 
     std::size_t num_bytes() const noexcept;
@@ -42,6 +53,14 @@ class SL_VertexBuffer
     template <typename data_type = unsigned char>
     const data_type* element(const ptrdiff_t offset) const noexcept;
 
+    template <unsigned numLanes>
+    void gather(
+        const ptrdiff_t offset,
+        const ptrdiff_t stride,
+        const uint32_t* vertIds,
+        unsigned numComponents,
+        float (*outLanes)[numLanes]) const noexcept;
+
     void* data() noexcept;
 
     const void* data() const noexcept;
@@ -71,7 +90,7 @@ inline std::size_t SL_VertexBuffer::num_bytes() const noexcept
 template <typename data_type>
 inline data_type* SL_VertexBuffer::element(const ptrdiff_t offset) noexcept
 {
-    return reinterpret_cast<data_type*>(mBuffer.get() + offset);
+    return reinterpret_cast<data_type*>(mData + offset);
 }
 
 
@@ -84,7 +103,50 @@ inline data_type* SL_VertexBuffer::element(const ptrdiff_t offset) noexcept
 template <typename data_type>
 inline const data_type* SL_VertexBuffer::element(const ptrdiff_t offset) const noexcept
 {
-    return reinterpret_cast<const data_type*>(mBuffer.get() + offset);
+    return reinterpret_cast<const data_type*>(mData + offset);
+}
+
+
+
+/*--------------------------------------
+ * Gather the 32-bit float components of a vertex attribute into SoA form.
+ *
+ * The offset and stride could be retrieved from a VAO
+--------------------------------------*/
+template <unsigned numLanes>
+inline void SL_VertexBuffer::gather(
+    const ptrdiff_t offset,
+    const ptrdiff_t stride,
+    const uint32_t* vertIds,
+    unsigned numComponents,
+    float (*outLanes)[numLanes]) const noexcept
+{
+    const unsigned char* const pBase = mData + offset;
+
+    #if defined(LS_X86_AVX2)
+        if (numLanes == 8)
+        {
+            const __m256i ids     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vertIds));
+            const __m256i offsets = _mm256_mullo_epi32(ids, _mm256_set1_epi32((int32_t)stride));
+
+            for (unsigned c = 0; c < numComponents; ++c)
+            {
+                const float* pComponent = reinterpret_cast<const float*>(pBase + c * sizeof(float));
+                _mm256_storeu_ps(outLanes[c], _mm256_i32gather_ps(pComponent, offsets, 1));
+            }
+
+            _mm256_zeroupper();
+            return;
+        }
+    #endif
+
+    for (unsigned c = 0; c < numComponents; ++c)
+    {
+        for (unsigned l = 0; l < numLanes; ++l)
+        {
+            outLanes[c][l] = *reinterpret_cast<const float*>(pBase + stride * vertIds[l] + c * sizeof(float));
+        }
+    }
 }
 
 
@@ -94,7 +156,7 @@ inline const data_type* SL_VertexBuffer::element(const ptrdiff_t offset) const n
 --------------------------------------*/
 inline void* SL_VertexBuffer::data() noexcept
 {
-    return mBuffer.get();
+    return mData;
 }
 
 
@@ -104,7 +166,7 @@ inline void* SL_VertexBuffer::data() noexcept
 --------------------------------------*/
 inline const void* SL_VertexBuffer::data() const noexcept
 {
-    return mBuffer.get();
+    return mData;
 }
 
 
@@ -114,7 +176,7 @@ inline const void* SL_VertexBuffer::data() const noexcept
 --------------------------------------*/
 inline void SL_VertexBuffer::assign(const void* pInputData, ptrdiff_t offset, std::size_t numBytes) noexcept
 {
-    ls::utils::fast_memcpy(mBuffer.get()+offset, pInputData, numBytes);
+    ls::utils::fast_memcpy(mData+offset, pInputData, numBytes);
 }
 
 
@@ -124,7 +186,7 @@ inline void SL_VertexBuffer::assign(const void* pInputData, ptrdiff_t offset, st
 --------------------------------------*/
 inline bool SL_VertexBuffer::valid() const noexcept
 {
-    return mBuffer != nullptr;
+    return mData != nullptr;
 }
 
 
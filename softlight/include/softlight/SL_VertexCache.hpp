@@ -2,6 +2,7 @@
 #ifndef SL_VERTEX_CACHE_HPP
 #define SL_VERTEX_CACHE_HPP
 
+#include "lightsky/utils/Copy.h" // fast_memset()
 #include "lightsky/utils/IndexedCache.hpp"
 #include "lightsky/utils/LRUCache.hpp"
 #include "lightsky/utils/LRU8WayCache.hpp"
@@ -61,4 +62,74 @@ inline LS_INLINE void sl_cache_query_or_update(SL_PTVCache& cache, size_t key, S
 
 
 
+/*-----------------------------------------------------------------------------
+ * Post-Transform Vertex Batching
+-----------------------------------------------------------------------------*/
+static_assert(ls::math::is_pow2<size_t>(SL_VERTEX_BATCH_SIZE), "Vertex batch size must be a power of 2.");
+
+
+
+/**
+ * @brief Post-Transform Vertex Batch
+ *
+ * This structure holds each unique vertex referenced by a contiguous range of
+ * indexed triangles. Every vertex in the batch only needs to be transformed
+ * once, regardless of how many triangles reference it.
+ */
+struct alignas(alignof(SL_TransformedVert)) SL_PTVBatch
+{
+    enum : uint32_t
+    {
+        SL_BATCH_MAX_VERTS  = SL_VERTEX_BATCH_SIZE * 3u,
+
+        // Keep the hash table at most 3/8 full to limit probing
+        SL_BATCH_TABLE_SIZE = SL_VERTEX_BATCH_SIZE * 8u,
+        SL_BATCH_TABLE_MASK = SL_BATCH_TABLE_SIZE - 1u
+    };
+
+    static_assert(SL_BATCH_MAX_VERTS < 32768u, "Vertex batch size too large for 16-bit slot indices.");
+    static_assert(SL_BATCH_MAX_VERTS % 4u == 0u, "Vertex batches must be processable in groups of 4 vertices.");
+
+    SL_TransformedVert mVerts[SL_BATCH_MAX_VERTS]; // unique, transformed vertices
+    ls::math::vec4 mScreenVerts[SL_BATCH_MAX_VERTS]; // perspective-divided screen coordinates of "mVerts"
+    uint8_t mClipFlags[SL_BATCH_MAX_VERTS];         // 0x02 if inside the clip volume, 0x01 if W > 0
+    uint32_t mVertIds[SL_BATCH_MAX_VERTS];         // vertex ID of each transformed vertex
+    uint16_t mTriSlots[SL_BATCH_MAX_VERTS];        // 3 slots in "mVerts" per triangle
+    int16_t mTable[SL_BATCH_TABLE_SIZE];           // maps vertex IDs to slots, -1 if unused
+    uint32_t mNumVerts;
+
+    inline void reset() noexcept
+    {
+        mNumVerts = 0;
+        ls::utils::fast_memset(mTable, 0xFF, sizeof(mTable));
+    }
+
+    inline LS_INLINE uint16_t insert(uint32_t vertId) noexcept
+    {
+        // Fibonacci hashing spreads out sequential indices
+        uint32_t h = ((vertId * 2654435769u) >> 16u) & SL_BATCH_TABLE_MASK;
+
+        while (true)
+        {
+            const int16_t slot = mTable[h];
+
+            if (slot < 0)
+            {
+                mTable[h] = (int16_t)mNumVerts;
+                mVertIds[mNumVerts] = vertId;
+                return (uint16_t)mNumVerts++;
+            }
+
+            if (mVertIds[slot] == vertId)
+            {
+                return (uint16_t)slot;
+            }
+
+            h = (h + 1u) & SL_BATCH_TABLE_MASK;
+        }
+    }
+};
+
+
+
 #endif /* SL_VERTEX_CACHE_HPP */
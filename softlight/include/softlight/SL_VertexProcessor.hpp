@@ -5,7 +5,7 @@
 #include <atomic>
 
 #include "softlight/SL_Mesh.hpp"
-#include "softlight/SL_ShaderUtil.hpp" // SL_BinCounter, SL_BinCounterAtomic
+#include "softlight/SL_ShaderUtil.hpp" // SL_BinCounterAtomic, sl_frag_bin()
 
 
 
@@ -26,21 +26,23 @@ struct mat4_t;
 } // end math namespace
 } // end ls namespace
 
-template <typename data_t>
-union SL_BinCounter;
-
 template <typename data_t>
 union SL_BinCounterAtomic;
 
 class SL_Context; // SL_Context.hpp
+class SL_HybridWait; // SL_HybridWait.hpp
+class SL_TaskRange; // SL_TaskQueue.hpp
 struct SL_FragmentBin; // SL_ShaderProcessor.hpp
 struct SL_FragCoord;
 struct SL_FboOutputFunctions; // SL_Framebuffer.hpp
 struct SL_PointRasterizer;
 struct SL_LineRasterizer;
 struct SL_Shader; // SL_Shader.hpp
+struct SL_TileBinLists; // SL_ShaderUtil.hpp
 struct SL_TransformedVert;
 struct SL_TriRasterizer;
+struct SL_VertexReuseStats;
+struct SL_BinFlushStats;
 
 
 
@@ -54,8 +56,33 @@ class SL_VertexProcessor
     uint32_t mProcessBufferIndex;
     SL_VertProcessBuffer* mProcessBuffer;
 
+    // Size of each fragment bin and the number of bins available per buffer,
+    // based on the number of varyings used by the current draw.
+    uint32_t mBinStride;
+    uint32_t mMaxBins;
+
+    // Screen area, in pixels, of the primitives this thread binned since its
+    // last flush. The rasterizer is invoked early once mMaxBinnedArea is
+    // reached (0 disables the early flush).
+    float mBinnedArea;
+    float mMaxBinnedArea;
+
     SL_BinCounterAtomic<uint_fast64_t>* mBusyProcessors;
 
+    // Idle threads spin mSpinBudget times before parking on mWaitSignal.
+    SL_HybridWait* mWaitSignal;
+    uint32_t mSpinBudget;
+
+    // Stealable work. The first mNumThreads ranges contain batches of
+    // primitives for the current draw. Each process buffer then has a set
+    // of mNumThreads ranges containing raster tiles, or the sorted bins
+    // owned by each thread when rasterizing points.
+    SL_TaskRange* mTaskRanges;
+
+    // Index of the first batch within each mesh (one extra entry holds the
+    // total). Instanced draws repeat the batches of a single mesh.
+    const uint32_t* mBatchOffsets;
+
     const SL_Shader*  mShader;
     const SL_Context* mContext;
     SL_FboOutputFunctions* mFragFuncs;
@@ -69,6 +96,13 @@ class SL_VertexProcessor
 
     SL_FragCoord* mFragQueues;
 
+    // Per-tile bin lists, used by the tiled triangle rasterizer
+    SL_TileBinLists* mTileBins;
+
+    SL_VertexReuseStats* mVertexStats;
+
+    SL_BinFlushStats* mFlushStats;
+
     virtual ~SL_VertexProcessor() noexcept = default;
     SL_VertexProcessor() noexcept {}
     SL_VertexProcessor(const SL_VertexProcessor&) noexcept = default;
@@ -90,22 +124,32 @@ class SL_VertexProcessor
     const SL_BinCounterAtomic<uint32_t>& active_num_bins_used() const noexcept { return mProcessBuffer[mProcessBufferIndex].mBinsUsed; }
     SL_BinCounterAtomic<uint32_t>& active_num_bins_used() noexcept { return mProcessBuffer[mProcessBufferIndex].mBinsUsed; }
 
-    const SL_BinCounter<uint32_t>* active_bin_indices() const noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds; }
-    SL_BinCounter<uint32_t>* active_bin_indices() noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds; }
+    const uint32_t* active_bin_indices() const noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds; }
+    uint32_t* active_bin_indices() noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds; }
+
+    const uint32_t* active_temp_bin_indices() const noexcept { return mProcessBuffer[mProcessBufferIndex].mTempBinIds; }
+    uint32_t* active_temp_bin_indices() noexcept { return mProcessBuffer[mProcessBufferIndex].mTempBinIds; }
+
+    const uint32_t& active_bin_index(uint_fast64_t index) const noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds[index]; }
+    uint32_t& active_bin_index(uint_fast64_t index) noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds[index]; }
 
-    const SL_BinCounter<uint32_t>* active_temp_bin_indices() const noexcept { return mProcessBuffer[mProcessBufferIndex].mTempBinIds; }
-    SL_BinCounter<uint32_t>* active_temp_bin_indices() noexcept { return mProcessBuffer[mProcessBufferIndex].mTempBinIds; }
+    const SL_FragmentBin* active_frag_bins() const noexcept { return reinterpret_cast<const SL_FragmentBin*>(mProcessBuffer[mProcessBufferIndex].mFragBins); }
+    SL_FragmentBin* active_frag_bins() noexcept { return reinterpret_cast<SL_FragmentBin*>(mProcessBuffer[mProcessBufferIndex].mFragBins); }
 
-    const SL_BinCounter<uint32_t>& active_bin_index(uint_fast64_t index) const noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds[index]; }
-    SL_BinCounter<uint32_t>& active_bin_index(uint_fast64_t index) noexcept { return mProcessBuffer[mProcessBufferIndex].mBinIds[index]; }
+    const SL_FragmentBin& active_frag_bin(uint_fast64_t binId) const noexcept { return sl_frag_bin(active_frag_bins(), mBinStride, binId); }
+    SL_FragmentBin& active_frag_bin(uint_fast64_t binId) noexcept { return sl_frag_bin(active_frag_bins(), mBinStride, binId); }
 
-    const SL_FragmentBin* active_frag_bins() const noexcept { return mProcessBuffer[mProcessBufferIndex].mFragBins; }
-    SL_FragmentBin* active_frag_bins() noexcept { return mProcessBuffer[mProcessBufferIndex].mFragBins; }
+    SL_TaskRange* active_tile_ranges() const noexcept { return mTaskRanges + mNumThreads * (1u + mProcessBufferIndex); }
 
   protected:
+    bool next_vertex_batch(size_t elementsPerBatch, size_t& outMeshId, size_t& outInstanceId, size_t& outBegin, size_t& outEnd) noexcept;
+
     template <typename RasterizerType>
     void flush_rasterizer() noexcept;
 
+    template <typename RasterizerType>
+    void flush_on_coverage(float primArea) noexcept;
+
     template <typename RasterizerType>
     void cleanup() noexcept;
 };
@@ -117,6 +161,8 @@ extern template void SL_VertexProcessor::flush_rasterizer<SL_PointRasterizer>()
 extern template void SL_VertexProcessor::flush_rasterizer<SL_LineRasterizer>() noexcept;
 extern template void SL_VertexProcessor::flush_rasterizer<SL_TriRasterizer>() noexcept;
 
+extern template void SL_VertexProcessor::flush_on_coverage<SL_TriRasterizer>(float) noexcept;
+
 extern template void SL_VertexProcessor::cleanup<SL_PointRasterizer>() noexcept;
 extern template void SL_VertexProcessor::cleanup<SL_LineRasterizer>() noexcept;
 extern template void SL_VertexProcessor::cleanup<SL_TriRasterizer>() noexcept;
@@ -729,6 +729,89 @@ struct SL_Blit_Compressed_to_Compressed<SL_ColorRGB4444, SL_ColorRGB1010102>
 
 
 
+/*-------------------------------------
+ * Row conversion
+ *
+ * Each row of a tile is converted at once so the most common blits can
+ * convert several texels per instruction.
+-------------------------------------*/
+template<class BlitOp>
+struct SL_BlitCompressedRow
+{
+    inline LS_INLINE void operator()(
+        const SL_TextureView* pTexture,
+        const uint_fast32_t* pSrcX,
+        const uint_fast32_t srcY,
+        const uint_fast32_t count,
+        unsigned char* const pOutBuf,
+        uint_fast32_t outIndex) const noexcept
+    {
+        constexpr BlitOp blitOp;
+
+        for (uint_fast32_t i = 0; i < count; ++i)
+        {
+            blitOp(pTexture, pSrcX[i], srcY, pOutBuf, outIndex);
+            outIndex += BlitOp::stride;
+        }
+    }
+};
+
+
+
+#if defined(LS_X86_SSE2) || defined(LS_ARM_NEON)
+template<>
+struct SL_BlitCompressedRow<SL_Blit_Compressed_to_RGBA<SL_ColorRGB565, uint8_t>>
+{
+    inline LS_INLINE void operator()(
+        const SL_TextureView* pTexture,
+        const uint_fast32_t* pSrcX,
+        const uint_fast32_t srcY,
+        const uint_fast32_t count,
+        unsigned char* const pOutBuf,
+        uint_fast32_t outIndex) const noexcept
+    {
+        constexpr SL_Blit_Compressed_to_RGBA<SL_ColorRGB565, uint8_t> blitOp;
+        const uint16_t* const pRow = reinterpret_cast<const uint16_t*>(pTexture->pTexels) + (uint_fast32_t)pTexture->width * srcY;
+        uint_fast32_t i = 0;
+
+        // Channels are expanded the same way as rgba_cast<uint8_t>(): red is
+        // stored in the lowest bits of each texel.
+        for (; i + 4u <= count; i += 4u)
+        {
+            #if defined(LS_X86_SSE2)
+                const __m128i p = _mm_set_epi32(pRow[pSrcX[i+3]], pRow[pSrcX[i+2]], pRow[pSrcX[i+1]], pRow[pSrcX[i+0]]);
+                const __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x1F)), 3);
+                const __m128i g = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x7E0)), 5);
+                const __m128i b = _mm_slli_epi32(_mm_srli_epi32(p, 11), 19);
+                const __m128i a = _mm_set1_epi32((int32_t)0xFF000000);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutBuf + outIndex), _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a)));
+
+            #else
+                const uint32_t texels[4] = {pRow[pSrcX[i+0]], pRow[pSrcX[i+1]], pRow[pSrcX[i+2]], pRow[pSrcX[i+3]]};
+                const uint32x4_t p = vld1q_u32(texels);
+                const uint32x4_t r = vshlq_n_u32(vandq_u32(p, vdupq_n_u32(0x1F)), 3);
+                const uint32x4_t g = vshlq_n_u32(vandq_u32(p, vdupq_n_u32(0x7E0)), 5);
+                const uint32x4_t b = vshlq_n_u32(vshrq_n_u32(p, 11), 19);
+                const uint32x4_t a = vdupq_n_u32(0xFF000000);
+
+                vst1q_u8(pOutBuf + outIndex, vreinterpretq_u8_u32(vorrq_u32(vorrq_u32(r, g), vorrq_u32(b, a))));
+            #endif
+
+            outIndex += 4u * sizeof(SL_ColorRGBAType<uint8_t>);
+        }
+
+        for (; i < count; ++i)
+        {
+            blitOp(pTexture, pSrcX[i], srcY, pOutBuf, outIndex);
+            outIndex += sizeof(SL_ColorRGBAType<uint8_t>);
+        }
+    }
+};
+#endif
+
+
+
 /*-----------------------------------------------------------------------------
  * SL_BlitProcessorCompressed functions and namespaces
 -----------------------------------------------------------------------------*/
@@ -875,53 +958,79 @@ void SL_BlitCompressedProcessor::blit_src_compressed() noexcept
 
 
 /*-------------------------------------
- * Nearest-neighbor filtering (RGBA)
+ * Retrieve the destination rectangle of a tile
+-------------------------------------*/
+bool SL_BlitCompressedProcessor::tile_bounds(
+    uint_fast32_t tileId,
+    uint_fast32_t& outX0,
+    uint_fast32_t& outY0,
+    uint_fast32_t& outX1,
+    uint_fast32_t& outY1) const noexcept
+{
+    const uint_fast32_t rectX1 = ls::math::min<uint_fast32_t>(mDstTex->width, dstX1);
+    const uint_fast32_t rectY1 = ls::math::min<uint_fast32_t>(mDstTex->height, dstY1);
+
+    if (LS_UNLIKELY(dstX0 >= rectX1 || dstY0 >= rectY1))
+    {
+        return false;
+    }
+
+    const uint_fast32_t tilesX = (rectX1 - dstX0 + TILE_SIZE - 1u) >> TILE_SHIFT;
+    const uint_fast32_t tilesY = (rectY1 - dstY0 + TILE_SIZE - 1u) >> TILE_SHIFT;
+
+    if (tileId >= tilesX * tilesY)
+    {
+        return false;
+    }
+
+    outX0 = dstX0 + ((tileId % tilesX) << TILE_SHIFT);
+    outY0 = dstY0 + ((tileId / tilesX) << TILE_SHIFT);
+    outX1 = ls::math::min<uint_fast32_t>(outX0 + TILE_SIZE, rectX1);
+    outY1 = ls::math::min<uint_fast32_t>(outY0 + TILE_SIZE, rectY1);
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Nearest-neighbor filtering
 -------------------------------------*/
 template<class BlitOp>
 void SL_BlitCompressedProcessor::blit_nearest() noexcept
 {
-    constexpr BlitOp blitOp;
+    constexpr SL_BlitCompressedRow<BlitOp> blitRow;
     unsigned char* const pOutBuf = reinterpret_cast<unsigned char* const>(mDstTex->pTexels);
 
     const uint_fast32_t inW  = (uint_fast32_t)srcX1 - (uint_fast32_t)srcX0;
     const uint_fast32_t inH  = (uint_fast32_t)srcY1 - (uint_fast32_t)srcY0;
-    const uint_fast32_t outW = (uint_fast32_t)dstX1 - (uint_fast32_t)dstX0;
 
     const uint_fast32_t totalOutW = mDstTex->width;
     const uint_fast32_t totalOutH = mDstTex->height;
 
-    // Only tile data along the y-axis of the render buffer. This will help to
-    // make use of the CPU prefetcher when iterating pixels along the x-axis
-    const uint_fast32_t x0    = ls::math::max<uint_fast32_t>(0u, dstX0);
-    const uint_fast32_t x1    = ls::math::min<uint_fast32_t>(totalOutW, x0 + outW);
-    const uint_fast32_t y0    = dstY0+mThreadId;
-    const uint_fast32_t y1    = dstY1;
     const uint_fast32_t finW  = (inW << NUM_FIXED_BITS);
     const uint_fast32_t finH  = (inH << NUM_FIXED_BITS);
     const uint_fast32_t foutW = (finW / totalOutW) + 1u; // account for rounding errors
     const uint_fast32_t foutH = (finH / totalOutH) + 1u;
 
-    uint_fast32_t y = y0;
+    uint_fast32_t srcXs[TILE_SIZE];
+    uint_fast32_t x0, y0, x1, y1;
 
-    while (LS_LIKELY(y < y1))
+    for (uint_fast32_t tileId = mThreadId; tile_bounds(tileId, x0, y0, x1, y1); tileId += mNumThreads)
     {
-        const uint_fast32_t yf       = (y * foutH) >> NUM_FIXED_BITS;
-        const uint_fast32_t srcY     = srcY1 - (srcY0 + yf) - 1u;
-        uint_fast32_t       outIndex = (x0 + totalOutW * y) * BlitOp::stride;
-
-        uint_fast32_t x = x0;
+        // Every row of a tile reads from the same source columns
+        for (uint_fast32_t x = x0; x < x1; ++x)
+        {
+            srcXs[x-x0] = (x * foutW) >> NUM_FIXED_BITS;
+        }
 
-        while (LS_LIKELY(x < x1))
+        for (uint_fast32_t y = y0; y < y1; ++y)
         {
-            const uint_fast32_t xf   = x * foutW;
-            const uint_fast32_t srcX = xf >> NUM_FIXED_BITS;
+            const uint_fast32_t yf   = (y * foutH) >> NUM_FIXED_BITS;
+            const uint_fast32_t srcY = srcY1 - (srcY0 + yf) - 1u;
 
-            blitOp(mSrcTex, srcX, srcY, pOutBuf, outIndex);
-            ++x;
-            outIndex += BlitOp::stride;
+            blitRow(mSrcTex, srcXs, srcY, x1-x0, pOutBuf, (x0 + totalOutW * y) * BlitOp::stride);
         }
-
-        y += mNumThreads;
     }
 }
 
@@ -3,6 +3,7 @@
 
 #include "lightsky/math/scalar_utils.h"
 #include "lightsky/math/vec_utils.h" // vector casting
+#include "lightsky/math/vec4.h"
 
 #include "softlight/SL_BlitProcesor.hpp"
 #include "softlight/SL_Color.hpp"
@@ -419,6 +420,358 @@ struct SL_Blit_RGBA_to_RGBA<float, uint8_t>
 
 
 
+/*-------------------------------------
+ * Load 4 floating-point color channels
+-------------------------------------*/
+inline LS_INLINE math::vec4 _sl_blit_load_rgbaf(const float* pTexel) noexcept
+{
+    #if defined(LS_X86_SSE)
+        return math::vec4{_mm_loadu_ps(pTexel)};
+    #elif defined(LS_ARM_NEON)
+        return math::vec4{vld1q_f32(pTexel)};
+    #else
+        return math::vec4{pTexel[0], pTexel[1], pTexel[2], pTexel[3]};
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Load & convert 4 half-float color channels
+-------------------------------------*/
+inline LS_INLINE math::vec4 _sl_blit_load_rgbah(const math::half* pTexel) noexcept
+{
+    #if defined(LS_X86_FP16)
+        return math::vec4{_mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pTexel)))};
+
+    #elif defined(LS_X86_SSE2)
+        // Shift the exponent & mantissa into place, then re-bias the exponent
+        // with a multiplication (2^112) which also handles denormals.
+        const __m128i h    = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pTexel)), _mm_setzero_si128());
+        const __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+        const __m128i bits = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+        const __m128  mag  = _mm_mul_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(_mm_set1_epi32(0x77800000)));
+        return math::vec4{_mm_or_ps(mag, _mm_castsi128_ps(sign))};
+
+    #elif defined(LS_ARM_NEON)
+        return math::vec4{vcvt_f32_f16(vld1_f16(reinterpret_cast<const __fp16*>(pTexel)))};
+
+    #else
+        return (math::vec4)(*reinterpret_cast<const math::vec4_t<math::half>*>(pTexel));
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Clamp & store a single 8-bit RGBA color
+-------------------------------------*/
+inline LS_INLINE void _sl_blit_store_rgba8(const math::vec4& rgba, unsigned char* pOut) noexcept
+{
+    const math::vec4&& c = math::clamp(rgba, math::vec4{0.f}, math::vec4{1.f}) * 255.f;
+
+    pOut[0] = (unsigned char)c[0];
+    pOut[1] = (unsigned char)c[1];
+    pOut[2] = (unsigned char)c[2];
+    pOut[3] = (unsigned char)c[3];
+}
+
+
+
+/*-------------------------------------
+ * Clamp & store 4 8-bit RGBA colors
+-------------------------------------*/
+inline LS_INLINE void _sl_blit_store_rgba8x4(
+    const math::vec4& c0,
+    const math::vec4& c1,
+    const math::vec4& c2,
+    const math::vec4& c3,
+    unsigned char* pOut) noexcept
+{
+    #if defined(LS_X86_SSE2)
+        const __m128  zero  = _mm_setzero_ps();
+        const __m128  one   = _mm_set1_ps(1.f);
+        const __m128  scale = _mm_set1_ps(255.f);
+        const __m128i i0    = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(c0.simd, zero), one), scale));
+        const __m128i i1    = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(c1.simd, zero), one), scale));
+        const __m128i i2    = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(c2.simd, zero), one), scale));
+        const __m128i i3    = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(c3.simd, zero), one), scale));
+        const __m128i i01   = _mm_packs_epi32(i0, i1);
+        const __m128i i23   = _mm_packs_epi32(i2, i3);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), _mm_packus_epi16(i01, i23));
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.f);
+        const float32x4_t one  = vdupq_n_f32(1.f);
+        const uint32x4_t  i0   = vcvtq_u32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(c0.simd, zero), one), 255.f));
+        const uint32x4_t  i1   = vcvtq_u32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(c1.simd, zero), one), 255.f));
+        const uint32x4_t  i2   = vcvtq_u32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(c2.simd, zero), one), 255.f));
+        const uint32x4_t  i3   = vcvtq_u32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(c3.simd, zero), one), 255.f));
+        const uint16x8_t  i01  = vcombine_u16(vmovn_u32(i0), vmovn_u32(i1));
+        const uint16x8_t  i23  = vcombine_u16(vmovn_u32(i2), vmovn_u32(i3));
+
+        vst1q_u8(pOut, vcombine_u8(vmovn_u16(i01), vmovn_u16(i23)));
+
+    #else
+        _sl_blit_store_rgba8(c0, pOut);
+        _sl_blit_store_rgba8(c1, pOut + 4);
+        _sl_blit_store_rgba8(c2, pOut + 8);
+        _sl_blit_store_rgba8(c3, pOut + 12);
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Row conversion
+ *
+ * Each row of a tile is converted at once so the most common blits can
+ * convert several texels per instruction.
+-------------------------------------*/
+template<class BlitOp>
+struct SL_BlitRow
+{
+    inline LS_INLINE void operator()(
+        const SL_TextureView* pTexture,
+        const uint_fast32_t* pSrcX,
+        const uint_fast32_t srcY,
+        const uint_fast32_t count,
+        unsigned char* const pOutBuf,
+        uint_fast32_t outIndex) const noexcept
+    {
+        constexpr BlitOp blitOp;
+
+        for (uint_fast32_t i = 0; i < count; ++i)
+        {
+            blitOp(pTexture, pSrcX[i], srcY, pOutBuf, outIndex);
+            outIndex += BlitOp::stride;
+        }
+    }
+};
+
+
+
+template<>
+struct SL_BlitRow<SL_Blit_RGBA_to_RGBA<float, uint8_t>>
+{
+    inline LS_INLINE void operator()(
+        const SL_TextureView* pTexture,
+        const uint_fast32_t* pSrcX,
+        const uint_fast32_t srcY,
+        const uint_fast32_t count,
+        unsigned char* const pOutBuf,
+        uint_fast32_t outIndex) const noexcept
+    {
+        const float* const pRow = reinterpret_cast<const float*>(pTexture->pTexels) + (uint_fast32_t)pTexture->width * srcY * 4u;
+        uint_fast32_t i = 0;
+
+        for (; i + 4u <= count; i += 4u)
+        {
+            _sl_blit_store_rgba8x4(
+                _sl_blit_load_rgbaf(pRow + pSrcX[i+0] * 4u),
+                _sl_blit_load_rgbaf(pRow + pSrcX[i+1] * 4u),
+                _sl_blit_load_rgbaf(pRow + pSrcX[i+2] * 4u),
+                _sl_blit_load_rgbaf(pRow + pSrcX[i+3] * 4u),
+                pOutBuf + outIndex);
+            outIndex += 4u * sizeof(SL_ColorRGBAType<uint8_t>);
+        }
+
+        for (; i < count; ++i)
+        {
+            _sl_blit_store_rgba8(_sl_blit_load_rgbaf(pRow + pSrcX[i] * 4u), pOutBuf + outIndex);
+            outIndex += sizeof(SL_ColorRGBAType<uint8_t>);
+        }
+    }
+};
+
+
+
+template<>
+struct SL_BlitRow<SL_Blit_RGBA_to_RGBA<math::half, uint8_t>>
+{
+    inline LS_INLINE void operator()(
+        const SL_TextureView* pTexture,
+        const uint_fast32_t* pSrcX,
+        const uint_fast32_t srcY,
+        const uint_fast32_t count,
+        unsigned char* const pOutBuf,
+        uint_fast32_t outIndex) const noexcept
+    {
+        const math::half* const pRow = reinterpret_cast<const math::half*>(pTexture->pTexels) + (uint_fast32_t)pTexture->width * srcY * 4u;
+        uint_fast32_t i = 0;
+
+        for (; i + 4u <= count; i += 4u)
+        {
+            _sl_blit_store_rgba8x4(
+                _sl_blit_load_rgbah(pRow + pSrcX[i+0] * 4u),
+                _sl_blit_load_rgbah(pRow + pSrcX[i+1] * 4u),
+                _sl_blit_load_rgbah(pRow + pSrcX[i+2] * 4u),
+                _sl_blit_load_rgbah(pRow + pSrcX[i+3] * 4u),
+                pOutBuf + outIndex);
+            outIndex += 4u * sizeof(SL_ColorRGBAType<uint8_t>);
+        }
+
+        for (; i < count; ++i)
+        {
+            _sl_blit_store_rgba8(_sl_blit_load_rgbah(pRow + pSrcX[i] * 4u), pOutBuf + outIndex);
+            outIndex += sizeof(SL_ColorRGBAType<uint8_t>);
+        }
+    }
+};
+
+
+
+/*-------------------------------------
+ * Load a texel as normalized, floating-point RGBA
+-------------------------------------*/
+template<typename inColor_type, unsigned inChannels>
+inline LS_INLINE math::vec4 _sl_blit_load_texel(const SL_TextureView* pTexture, uint_fast32_t x, uint_fast32_t y) noexcept
+{
+    const inColor_type* const pTexel = reinterpret_cast<const inColor_type*>(pTexture->pTexels) + (x + (uint_fast32_t)pTexture->width * y) * inChannels;
+
+    SL_ColorRGBAType<inColor_type> c{
+        SL_ColorLimits<inColor_type, SL_ColorRType>::min().r,
+        SL_ColorLimits<inColor_type, SL_ColorRType>::min().r,
+        SL_ColorLimits<inColor_type, SL_ColorRType>::min().r,
+        SL_ColorLimits<inColor_type, SL_ColorRGBAType>::max()[3]
+    };
+
+    for (unsigned i = 0; i < inChannels; ++i)
+    {
+        c[i] = pTexel[i];
+    }
+
+    return (math::vec4)color_cast<float, inColor_type>(c);
+}
+
+
+
+/*-------------------------------------
+ * Place channels where nearest-neighbor blits would put them when expanding
+ * R or RG colors.
+-------------------------------------*/
+template<unsigned inChannels>
+inline LS_INLINE math::vec4 _sl_blit_swizzle(const math::vec4& c, unsigned outChannels) noexcept
+{
+    return (inChannels == 1u && outChannels >= 3u)
+        ? math::vec4{0.f, 0.f, c[0], 1.f}
+        : (inChannels == 2u && outChannels == 4u)
+        ? math::vec4{0.f, c[0], c[1], 1.f}
+        : c;
+}
+
+
+
+/*-------------------------------------
+ * Convert & store a row of filtered colors
+-------------------------------------*/
+typedef void (*SL_BlitStoreRowFunc)(const math::vec4*, uint_fast32_t, unsigned char*);
+
+template<typename outColor_type, unsigned outChannels>
+void _sl_blit_store_row(const math::vec4* pColors, uint_fast32_t count, unsigned char* pOut) noexcept
+{
+    outColor_type* pTexels = reinterpret_cast<outColor_type*>(pOut);
+
+    for (uint_fast32_t i = 0; i < count; ++i)
+    {
+        // Integral formats cannot represent values outside of [0, 1]
+        const SL_ColorRGBAType<float> rgba = ls::setup::IsIntegral<outColor_type>::value
+            ? math::clamp(pColors[i], math::vec4{0.f}, math::vec4{1.f})
+            : pColors[i];
+        const SL_ColorRGBAType<outColor_type>&& c = color_cast<outColor_type, float>(rgba);
+
+        for (unsigned j = 0; j < outChannels; ++j)
+        {
+            pTexels[j] = c[j];
+        }
+
+        pTexels += outChannels;
+    }
+}
+
+
+
+template<>
+void _sl_blit_store_row<uint8_t, 4>(const math::vec4* pColors, uint_fast32_t count, unsigned char* pOut) noexcept
+{
+    uint_fast32_t i = 0;
+
+    for (; i + 4u <= count; i += 4u)
+    {
+        _sl_blit_store_rgba8x4(pColors[i], pColors[i+1], pColors[i+2], pColors[i+3], pOut);
+        pOut += 4u * sizeof(SL_ColorRGBAType<uint8_t>);
+    }
+
+    for (; i < count; ++i)
+    {
+        _sl_blit_store_rgba8(pColors[i], pOut);
+        pOut += sizeof(SL_ColorRGBAType<uint8_t>);
+    }
+}
+
+
+
+template<typename outColor_type>
+inline SL_BlitStoreRowFunc _sl_blit_store_row_func(unsigned numChannels) noexcept
+{
+    return (numChannels == 1u) ? &_sl_blit_store_row<outColor_type, 1>
+        : (numChannels == 2u) ? &_sl_blit_store_row<outColor_type, 2>
+        : (numChannels == 3u) ? &_sl_blit_store_row<outColor_type, 3>
+        : &_sl_blit_store_row<outColor_type, 4>;
+}
+
+
+
+inline SL_BlitStoreRowFunc _sl_blit_store_row_func(const SL_TextureView* pTexture) noexcept
+{
+    switch (pTexture->type)
+    {
+        case SL_COLOR_R_8U:
+        case SL_COLOR_RG_8U:
+        case SL_COLOR_RGB_8U:
+        case SL_COLOR_RGBA_8U:      return _sl_blit_store_row_func<uint8_t>(pTexture->numChannels);
+
+        case SL_COLOR_R_16U:
+        case SL_COLOR_RG_16U:
+        case SL_COLOR_RGB_16U:
+        case SL_COLOR_RGBA_16U:     return _sl_blit_store_row_func<uint16_t>(pTexture->numChannels);
+
+        case SL_COLOR_R_32U:
+        case SL_COLOR_RG_32U:
+        case SL_COLOR_RGB_32U:
+        case SL_COLOR_RGBA_32U:     return _sl_blit_store_row_func<uint32_t>(pTexture->numChannels);
+
+        case SL_COLOR_R_64U:
+        case SL_COLOR_RG_64U:
+        case SL_COLOR_RGB_64U:
+        case SL_COLOR_RGBA_64U:     return _sl_blit_store_row_func<uint64_t>(pTexture->numChannels);
+
+        case SL_COLOR_R_HALF:
+        case SL_COLOR_RG_HALF:
+        case SL_COLOR_RGB_HALF:
+        case SL_COLOR_RGBA_HALF:    return _sl_blit_store_row_func<math::half>(pTexture->numChannels);
+
+        case SL_COLOR_R_FLOAT:
+        case SL_COLOR_RG_FLOAT:
+        case SL_COLOR_RGB_FLOAT:
+        case SL_COLOR_RGBA_FLOAT:   return _sl_blit_store_row_func<float>(pTexture->numChannels);
+
+        case SL_COLOR_R_DOUBLE:
+        case SL_COLOR_RG_DOUBLE:
+        case SL_COLOR_RGB_DOUBLE:
+        case SL_COLOR_RGBA_DOUBLE:  return _sl_blit_store_row_func<double>(pTexture->numChannels);
+
+        default:
+            break;
+    }
+
+    LS_ASSERT(false);
+    LS_UNREACHABLE();
+}
+
+
+
 /*-----------------------------------------------------------------------------
  * SL_BlitProcessor functions and namespaces
 -----------------------------------------------------------------------------*/
@@ -615,53 +968,187 @@ void SL_BlitProcessor::blit_src_rgba() noexcept
 
 
 /*-------------------------------------
- * Nearest-neighbor filtering (RGBA)
+ * Retrieve the destination rectangle of a tile
+-------------------------------------*/
+bool SL_BlitProcessor::tile_bounds(
+    uint_fast32_t tileId,
+    uint_fast32_t& outX0,
+    uint_fast32_t& outY0,
+    uint_fast32_t& outX1,
+    uint_fast32_t& outY1) const noexcept
+{
+    const uint_fast32_t rectX1 = math::min<uint_fast32_t>(mDstTex->width, dstX1);
+    const uint_fast32_t rectY1 = math::min<uint_fast32_t>(mDstTex->height, dstY1);
+
+    if (LS_UNLIKELY(dstX0 >= rectX1 || dstY0 >= rectY1))
+    {
+        return false;
+    }
+
+    const uint_fast32_t tilesX = (rectX1 - dstX0 + TILE_SIZE - 1u) >> TILE_SHIFT;
+    const uint_fast32_t tilesY = (rectY1 - dstY0 + TILE_SIZE - 1u) >> TILE_SHIFT;
+
+    if (tileId >= tilesX * tilesY)
+    {
+        return false;
+    }
+
+    outX0 = dstX0 + ((tileId % tilesX) << TILE_SHIFT);
+    outY0 = dstY0 + ((tileId / tilesX) << TILE_SHIFT);
+    outX1 = math::min<uint_fast32_t>(outX0 + TILE_SIZE, rectX1);
+    outY1 = math::min<uint_fast32_t>(outY0 + TILE_SIZE, rectY1);
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Nearest-neighbor filtering
 -------------------------------------*/
 template<class BlipOp>
 void SL_BlitProcessor::blit_nearest() noexcept
 {
-    constexpr BlipOp blitOp;
+    constexpr SL_BlitRow<BlipOp> blitRow;
     unsigned char* const pOutBuf = reinterpret_cast<unsigned char* const>(mDstTex->pTexels);
 
     const uint_fast32_t inW  = (uint_fast32_t)srcX1 - (uint_fast32_t)srcX0;
     const uint_fast32_t inH  = (uint_fast32_t)srcY1 - (uint_fast32_t)srcY0;
-    const uint_fast32_t outW = (uint_fast32_t)dstX1 - (uint_fast32_t)dstX0;
 
     const uint_fast32_t totalOutW = mDstTex->width;
     const uint_fast32_t totalOutH = mDstTex->height;
 
-    // Only tile data along the y-axis of the render buffer. This will help to
-    // make use of the CPU prefetcher when iterating pixels along the x-axis
-    const uint_fast32_t x0    = ls::math::max<uint_fast32_t>(0u, dstX0);
-    const uint_fast32_t x1    = ls::math::min<uint_fast32_t>(totalOutW, x0 + outW);
-    const uint_fast32_t y0    = dstY0+mThreadId;
-    const uint_fast32_t y1    = dstY1;
     const uint_fast32_t finW  = (inW << NUM_FIXED_BITS);
     const uint_fast32_t finH  = (inH << NUM_FIXED_BITS);
     const uint_fast32_t foutW = (finW / totalOutW) + 1u; // account for rounding errors
     const uint_fast32_t foutH = (finH / totalOutH) + 1u;
 
-    uint_fast32_t y = y0;
+    uint_fast32_t srcXs[TILE_SIZE];
+    uint_fast32_t x0, y0, x1, y1;
 
-    while (LS_LIKELY(y < y1))
+    for (uint_fast32_t tileId = mThreadId; tile_bounds(tileId, x0, y0, x1, y1); tileId += mNumThreads)
     {
-        const uint_fast32_t yf       = (y * foutH) >> NUM_FIXED_BITS;
-        const uint_fast32_t srcY     = srcY1 - (srcY0 + yf) - 1u;
-        uint_fast32_t       outIndex = (x0 + totalOutW * y) * BlipOp::stride;
-
-        uint_fast32_t x = x0;
+        // Every row of a tile reads from the same source columns
+        for (uint_fast32_t x = x0; x < x1; ++x)
+        {
+            srcXs[x-x0] = (x * foutW) >> NUM_FIXED_BITS;
+        }
 
-        while (LS_LIKELY(x < x1))
+        for (uint_fast32_t y = y0; y < y1; ++y)
         {
-            const uint_fast32_t xf   = x * foutW;
-            const uint_fast32_t srcX = xf >> NUM_FIXED_BITS;
+            const uint_fast32_t yf   = (y * foutH) >> NUM_FIXED_BITS;
+            const uint_fast32_t srcY = srcY1 - (srcY0 + yf) - 1u;
 
-            blitOp(mSrcTex, srcX, srcY, pOutBuf, outIndex);
-            ++x;
-            outIndex += BlipOp::stride;
+            blitRow(mSrcTex, srcXs, srcY, x1-x0, pOutBuf, (x0 + totalOutW * y) * BlipOp::stride);
         }
+    }
+}
+
+
 
-        y += mNumThreads;
+/*-------------------------------------
+ * Bilinear & box filtering
+-------------------------------------*/
+template<typename inColor_type, unsigned inChannels>
+void SL_BlitProcessor::blit_filtered() noexcept
+{
+    const SL_BlitStoreRowFunc storeRow = _sl_blit_store_row_func(mDstTex);
+    unsigned char* const pOutBuf = reinterpret_cast<unsigned char* const>(mDstTex->pTexels);
+
+    const uint_fast32_t inW         = (uint_fast32_t)srcX1 - (uint_fast32_t)srcX0;
+    const uint_fast32_t inH         = (uint_fast32_t)srcY1 - (uint_fast32_t)srcY0;
+    const uint_fast32_t outW        = (uint_fast32_t)dstX1 - (uint_fast32_t)dstX0;
+    const uint_fast32_t outH        = (uint_fast32_t)dstY1 - (uint_fast32_t)dstY0;
+    const uint_fast32_t totalOutW   = mDstTex->width;
+    const uint_fast32_t outStride   = mDstTex->bytesPerTexel;
+    const unsigned      outChannels = mDstTex->numChannels;
+    const float         scaleX      = (float)inW / (float)outW;
+    const float         scaleY      = (float)inH / (float)outH;
+    const float         maxX        = (float)(srcX1 - 1u);
+    const float         maxY        = (float)(srcY1 - 1u);
+    const bool          boxFilter   = mFilter == SL_BLIT_FILTER_BOX;
+
+    // Column parameters are shared by every row of a tile. Bilinear filtering
+    // uses the first two arrays as neighboring columns while box filtering
+    // uses them as a range of columns.
+    uint_fast32_t colA[TILE_SIZE];
+    uint_fast32_t colB[TILE_SIZE];
+    float         colWeight[TILE_SIZE];
+    math::vec4    colors[TILE_SIZE];
+    uint_fast32_t x0, y0, x1, y1;
+
+    for (uint_fast32_t tileId = mThreadId; tile_bounds(tileId, x0, y0, x1, y1); tileId += mNumThreads)
+    {
+        for (uint_fast32_t x = x0; x < x1; ++x)
+        {
+            const uint_fast32_t dx = x - dstX0;
+
+            if (boxFilter)
+            {
+                colA[x-x0] = srcX0 + (uint_fast32_t)(((uint64_t)dx * inW) / outW);
+                colB[x-x0] = srcX0 + (uint_fast32_t)(((uint64_t)(dx+1u) * inW + outW - 1u) / outW);
+            }
+            else
+            {
+                const float u = math::clamp((float)srcX0 + ((float)dx + 0.5f) * scaleX - 0.5f, (float)srcX0, maxX);
+                colA[x-x0]      = (uint_fast32_t)u;
+                colB[x-x0]      = math::min<uint_fast32_t>(colA[x-x0] + 1u, srcX1 - 1u);
+                colWeight[x-x0] = u - (float)colA[x-x0];
+            }
+        }
+
+        for (uint_fast32_t y = y0; y < y1; ++y)
+        {
+            // Source rows are flipped vertically, matching nearest-neighbor
+            // blits.
+            const uint_fast32_t dy = y - dstY0;
+
+            if (boxFilter)
+            {
+                const uint_fast32_t rowEnd   = srcY1 - (uint_fast32_t)(((uint64_t)dy * inH) / outH);
+                const uint_fast32_t rowBegin = srcY1 - (uint_fast32_t)(((uint64_t)(dy+1u) * inH + outH - 1u) / outH);
+
+                for (uint_fast32_t x = x0; x < x1; ++x)
+                {
+                    const uint_fast32_t colBegin = colA[x-x0];
+                    const uint_fast32_t colEnd   = colB[x-x0];
+                    math::vec4 sum{0.f};
+
+                    for (uint_fast32_t row = rowBegin; row < rowEnd; ++row)
+                    {
+                        for (uint_fast32_t col = colBegin; col < colEnd; ++col)
+                        {
+                            sum += _sl_blit_load_texel<inColor_type, inChannels>(mSrcTex, col, row);
+                        }
+                    }
+
+                    const float count = (float)((rowEnd-rowBegin) * (colEnd-colBegin));
+                    colors[x-x0] = _sl_blit_swizzle<inChannels>(sum * (1.f / count), outChannels);
+                }
+            }
+            else
+            {
+                const float         v    = math::clamp((float)srcY1 - 0.5f - ((float)dy + 0.5f) * scaleY, (float)srcY0, maxY);
+                const uint_fast32_t row0 = (uint_fast32_t)v;
+                const uint_fast32_t row1 = math::min<uint_fast32_t>(row0 + 1u, srcY1 - 1u);
+                const float         fy   = v - (float)row0;
+
+                for (uint_fast32_t x = x0; x < x1; ++x)
+                {
+                    const float      fx  = colWeight[x-x0];
+                    const math::vec4 c00 = _sl_blit_load_texel<inColor_type, inChannels>(mSrcTex, colA[x-x0], row0);
+                    const math::vec4 c10 = _sl_blit_load_texel<inColor_type, inChannels>(mSrcTex, colB[x-x0], row0);
+                    const math::vec4 c01 = _sl_blit_load_texel<inColor_type, inChannels>(mSrcTex, colA[x-x0], row1);
+                    const math::vec4 c11 = _sl_blit_load_texel<inColor_type, inChannels>(mSrcTex, colB[x-x0], row1);
+                    const math::vec4 c0  = c00 + (c10 - c00) * fx;
+                    const math::vec4 c1  = c01 + (c11 - c01) * fx;
+
+                    colors[x-x0] = _sl_blit_swizzle<inChannels>(c0 + (c1 - c0) * fy, outChannels);
+                }
+            }
+
+            storeRow(colors, x1-x0, pOutBuf + (x0 + totalOutW * y) * outStride);
+        }
     }
 }
 
@@ -674,6 +1161,50 @@ void SL_BlitProcessor::execute() noexcept
 {
     LS_ASSERT(!sl_is_compressed_color(mSrcTex->type) && !sl_is_compressed_color(mDstTex->type));
 
+    if (mFilter != SL_BLIT_FILTER_NEAREST)
+    {
+        switch (mSrcTex->type)
+        {
+            case SL_COLOR_R_8U:        blit_filtered<uint8_t, 1>();     break;
+            case SL_COLOR_R_16U:       blit_filtered<uint16_t, 1>();    break;
+            case SL_COLOR_R_32U:       blit_filtered<uint32_t, 1>();    break;
+            case SL_COLOR_R_64U:       blit_filtered<uint64_t, 1>();    break;
+            case SL_COLOR_R_HALF:      blit_filtered<ls::math::half, 1>(); break;
+            case SL_COLOR_R_FLOAT:     blit_filtered<float, 1>();       break;
+            case SL_COLOR_R_DOUBLE:    blit_filtered<double, 1>();      break;
+
+            case SL_COLOR_RG_8U:       blit_filtered<uint8_t, 2>();     break;
+            case SL_COLOR_RG_16U:      blit_filtered<uint16_t, 2>();    break;
+            case SL_COLOR_RG_32U:      blit_filtered<uint32_t, 2>();    break;
+            case SL_COLOR_RG_64U:      blit_filtered<uint64_t, 2>();    break;
+            case SL_COLOR_RG_HALF:     blit_filtered<ls::math::half, 2>(); break;
+            case SL_COLOR_RG_FLOAT:    blit_filtered<float, 2>();       break;
+            case SL_COLOR_RG_DOUBLE:   blit_filtered<double, 2>();      break;
+
+            case SL_COLOR_RGB_8U:      blit_filtered<uint8_t, 3>();     break;
+            case SL_COLOR_RGB_16U:     blit_filtered<uint16_t, 3>();    break;
+            case SL_COLOR_RGB_32U:     blit_filtered<uint32_t, 3>();    break;
+            case SL_COLOR_RGB_64U:     blit_filtered<uint64_t, 3>();    break;
+            case SL_COLOR_RGB_HALF:    blit_filtered<ls::math::half, 3>(); break;
+            case SL_COLOR_RGB_FLOAT:   blit_filtered<float, 3>();       break;
+            case SL_COLOR_RGB_DOUBLE:  blit_filtered<double, 3>();      break;
+
+            case SL_COLOR_RGBA_8U:     blit_filtered<uint8_t, 4>();     break;
+            case SL_COLOR_RGBA_16U:    blit_filtered<uint16_t, 4>();    break;
+            case SL_COLOR_RGBA_32U:    blit_filtered<uint32_t, 4>();    break;
+            case SL_COLOR_RGBA_64U:    blit_filtered<uint64_t, 4>();    break;
+            case SL_COLOR_RGBA_HALF:   blit_filtered<ls::math::half, 4>(); break;
+            case SL_COLOR_RGBA_FLOAT:  blit_filtered<float, 4>();       break;
+            case SL_COLOR_RGBA_DOUBLE: blit_filtered<double, 4>();      break;
+
+            default:
+                LS_ASSERT(false);
+                LS_UNREACHABLE();
+        }
+
+        return;
+    }
+
     switch (mSrcTex->type)
     {
         case SL_COLOR_R_8U:       blit_src_r<uint8_t>();     break;
@@ -0,0 +1,253 @@
+
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "lightsky/math/scalar_utils.h"
+
+#include "softlight/SL_BlockCompressProcessor.hpp"
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_ColorBlock.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Index a texel of the uncompressed texture
+-------------------------------------*/
+template <SL_TexelOrder order>
+inline LS_INLINE ptrdiff_t _sl_block_texel_index(const SL_TextureView& tex, uint_fast32_t x, uint_fast32_t y, uint_fast32_t z) noexcept
+{
+    return (tex.depth > 1) ? sl_texel_index<order>(tex, x, y, z) : sl_texel_index<order>(tex, x, y);
+}
+
+
+
+/*-------------------------------------
+ * Expand an 8-bit source texel to RGBA. Missing channels are zeroed and
+ * missing alpha is opaque.
+-------------------------------------*/
+inline LS_INLINE SL_ColorRGBA8 _sl_expand_block_input(const SL_ColorR8& c) noexcept
+{
+    return SL_ColorRGBA8{c.r, (uint8_t)0, (uint8_t)0, (uint8_t)255};
+}
+
+inline LS_INLINE SL_ColorRGBA8 _sl_expand_block_input(const SL_ColorRG8& c) noexcept
+{
+    return SL_ColorRGBA8{c.v[0], c.v[1], (uint8_t)0, (uint8_t)255};
+}
+
+inline LS_INLINE SL_ColorRGBA8 _sl_expand_block_input(const SL_ColorRGB8& c) noexcept
+{
+    return SL_ColorRGBA8{c.v[0], c.v[1], c.v[2], (uint8_t)255};
+}
+
+inline LS_INLINE SL_ColorRGBA8 _sl_expand_block_input(const SL_ColorRGBA8& c) noexcept
+{
+    return c;
+}
+
+
+
+/*-------------------------------------
+ * Reduce an RGBA texel to the channels stored by a block
+-------------------------------------*/
+template <typename color_type>
+inline color_type _sl_reduce_block_input(const SL_ColorRGBA8& c) noexcept;
+
+template <>
+inline LS_INLINE SL_ColorR8 _sl_reduce_block_input<SL_ColorR8>(const SL_ColorRGBA8& c) noexcept
+{
+    return SL_ColorR8{c.v[0]};
+}
+
+template <>
+inline LS_INLINE SL_ColorRG8 _sl_reduce_block_input<SL_ColorRG8>(const SL_ColorRGBA8& c) noexcept
+{
+    return SL_ColorRG8{c.v[0], c.v[1]};
+}
+
+template <>
+inline LS_INLINE SL_ColorRGBA8 _sl_reduce_block_input<SL_ColorRGBA8>(const SL_ColorRGBA8& c) noexcept
+{
+    return c;
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_BlockCompressProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Compress each 4x4 group of texels
+-------------------------------------*/
+template <typename color_type, typename block_type, SL_TexelOrder order>
+void SL_BlockCompressProcessor::encode_blocks() noexcept
+{
+    typedef typename block_type::color_type block_color;
+
+    const SL_TextureView&   src     = *mSrcTex;
+    const SL_TextureView&   dst     = *mDstTex;
+    const color_type* const pSrc    = reinterpret_cast<const color_type*>(src.pTexels);
+    block_type* const       pDst    = reinterpret_cast<block_type*>(dst.pTexels);
+    const uint_fast32_t     maxX    = (uint_fast32_t)src.width - 1u;
+    const uint_fast32_t     maxY    = (uint_fast32_t)src.height - 1u;
+    const uint_fast32_t     blocksX = ((uint_fast32_t)src.width + 3u) >> 2u;
+    const uint_fast32_t     blocksY = ((uint_fast32_t)src.height + 3u) >> 2u;
+    const uint_fast32_t     numRows = blocksY * (uint_fast32_t)src.depth;
+
+    block_color texels[16];
+
+    for (uint_fast32_t row = mThreadId; row < numRows; row += mNumThreads)
+    {
+        const uint_fast32_t z  = row / blocksY;
+        const uint_fast32_t y0 = (row % blocksY) << 2u;
+
+        for (uint_fast32_t bx = 0; bx < blocksX; ++bx)
+        {
+            const uint_fast32_t x0 = bx << 2u;
+
+            for (uint_fast32_t i = 0; i < 16; ++i)
+            {
+                const uint_fast32_t x = ls::math::min<uint_fast32_t>(x0 + (i & 3u), maxX);
+                const uint_fast32_t y = ls::math::min<uint_fast32_t>(y0 + (i >> 2u), maxY);
+                texels[i] = _sl_reduce_block_input<block_color>(_sl_expand_block_input(pSrc[_sl_block_texel_index<order>(src, x, y, z)]));
+            }
+
+            sl_encode_block(texels, pDst[sl_block_index(dst, x0, y0, z)]);
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Decompress each 4x4 block of texels
+-------------------------------------*/
+template <typename block_type, SL_TexelOrder order>
+void SL_BlockCompressProcessor::decode_blocks() noexcept
+{
+    typedef typename block_type::color_type color_type;
+
+    const SL_TextureView&   src     = *mSrcTex;
+    const SL_TextureView&   dst     = *mDstTex;
+    const block_type* const pSrc    = reinterpret_cast<const block_type*>(src.pTexels);
+    color_type* const       pDst    = reinterpret_cast<color_type*>(dst.pTexels);
+    const uint_fast32_t     width   = (uint_fast32_t)dst.width;
+    const uint_fast32_t     height  = (uint_fast32_t)dst.height;
+    const uint_fast32_t     blocksX = (width + 3u) >> 2u;
+    const uint_fast32_t     blocksY = (height + 3u) >> 2u;
+    const uint_fast32_t     numRows = blocksY * (uint_fast32_t)dst.depth;
+
+    color_type texels[16];
+
+    for (uint_fast32_t row = mThreadId; row < numRows; row += mNumThreads)
+    {
+        const uint_fast32_t z  = row / blocksY;
+        const uint_fast32_t y0 = (row % blocksY) << 2u;
+        const uint_fast32_t h  = ls::math::min<uint_fast32_t>(4u, height - y0);
+
+        for (uint_fast32_t bx = 0; bx < blocksX; ++bx)
+        {
+            const uint_fast32_t x0 = bx << 2u;
+            const uint_fast32_t w  = ls::math::min<uint_fast32_t>(4u, width - x0);
+
+            sl_decode_block(pSrc[sl_block_index(src, x0, y0, z)], texels);
+
+            for (uint_fast32_t y = 0; y < h; ++y)
+            {
+                for (uint_fast32_t x = 0; x < w; ++x)
+                {
+                    pDst[_sl_block_texel_index<order>(dst, x0 + x, y0 + y, z)] = texels[x + 4u * y];
+                }
+            }
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Source format & texel order dispatch
+-------------------------------------*/
+template <typename block_type>
+void SL_BlockCompressProcessor::encode() noexcept
+{
+    if (mTexelOrder == SL_TexelOrder::SWIZZLED)
+    {
+        switch (mSrcTex->type)
+        {
+            case SL_COLOR_R_8U:    encode_blocks<SL_ColorR8,    block_type, SL_TexelOrder::SWIZZLED>(); break;
+            case SL_COLOR_RG_8U:   encode_blocks<SL_ColorRG8,   block_type, SL_TexelOrder::SWIZZLED>(); break;
+            case SL_COLOR_RGB_8U:  encode_blocks<SL_ColorRGB8,  block_type, SL_TexelOrder::SWIZZLED>(); break;
+            case SL_COLOR_RGBA_8U: encode_blocks<SL_ColorRGBA8, block_type, SL_TexelOrder::SWIZZLED>(); break;
+
+            default:
+                // other formats are rejected by SL_Context::compress_texture()
+                break;
+        }
+    }
+    else
+    {
+        switch (mSrcTex->type)
+        {
+            case SL_COLOR_R_8U:    encode_blocks<SL_ColorR8,    block_type, SL_TexelOrder::ORDERED>(); break;
+            case SL_COLOR_RG_8U:   encode_blocks<SL_ColorRG8,   block_type, SL_TexelOrder::ORDERED>(); break;
+            case SL_COLOR_RGB_8U:  encode_blocks<SL_ColorRGB8,  block_type, SL_TexelOrder::ORDERED>(); break;
+            case SL_COLOR_RGBA_8U: encode_blocks<SL_ColorRGBA8, block_type, SL_TexelOrder::ORDERED>(); break;
+
+            default:
+                break;
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Texel order dispatch
+-------------------------------------*/
+template <typename block_type>
+void SL_BlockCompressProcessor::decode() noexcept
+{
+    if (mTexelOrder == SL_TexelOrder::SWIZZLED)
+    {
+        decode_blocks<block_type, SL_TexelOrder::SWIZZLED>();
+    }
+    else
+    {
+        decode_blocks<block_type, SL_TexelOrder::ORDERED>();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Run the block compressor
+-------------------------------------*/
+void SL_BlockCompressProcessor::execute() noexcept
+{
+    const SL_ColorDataType blockType = mDecompress ? mSrcTex->type : mDstTex->type;
+
+    switch (blockType)
+    {
+        case SL_COLOR_BC1: mDecompress ? decode<SL_BlockBC1>() : encode<SL_BlockBC1>(); break;
+        case SL_COLOR_BC3: mDecompress ? decode<SL_BlockBC3>() : encode<SL_BlockBC3>(); break;
+        case SL_COLOR_BC4: mDecompress ? decode<SL_BlockBC4>() : encode<SL_BlockBC4>(); break;
+        case SL_COLOR_BC5: mDecompress ? decode<SL_BlockBC5>() : encode<SL_BlockBC5>(); break;
+
+        default:
+            // non-block formats are rejected by the context
+            break;
+    }
+}
@@ -2,6 +2,8 @@
 #include "lightsky/utils/Copy.h"
 
 #include "softlight/SL_ClearProcesor.hpp"
+#include "softlight/SL_FastClear.hpp"
+#include "softlight/SL_HiZBuffer.hpp"
 #include "softlight/SL_ShaderUtil.hpp"
 #include "softlight/SL_Texture.hpp"
 
@@ -25,7 +27,8 @@ void SL_ClearProcessor::clear_texture(const color_type& inColor) noexcept
 {
     size_t w = (size_t)mBackBuffer->width;
     size_t h = (size_t)mBackBuffer->height;
-    size_t numBytes = w * h;
+    size_t d = (size_t)mBackBuffer->depth; // samples of multisampled attachments
+    size_t numBytes = w * h * d;
     size_t begin;
     size_t end;
 
@@ -109,6 +112,12 @@ template void SL_ClearProcessor::clear_texture<SL_ColorRGB1010102>(const SL_Colo
 -------------------------------------*/
 void SL_ClearProcessor::execute() noexcept
 {
+    if (mFastClear)
+    {
+        mFastClear->resolve(mBackBuffer, mDepthBuffer, mNumThreads, mThreadId);
+        return;
+    }
+
     switch (mBackBuffer->type)
     {
         case SL_COLOR_R_8U:       clear_texture<SL_ColorRType<uint8_t>>(*reinterpret_cast<const SL_ColorRType<uint8_t>*>(mTexture));     break;
@@ -149,4 +158,16 @@ void SL_ClearProcessor::execute() noexcept
         case SL_COLOR_RGBA_4444:    clear_texture<SL_ColorRGB4444>(*reinterpret_cast<const SL_ColorRGB4444*>(mTexture)); break;
         case SL_COLOR_RGBA_1010102: clear_texture<SL_ColorRGB1010102>(*reinterpret_cast<const SL_ColorRGB1010102*>(mTexture)); break;
     }
+
+    // Depth clears reset this thread's partition of the depth hierarchy
+    if (mDepthHiZ)
+    {
+        switch (mBackBuffer->type)
+        {
+            case SL_COLOR_R_HALF:   mDepthHiZ->clear((float)*reinterpret_cast<const ls::math::half*>(mTexture), mNumThreads, mThreadId); break;
+            case SL_COLOR_R_FLOAT:  mDepthHiZ->clear(*reinterpret_cast<const float*>(mTexture), mNumThreads, mThreadId); break;
+            case SL_COLOR_R_DOUBLE: mDepthHiZ->clear((float)*reinterpret_cast<const double*>(mTexture), mNumThreads, mThreadId); break;
+            default: break;
+        }
+    }
 }
@@ -51,6 +51,11 @@ size_t sl_bytes_per_color(SL_ColorDataType p) noexcept
         case SL_COLOR_RGBA_4444:    return sizeof(uint16_t);
         case SL_COLOR_RGBA_1010102: return sizeof(uint32_t);
 
+        case SL_COLOR_BC1:          return 8;
+        case SL_COLOR_BC3:          return 16;
+        case SL_COLOR_BC4:          return 8;
+        case SL_COLOR_BC5:          return 16;
+
         default:
             break;
     }
@@ -105,6 +110,11 @@ unsigned sl_elements_per_color(SL_ColorDataType p) noexcept
         case SL_COLOR_RGBA_4444:    return 4;
         case SL_COLOR_RGBA_1010102: return 4;
 
+        case SL_COLOR_BC1:          return 4;
+        case SL_COLOR_BC3:          return 4;
+        case SL_COLOR_BC4:          return 1;
+        case SL_COLOR_BC5:          return 2;
+
         default:
             break;
     }
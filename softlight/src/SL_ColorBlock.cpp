@@ -0,0 +1,524 @@
+
+#include <cstddef> // ptrdiff_t
+#include <utility> // std::swap()
+
+#include "lightsky/setup/Arch.h"
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "softlight/SL_ColorBlock.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Build the 4-color palette of a BC1 block
+-------------------------------------*/
+inline void _sl_bc1_palette(const SL_BlockBC1& block, bool alwaysOpaque, SL_ColorRGBA8 outPalette[4]) noexcept
+{
+    const SL_ColorRGBA8 c0 = sl_unpack_bc_endpoint(block.color0);
+    const SL_ColorRGBA8 c1 = sl_unpack_bc_endpoint(block.color1);
+
+    outPalette[0] = c0;
+    outPalette[1] = c1;
+
+    if (alwaysOpaque || block.color0 > block.color1)
+    {
+        outPalette[2] = sl_mix_bc_endpoints(c0, c1, 2u, 1u);
+        outPalette[3] = sl_mix_bc_endpoints(c0, c1, 1u, 2u);
+    }
+    else
+    {
+        outPalette[2] = sl_mix_bc_endpoints(c0, c1, 1u, 1u);
+        outPalette[3] = SL_ColorRGBA8{0, 0, 0, 0};
+    }
+}
+
+
+
+/*-------------------------------------
+ * Build the 8-value palette of a BC4 block
+-------------------------------------*/
+inline void _sl_bc4_palette(const SL_BlockBC4& block, uint8_t outPalette[8]) noexcept
+{
+    const unsigned r0 = block.red0;
+    const unsigned r1 = block.red1;
+
+    outPalette[0] = (uint8_t)r0;
+    outPalette[1] = (uint8_t)r1;
+
+    if (r0 > r1)
+    {
+        for (unsigned i = 2; i < 8; ++i)
+        {
+            outPalette[i] = (uint8_t)(((8u - i) * r0 + (i - 1u) * r1) / 7u);
+        }
+    }
+    else
+    {
+        for (unsigned i = 2; i < 6; ++i)
+        {
+            outPalette[i] = (uint8_t)(((6u - i) * r0 + (i - 1u) * r1) / 5u);
+        }
+
+        outPalette[6] = 0;
+        outPalette[7] = 255;
+    }
+}
+
+
+
+/*-------------------------------------
+ * Unpack the 3-bit indices of a BC4 block
+-------------------------------------*/
+inline void _sl_bc4_indices(const SL_BlockBC4& block, uint8_t outIndices[16]) noexcept
+{
+    uint64_t bits = 0;
+    for (unsigned i = 6; i--;)
+    {
+        bits = (bits << 8u) | (uint64_t)block.indices[i];
+    }
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        outIndices[i] = (uint8_t)((bits >> (i * 3u)) & 0x07u);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Decode a BC4 block into 16 bytes
+-------------------------------------*/
+void _sl_decode_bc4(const SL_BlockBC4& block, uint8_t* pOut) noexcept
+{
+    alignas(16) uint8_t palette[16] = {0};
+    alignas(16) uint8_t indices[16];
+
+    _sl_bc4_palette(block, palette);
+    _sl_bc4_indices(block, indices);
+
+    #if defined(LS_X86_SSSE3)
+        const __m128i p = _mm_load_si128(reinterpret_cast<const __m128i*>(palette));
+        const __m128i i = _mm_load_si128(reinterpret_cast<const __m128i*>(indices));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), _mm_shuffle_epi8(p, i));
+
+    #elif defined(LS_ARM_NEON)
+        const uint8x8_t p = vld1_u8(palette);
+        vst1_u8(pOut,     vtbl1_u8(p, vld1_u8(indices)));
+        vst1_u8(pOut + 8, vtbl1_u8(p, vld1_u8(indices + 8)));
+
+    #else
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            pOut[i] = palette[indices[i]];
+        }
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Decode a BC1 block into 16 RGBA texels
+-------------------------------------*/
+void _sl_decode_bc1(const SL_BlockBC1& block, bool alwaysOpaque, SL_ColorRGBA8* pOut) noexcept
+{
+    alignas(16) SL_ColorRGBA8 palette[4];
+    _sl_bc1_palette(block, alwaysOpaque, palette);
+
+    #if defined(LS_X86_SSSE3) || defined(LS_ARM_NEON)
+        // Each texel selects 4 consecutive bytes of the palette
+        alignas(16) uint32_t lookups[16];
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            lookups[i] = ((block.indices >> (i * 2u)) & 0x03u) * 0x04040404u + 0x03020100u;
+        }
+
+        #if defined(LS_X86_SSSE3)
+            const __m128i p = _mm_load_si128(reinterpret_cast<const __m128i*>(palette));
+            for (unsigned i = 0; i < 16; i += 4)
+            {
+                const __m128i lookup = _mm_load_si128(reinterpret_cast<const __m128i*>(lookups + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_shuffle_epi8(p, lookup));
+            }
+        #else
+            const uint8_t* const pPalette = reinterpret_cast<const uint8_t*>(palette);
+            const uint8x8x2_t p{{vld1_u8(pPalette), vld1_u8(pPalette + 8)}};
+            for (unsigned i = 0; i < 16; i += 4)
+            {
+                const uint8_t* const pLookup = reinterpret_cast<const uint8_t*>(lookups + i);
+                uint8_t* const pTexels = reinterpret_cast<uint8_t*>(pOut + i);
+                vst1_u8(pTexels,     vtbl2_u8(p, vld1_u8(pLookup)));
+                vst1_u8(pTexels + 8, vtbl2_u8(p, vld1_u8(pLookup + 8)));
+            }
+        #endif
+
+    #else
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            pOut[i] = palette[(block.indices >> (i * 2u)) & 0x03u];
+        }
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * Pack an 8-bit color into an RGB565 endpoint
+-------------------------------------*/
+inline LS_INLINE uint16_t _sl_pack_bc_endpoint(const int c[3]) noexcept
+{
+    const unsigned r = ((unsigned)c[0] * 31u + 127u) / 255u;
+    const unsigned g = ((unsigned)c[1] * 63u + 127u) / 255u;
+    const unsigned b = ((unsigned)c[2] * 31u + 127u) / 255u;
+
+    return (uint16_t)((r << 11u) | (g << 5u) | b);
+}
+
+
+
+/*-------------------------------------
+ * Squared distance between two RGB colors
+-------------------------------------*/
+inline LS_INLINE int _sl_bc_distance(const SL_ColorRGBA8& a, const SL_ColorRGBA8& b) noexcept
+{
+    const int dr = (int)a.v[0] - (int)b.v[0];
+    const int dg = (int)a.v[1] - (int)b.v[1];
+    const int db = (int)a.v[2] - (int)b.v[2];
+
+    return dr*dr + dg*dg + db*db;
+}
+
+
+
+/*-------------------------------------
+ * Encode a BC1 block
+-------------------------------------*/
+void _sl_encode_bc1(const SL_ColorRGBA8 inTexels[16], bool alwaysOpaque, SL_BlockBC1& outBlock) noexcept
+{
+    int minColor[3] = {255, 255, 255};
+    int maxColor[3] = {0, 0, 0};
+    int sum[3] = {0, 0, 0};
+    int numOpaque = 0;
+    bool hasAlpha = false;
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        if (!alwaysOpaque && inTexels[i].v[3] < 128u)
+        {
+            hasAlpha = true;
+            continue;
+        }
+
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            minColor[c] = (inTexels[i].v[c] < minColor[c]) ? inTexels[i].v[c] : minColor[c];
+            maxColor[c] = (inTexels[i].v[c] > maxColor[c]) ? inTexels[i].v[c] : maxColor[c];
+            sum[c] += inTexels[i].v[c];
+        }
+
+        ++numOpaque;
+    }
+
+    if (!numOpaque)
+    {
+        outBlock.color0 = 0;
+        outBlock.color1 = 0;
+        outBlock.indices = 0xFFFFFFFFu;
+        return;
+    }
+
+    // The bounding box has four diagonals. Pick the one which follows the
+    // correlation of red and blue with green.
+    int covRG = 0;
+    int covBG = 0;
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        if (!alwaysOpaque && inTexels[i].v[3] < 128u)
+        {
+            continue;
+        }
+
+        const int r = (int)inTexels[i].v[0] * numOpaque - sum[0];
+        const int g = (int)inTexels[i].v[1] * numOpaque - sum[1];
+        const int b = (int)inTexels[i].v[2] * numOpaque - sum[2];
+        covRG += (r >> 4) * (g >> 4);
+        covBG += (b >> 4) * (g >> 4);
+    }
+
+    if (covRG < 0)
+    {
+        std::swap(minColor[0], maxColor[0]);
+    }
+
+    if (covBG < 0)
+    {
+        std::swap(minColor[2], maxColor[2]);
+    }
+
+    // Pull the endpoints inward so the interpolated colors land closer to
+    // the texels they represent.
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        const int inset = (maxColor[c] - minColor[c]) / 16;
+        maxColor[c] -= inset;
+        minColor[c] += inset;
+    }
+
+    uint16_t color0 = _sl_pack_bc_endpoint(maxColor);
+    uint16_t color1 = _sl_pack_bc_endpoint(minColor);
+
+    // The endpoint order selects the 3-color or 4-color palette
+    if (hasAlpha ? (color0 > color1) : (color0 < color1))
+    {
+        std::swap(color0, color1);
+    }
+
+    outBlock.color0 = color0;
+    outBlock.color1 = color1;
+    outBlock.indices = 0;
+
+    SL_ColorRGBA8 palette[4];
+    _sl_bc1_palette(outBlock, alwaysOpaque, palette);
+
+    const unsigned numColors = (alwaysOpaque || color0 > color1) ? 4u : 3u;
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        unsigned index = 3u;
+
+        if (alwaysOpaque || inTexels[i].v[3] >= 128u)
+        {
+            int minDist = _sl_bc_distance(inTexels[i], palette[0]);
+            index = 0;
+
+            for (unsigned p = 1; p < numColors; ++p)
+            {
+                const int dist = _sl_bc_distance(inTexels[i], palette[p]);
+                if (dist < minDist)
+                {
+                    minDist = dist;
+                    index = p;
+                }
+            }
+        }
+
+        outBlock.indices |= (uint32_t)index << (i * 2u);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Encode a BC4 block
+-------------------------------------*/
+void _sl_encode_bc4(const uint8_t* pValues, ptrdiff_t stride, SL_BlockBC4& outBlock) noexcept
+{
+    uint8_t minVal = 255;
+    uint8_t maxVal = 0;
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        const uint8_t val = pValues[i * stride];
+        minVal = (val < minVal) ? val : minVal;
+        maxVal = (val > maxVal) ? val : maxVal;
+    }
+
+    // The 8-value palette is always used
+    outBlock.red0 = maxVal;
+    outBlock.red1 = minVal;
+
+    uint64_t bits = 0;
+
+    if (maxVal != minVal)
+    {
+        uint8_t palette[8];
+        _sl_bc4_palette(outBlock, palette);
+
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            const int val = pValues[i * stride];
+            int minDist = 256;
+            unsigned index = 0;
+
+            for (unsigned p = 0; p < 8; ++p)
+            {
+                const int dist = (val > palette[p]) ? (val - palette[p]) : (palette[p] - val);
+                if (dist < minDist)
+                {
+                    minDist = dist;
+                    index = p;
+                }
+            }
+
+            bits |= (uint64_t)index << (i * 3u);
+        }
+    }
+
+    for (unsigned i = 0; i < 6; ++i)
+    {
+        outBlock.indices[i] = (uint8_t)(bits >> (i * 8u));
+    }
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Full-Block Decoding
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * BC1
+-------------------------------------*/
+void sl_decode_block(const SL_BlockBC1& block, SL_ColorRGBA8 outTexels[16]) noexcept
+{
+    _sl_decode_bc1(block, false, outTexels);
+}
+
+
+
+/*-------------------------------------
+ * BC3
+-------------------------------------*/
+void sl_decode_block(const SL_BlockBC3& block, SL_ColorRGBA8 outTexels[16]) noexcept
+{
+    alignas(16) uint8_t alpha[16];
+
+    _sl_decode_bc1(block.color, true, outTexels);
+    _sl_decode_bc4(block.alpha, alpha);
+
+    #if defined(LS_X86_SSSE3)
+        // Move 4 alpha values into the last byte of each texel
+        const __m128i alphaShuffle = _mm_set_epi8(3, -1, -1, -1, 2, -1, -1, -1, 1, -1, -1, -1, 0, -1, -1, -1);
+        const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(alpha));
+
+        for (unsigned i = 0; i < 16; i += 4)
+        {
+            __m128i* const pTexels = reinterpret_cast<__m128i*>(outTexels + i);
+            const __m128i c = _mm_and_si128(_mm_loadu_si128(pTexels), colorMask);
+            _mm_storeu_si128(pTexels, _mm_or_si128(c, _mm_shuffle_epi8(a, alphaShuffle)));
+            a = _mm_srli_si128(a, 4);
+        }
+
+    #elif defined(LS_ARM_NEON)
+        // Indices past the end of the table produce 0
+        const uint8_t alphaShuffle[16] = {128, 128, 128, 0, 128, 128, 128, 1, 128, 128, 128, 2, 128, 128, 128, 3};
+        const uint8x16_t baseLookup = vld1q_u8(alphaShuffle);
+        const uint8x8x2_t a{{vld1_u8(alpha), vld1_u8(alpha + 8)}};
+        const uint32x4_t colorMask = vdupq_n_u32(0x00FFFFFF);
+
+        for (unsigned i = 0; i < 16; i += 4)
+        {
+            const uint8x16_t lookup = vaddq_u8(baseLookup, vdupq_n_u8((uint8_t)i));
+            const uint8x16_t shuffled = vcombine_u8(vtbl2_u8(a, vget_low_u8(lookup)), vtbl2_u8(a, vget_high_u8(lookup)));
+            uint8_t* const pTexels = reinterpret_cast<uint8_t*>(outTexels + i);
+            const uint32x4_t c = vandq_u32(vreinterpretq_u32_u8(vld1q_u8(pTexels)), colorMask);
+            vst1q_u8(pTexels, vorrq_u8(vreinterpretq_u8_u32(c), shuffled));
+        }
+
+    #else
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            outTexels[i].v[3] = alpha[i];
+        }
+    #endif
+}
+
+
+
+/*-------------------------------------
+ * BC4
+-------------------------------------*/
+void sl_decode_block(const SL_BlockBC4& block, SL_ColorR8 outTexels[16]) noexcept
+{
+    _sl_decode_bc4(block, reinterpret_cast<uint8_t*>(outTexels));
+}
+
+
+
+/*-------------------------------------
+ * BC5
+-------------------------------------*/
+void sl_decode_block(const SL_BlockBC5& block, SL_ColorRG8 outTexels[16]) noexcept
+{
+    alignas(16) uint8_t r[16];
+    alignas(16) uint8_t g[16];
+
+    _sl_decode_bc4(block.red, r);
+    _sl_decode_bc4(block.green, g);
+
+    uint8_t* const pOut = reinterpret_cast<uint8_t*>(outTexels);
+
+    #if defined(LS_X86_SSE2)
+        const __m128i r8 = _mm_load_si128(reinterpret_cast<const __m128i*>(r));
+        const __m128i g8 = _mm_load_si128(reinterpret_cast<const __m128i*>(g));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut),      _mm_unpacklo_epi8(r8, g8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + 16), _mm_unpackhi_epi8(r8, g8));
+
+    #elif defined(LS_ARM_NEON)
+        vst2q_u8(pOut, uint8x16x2_t{{vld1q_u8(r), vld1q_u8(g)}});
+
+    #else
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            pOut[i*2+0] = r[i];
+            pOut[i*2+1] = g[i];
+        }
+    #endif
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Full-Block Encoding
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * BC1
+-------------------------------------*/
+void sl_encode_block(const SL_ColorRGBA8 inTexels[16], SL_BlockBC1& outBlock) noexcept
+{
+    _sl_encode_bc1(inTexels, false, outBlock);
+}
+
+
+
+/*-------------------------------------
+ * BC3
+-------------------------------------*/
+void sl_encode_block(const SL_ColorRGBA8 inTexels[16], SL_BlockBC3& outBlock) noexcept
+{
+    _sl_encode_bc4(reinterpret_cast<const uint8_t*>(inTexels) + 3, sizeof(SL_ColorRGBA8), outBlock.alpha);
+    _sl_encode_bc1(inTexels, true, outBlock.color);
+}
+
+
+
+/*-------------------------------------
+ * BC4
+-------------------------------------*/
+void sl_encode_block(const SL_ColorR8 inTexels[16], SL_BlockBC4& outBlock) noexcept
+{
+    _sl_encode_bc4(reinterpret_cast<const uint8_t*>(inTexels), sizeof(SL_ColorR8), outBlock);
+}
+
+
+
+/*-------------------------------------
+ * BC5
+-------------------------------------*/
+void sl_encode_block(const SL_ColorRG8 inTexels[16], SL_BlockBC5& outBlock) noexcept
+{
+    _sl_encode_bc4(reinterpret_cast<const uint8_t*>(inTexels),     sizeof(SL_ColorRG8), outBlock.red);
+    _sl_encode_bc4(reinterpret_cast<const uint8_t*>(inTexels) + 1, sizeof(SL_ColorRG8), outBlock.green);
+}
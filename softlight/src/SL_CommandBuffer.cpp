@@ -0,0 +1,215 @@
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_CommandBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_CommandBuffer Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_CommandBuffer::SL_CommandBuffer() noexcept :
+    mCommands{},
+    mMeshes{},
+    mPayload{}
+{}
+
+
+
+/*-------------------------------------
+ * Remove all recorded commands, retaining memory for reuse
+-------------------------------------*/
+void SL_CommandBuffer::clear() noexcept
+{
+    mCommands.clear();
+    mMeshes.clear();
+    mPayload.clear();
+}
+
+
+
+/*-------------------------------------
+ * Record a mesh draw
+-------------------------------------*/
+void SL_CommandBuffer::draw(const SL_Mesh& m, size_t shaderId, size_t fboId) noexcept
+{
+    draw_instanced(m, 1, shaderId, fboId);
+}
+
+
+
+/*-------------------------------------
+ * Record a draw of several meshes
+-------------------------------------*/
+void SL_CommandBuffer::draw_multiple(const SL_Mesh* meshes, size_t numMeshes, size_t shaderId, size_t fboId) noexcept
+{
+    if (meshes == nullptr || numMeshes == 0)
+    {
+        return;
+    }
+
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_DRAW_MULTIPLE;
+    cmd.draw = SL_DrawCommand{shaderId, fboId, mMeshes.size(), numMeshes, 1};
+
+    mMeshes.insert(mMeshes.end(), meshes, meshes + numMeshes);
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record an instanced mesh draw
+-------------------------------------*/
+void SL_CommandBuffer::draw_instanced(const SL_Mesh& m, size_t numInstances, size_t shaderId, size_t fboId) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_DRAW;
+    cmd.draw = SL_DrawCommand{shaderId, fboId, mMeshes.size(), 1, numInstances};
+
+    mMeshes.push_back(m);
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a blit between two textures
+-------------------------------------*/
+void SL_CommandBuffer::blit(size_t outTextureId, size_t inTextureId) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_BLIT;
+    cmd.blit = SL_BlitCommand{outTextureId, inTextureId, nullptr, true, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a blit between two textures
+-------------------------------------*/
+void SL_CommandBuffer::blit(
+    size_t outTextureId,
+    size_t inTextureId,
+    uint16_t srcX0,
+    uint16_t srcY0,
+    uint16_t srcX1,
+    uint16_t srcY1,
+    uint16_t dstX0,
+    uint16_t dstY0,
+    uint16_t dstX1,
+    uint16_t dstY1) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_BLIT;
+    cmd.blit = SL_BlitCommand{outTextureId, inTextureId, nullptr, false, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1};
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a blit to an external buffer
+-------------------------------------*/
+void SL_CommandBuffer::blit(SL_TextureView& buffer, size_t textureId) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_BLIT;
+    cmd.blit = SL_BlitCommand{0, textureId, &buffer, true, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a blit to an external buffer
+-------------------------------------*/
+void SL_CommandBuffer::blit(
+    SL_TextureView& buffer,
+    size_t textureId,
+    uint16_t srcX0,
+    uint16_t srcY0,
+    uint16_t srcX1,
+    uint16_t srcY1,
+    uint16_t dstX0,
+    uint16_t dstY0,
+    uint16_t dstX1,
+    uint16_t dstY1) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_BLIT;
+    cmd.blit = SL_BlitCommand{0, textureId, &buffer, false, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1};
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a clear of a framebuffer's color attachment
+-------------------------------------*/
+void SL_CommandBuffer::clear_color_buffer(size_t fboId, unsigned attachmentId, const ls::math::vec4_t<double>& color) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_CLEAR;
+    cmd.clear = SL_ClearCommand{fboId, attachmentId, true, false, {color[0], color[1], color[2], color[3]}, 0.0};
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a clear of a framebuffer's depth attachment
+-------------------------------------*/
+void SL_CommandBuffer::clear_depth_buffer(size_t fboId, double depth) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_CLEAR;
+    cmd.clear = SL_ClearCommand{fboId, 0, false, true, {0.0, 0.0, 0.0, 0.0}, depth};
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record a clear of a framebuffer's color & depth attachments
+-------------------------------------*/
+void SL_CommandBuffer::clear_framebuffer(size_t fboId, unsigned attachmentId, const ls::math::vec4_t<double>& color, double depth) noexcept
+{
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_CLEAR;
+    cmd.clear = SL_ClearCommand{fboId, attachmentId, true, true, {color[0], color[1], color[2], color[3]}, depth};
+
+    mCommands.push_back(cmd);
+}
+
+
+
+/*-------------------------------------
+ * Record an update to a uniform buffer
+-------------------------------------*/
+void SL_CommandBuffer::update_uniforms(size_t uboId, const void* pData, size_t offset, size_t numBytes) noexcept
+{
+    if (pData == nullptr || numBytes == 0)
+    {
+        return;
+    }
+
+    const unsigned char* pBytes = reinterpret_cast<const unsigned char*>(pData);
+
+    SL_Command cmd;
+    cmd.type = SL_COMMAND_UPDATE_UNIFORMS;
+    cmd.uniforms = SL_UniformCommand{uboId, offset, mPayload.size(), numBytes};
+
+    mPayload.insert(mPayload.end(), pBytes, pBytes + numBytes);
+    mCommands.push_back(cmd);
+}
@@ -0,0 +1,187 @@
+
+#include <utility> // std::move
+
+#include "softlight/SL_CommandQueue.hpp"
+#include "softlight/SL_Context.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_Fence Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_Fence::SL_Fence() noexcept :
+    mLock{},
+    mSignal{},
+    mSignaled{false}
+{}
+
+
+
+/*-------------------------------------
+ * Mark all commands as complete
+-------------------------------------*/
+void SL_Fence::signal() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mLock};
+        mSignaled = true;
+    }
+
+    mSignal.notify_all();
+}
+
+
+
+/*-------------------------------------
+ * Determine if all commands have completed without blocking
+-------------------------------------*/
+bool SL_Fence::signaled() const noexcept
+{
+    std::lock_guard<std::mutex> lock{mLock};
+    return mSignaled;
+}
+
+
+
+/*-------------------------------------
+ * Block the calling thread until all commands have completed
+-------------------------------------*/
+void SL_Fence::wait() const noexcept
+{
+    std::unique_lock<std::mutex> lock{mLock};
+    mSignal.wait(lock, [this]()->bool { return mSignaled; });
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_CommandQueue Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_CommandQueue::~SL_CommandQueue() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mLock};
+        mRunning = false;
+    }
+
+    mPendingSignal.notify_one();
+
+    // remaining submissions are executed before the thread exits
+    mThread.join();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_CommandQueue::SL_CommandQueue(SL_Context& context) noexcept :
+    mContext{&context},
+    mLock{},
+    mPendingSignal{},
+    mIdleSignal{},
+    mPending{},
+    mExecuting{false},
+    mRunning{true},
+    mThread{&SL_CommandQueue::execute_submissions, this}
+{}
+
+
+
+/*-------------------------------------
+ * Thread entry point
+-------------------------------------*/
+void SL_CommandQueue::execute_submissions() noexcept
+{
+    std::unique_lock<std::mutex> lock{mLock};
+
+    while (true)
+    {
+        mPendingSignal.wait(lock, [this]()->bool { return !mPending.empty() || !mRunning; });
+
+        if (mPending.empty())
+        {
+            break;
+        }
+
+        SL_Submission submission{std::move(mPending.front())};
+        mPending.pop_front();
+        mExecuting = true;
+
+        lock.unlock();
+        mContext->execute(submission.commands);
+        submission.fence->signal();
+        lock.lock();
+
+        mExecuting = false;
+
+        if (mPending.empty())
+        {
+            mIdleSignal.notify_all();
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Queue a copy of a command buffer for execution
+-------------------------------------*/
+std::shared_ptr<SL_Fence> SL_CommandQueue::submit(const SL_CommandBuffer& commands) noexcept
+{
+    return submit(SL_CommandBuffer{commands});
+}
+
+
+
+/*-------------------------------------
+ * Queue a command buffer for execution
+-------------------------------------*/
+std::shared_ptr<SL_Fence> SL_CommandQueue::submit(SL_CommandBuffer&& commands) noexcept
+{
+    std::shared_ptr<SL_Fence> fence{std::make_shared<SL_Fence>()};
+
+    {
+        std::lock_guard<std::mutex> lock{mLock};
+        mPending.push_back(SL_Submission{std::move(commands), fence});
+    }
+
+    mPendingSignal.notify_one();
+
+    return fence;
+}
+
+
+
+/*-------------------------------------
+ * Determine if any submissions are pending or executing
+-------------------------------------*/
+bool SL_CommandQueue::busy() noexcept
+{
+    std::lock_guard<std::mutex> lock{mLock};
+    return mExecuting || !mPending.empty();
+}
+
+
+
+/*-------------------------------------
+ * Wait for all submissions to complete
+-------------------------------------*/
+void SL_CommandQueue::wait() noexcept
+{
+    // Commands executed by the queue may call back into the context, which
+    // will attempt to synchronize with the queue.
+    if (std::this_thread::get_id() == mThread.get_id())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{mLock};
+    mIdleSignal.wait(lock, [this]()->bool { return !mExecuting && mPending.empty(); });
+}
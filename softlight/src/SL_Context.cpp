@@ -3,6 +3,8 @@
 #include <iterator> // std::back_inserter
 #include <utility> // std::move
 
+#include "softlight/SL_CommandBuffer.hpp"
+#include "softlight/SL_CommandQueue.hpp"
 #include "softlight/SL_Context.hpp"
 #include "softlight/SL_FragmentProcessor.hpp"
 #include "softlight/SL_Framebuffer.hpp"
@@ -20,6 +22,9 @@
 -------------------------------------*/
 SL_Context::~SL_Context() noexcept
 {
+    // Drain all pending submissions before releasing their resources
+    mCommandQueue.reset();
+
     for (SL_Texture* pTex : mTextures)
     {
         delete pTex;
@@ -40,16 +45,18 @@ SL_Context::SL_Context() noexcept :
     mUniforms{},
     mShaders{},
     mViewState{},
-    mProcessors{}
+    mProcessors{},
+    mCommandQueue{}
 {}
 
 
 
 /*-------------------------------------
- *
+ * Pending submissions from the input context are completed before any of
+ * its resources are copied.
 -------------------------------------*/
 SL_Context::SL_Context(const SL_Context& c) noexcept :
-    mVaos{c.mVaos},
+    mVaos{(c.finish(), c.mVaos)},
     mTextures{},
     mFbos{c.mFbos},
     mVbos{c.mVbos},
@@ -57,7 +64,8 @@ SL_Context::SL_Context(const SL_Context& c) noexcept :
     mUniforms{c.mUniforms},
     mShaders{c.mShaders},
     mViewState{c.mViewState},
-    mProcessors{c.mProcessors}
+    mProcessors{c.mProcessors},
+    mCommandQueue{}
 {
     mTextures.reserve(c.mTextures.size());
 
@@ -70,10 +78,11 @@ SL_Context::SL_Context(const SL_Context& c) noexcept :
 
 
 /*-------------------------------------
- *
+ * The command queue of the input context remains bound to it, so its
+ * pending submissions are completed before any resources are moved.
 -------------------------------------*/
 SL_Context::SL_Context(SL_Context&& c) noexcept :
-    mVaos{std::move(c.mVaos)},
+    mVaos{(c.finish(), std::move(c.mVaos))},
     mTextures{std::move(c.mTextures)},
     mFbos{std::move(c.mFbos)},
     mVbos{std::move(c.mVbos)},
@@ -81,7 +90,8 @@ SL_Context::SL_Context(SL_Context&& c) noexcept :
     mUniforms{std::move(c.mUniforms)},
     mShaders{std::move(c.mShaders)},
     mViewState{std::move(c.mViewState)},
-    mProcessors{std::move(c.mProcessors)}
+    mProcessors{std::move(c.mProcessors)},
+    mCommandQueue{}
 {}
 
 
@@ -93,6 +103,9 @@ SL_Context& SL_Context::operator=(const SL_Context& c) noexcept
 {
     if (this != &c)
     {
+        finish();
+        c.finish();
+
         mVaos       = c.mVaos;
         mFbos       = c.mFbos;
         mVbos       = c.mVbos;
@@ -129,6 +142,9 @@ SL_Context& SL_Context::operator=(SL_Context&& c) noexcept
 {
     if (this != &c)
     {
+        finish();
+        c.finish();
+
         mVaos       = std::move(c.mVaos);
         mTextures   = std::move(c.mTextures);
         mFbos       = std::move(c.mFbos);
@@ -180,6 +196,8 @@ SL_VertexArray& SL_Context::vao(std::size_t index)
 -------------------------------------*/
 std::size_t SL_Context::create_vao()
 {
+    finish();
+
     mVaos.push_back(SL_VertexArray{});
     return mVaos.size() - 1;
 }
@@ -191,6 +209,8 @@ std::size_t SL_Context::create_vao()
 -------------------------------------*/
 void SL_Context::destroy_vao(std::size_t index)
 {
+    finish();
+
     mVaos.erase(mVaos.begin() + index);
 }
 
@@ -231,6 +251,8 @@ SL_Texture& SL_Context::texture(std::size_t index)
 -------------------------------------*/
 std::size_t SL_Context::create_texture()
 {
+    finish();
+
     mTextures.push_back(new SL_Texture{});
     return mTextures.size() - 1;
 }
@@ -242,12 +264,107 @@ std::size_t SL_Context::create_texture()
 -------------------------------------*/
 void SL_Context::destroy_texture(std::size_t index)
 {
+    finish();
+
     delete mTextures[index];
     mTextures.erase(mTextures.begin() + index);
 }
 
 
 
+/*-------------------------------------
+ * Generate a texture's mip chain
+-------------------------------------*/
+int SL_Context::generate_mips(std::size_t textureId, SL_MipFilter filter, SL_TexelOrder order, uint16_t numLevels) noexcept
+{
+    finish();
+
+    SL_Texture& tex = *mTextures[textureId];
+    resolve_fast_clears(tex.view());
+    const int retCode = tex.init_mips(numLevels);
+
+    if (retCode == 0)
+    {
+        mProcessors.run_mip_processors(tex, filter, order);
+    }
+
+    return retCode;
+}
+
+
+
+/*-------------------------------------
+ * Compress a texture
+-------------------------------------*/
+int SL_Context::compress_texture(std::size_t outTextureId, std::size_t inTextureId, SL_ColorDataType blockType, SL_TexelOrder order) noexcept
+{
+    if (!sl_is_block_compressed_color(blockType) || outTextureId == inTextureId)
+    {
+        return -1;
+    }
+
+    const SL_TextureView& src = mTextures[inTextureId]->view();
+
+    if (!src.pTexels || sl_block_compressed_color_for(src.type) == src.type)
+    {
+        return -2;
+    }
+
+    finish();
+    resolve_fast_clears(src);
+
+    SL_Texture& dst = *mTextures[outTextureId];
+
+    if (dst.init(blockType, src.width, src.height, src.depth) != 0)
+    {
+        return -3;
+    }
+
+    mProcessors.run_block_compress_processors(&src, &dst.view(), order, false);
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Decompress a texture
+-------------------------------------*/
+int SL_Context::decompress_texture(std::size_t outTextureId, std::size_t inTextureId, SL_TexelOrder order) noexcept
+{
+    const SL_TextureView& src = mTextures[inTextureId]->view();
+
+    if (!sl_is_block_compressed_color(src.type) || outTextureId == inTextureId)
+    {
+        return -1;
+    }
+
+    if (!src.pTexels)
+    {
+        return -2;
+    }
+
+    finish();
+
+    const SL_ColorDataType outType =
+        (src.type == SL_COLOR_BC4) ? SL_COLOR_R_8U :
+        (src.type == SL_COLOR_BC5) ? SL_COLOR_RG_8U :
+        SL_COLOR_RGBA_8U;
+
+    SL_Texture& dst = *mTextures[outTextureId];
+
+    if (dst.init(outType, src.width, src.height, src.depth) != 0)
+    {
+        return -3;
+    }
+
+    mProcessors.run_block_compress_processors(&src, &dst.view(), order, true);
+
+    return 0;
+}
+
+
+
 /*-------------------------------------
  *
 -------------------------------------*/
@@ -283,6 +400,8 @@ SL_Framebuffer& SL_Context::framebuffer(std::size_t index)
 -------------------------------------*/
 std::size_t SL_Context::create_framebuffer()
 {
+    finish();
+
     mFbos.push_back(SL_Framebuffer{});
     return mFbos.size() - 1;
 }
@@ -294,6 +413,8 @@ std::size_t SL_Context::create_framebuffer()
 -------------------------------------*/
 void SL_Context::destroy_framebuffer(std::size_t index)
 {
+    finish();
+
     mFbos.erase(mFbos.begin() + index);
 }
 
@@ -334,6 +455,8 @@ SL_VertexBuffer& SL_Context::vbo(std::size_t index)
 -------------------------------------*/
 std::size_t SL_Context::create_vbo()
 {
+    finish();
+
     mVbos.push_back(SL_VertexBuffer{});
     return mVbos.size() - 1;
 }
@@ -345,6 +468,8 @@ std::size_t SL_Context::create_vbo()
 -------------------------------------*/
 void SL_Context::destroy_vbo(std::size_t index)
 {
+    finish();
+
     mVbos.erase(mVbos.begin() + index);
 }
 
@@ -385,6 +510,8 @@ SL_IndexBuffer& SL_Context::ibo(std::size_t index)
 -------------------------------------*/
 std::size_t SL_Context::create_ibo()
 {
+    finish();
+
     mIbos.push_back(SL_IndexBuffer{});
     return mIbos.size() - 1;
 }
@@ -396,6 +523,8 @@ std::size_t SL_Context::create_ibo()
 -------------------------------------*/
 void SL_Context::destroy_ibo(std::size_t index)
 {
+    finish();
+
     mIbos.erase(mIbos.begin() + index);
 }
 
@@ -436,6 +565,8 @@ SL_UniformBuffer& SL_Context::ubo(std::size_t index)
 -------------------------------------*/
 std::size_t SL_Context::create_ubo()
 {
+    finish();
+
     mUniforms.push_back(SL_UniformBuffer{});
     return mUniforms.size() - 1;
 }
@@ -447,6 +578,8 @@ std::size_t SL_Context::create_ubo()
 -------------------------------------*/
 void SL_Context::destroy_ubo(std::size_t index)
 {
+    finish();
+
     mUniforms.erase(mUniforms.begin() + index);
 }
 
@@ -489,6 +622,8 @@ std::size_t SL_Context::create_shader(
     const SL_VertexShader& vertShader,
     const SL_FragmentShader& fragShader)
 {
+    finish();
+
     if (vertShader.numVaryings < fragShader.numVaryings)
     {
         return (std::size_t)-1;
@@ -532,7 +667,12 @@ std::size_t SL_Context::create_shader(
     SL_Shader shader;
     shader.pipelineState = pipeline;
     shader.pVertShader = vertShader.shader;
+    shader.pVertBatchShader = vertShader.batchShader;
     shader.pFragShader = fragShader.shader;
+    shader.pFragBatchShader = fragShader.batchShader;
+    shader.pFragQuadShader = fragShader.quadShader;
+    shader.pointSize = vertShader.pointSize;
+    shader.fragNeverDiscards = fragShader.neverDiscards;
     shader.pUniforms = nullptr;
 
     mShaders.push_back(shader);
@@ -549,6 +689,8 @@ std::size_t SL_Context::create_shader(
     const SL_FragmentShader& fragShader,
     std::size_t uniformIndex)
 {
+    finish();
+
     if (uniformIndex >= mUniforms.size())
     {
         return (std::size_t)-1;
@@ -597,7 +739,12 @@ std::size_t SL_Context::create_shader(
     SL_Shader shader;
     shader.pipelineState = pipeline;
     shader.pVertShader = vertShader.shader;
+    shader.pVertBatchShader = vertShader.batchShader;
     shader.pFragShader = fragShader.shader;
+    shader.pFragBatchShader = fragShader.batchShader;
+    shader.pFragQuadShader = fragShader.quadShader;
+    shader.pointSize = vertShader.pointSize;
+    shader.fragNeverDiscards = fragShader.neverDiscards;
     shader.pUniforms = &mUniforms[uniformIndex];
 
     mShaders.push_back(shader);
@@ -611,6 +758,8 @@ std::size_t SL_Context::create_shader(
 -------------------------------------*/
 void SL_Context::destroy_shader(std::size_t index)
 {
+    finish();
+
     mShaders.erase(mShaders.begin() + index);
 }
 
@@ -621,6 +770,8 @@ void SL_Context::destroy_shader(std::size_t index)
 -------------------------------------*/
 void SL_Context::terminate()
 {
+    mCommandQueue.reset();
+
     mVaos.clear();
     mVaos.shrink_to_fit();
 
@@ -660,6 +811,9 @@ void SL_Context::terminate()
 -------------------------------------*/
 void SL_Context::import(SL_Context&& inContext) noexcept
 {
+    finish();
+    inContext.finish();
+
     SL_AlignedVector<SL_VertexArray>&   inVaos     = inContext.mVaos;
     SL_AlignedVector<SL_Texture*>&      inTextures = inContext.mTextures;
     SL_AlignedVector<SL_Framebuffer>&   inFbos     = inContext.mFbos;
@@ -713,6 +867,8 @@ void SL_Context::import(SL_Context&& inContext) noexcept
 -------------------------------------*/
 void SL_Context::draw(const SL_Mesh& m, size_t shaderId, size_t fboId) noexcept
 {
+    finish();
+
     mProcessors.run_shader_processors(*this, m, 1, mShaders[shaderId], mFbos[fboId]);
 }
 
@@ -723,6 +879,8 @@ void SL_Context::draw(const SL_Mesh& m, size_t shaderId, size_t fboId) noexcept
 -------------------------------------*/
 void SL_Context::draw_multiple(const SL_Mesh* meshes, size_t numMeshes, size_t shaderId, size_t fboId) noexcept
 {
+    finish();
+
     if (meshes != nullptr && numMeshes > 0)
     {
         mProcessors.run_shader_processors(*this, meshes, numMeshes, mShaders[shaderId], mFbos[fboId]);
@@ -736,16 +894,76 @@ void SL_Context::draw_multiple(const SL_Mesh* meshes, size_t numMeshes, size_t s
 -------------------------------------*/
 void SL_Context::draw_instanced(const SL_Mesh& m, size_t numInstances, size_t shaderId, size_t fboId) noexcept
 {
+    finish();
+
     mProcessors.run_shader_processors(*this, m, numInstances, mShaders[shaderId], mFbos[fboId]);
 }
 
 
 
+/*-------------------------------------
+ * Draw meshes with a depth prepass
+-------------------------------------*/
+void SL_Context::draw_prepassed(const SL_Mesh* meshes, size_t numMeshes, size_t shaderId, size_t fboId) noexcept
+{
+    finish();
+
+    if (meshes == nullptr || numMeshes == 0)
+    {
+        return;
+    }
+
+    const SL_Shader& shader = mShaders[shaderId];
+    SL_Framebuffer&  fbo    = mFbos[fboId];
+
+    // Half-float depth is quantized on write and can't be compared for
+    // equality against interpolated fragment depth. Shaders which discard
+    // fragments must run before depth is written, otherwise holes in
+    // alpha-tested geometry would occlude everything behind them.
+    if (!shader.fragNeverDiscards || fbo.get_depth_buffer().bytesPerTexel == sizeof(ls::math::half))
+    {
+        mProcessors.run_shader_processors(*this, meshes, numMeshes, shader, fbo);
+        return;
+    }
+
+    // Depth-only pass. Removing outputs lets the rasterizer write depth
+    // directly without invoking the fragment shader.
+    SL_Shader depthShader = shader;
+    depthShader.pipelineState.num_render_targets(SL_RENDER_TARGET_COUNT_0);
+    depthShader.pipelineState.num_varyings(SL_VARYING_COUNT_0);
+    depthShader.pipelineState.blend_mode(SL_BLEND_OFF);
+    depthShader.pipelineState.depth_mask(SL_DEPTH_MASK_ON);
+
+    mProcessors.run_shader_processors(*this, meshes, numMeshes, depthShader, fbo);
+
+    // Shading pass. Only the nearest fragment of each pixel matches the
+    // depth buffer.
+    SL_Shader colorShader = shader;
+    colorShader.pipelineState.depth_test(SL_DEPTH_TEST_EQUAL);
+    colorShader.pipelineState.depth_mask(SL_DEPTH_MASK_OFF);
+
+    mProcessors.run_shader_processors(*this, meshes, numMeshes, colorShader, fbo);
+}
+
+
+
 /*-------------------------------------
  * Blit to a window
 -------------------------------------*/
 void SL_Context::blit(size_t outTextureId, size_t inTextureId) noexcept
 {
+    this->blit(outTextureId, inTextureId, SL_BLIT_FILTER_DEFAULT);
+}
+
+
+
+/*-------------------------------------
+ * Blit to a window with filtering
+-------------------------------------*/
+void SL_Context::blit(size_t outTextureId, size_t inTextureId, SL_BlitFilter filter) noexcept
+{
+    finish();
+
     SL_Texture*    pOut  = mTextures[outTextureId];
     SL_Texture*    pIn   = mTextures[inTextureId];
     const uint16_t srcX0 = 0;
@@ -763,7 +981,8 @@ void SL_Context::blit(size_t outTextureId, size_t inTextureId) noexcept
         srcX0, srcY0,
         srcX1, srcY1,
         dstX0, dstY0,
-        dstX1, dstY1);
+        dstX1, dstY1,
+        filter);
 }
 
 
@@ -783,9 +1002,49 @@ void SL_Context::blit(
     uint16_t dstX1,
     uint16_t dstY1) noexcept
 {
+    this->blit(
+        outTextureId,
+        inTextureId,
+        srcX0, srcY0,
+        srcX1, srcY1,
+        dstX0, dstY0,
+        dstX1, dstY1,
+        SL_BLIT_FILTER_DEFAULT);
+}
+
+
+
+/*-------------------------------------
+ * Blit to a window with filtering
+-------------------------------------*/
+void SL_Context::blit(
+    size_t outTextureId,
+    size_t inTextureId,
+    uint16_t srcX0,
+    uint16_t srcY0,
+    uint16_t srcX1,
+    uint16_t srcY1,
+    uint16_t dstX0,
+    uint16_t dstY0,
+    uint16_t dstX1,
+    uint16_t dstY1,
+    SL_BlitFilter filter) noexcept
+{
+    finish();
+
     SL_TextureView& i = mTextures[inTextureId]->view();
     SL_TextureView& o = mTextures[outTextureId]->view();
 
+    // The output may also be partially overwritten by a later resolve
+    resolve_fast_clears(i);
+    resolve_fast_clears(o);
+
+    // Block-compressed textures must be decompressed before blitting
+    if (sl_is_block_compressed_color(i.type) || sl_is_block_compressed_color(o.type))
+    {
+        return;
+    }
+
     if (sl_is_compressed_color(mTextures[outTextureId]->type()) || sl_is_compressed_color(mTextures[inTextureId]->type()))
     {
         mProcessors.run_blit_compressed_processors(
@@ -804,7 +1063,8 @@ void SL_Context::blit(
             srcX0, srcY0,
             srcX1, srcY1,
             dstX0, dstY0,
-            dstX1, dstY1);
+            dstX1, dstY1,
+            filter);
     }
 }
 
@@ -815,6 +1075,18 @@ void SL_Context::blit(
 -------------------------------------*/
 void SL_Context::blit(SL_TextureView& buffer, size_t textureId) noexcept
 {
+    this->blit(buffer, textureId, SL_BLIT_FILTER_DEFAULT);
+}
+
+
+
+/*-------------------------------------
+ * Blit to a window with filtering
+-------------------------------------*/
+void SL_Context::blit(SL_TextureView& buffer, size_t textureId, SL_BlitFilter filter) noexcept
+{
+    finish();
+
     SL_Texture*    pTex  = mTextures[textureId];
     const uint16_t srcX0 = 0;
     const uint16_t srcY0 = 0;
@@ -831,7 +1103,8 @@ void SL_Context::blit(SL_TextureView& buffer, size_t textureId) noexcept
         srcX0, srcY0,
         srcX1, srcY1,
         dstX0, dstY0,
-        dstX1, dstY1);
+        dstX1, dstY1,
+        filter);
 }
 
 
@@ -851,7 +1124,43 @@ void SL_Context::blit(
     uint16_t dstX1,
     uint16_t dstY1) noexcept
 {
+    this->blit(
+        buffer,
+        textureId,
+        srcX0, srcY0,
+        srcX1, srcY1,
+        dstX0, dstY0,
+        dstX1, dstY1,
+        SL_BLIT_FILTER_DEFAULT);
+}
+
+
+
+/*-------------------------------------
+ * Blit to a window with filtering
+-------------------------------------*/
+void SL_Context::blit(
+    SL_TextureView& buffer,
+    size_t textureId,
+    uint16_t srcX0,
+    uint16_t srcY0,
+    uint16_t srcX1,
+    uint16_t srcY1,
+    uint16_t dstX0,
+    uint16_t dstY0,
+    uint16_t dstX1,
+    uint16_t dstY1,
+    SL_BlitFilter filter) noexcept
+{
+    finish();
+
     SL_TextureView& t = mTextures[textureId]->view();
+    resolve_fast_clears(t);
+
+    if (sl_is_block_compressed_color(t.type) || sl_is_block_compressed_color(buffer.type))
+    {
+        return;
+    }
 
     if (sl_is_compressed_color(mTextures[textureId]->type()) || sl_is_compressed_color(buffer.type))
     {
@@ -869,7 +1178,8 @@ void SL_Context::blit(
             srcX0, srcY0,
             srcX1, srcY1,
             dstX0, dstY0,
-            dstX1, dstY1);
+            dstX1, dstY1,
+            filter);
     }
 }
 
@@ -880,9 +1190,17 @@ void SL_Context::blit(
 --------------------------------------*/
 void SL_Context::clear_color_buffer(size_t fboId, unsigned attachmentId, const ls::math::vec4_t<double>& color) noexcept
 {
+    finish();
+
     SL_TextureView& pTex = mFbos[fboId].get_color_buffer(attachmentId);
     SL_GeneralColor outColor = sl_match_color_for_type(pTex.type, color);
 
+    if (mFbos[fboId].fast_clears())
+    {
+        mFbos[fboId].fast_clear_color_buffer(attachmentId, &outColor.color);
+        return;
+    }
+
     mProcessors.run_clear_processors(&outColor.color, &pTex);
 }
 
@@ -893,6 +1211,8 @@ void SL_Context::clear_color_buffer(size_t fboId, unsigned attachmentId, const l
 --------------------------------------*/
 void SL_Context::clear_depth_buffer(size_t fboId, double depth) noexcept
 {
+    finish();
+
     SL_TextureView& pTex = mFbos[fboId].get_depth_buffer();
     union
     {
@@ -919,7 +1239,13 @@ void SL_Context::clear_depth_buffer(size_t fboId, double depth) noexcept
             return;
     }
 
-    mProcessors.run_clear_processors(&depthVal, &pTex);
+    if (mFbos[fboId].fast_clears())
+    {
+        mFbos[fboId].fast_clear_depth_buffer(&depthVal);
+        return;
+    }
+
+    mProcessors.run_clear_processors(&depthVal, &pTex, &mFbos[fboId].get_depth_hierarchy());
 
 }
 
@@ -930,6 +1256,8 @@ void SL_Context::clear_depth_buffer(size_t fboId, double depth) noexcept
 --------------------------------------*/
 void SL_Context::clear_framebuffer(size_t fboId, unsigned attachmentId, const ls::math::vec4_t<double>& color, double depth) noexcept
 {
+    finish();
+
     SL_TextureView& pColorBuf = mFbos[fboId].get_color_buffer(attachmentId);
     SL_TextureView& pDepth = mFbos[fboId].get_depth_buffer();
     SL_GeneralColor outColor = sl_match_color_for_type(pColorBuf.type, color);
@@ -959,7 +1287,14 @@ void SL_Context::clear_framebuffer(size_t fboId, unsigned attachmentId, const ls
             return;
     }
 
-    mProcessors.run_clear_processors(&outColor.color, &depthVal, &pColorBuf, &pDepth);
+    if (mFbos[fboId].fast_clears())
+    {
+        mFbos[fboId].fast_clear_color_buffer(attachmentId, &outColor.color);
+        mFbos[fboId].fast_clear_depth_buffer(&depthVal);
+        return;
+    }
+
+    mProcessors.run_clear_processors(&outColor.color, &depthVal, &pColorBuf, &pDepth, &mFbos[fboId].get_depth_hierarchy());
 }
 
 
@@ -969,6 +1304,8 @@ void SL_Context::clear_framebuffer(size_t fboId, unsigned attachmentId, const ls
 --------------------------------------*/
 void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 2>& bufferIndices, const std::array<ls::math::vec4_t<double>, 2>& colors, double depth) noexcept
 {
+    finish();
+
     SL_TextureView& pDepth = mFbos[fboId].get_depth_buffer();
 
     std::array<SL_TextureView*, 2> buffers{
@@ -1011,7 +1348,18 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 2>&
             return;
     }
 
-    mProcessors.run_clear_processors(outColors, &depthVal, buffers, &pDepth);
+    if (mFbos[fboId].fast_clears())
+    {
+        for (size_t i = 0; i < bufferIndices.size(); ++i)
+        {
+            mFbos[fboId].fast_clear_color_buffer(bufferIndices[i], outColors[i]);
+        }
+
+        mFbos[fboId].fast_clear_depth_buffer(&depthVal);
+        return;
+    }
+
+    mProcessors.run_clear_processors(outColors, &depthVal, buffers, &pDepth, &mFbos[fboId].get_depth_hierarchy());
 }
 
 
@@ -1021,6 +1369,8 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 2>&
 --------------------------------------*/
 void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 3>& bufferIndices, const std::array<ls::math::vec4_t<double>, 3>& colors, double depth) noexcept
 {
+    finish();
+
     SL_TextureView& pDepth = mFbos[fboId].get_depth_buffer();
 
     std::array<SL_TextureView*, 3> buffers{
@@ -1066,7 +1416,18 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 3>&
             return;
     }
 
-    mProcessors.run_clear_processors(outColors, &depthVal, buffers, &pDepth);
+    if (mFbos[fboId].fast_clears())
+    {
+        for (size_t i = 0; i < bufferIndices.size(); ++i)
+        {
+            mFbos[fboId].fast_clear_color_buffer(bufferIndices[i], outColors[i]);
+        }
+
+        mFbos[fboId].fast_clear_depth_buffer(&depthVal);
+        return;
+    }
+
+    mProcessors.run_clear_processors(outColors, &depthVal, buffers, &pDepth, &mFbos[fboId].get_depth_hierarchy());
 }
 
 
@@ -1076,6 +1437,8 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 3>&
 --------------------------------------*/
 void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 4>& bufferIndices, const std::array<ls::math::vec4_t<double>, 4>& colors, double depth) noexcept
 {
+    finish();
+
     SL_TextureView& pDepth = mFbos[fboId].get_depth_buffer();
 
     std::array<SL_TextureView*, 4> buffers{
@@ -1124,7 +1487,225 @@ void SL_Context::clear_framebuffer(size_t fboId, const std::array<unsigned, 4>&
             return;
     }
 
-    mProcessors.run_clear_processors(outColors, &depthVal, buffers, &pDepth);
+    if (mFbos[fboId].fast_clears())
+    {
+        for (size_t i = 0; i < bufferIndices.size(); ++i)
+        {
+            mFbos[fboId].fast_clear_color_buffer(bufferIndices[i], outColors[i]);
+        }
+
+        mFbos[fboId].fast_clear_depth_buffer(&depthVal);
+        return;
+    }
+
+    mProcessors.run_clear_processors(outColors, &depthVal, buffers, &pDepth, &mFbos[fboId].get_depth_hierarchy());
+}
+
+
+
+/*--------------------------------------
+ * Write the pending clears of a framebuffer
+--------------------------------------*/
+void SL_Context::resolve_framebuffer(size_t fboId) noexcept
+{
+    finish();
+
+    SL_Framebuffer& fbo = mFbos[fboId];
+    SL_FastClear& clears = fbo.get_fast_clears();
+
+    if (clears.pending())
+    {
+        mProcessors.run_resolve_processors(&clears, &fbo.get_color_buffer(0), &fbo.get_depth_buffer());
+    }
+}
+
+
+
+/*--------------------------------------
+ * Average the samples of a multisampled color attachment
+--------------------------------------*/
+int SL_Context::resolve_samples(size_t fboId, unsigned colorIndex, size_t outTextureId) noexcept
+{
+    finish();
+
+    SL_Framebuffer& fbo = mFbos[fboId];
+
+    if (fbo.num_samples() <= 1)
+    {
+        return -1;
+    }
+
+    if (colorIndex >= fbo.num_color_buffers() || !fbo.get_color_buffer(colorIndex).pTexels)
+    {
+        return -2;
+    }
+
+    const SL_TextureView& src = fbo.get_color_buffer(colorIndex);
+    SL_TextureView&       dst = mTextures[outTextureId]->view();
+
+    if (dst.width != src.width || dst.height != src.height || dst.type != src.type || sl_is_compressed_color(src.type))
+    {
+        return -3;
+    }
+
+    // Pending clears must be written into every sample first
+    resolve_framebuffer(fboId);
+    resolve_fast_clears(dst);
+
+    mProcessors.run_sample_resolve_processors(&src, &dst);
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Write the pending clears of all framebuffers which a texture is attached
+ * to, before it's read or written outside of a draw.
+--------------------------------------*/
+void SL_Context::resolve_fast_clears(const SL_TextureView& texture) noexcept
+{
+    if (!texture.pTexels)
+    {
+        return;
+    }
+
+    for (SL_Framebuffer& fbo : mFbos)
+    {
+        SL_FastClear& clears = fbo.get_fast_clears();
+
+        if (!clears.pending())
+        {
+            continue;
+        }
+
+        bool isAttached = fbo.get_depth_buffer().pTexels == texture.pTexels;
+
+        for (unsigned i = 0; i < fbo.num_color_buffers(); ++i)
+        {
+            isAttached = isAttached || fbo.get_color_buffer(i).pTexels == texture.pTexels;
+        }
+
+        if (isAttached)
+        {
+            mProcessors.run_resolve_processors(&clears, &fbo.get_color_buffer(0), &fbo.get_depth_buffer());
+        }
+    }
+}
+
+
+
+/*--------------------------------------
+ * Execute a command buffer
+--------------------------------------*/
+void SL_Context::execute(const SL_CommandBuffer& commands) noexcept
+{
+    const SL_Mesh* const       pMeshes  = commands.meshes();
+    const unsigned char* const pPayload = commands.payload();
+
+    for (size_t i = 0; i < commands.size(); ++i)
+    {
+        const SL_Command& cmd = commands.command(i);
+
+        switch (cmd.type)
+        {
+            case SL_COMMAND_DRAW:
+                draw_instanced(pMeshes[cmd.draw.firstMesh], cmd.draw.numInstances, cmd.draw.shaderId, cmd.draw.fboId);
+                break;
+
+            case SL_COMMAND_DRAW_MULTIPLE:
+                draw_multiple(pMeshes + cmd.draw.firstMesh, cmd.draw.numMeshes, cmd.draw.shaderId, cmd.draw.fboId);
+                break;
+
+            case SL_COMMAND_CLEAR:
+            {
+                const SL_ClearCommand& c = cmd.clear;
+                const ls::math::vec4_t<double> color{c.color[0], c.color[1], c.color[2], c.color[3]};
+
+                if (c.clearColor && c.clearDepth)
+                {
+                    clear_framebuffer(c.fboId, c.attachmentId, color, c.depth);
+                }
+                else if (c.clearColor)
+                {
+                    clear_color_buffer(c.fboId, c.attachmentId, color);
+                }
+                else if (c.clearDepth)
+                {
+                    clear_depth_buffer(c.fboId, c.depth);
+                }
+                break;
+            }
+
+            case SL_COMMAND_BLIT:
+            {
+                const SL_BlitCommand& b = cmd.blit;
+
+                if (b.pOutBuffer && b.fullSize)
+                {
+                    blit(*b.pOutBuffer, b.inTextureId);
+                }
+                else if (b.pOutBuffer)
+                {
+                    blit(*b.pOutBuffer, b.inTextureId, b.srcX0, b.srcY0, b.srcX1, b.srcY1, b.dstX0, b.dstY0, b.dstX1, b.dstY1);
+                }
+                else if (b.fullSize)
+                {
+                    blit(b.outTextureId, b.inTextureId);
+                }
+                else
+                {
+                    blit(b.outTextureId, b.inTextureId, b.srcX0, b.srcY0, b.srcX1, b.srcY1, b.dstX0, b.dstY0, b.dstX1, b.dstY1);
+                }
+                break;
+            }
+
+            case SL_COMMAND_UPDATE_UNIFORMS:
+                mUniforms[cmd.uniforms.uboId].assign(pPayload + cmd.uniforms.firstByte, cmd.uniforms.uboOffset, cmd.uniforms.numBytes);
+                break;
+
+            default:
+                LS_UNREACHABLE();
+        }
+    }
+}
+
+
+
+/*--------------------------------------
+ * Execute a command buffer asynchronously
+--------------------------------------*/
+std::shared_ptr<SL_Fence> SL_Context::submit(const SL_CommandBuffer& commands) noexcept
+{
+    return submit(SL_CommandBuffer{commands});
+}
+
+
+
+/*--------------------------------------
+ * Execute a command buffer asynchronously
+--------------------------------------*/
+std::shared_ptr<SL_Fence> SL_Context::submit(SL_CommandBuffer&& commands) noexcept
+{
+    if (!mCommandQueue)
+    {
+        mCommandQueue.reset(new SL_CommandQueue{*this});
+    }
+
+    return mCommandQueue->submit(std::move(commands));
+}
+
+
+
+/*--------------------------------------
+ * Wait for all submitted command buffers
+--------------------------------------*/
+void SL_Context::finish() const noexcept
+{
+    if (mCommandQueue)
+    {
+        mCommandQueue->wait();
+    }
 }
 
 
@@ -1144,5 +1725,143 @@ unsigned SL_Context::num_threads() const noexcept
 --------------------------------------*/
 unsigned SL_Context::num_threads(unsigned inNumThreads) noexcept
 {
+    finish();
+
     return mProcessors.concurrency(inNumThreads);
 }
+
+
+
+/*--------------------------------------
+ * Retrieve the vertex reuse ratio
+--------------------------------------*/
+float SL_Context::vertex_reuse_ratio() const noexcept
+{
+    finish();
+
+    return mProcessors.vertex_reuse_ratio();
+}
+
+
+
+/*--------------------------------------
+ * Reset the vertex reuse counters
+--------------------------------------*/
+void SL_Context::reset_vertex_stats() noexcept
+{
+    finish();
+
+    mProcessors.reset_vertex_stats();
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the maximum number of binned primitives
+--------------------------------------*/
+uint32_t SL_Context::bin_capacity() const noexcept
+{
+    return mProcessors.bin_capacity();
+}
+
+
+
+/*--------------------------------------
+ * Set the maximum number of binned primitives
+--------------------------------------*/
+void SL_Context::bin_capacity(uint32_t maxBinnedPrims) noexcept
+{
+    finish();
+
+    mProcessors.bin_capacity(maxBinnedPrims);
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the bin flushing policy
+--------------------------------------*/
+SL_BinFlushPolicy SL_Context::bin_flush_policy() const noexcept
+{
+    return mProcessors.bin_flush_policy();
+}
+
+
+
+/*--------------------------------------
+ * Set the bin flushing policy
+--------------------------------------*/
+void SL_Context::bin_flush_policy(SL_BinFlushPolicy policy) noexcept
+{
+    finish();
+
+    mProcessors.bin_flush_policy(policy);
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the screen coverage which triggers an adaptive flush
+--------------------------------------*/
+float SL_Context::bin_coverage_limit() const noexcept
+{
+    return mProcessors.bin_coverage_limit();
+}
+
+
+
+/*--------------------------------------
+ * Set the screen coverage which triggers an adaptive flush
+--------------------------------------*/
+void SL_Context::bin_coverage_limit(float numScreens) noexcept
+{
+    finish();
+
+    mProcessors.bin_coverage_limit(numScreens);
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the bin flushing counters
+--------------------------------------*/
+SL_BinFlushCounts SL_Context::bin_flush_counts() const noexcept
+{
+    finish();
+
+    return mProcessors.bin_flush_counts();
+}
+
+
+
+/*--------------------------------------
+ * Reset the bin flushing counters
+--------------------------------------*/
+void SL_Context::reset_bin_flush_stats() noexcept
+{
+    finish();
+
+    mProcessors.reset_bin_flush_stats();
+}
+
+
+
+/*--------------------------------------
+ * Retrieve the thread spin budget
+--------------------------------------*/
+uint32_t SL_Context::spin_budget() const noexcept
+{
+    return mProcessors.spin_budget();
+}
+
+
+
+/*--------------------------------------
+ * Set the thread spin budget
+--------------------------------------*/
+void SL_Context::spin_budget(uint32_t numSpins) noexcept
+{
+    finish();
+
+    mProcessors.spin_budget(numSpins);
+}
@@ -0,0 +1,347 @@
+#include <utility> // std::move()
+
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "lightsky/math/scalar_utils.h"
+
+#include "lightsky/utils/Copy.h"
+
+#include "softlight/SL_FastClear.hpp"
+#include "softlight/SL_ShaderUtil.hpp" // sl_num_raster_tiles()
+#include "softlight/SL_Texture.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*--------------------------------------
+ * Assign every texel within a raster tile to a single value
+--------------------------------------*/
+inline void _sl_fill_tile(SL_TextureView& tex, uint16_t tileX, uint16_t tileY, const void* pValue) noexcept
+{
+    const size_t x0 = (size_t)tileX << SL_RASTER_TILE_SHIFT;
+    const size_t y0 = (size_t)tileY << SL_RASTER_TILE_SHIFT;
+    const size_t w  = (size_t)tex.width;
+    const size_t h  = (size_t)tex.height;
+
+    if (!tex.pTexels || x0 >= w || y0 >= h)
+    {
+        return;
+    }
+
+    const size_t x1       = math::min<size_t>(x0 + SL_RASTER_TILE_SIZE, w);
+    const size_t y1       = math::min<size_t>(y0 + SL_RASTER_TILE_SIZE, h);
+    const size_t bpt      = (size_t)tex.bytesPerTexel;
+    const size_t rowBytes = (x1 - x0) * bpt;
+    char* const  pFirst   = tex.pTexels + (x0 + w * y0) * bpt;
+
+    switch (bpt)
+    {
+        case sizeof(uint8_t):
+            ls::utils::fast_memset(pFirst, *reinterpret_cast<const uint8_t*>(pValue), rowBytes);
+            break;
+
+        case sizeof(uint16_t):
+            ls::utils::fast_memset_2(pFirst, *reinterpret_cast<const uint16_t*>(pValue), rowBytes);
+            break;
+
+        case sizeof(uint32_t):
+            ls::utils::fast_memset_4(pFirst, *reinterpret_cast<const uint32_t*>(pValue), rowBytes);
+            break;
+
+        case sizeof(uint64_t):
+            ls::utils::fast_memset_8(pFirst, *reinterpret_cast<const uint64_t*>(pValue), rowBytes);
+            break;
+
+        default:
+            for (size_t x = 0; x < rowBytes; x += bpt)
+            {
+                ls::utils::fast_memcpy(pFirst + x, pValue, bpt);
+            }
+    }
+
+    // The remaining rows of a tile are copied from the first, which is
+    // still resident in cache. Multisampled attachments store each sample
+    // in a separate layer.
+    const size_t d = (size_t)tex.depth;
+
+    for (size_t z = 0; z < d; ++z)
+    {
+        for (size_t y = z ? y0 : (y0 + 1u); y < y1; ++y)
+        {
+            ls::utils::fast_memcpy(tex.pTexels + (x0 + w * (y + h * z)) * bpt, pFirst, rowBytes);
+        }
+    }
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_FastClear Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_FastClear::~SL_FastClear() noexcept
+{
+    terminate();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_FastClear::SL_FastClear() noexcept :
+    mTilesX{0},
+    mTilesY{0},
+    mPendingMask{0},
+    mTiles{nullptr},
+    mValues{}
+{}
+
+
+
+/*-------------------------------------
+ * Copy Constructor
+-------------------------------------*/
+SL_FastClear::SL_FastClear(const SL_FastClear& c) noexcept :
+    SL_FastClear{}
+{
+    *this = c;
+}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_FastClear::SL_FastClear(SL_FastClear&& c) noexcept :
+    mTilesX{c.mTilesX},
+    mTilesY{c.mTilesY},
+    mPendingMask{c.mPendingMask},
+    mTiles{std::move(c.mTiles)}
+{
+    ls::utils::fast_memcpy(mValues, c.mValues, sizeof(mValues));
+
+    c.mTilesX = 0;
+    c.mTilesY = 0;
+    c.mPendingMask = 0;
+}
+
+
+
+/*-------------------------------------
+ * Copy Operator
+-------------------------------------*/
+SL_FastClear& SL_FastClear::operator=(const SL_FastClear& c) noexcept
+{
+    if (this == &c)
+    {
+        return *this;
+    }
+
+    terminate();
+
+    if (c.valid())
+    {
+        const size_t numTiles = (size_t)c.mTilesX * (size_t)c.mTilesY;
+
+        mTiles = ls::utils::make_unique_aligned_array<uint8_t>(numTiles);
+
+        if (!mTiles)
+        {
+            terminate();
+            return *this;
+        }
+
+        mTilesX = c.mTilesX;
+        mTilesY = c.mTilesY;
+        mPendingMask = c.mPendingMask;
+
+        ls::utils::fast_memcpy(mTiles.get(), c.mTiles.get(), numTiles);
+        ls::utils::fast_memcpy(mValues, c.mValues, sizeof(mValues));
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_FastClear& SL_FastClear::operator=(SL_FastClear&& c) noexcept
+{
+    if (this != &c)
+    {
+        mTilesX = c.mTilesX;
+        c.mTilesX = 0;
+
+        mTilesY = c.mTilesY;
+        c.mTilesY = 0;
+
+        mPendingMask = c.mPendingMask;
+        c.mPendingMask = 0;
+
+        mTiles = std::move(c.mTiles);
+
+        ls::utils::fast_memcpy(mValues, c.mValues, sizeof(mValues));
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Allocate one set of clear flags per raster tile. No tiles are pending.
+-------------------------------------*/
+int SL_FastClear::init(uint16_t width, uint16_t height) noexcept
+{
+    terminate();
+
+    if (!width || !height)
+    {
+        return -1;
+    }
+
+    const uint16_t tilesX = sl_num_raster_tiles<uint16_t>(width);
+    const uint16_t tilesY = sl_num_raster_tiles<uint16_t>(height);
+
+    mTiles = ls::utils::make_unique_aligned_array<uint8_t>((size_t)tilesX * (size_t)tilesY);
+
+    if (!mTiles)
+    {
+        terminate();
+        return -2;
+    }
+
+    mTilesX = tilesX;
+    mTilesY = tilesY;
+
+    ls::utils::fast_memset(mTiles.get(), 0, (size_t)tilesX * (size_t)tilesY);
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Release all resources. Pending clears are discarded.
+-------------------------------------*/
+void SL_FastClear::terminate() noexcept
+{
+    mTilesX = 0;
+    mTilesY = 0;
+    mPendingMask = 0;
+    mTiles.reset();
+}
+
+
+
+/*-------------------------------------
+ * Mark an attachment as cleared within every tile
+-------------------------------------*/
+void SL_FastClear::clear(unsigned attachmentId, const void* pValue, unsigned bytesPerTexel) noexcept
+{
+    if (!valid() || attachmentId >= SL_FAST_CLEAR_MAX_ATTACHMENTS || !bytesPerTexel || bytesPerTexel > SL_FAST_CLEAR_MAX_TEXEL_BYTES)
+    {
+        return;
+    }
+
+    const uint8_t mask     = (uint8_t)(1u << attachmentId);
+    const size_t  numTiles = (size_t)mTilesX * (size_t)mTilesY;
+
+    ls::utils::fast_memcpy(mValues[attachmentId], pValue, bytesPerTexel);
+
+    for (size_t i = 0; i < numTiles; ++i)
+    {
+        mTiles[i] |= mask;
+    }
+
+    mPendingMask |= mask;
+}
+
+
+
+/*-------------------------------------
+ * Write the pending clears of a single tile
+-------------------------------------*/
+void SL_FastClear::resolve_attachments(uint16_t tileX, uint16_t tileY, SL_TextureView* pColors, SL_TextureView* pDepth) noexcept
+{
+    uint8_t& tile = mTiles[tileX + mTilesX * tileY];
+
+    for (unsigned i = 0; i < SL_FAST_CLEAR_DEPTH_ATTACHMENT; ++i)
+    {
+        if (tile & (1u << i))
+        {
+            _sl_fill_tile(pColors[i], tileX, tileY, mValues[i]);
+        }
+    }
+
+    if (tile & (1u << SL_FAST_CLEAR_DEPTH_ATTACHMENT))
+    {
+        _sl_fill_tile(*pDepth, tileX, tileY, mValues[SL_FAST_CLEAR_DEPTH_ATTACHMENT]);
+    }
+
+    tile = 0;
+}
+
+
+
+/*-------------------------------------
+ * Resolve a thread's partition of tiles
+-------------------------------------*/
+void SL_FastClear::resolve(SL_TextureView* pColors, SL_TextureView* pDepth, uint16_t numThreads, uint16_t threadId) noexcept
+{
+    if (!mPendingMask)
+    {
+        return;
+    }
+
+    const size_t numTiles = (size_t)mTilesX * (size_t)mTilesY;
+    const size_t tilesPerThread = (numTiles + numThreads - 1) / numThreads;
+    const size_t begin = math::min(numTiles, tilesPerThread*threadId);
+    const size_t end = math::min(numTiles, tilesPerThread*(threadId+1u));
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        const uint16_t tileY = (uint16_t)(i / mTilesX);
+        const uint16_t tileX = (uint16_t)(i - (size_t)tileY * mTilesX);
+        resolve_tile(tileX, tileY, pColors, pDepth);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Resolve all tiles on the current thread
+-------------------------------------*/
+void SL_FastClear::resolve(SL_TextureView* pColors, SL_TextureView* pDepth) noexcept
+{
+    resolve(pColors, pDepth, 1, 0);
+    mark_resolved();
+}
+
+
+
+/*-------------------------------------
+ * Acknowledge that every tile has been resolved
+-------------------------------------*/
+void SL_FastClear::mark_resolved() noexcept
+{
+    mPendingMask = 0;
+}
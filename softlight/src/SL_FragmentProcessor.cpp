@@ -31,56 +31,33 @@ inline void LS_IMPERATIVE interpolate_line_varyings(
     math::vec4* const       outVaryings
 ) noexcept
 {
-    #if defined(LS_X86_AVX2)
-        (void)numVaryings;
-        const __m256 p = _mm256_set1_ps(percent);
-        __m256 v0, v1, v2, v3, v4, v5, o0, o1;
-
-        v0 = _mm256_load_ps(reinterpret_cast<const float*>(inVaryings));
-        v1 = _mm256_load_ps(reinterpret_cast<const float*>(inVaryings+SL_SHADER_MAX_VARYING_VECTORS));
-        v3 = _mm256_load_ps(reinterpret_cast<const float*>(inVaryings+2));
-        v4 = _mm256_load_ps(reinterpret_cast<const float*>(inVaryings+2+SL_SHADER_MAX_VARYING_VECTORS));
-
-        v2 = _mm256_sub_ps(v1, v0);
-        v5 = _mm256_sub_ps(v4, v3);
-        o0 = _mm256_fmadd_ps(v2, p, v0);
-        o1 = _mm256_fmadd_ps(v5, p, v3);
-
-        _mm256_store_ps(reinterpret_cast<float*>(outVaryings), o0);
-        _mm256_store_ps(reinterpret_cast<float*>(outVaryings+2), o1);
-
-        _mm256_zeroupper();
-
-    #elif defined(LS_X86_FMA)
-        (void)numVaryings;
+    #if defined(LS_X86_FMA)
+        const math::vec4* const LS_RESTRICT_PTR inVaryings1 = inVaryings + numVaryings;
         const __m128 p = _mm_set1_ps(percent);
-        __m128 v0, v1, v2, v3, v4, v5, o0, o1;
-
-        v0 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings));
-        v1 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings+SL_SHADER_MAX_VARYING_VECTORS));
-        v3 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings+1));
-        v4 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings+1+SL_SHADER_MAX_VARYING_VECTORS));
-
-        v2 = _mm_sub_ps(v1, v0);
-        v5 = _mm_sub_ps(v4, v3);
-        o0 = _mm_fmadd_ps(v2, p, v0);
-        o1 = _mm_fmadd_ps(v5, p, v3);
+        __m128 v0, v1;
 
-        _mm_store_ps(reinterpret_cast<float*>(outVaryings), o0);
-        _mm_store_ps(reinterpret_cast<float*>(outVaryings+1), o1);
+        switch (numVaryings)
+        {
+            case 4:
+                v0 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings + 3));
+                v1 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings1 + 3));
+                _mm_store_ps(reinterpret_cast<float*>(outVaryings + 3), _mm_fmadd_ps(_mm_sub_ps(v1, v0), p, v0));
 
-        v0 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings+2));
-        v1 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings+2+SL_SHADER_MAX_VARYING_VECTORS));
-        v3 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings+3));
-        v4 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings+3+SL_SHADER_MAX_VARYING_VECTORS));
+            case 3:
+                v0 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings + 2));
+                v1 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings1 + 2));
+                _mm_store_ps(reinterpret_cast<float*>(outVaryings + 2), _mm_fmadd_ps(_mm_sub_ps(v1, v0), p, v0));
 
-        v2 = _mm_sub_ps(v1, v0);
-        v5 = _mm_sub_ps(v4, v3);
-        o0 = _mm_fmadd_ps(v2, p, v0);
-        o1 = _mm_fmadd_ps(v5, p, v3);
+            case 2:
+                v0 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings + 1));
+                v1 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings1 + 1));
+                _mm_store_ps(reinterpret_cast<float*>(outVaryings + 1), _mm_fmadd_ps(_mm_sub_ps(v1, v0), p, v0));
 
-        _mm_store_ps(reinterpret_cast<float*>(outVaryings+2), o0);
-        _mm_store_ps(reinterpret_cast<float*>(outVaryings+3), o1);
+            case 1:
+                v0 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings + 0));
+                v1 = _mm_load_ps(reinterpret_cast<const float*>(inVaryings1 + 0));
+                _mm_store_ps(reinterpret_cast<float*>(outVaryings + 0), _mm_fmadd_ps(_mm_sub_ps(v1, v0), p, v0));
+        }
 
     #elif defined(LS_ARM_NEON)
         const float32x4_t p = vdupq_n_f32(percent);
@@ -90,28 +67,28 @@ inline void LS_IMPERATIVE interpolate_line_varyings(
         {
             case 4:
                 v0 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 3));
-                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 3 + SL_SHADER_MAX_VARYING_VECTORS));
+                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 3 + numVaryings));
                 v2 = vsubq_f32(v1, v0);
                 o = vmlaq_f32(v0, p, v2);
                 vst1q_f32(reinterpret_cast<float*>(outVaryings + 3), o);
 
             case 3:
                 v0 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 2));
-                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 2 + SL_SHADER_MAX_VARYING_VECTORS));
+                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 2 + numVaryings));
                 v2 = vsubq_f32(v1, v0);
                 o = vmlaq_f32(v0, p, v2);
                 vst1q_f32(reinterpret_cast<float*>(outVaryings + 2), o);
 
             case 2:
                 v0 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 1));
-                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 1 + SL_SHADER_MAX_VARYING_VECTORS));
+                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 1 + numVaryings));
                 v2 = vsubq_f32(v1, v0);
                 o = vmlaq_f32(v0, p, v2);
                 vst1q_f32(reinterpret_cast<float*>(outVaryings + 1), o);
 
             case 1:
                 v0 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 0));
-                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 0 + SL_SHADER_MAX_VARYING_VECTORS));
+                v1 = vld1q_f32(reinterpret_cast<const float*>(inVaryings + 0 + numVaryings));
                 v2 = vsubq_f32(v1, v0);
                 o = vmlaq_f32(v0, p, v2);
                 vst1q_f32(reinterpret_cast<float*>(outVaryings + 0), o);
@@ -125,22 +102,22 @@ inline void LS_IMPERATIVE interpolate_line_varyings(
         {
             case 4:
                 v0 = inVaryings+3;
-                v1 = inVaryings+3+SL_SHADER_MAX_VARYING_VECTORS;
+                v1 = inVaryings+3+numVaryings;
                 outVaryings[3] = math::mix(*v0, *v1, percent);
 
             case 3:
                 v0 = inVaryings+2;
-                v1 = inVaryings+2+SL_SHADER_MAX_VARYING_VECTORS;
+                v1 = inVaryings+2+numVaryings;
                 outVaryings[2] = math::mix(*v0, *v1, percent);
 
             case 2:
                 v0 = inVaryings+1;
-                v1 = inVaryings+1+SL_SHADER_MAX_VARYING_VECTORS;
+                v1 = inVaryings+1+numVaryings;
                 outVaryings[1] = math::mix(*v0, *v1, percent);
 
             case 1:
                 v0 = inVaryings;
-                v1 = inVaryings+SL_SHADER_MAX_VARYING_VECTORS;
+                v1 = inVaryings+numVaryings;
                 outVaryings[0] = math::mix(*v0, *v1, percent);
         }
 
@@ -160,86 +137,35 @@ inline void LS_IMPERATIVE interpolate_tri_varyings(
 {
     static_assert(SL_SHADER_MAX_VARYING_VECTORS == 4, "Please update the varying interpolator.");
 
-    #if defined(LS_X86_AVX2)
-        (void)numVaryings;
-
-        const float* LS_RESTRICT_PTR i0 = reinterpret_cast<const float*>(inVaryings0);
-        const float* LS_RESTRICT_PTR i1 = reinterpret_cast<const float*>(inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS);
-        const float* LS_RESTRICT_PTR i2 = reinterpret_cast<const float*>(inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS * 2);
-        float* const LS_RESTRICT_PTR o = reinterpret_cast<float*>(outVaryings);
-
-        __m256 a, c, v0, v2;
-
-        a = _mm256_load_ps(i0 + 0);
-        c = _mm256_load_ps(i0 + 8);
-        const __m256 bc0 = _mm256_broadcast_ss(baryCoords+0);
-        v0 = _mm256_mul_ps(bc0, a);
-        v2 = _mm256_mul_ps(bc0, c);
-
-        a = _mm256_load_ps(i1 + 0);
-        c = _mm256_load_ps(i1 + 8);
-        const __m256 bc1 = _mm256_broadcast_ss(baryCoords+1);
-        v0 = _mm256_fmadd_ps(bc1, a, v0);
-        v2 = _mm256_fmadd_ps(bc1, c, v2);
+    #if defined(LS_X86_SSE)
+        const math::vec4* LS_RESTRICT_PTR inVaryings1 = inVaryings0 + numVaryings;
+        const math::vec4* LS_RESTRICT_PTR inVaryings2 = inVaryings0 + numVaryings * 2;
 
-        a = _mm256_load_ps(i2 + 0);
-        c = _mm256_load_ps(i2 + 8);
-        const __m256 bc2 = _mm256_broadcast_ss(baryCoords+2);
-        v0 = _mm256_fmadd_ps(bc2, a, v0);
-        v2 = _mm256_fmadd_ps(bc2, c, v2);
-
-        _mm256_store_ps(o + 0,  v0);
-        _mm256_store_ps(o + 8,  v2);
-        _mm256_zeroupper();
-
-    #elif defined(LS_X86_SSE)
-        (void)numVaryings;
+        const __m128 bc0 = _mm_load1_ps(baryCoords+0);
+        const __m128 bc1 = _mm_load1_ps(baryCoords+1);
+        const __m128 bc2 = _mm_load1_ps(baryCoords+2);
 
-        const float* LS_RESTRICT_PTR i0 = reinterpret_cast<const float*>(inVaryings0);
-        const float* LS_RESTRICT_PTR i1 = reinterpret_cast<const float*>(inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS);
-        const float* LS_RESTRICT_PTR i2 = reinterpret_cast<const float*>(inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS * 2);
         float* const LS_RESTRICT_PTR o = reinterpret_cast<float*>(outVaryings);
 
-        __m128 a, b, c, d, v0, v1, v2, v3;
+        // Varyings are tightly packed per-vertex, only load what's been used
+        for (uint_fast32_t i = 0; i < numVaryings; ++i)
+        {
+            const __m128 a = _mm_load_ps(reinterpret_cast<const float*>(inVaryings0+i));
+            const __m128 b = _mm_load_ps(reinterpret_cast<const float*>(inVaryings1+i));
+            const __m128 c = _mm_load_ps(reinterpret_cast<const float*>(inVaryings2+i));
 
-        a = _mm_load_ps(i0 + 0);
-        b = _mm_load_ps(i0 + 4);
-        c = _mm_load_ps(i0 + 8);
-        d = _mm_load_ps(i0 + 12);
-        const __m128 bc0 = _mm_load1_ps(baryCoords+0);
-        v0 = _mm_mul_ps(bc0, a);
-        v1 = _mm_mul_ps(bc0, b);
-        v2 = _mm_mul_ps(bc0, c);
-        v3 = _mm_mul_ps(bc0, d);
-
-        a = _mm_load_ps(i1 + 0);
-        b = _mm_load_ps(i1 + 4);
-        c = _mm_load_ps(i1 + 8);
-        d = _mm_load_ps(i1 + 12);
-        const __m128 bc1 = _mm_load1_ps(baryCoords+1);
-        v0 = _mm_add_ps(_mm_mul_ps(bc1, a), v0);
-        v1 = _mm_add_ps(_mm_mul_ps(bc1, b), v1);
-        v2 = _mm_add_ps(_mm_mul_ps(bc1, c), v2);
-        v3 = _mm_add_ps(_mm_mul_ps(bc1, d), v3);
-
-        a = _mm_load_ps(i2 + 0);
-        b = _mm_load_ps(i2 + 4);
-        c = _mm_load_ps(i2 + 8);
-        d = _mm_load_ps(i2 + 12);
-        const __m128 bc2 = _mm_load1_ps(baryCoords+2);
-        v0 = _mm_add_ps(_mm_mul_ps(bc2, a), v0);
-        v1 = _mm_add_ps(_mm_mul_ps(bc2, b), v1);
-        v2 = _mm_add_ps(_mm_mul_ps(bc2, c), v2);
-        v3 = _mm_add_ps(_mm_mul_ps(bc2, d), v3);
+            #if defined(LS_X86_FMA)
+                const __m128 v = _mm_fmadd_ps(bc2, c, _mm_fmadd_ps(bc1, b, _mm_mul_ps(bc0, a)));
+            #else
+                const __m128 v = _mm_add_ps(_mm_mul_ps(bc2, c), _mm_add_ps(_mm_mul_ps(bc1, b), _mm_mul_ps(bc0, a)));
+            #endif
 
-        _mm_store_ps(o + 0,  v0);
-        _mm_store_ps(o + 4,  v1);
-        _mm_store_ps(o + 8,  v2);
-        _mm_store_ps(o + 12, v3);
+            _mm_store_ps(o + i*4u, v);
+        }
 
     #elif defined(LS_ARCH_AARCH64)
-        const math::vec4* LS_RESTRICT_PTR inVaryings1 = inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS;
-        const math::vec4* LS_RESTRICT_PTR inVaryings2 = inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS * 2;
+        const math::vec4* LS_RESTRICT_PTR inVaryings1 = inVaryings0 + numVaryings;
+        const math::vec4* LS_RESTRICT_PTR inVaryings2 = inVaryings0 + numVaryings * 2;
 
         const float32x4_t bc  = vld1q_f32(baryCoords);
         float32x4_t v0, v1, v2;
@@ -274,8 +200,8 @@ inline void LS_IMPERATIVE interpolate_tri_varyings(
         }
 
     #elif defined(LS_ARM_NEON)
-        const math::vec4* LS_RESTRICT_PTR inVaryings1 = inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS;
-        const math::vec4* LS_RESTRICT_PTR inVaryings2 = inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS * 2;
+        const math::vec4* LS_RESTRICT_PTR inVaryings1 = inVaryings0 + numVaryings;
+        const math::vec4* LS_RESTRICT_PTR inVaryings2 = inVaryings0 + numVaryings * 2;
 
         const float32x4_t bc  = vld1q_f32(baryCoords);
         const float32x4_t bc0 = vdupq_n_f32(vgetq_lane_f32(bc, 0));
@@ -313,8 +239,8 @@ inline void LS_IMPERATIVE interpolate_tri_varyings(
         }
 
     #else
-        const math::vec4* LS_RESTRICT_PTR inVaryings1 = inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS;
-        const math::vec4* LS_RESTRICT_PTR inVaryings2 = inVaryings0 + SL_SHADER_MAX_VARYING_VECTORS * 2;
+        const math::vec4* LS_RESTRICT_PTR inVaryings1 = inVaryings0 + numVaryings;
+        const math::vec4* LS_RESTRICT_PTR inVaryings2 = inVaryings0 + numVaryings * 2;
 
         const float bc0 = baryCoords[0];
         const float bc1 = baryCoords[1];
@@ -332,6 +258,171 @@ inline void LS_IMPERATIVE interpolate_tri_varyings(
 
 
 
+/*--------------------------------------
+ * Interpolate varying variables across a batch of triangle fragments
+--------------------------------------*/
+inline void LS_IMPERATIVE interpolate_tri_varyings_batch(
+    const math::vec4* LS_RESTRICT_PTR baryCoords,
+    uint_fast32_t           numFrags,
+    uint_fast32_t           numVaryings,
+    const math::vec4*       inVaryings0,
+    SL_FragmentBatchParam&  outParams) noexcept
+{
+    constexpr uint_fast32_t numLanes = SL_SHADER_FRAG_BATCH_SIZE;
+
+    const float* LS_RESTRICT_PTR i0 = reinterpret_cast<const float*>(inVaryings0);
+    const float* LS_RESTRICT_PTR i1 = reinterpret_cast<const float*>(inVaryings0 + numVaryings);
+    const float* LS_RESTRICT_PTR i2 = reinterpret_cast<const float*>(inVaryings0 + numVaryings * 2);
+
+    // Transpose barycentric coordinates into SoA form. Unused lanes reuse the
+    // last valid fragment to avoid shading garbage data.
+    alignas(sizeof(float)*numLanes) float bc0[numLanes];
+    alignas(sizeof(float)*numLanes) float bc1[numLanes];
+    alignas(sizeof(float)*numLanes) float bc2[numLanes];
+
+    for (uint_fast32_t l = 0; l < numLanes; ++l)
+    {
+        const math::vec4& bc = baryCoords[l < numFrags ? l : (numFrags-1)];
+        bc0[l] = bc[0];
+        bc1[l] = bc[1];
+        bc2[l] = bc[2];
+    }
+
+    #if defined(LS_X86_AVX2) && (SL_FRAGMENT_BATCH_SIZE == 8)
+        const __m256 b0 = _mm256_load_ps(bc0);
+        const __m256 b1 = _mm256_load_ps(bc1);
+        const __m256 b2 = _mm256_load_ps(bc2);
+
+        for (uint_fast32_t i = 0; i < numVaryings*4u; ++i)
+        {
+            __m256 v = _mm256_mul_ps(b0, _mm256_broadcast_ss(i0+i));
+            v = _mm256_fmadd_ps(b1, _mm256_broadcast_ss(i1+i), v);
+            v = _mm256_fmadd_ps(b2, _mm256_broadcast_ss(i2+i), v);
+            _mm256_store_ps(outParams.pVaryings[i/4u][i%4u], v);
+        }
+
+        _mm256_zeroupper();
+
+    #elif defined(LS_X86_SSE)
+        for (uint_fast32_t l = 0; l < numLanes; l += 4)
+        {
+            const __m128 b0 = _mm_load_ps(bc0+l);
+            const __m128 b1 = _mm_load_ps(bc1+l);
+            const __m128 b2 = _mm_load_ps(bc2+l);
+
+            for (uint_fast32_t i = 0; i < numVaryings*4u; ++i)
+            {
+                __m128 v = _mm_mul_ps(b0, _mm_load1_ps(i0+i));
+                v = _mm_add_ps(_mm_mul_ps(b1, _mm_load1_ps(i1+i)), v);
+                v = _mm_add_ps(_mm_mul_ps(b2, _mm_load1_ps(i2+i)), v);
+                _mm_store_ps(outParams.pVaryings[i/4u][i%4u]+l, v);
+            }
+        }
+
+    #elif defined(LS_ARM_NEON)
+        for (uint_fast32_t l = 0; l < numLanes; l += 4)
+        {
+            const float32x4_t b0 = vld1q_f32(bc0+l);
+            const float32x4_t b1 = vld1q_f32(bc1+l);
+            const float32x4_t b2 = vld1q_f32(bc2+l);
+
+            for (uint_fast32_t i = 0; i < numVaryings*4u; ++i)
+            {
+                float32x4_t v = vmulq_n_f32(b0, i0[i]);
+                v = vmlaq_n_f32(v, b1, i1[i]);
+                v = vmlaq_n_f32(v, b2, i2[i]);
+                vst1q_f32(outParams.pVaryings[i/4u][i%4u]+l, v);
+            }
+        }
+
+    #else
+        for (uint_fast32_t i = 0; i < numVaryings*4u; ++i)
+        {
+            const float a = i0[i];
+            const float b = i1[i];
+            const float c = i2[i];
+            float* const LS_RESTRICT_PTR o = outParams.pVaryings[i/4u][i%4u];
+
+            for (uint_fast32_t l = 0; l < numLanes; ++l)
+            {
+                o[l] = bc0[l]*a + bc1[l]*b + bc2[l]*c;
+            }
+        }
+    #endif
+}
+
+
+
+/*--------------------------------------
+ * Apply perspective correction to the barycentric coordinates of queued
+ * triangle fragments
+--------------------------------------*/
+inline void LS_IMPERATIVE perspective_correct_tri_fragments(
+    const math::vec4* pPoints,
+    uint_fast32_t     numQueuedFrags,
+    SL_FragCoord*     outCoords) noexcept
+{
+    #if defined(LS_X86_AVX)
+        #if defined(LS_X86_AVX2)
+            const __m256 mask       = _mm256_castsi256_ps(_mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1));
+            const __m256i idx       = _mm256_set_epi32(-1, 11, 7, 3, -1, 11, 7, 3);
+            const __m256 homogenous = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), reinterpret_cast<const float*>(pPoints), idx, mask, sizeof(float));
+        #else
+            const __m256 homogenous = _mm256_set_ps(0.f, pPoints[2][3], pPoints[1][3], pPoints[0][3], 0.f, pPoints[2][3], pPoints[1][3], pPoints[0][3]);
+        #endif
+
+        for (uint_fast32_t i = 0; i < numQueuedFrags; i += 2)
+        {
+            float* const pBc = reinterpret_cast<float*>(outCoords->bc + i);
+            const __m256 bc = _mm256_mul_ps(_mm256_load_ps(pBc), homogenous);
+
+            // horizontal add
+            const __m256 a     = _mm256_permute_ps(bc, 0xB1);
+            const __m256 b     = _mm256_add_ps(bc, a);
+            const __m256 c     = _mm256_permute_ps(b, 0x0F);
+            const __m256 d     = _mm256_add_ps(c, b);
+            const __m256 persp = _mm256_rcp_ps(d);
+
+            _mm256_store_ps(pBc, _mm256_mul_ps(bc, persp));
+        }
+
+    #elif defined(LS_ARM_NEON)
+        const float32x4_t homogenous = vld4q_f32(reinterpret_cast<const float*>(pPoints)).val[3];
+
+        for (uint_fast32_t i = 0; i < numQueuedFrags; ++i)
+        {
+            float* const pBc = reinterpret_cast<float*>(outCoords->bc + i);
+            const float32x4_t bc = vmulq_f32(vld1q_f32(pBc), homogenous);
+
+            // horizontal add
+            #if defined(LS_ARCH_AARCH64)
+                const float32x4_t a = vdupq_n_f32(vaddvq_f32(bc));
+                vst1q_f32(pBc, vdivq_f32(bc, a));
+            #else
+                const float32x4_t a     = vrev64q_f32(bc);
+                const float32x4_t b     = vaddq_f32(bc, a);
+                const float32x2_t c     = vdup_lane_f32(vget_high_f32(b), 3);
+                const float32x2_t d     = vadd_f32(vget_low_f32(b), c);
+                const float32x4_t e     = vdupq_lane_f32(d, 0);
+                const float32x4_t f     = vrecpeq_f32(e);
+                const float32x4_t persp = vmulq_f32(vrecpsq_f32(e, f), f);
+                vst1q_f32(pBc, vmulq_f32(bc, persp));
+            #endif
+        }
+
+    #else
+        const math::vec4 homogenous{pPoints[0][3], pPoints[1][3], pPoints[2][3], 0.f};
+        for (uint_fast32_t i = 0; i < numQueuedFrags; ++i)
+        {
+            const math::vec4&& bc = outCoords->bc[i] * homogenous;
+            const math::vec4&& persp = {math::sum_inv(bc)};
+            outCoords->bc[i] = bc * persp;
+        }
+    #endif
+}
+
+
+
 } // end anonymous namespace
 
 
@@ -432,66 +523,14 @@ void SL_FragmentProcessor::flush_tri_fragments(
     SL_FragmentParam        fragParams;
 
     fragParams.pUniforms = pUniforms;
-    const math::vec4* pPoints = bin.mScreenCoords;
 
-    // perspective correction
-    #if defined(LS_X86_AVX)
-        #if defined(LS_X86_AVX2)
-            const __m256 mask       = _mm256_castsi256_ps(_mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1));
-            const __m256i idx       = _mm256_set_epi32(-1, 11, 7, 3, -1, 11, 7, 3);
-            const __m256 homogenous = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), reinterpret_cast<const float*>(pPoints), idx, mask, sizeof(float));
-        #else
-            const __m256 homogenous = _mm256_set_ps(0.f, pPoints[2][3], pPoints[1][3], pPoints[0][3], 0.f, pPoints[2][3], pPoints[1][3], pPoints[0][3]);
-        #endif
-
-        for (uint_fast32_t i = 0; i < numQueuedFrags; i += 2)
-        {
-            float* const pBc = reinterpret_cast<float*>(outCoords->bc + i);
-            const __m256 bc = _mm256_mul_ps(_mm256_load_ps(pBc), homogenous);
-
-            // horizontal add
-            const __m256 a     = _mm256_permute_ps(bc, 0xB1);
-            const __m256 b     = _mm256_add_ps(bc, a);
-            const __m256 c     = _mm256_permute_ps(b, 0x0F);
-            const __m256 d     = _mm256_add_ps(c, b);
-            const __m256 persp = _mm256_rcp_ps(d);
+    perspective_correct_tri_fragments(bin.mScreenCoords, numQueuedFrags, outCoords);
 
-            _mm256_store_ps(pBc, _mm256_mul_ps(bc, persp));
-        }
-
-    #elif defined(LS_ARM_NEON)
-        const float32x4_t homogenous = vld4q_f32(reinterpret_cast<const float*>(pPoints)).val[3];
-
-        for (uint_fast32_t i = 0; i < numQueuedFrags; ++i)
-        {
-            float* const pBc = reinterpret_cast<float*>(outCoords->bc + i);
-            const float32x4_t bc = vmulq_f32(vld1q_f32(pBc), homogenous);
-
-            // horizontal add
-            #if defined(LS_ARCH_AARCH64)
-                const float32x4_t a = vdupq_n_f32(vaddvq_f32(bc));
-                vst1q_f32(pBc, vdivq_f32(bc, a));
-            #else
-                const float32x4_t a     = vrev64q_f32(bc);
-                const float32x4_t b     = vaddq_f32(bc, a);
-                const float32x2_t c     = vdup_lane_f32(vget_high_f32(b), 3);
-                const float32x2_t d     = vadd_f32(vget_low_f32(b), c);
-                const float32x4_t e     = vdupq_lane_f32(d, 0);
-                const float32x4_t f     = vrecpeq_f32(e);
-                const float32x4_t persp = vmulq_f32(vrecpsq_f32(e, f), f);
-                vst1q_f32(pBc, vmulq_f32(bc, persp));
-            #endif
-        }
-
-    #else
-        const math::vec4 homogenous{pPoints[0][3], pPoints[1][3], pPoints[2][3], 0.f};
-        for (uint_fast32_t i = 0; i < numQueuedFrags; ++i)
-        {
-            const math::vec4&& bc = outCoords->bc[i] * homogenous;
-            const math::vec4&& persp = {math::sum_inv(bc)};
-            outCoords->bc[i] = bc * persp;
-        }
-    #endif
+    if (mShader->pFragBatchShader)
+    {
+        flush_tri_fragment_batches<depth_type>(bin, numQueuedFrags, outCoords);
+        return;
+    }
 
     for (uint_fast32_t i = 0; i < numQueuedFrags; ++i)
     {
@@ -535,3 +574,267 @@ void SL_FragmentProcessor::flush_tri_fragments(
 template void SL_FragmentProcessor::flush_tri_fragments<ls::math::half>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
 template void SL_FragmentProcessor::flush_tri_fragments<float>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
 template void SL_FragmentProcessor::flush_tri_fragments<double>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
+
+
+
+/*--------------------------------------
+ * Shade perspective-corrected triangle fragments in SIMD-sized batches
+--------------------------------------*/
+template <typename depth_type>
+void SL_FragmentProcessor::flush_tri_fragment_batches(
+    const SL_FragmentBin&     bin,
+    uint_fast32_t             numQueuedFrags,
+    const SL_FragCoord* const outCoords) const noexcept
+{
+    constexpr uint_fast32_t numLanes      = SL_SHADER_FRAG_BATCH_SIZE;
+    const SL_PipelineState  pipeline      = mShader->pipelineState;
+    const SL_BlendMode      blendMode     = pipeline.blend_mode();
+    const SL_FboOutputMask  fboOutMask    = sl_calc_fbo_out_mask((unsigned)pipeline.num_render_targets(), (blendMode != SL_BLEND_OFF));
+    const uint32_t          numVaryings   = (unsigned)pipeline.num_varyings();
+    const uint32_t          numOutputs    = (unsigned)pipeline.num_render_targets();
+    const int_fast32_t      haveDepthMask = pipeline.depth_mask() == SL_DEPTH_MASK_ON;
+    const auto              batchShader   = mShader->pFragBatchShader;
+    SL_FboOutputFunctions&  fboOutFuncs   = *mFragFuncs;
+    SL_TextureView* const   pColorBufs    = fboOutFuncs.pColorAttachments;
+    SL_TextureView&         pDepthBuf     = *fboOutFuncs.pDepthAttachment;
+    const auto* const       pColorFuncs   = fboOutFuncs.pOutFunc;
+    const auto* const       pBlendFuncs   = fboOutFuncs.pOutBlendedFunc;
+    math::vec4              outputs[SL_SHADER_MAX_FRAG_OUTPUTS];
+    SL_FragmentBatchParam   batchParams;
+
+    batchParams.pUniforms = mShader->pUniforms;
+
+    for (uint_fast32_t i = 0; i < numQueuedFrags; i += numLanes)
+    {
+        const uint_fast32_t numFrags = math::min<uint_fast32_t>(numLanes, numQueuedFrags - i);
+
+        interpolate_tri_varyings_batch(outCoords->bc + i, numFrags, numVaryings, bin.mVaryings, batchParams);
+
+        for (uint_fast32_t l = 0; l < numLanes; ++l)
+        {
+            const SL_FragCoordXYZ& coord = outCoords->coord[i + (l < numFrags ? l : (numFrags-1))];
+            batchParams.x[l]     = coord.x;
+            batchParams.y[l]     = coord.y;
+            batchParams.depth[l] = coord.depth;
+        }
+
+        batchParams.laneMask = (1u << numFrags) - 1u;
+
+        const uint32_t outMask = batchShader(batchParams) & batchParams.laneMask;
+
+        for (uint_fast32_t l = 0; l < numFrags; ++l)
+        {
+            const uint16_t x = (uint16_t)batchParams.x[l];
+            const uint16_t y = (uint16_t)batchParams.y[l];
+
+            if (LS_LIKELY(outMask & (1u << l)))
+            {
+                for (uint_fast32_t t = 0; t < numOutputs; ++t)
+                {
+                    outputs[t] = math::vec4{
+                        batchParams.pOutputs[t][0][l],
+                        batchParams.pOutputs[t][1][l],
+                        batchParams.pOutputs[t][2][l],
+                        batchParams.pOutputs[t][3][l]
+                    };
+                }
+
+                switch (fboOutMask)
+                {
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2_3: (*pBlendFuncs[3])(x, y, outputs[3], pColorBufs[3], blendMode);
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2:   (*pBlendFuncs[2])(x, y, outputs[2], pColorBufs[2], blendMode);
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1:     (*pBlendFuncs[1])(x, y, outputs[1], pColorBufs[1], blendMode);
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0:       (*pBlendFuncs[0])(x, y, outputs[0], pColorBufs[0], blendMode);
+                        break;
+
+                    case SL_FBO_OUTPUT_ATTACHMENT_0_1_2_3: (*pColorFuncs[3])(x, y, outputs[3], pColorBufs[3]);
+                    case SL_FBO_OUTPUT_ATTACHMENT_0_1_2:   (*pColorFuncs[2])(x, y, outputs[2], pColorBufs[2]);
+                    case SL_FBO_OUTPUT_ATTACHMENT_0_1:     (*pColorFuncs[1])(x, y, outputs[1], pColorBufs[1]);
+                    case SL_FBO_OUTPUT_ATTACHMENT_0:       (*pColorFuncs[0])(x, y, outputs[0], pColorBufs[0]);
+                        break;
+
+                    default:
+                        LS_UNREACHABLE();
+                }
+            }
+
+            if (LS_LIKELY(haveDepthMask))
+            {
+                ((depth_type*)pDepthBuf.pTexels)[x + pDepthBuf.width * y] = (depth_type)batchParams.depth[l];
+            }
+        }
+    }
+}
+
+
+
+template void SL_FragmentProcessor::flush_tri_fragment_batches<ls::math::half>(const SL_FragmentBin&, uint_fast32_t, const SL_FragCoord* const) const noexcept;
+template void SL_FragmentProcessor::flush_tri_fragment_batches<float>(const SL_FragmentBin&, uint_fast32_t, const SL_FragCoord* const) const noexcept;
+template void SL_FragmentProcessor::flush_tri_fragment_batches<double>(const SL_FragmentBin&, uint_fast32_t, const SL_FragCoord* const) const noexcept;
+
+
+
+/*--------------------------------------
+ * Shade triangle fragments in 2x2 quads
+--------------------------------------*/
+template <typename depth_type>
+void SL_FragmentProcessor::flush_tri_quads(
+    const SL_FragmentBin& bin,
+    uint_fast32_t         numQueuedFrags,
+    SL_FragCoord* const   outCoords) const noexcept
+{
+    const SL_PipelineState  pipeline      = mShader->pipelineState;
+    const SL_BlendMode      blendMode     = pipeline.blend_mode();
+    const SL_FboOutputMask  fboOutMask    = sl_calc_fbo_out_mask((unsigned)pipeline.num_render_targets(), (blendMode != SL_BLEND_OFF));
+    const uint32_t          numVaryings   = (unsigned)pipeline.num_varyings();
+    const int_fast32_t      haveDepthMask = pipeline.depth_mask() == SL_DEPTH_MASK_ON;
+    const auto              quadShader    = mShader->pFragQuadShader;
+    SL_FboOutputFunctions&  fboOutFuncs   = *mFragFuncs;
+    SL_TextureView* const   pColorBufs    = fboOutFuncs.pColorAttachments;
+    SL_TextureView&         pDepthBuf     = *fboOutFuncs.pDepthAttachment;
+    const auto* const       pColorFuncs   = fboOutFuncs.pOutFunc;
+    const auto* const       pBlendFuncs   = fboOutFuncs.pOutBlendedFunc;
+    SL_FragmentQuadParam    quadParams;
+
+    quadParams.pUniforms = mShader->pUniforms;
+
+    // Helper lanes are perspective-corrected as well so derivatives remain
+    // continuous across triangle edges.
+    perspective_correct_tri_fragments(bin.mScreenCoords, numQueuedFrags, outCoords);
+
+    for (uint_fast32_t i = 0; i < numQueuedFrags; i += 4)
+    {
+        for (uint_fast32_t l = 0; l < 4; ++l)
+        {
+            interpolate_tri_varyings(&outCoords->bc[i+l], numVaryings, bin.mVaryings, quadParams.pVaryings[l]);
+            quadParams.coord[l] = outCoords->coord[i+l];
+        }
+
+        quadParams.laneMask = outCoords->quadMask[i >> 2];
+
+        const uint32_t outMask = quadShader(quadParams) & quadParams.laneMask;
+
+        for (uint_fast32_t l = 0; l < 4; ++l)
+        {
+            if (!(quadParams.laneMask & (1u << l)))
+            {
+                continue;
+            }
+
+            const uint16_t    x        = quadParams.coord[l].x;
+            const uint16_t    y        = quadParams.coord[l].y;
+            const math::vec4* pOutputs = quadParams.pOutputs[l];
+
+            if (LS_LIKELY(outMask & (1u << l)))
+            {
+                switch (fboOutMask)
+                {
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2_3: (*pBlendFuncs[3])(x, y, pOutputs[3], pColorBufs[3], blendMode);
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1_2:   (*pBlendFuncs[2])(x, y, pOutputs[2], pColorBufs[2], blendMode);
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0_1:     (*pBlendFuncs[1])(x, y, pOutputs[1], pColorBufs[1], blendMode);
+                    case SL_FBO_OUTPUT_ALPHA_ATTACHMENT_0:       (*pBlendFuncs[0])(x, y, pOutputs[0], pColorBufs[0], blendMode);
+                        break;
+
+                    case SL_FBO_OUTPUT_ATTACHMENT_0_1_2_3: (*pColorFuncs[3])(x, y, pOutputs[3], pColorBufs[3]);
+                    case SL_FBO_OUTPUT_ATTACHMENT_0_1_2:   (*pColorFuncs[2])(x, y, pOutputs[2], pColorBufs[2]);
+                    case SL_FBO_OUTPUT_ATTACHMENT_0_1:     (*pColorFuncs[1])(x, y, pOutputs[1], pColorBufs[1]);
+                    case SL_FBO_OUTPUT_ATTACHMENT_0:       (*pColorFuncs[0])(x, y, pOutputs[0], pColorBufs[0]);
+                        break;
+
+                    default:
+                        LS_UNREACHABLE();
+                }
+            }
+
+            if (LS_LIKELY(haveDepthMask))
+            {
+                ((depth_type*)pDepthBuf.pTexels)[x + pDepthBuf.width * y] = (depth_type)quadParams.coord[l].depth;
+            }
+        }
+    }
+}
+
+
+
+template void SL_FragmentProcessor::flush_tri_quads<ls::math::half>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
+template void SL_FragmentProcessor::flush_tri_quads<float>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
+template void SL_FragmentProcessor::flush_tri_quads<double>(const SL_FragmentBin&, uint_fast32_t, SL_FragCoord* const) const noexcept;
+
+
+
+/*--------------------------------------
+ * Shade multisampled triangle fragments once per pixel, writing the result
+ * into every covered sample.
+--------------------------------------*/
+void SL_FragmentProcessor::flush_tri_samples(
+    const SL_FragmentBin& bin,
+    uint_fast32_t         numQueuedFrags,
+    SL_FragCoord* const   outCoords) const noexcept
+{
+    const SL_PipelineState  pipeline     = mShader->pipelineState;
+    const SL_BlendMode      blendMode    = pipeline.blend_mode();
+    const uint32_t          numVaryings  = (unsigned)pipeline.num_varyings();
+    const uint32_t          numOutputs   = (unsigned)pipeline.num_render_targets();
+    const auto              fragShader   = mShader->pFragShader;
+    SL_FboOutputFunctions&  fboOutFuncs  = *mFragFuncs;
+    SL_TextureView* const   pColorBufs   = fboOutFuncs.pColorAttachments;
+    const uint32_t          numSamples   = fboOutFuncs.numSamples;
+    const auto* const       pColorFuncs  = fboOutFuncs.pOutFunc;
+    const auto* const       pBlendFuncs  = fboOutFuncs.pOutBlendedFunc;
+    SL_FragmentParam        fragParams;
+
+    // Views of each sample layer, allowing the regular output functions to
+    // write individual samples.
+    SL_TextureView sampleBufs[SL_FboLimits::SL_FBO_MAX_SAMPLES][SL_FboLimits::SL_FBO_MAX_COLOR_ATTACHMENTS];
+
+    for (uint32_t t = 0; t < numOutputs; ++t)
+    {
+        const size_t layerBytes = (size_t)pColorBufs[t].width * (size_t)pColorBufs[t].height * (size_t)pColorBufs[t].bytesPerTexel;
+
+        for (uint32_t s = 0; s < numSamples; ++s)
+        {
+            sampleBufs[s][t] = pColorBufs[t];
+            sampleBufs[s][t].pTexels += layerBytes * s;
+            sampleBufs[s][t].depth = 1;
+        }
+    }
+
+    fragParams.pUniforms = mShader->pUniforms;
+
+    perspective_correct_tri_fragments(bin.mScreenCoords, numQueuedFrags, outCoords);
+
+    for (uint_fast32_t i = 0; i < numQueuedFrags; ++i)
+    {
+        interpolate_tri_varyings(&outCoords->bc[i], numVaryings, bin.mVaryings, fragParams.pVaryings);
+        fragParams.coord = outCoords->coord[i];
+
+        if (LS_UNLIKELY(!fragShader(fragParams)))
+        {
+            continue;
+        }
+
+        const uint16_t x          = fragParams.coord.x;
+        const uint16_t y          = fragParams.coord.y;
+        const uint32_t sampleMask = outCoords->sampleMask[i];
+
+        for (uint32_t s = 0; s < numSamples; ++s)
+        {
+            if (!(sampleMask & (1u << s)))
+            {
+                continue;
+            }
+
+            for (uint32_t t = 0; t < numOutputs; ++t)
+            {
+                if (blendMode != SL_BLEND_OFF)
+                {
+                    (*pBlendFuncs[t])(x, y, fragParams.pOutputs[t], sampleBufs[s][t], blendMode);
+                }
+                else
+                {
+                    (*pColorFuncs[t])(x, y, fragParams.pOutputs[t], sampleBufs[s][t]);
+                }
+            }
+        }
+    }
+}
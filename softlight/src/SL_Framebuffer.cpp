@@ -1,4 +1,6 @@
 
+#include <utility> // std::move()
+
 #include "lightsky/setup/Compiler.h" // LS_COMPILER_MSC
 
 #include "lightsky/math/vec_utils.h" // vector casting
@@ -712,7 +714,9 @@ SL_Framebuffer::~SL_Framebuffer() noexcept
 SL_Framebuffer::SL_Framebuffer() noexcept :
     mNumColors{0},
     mColors{},
-    mDepth{}
+    mDepth{},
+    mDepthHiZ{},
+    mFastClear{}
 {
     terminate();
 }
@@ -732,6 +736,8 @@ SL_Framebuffer::SL_Framebuffer(const SL_Framebuffer& f) noexcept
     }
 
     mDepth = f.mDepth;
+    mDepthHiZ = f.mDepthHiZ;
+    mFastClear = f.mFastClear;
 }
 
 
@@ -752,6 +758,9 @@ SL_Framebuffer::SL_Framebuffer(SL_Framebuffer&& f) noexcept
 
     mDepth = f.mDepth;
     sl_reset(f.mDepth);
+
+    mDepthHiZ = std::move(f.mDepthHiZ);
+    mFastClear = std::move(f.mFastClear);
 }
 
 
@@ -779,6 +788,8 @@ SL_Framebuffer& SL_Framebuffer::operator=(const SL_Framebuffer& f) noexcept
     }
 
     mDepth = f.mDepth;
+    mDepthHiZ = f.mDepthHiZ;
+    mFastClear = f.mFastClear;
 
     return *this;
 }
@@ -812,6 +823,9 @@ SL_Framebuffer& SL_Framebuffer::operator=(SL_Framebuffer&& f) noexcept
     mDepth = f.mDepth;
     sl_reset(f.mDepth);
 
+    mDepthHiZ = std::move(f.mDepthHiZ);
+    mFastClear = std::move(f.mFastClear);
+
     return *this;
 }
 
@@ -837,12 +851,15 @@ int SL_Framebuffer::reserve_color_buffers(unsigned numColorBuffers) noexcept
         return -2;
     }
 
+    resolve_fast_clears();
+
     for (unsigned i = 0; i < (unsigned)SL_FboLimits::SL_FBO_MAX_COLOR_ATTACHMENTS; ++i)
     {
         sl_reset(mColors[i]);
     }
 
     mNumColors = numColorBuffers;
+    realloc_fast_clears();
 
     return 0;
 }
@@ -859,7 +876,15 @@ int SL_Framebuffer::attach_color_buffer(unsigned index, SL_TextureView& t) noexc
         return -1;
     }
 
+    // Block-compressed textures can't be rendered to
+    if (sl_is_block_compressed_color(t.type))
+    {
+        return -2;
+    }
+
+    resolve_fast_clears();
     mColors[index] = t;
+    realloc_fast_clears();
 
     return 0;
 }
@@ -876,7 +901,9 @@ int SL_Framebuffer::detach_color_buffer(unsigned index) noexcept
         return -1;
     }
 
+    resolve_fast_clears();
     sl_reset(mColors[index]);
+    realloc_fast_clears();
 
     return 0;
 }
@@ -907,7 +934,27 @@ void SL_Framebuffer::clear_color_buffers() noexcept
 -------------------------------------*/
 int SL_Framebuffer::attach_depth_buffer(SL_TextureView& d) noexcept
 {
+    if (sl_is_block_compressed_color(d.type))
+    {
+        return -1;
+    }
+
+    resolve_fast_clears();
     mDepth = d;
+    realloc_fast_clears();
+
+    #if SL_HIZ_ENABLED
+        // Depth ranges are only tracked for single-sampled depth buffers
+        if (d.depth > 1)
+        {
+            mDepthHiZ.terminate();
+        }
+        else
+        {
+            mDepthHiZ.init(d.width, d.height);
+        }
+    #endif
+
     return 0;
 }
 
@@ -918,7 +965,10 @@ int SL_Framebuffer::attach_depth_buffer(SL_TextureView& d) noexcept
 -------------------------------------*/
 int SL_Framebuffer::detach_depth_buffer() noexcept
 {
+    resolve_fast_clears();
     sl_reset(mDepth);
+    mDepthHiZ.terminate();
+    realloc_fast_clears();
     return 0;
 }
 
@@ -976,7 +1026,8 @@ int SL_Framebuffer::valid() const noexcept
         return -8;
     }
 
-    if (mDepth.depth > 1)
+    // Multisampled attachments contain one layer per sample
+    if (mDepth.depth != 1 && mDepth.depth != 2 && mDepth.depth != (uint16_t)SL_FboLimits::SL_FBO_MAX_SAMPLES)
     {
         return -9;
     }
@@ -986,6 +1037,11 @@ int SL_Framebuffer::valid() const noexcept
         return -10;
     }
 
+    if (mDepth.depth > 1 && depth != mDepth.depth)
+    {
+        return -11;
+    }
+
     return 0;
 }
 
@@ -1002,6 +1058,103 @@ void SL_Framebuffer::terminate() noexcept
     }
 
     sl_reset(mDepth);
+    mDepthHiZ.terminate();
+    mFastClear.terminate();
+}
+
+
+
+/*-------------------------------------
+ * Resize the clear flags of each tile after attachments change
+-------------------------------------*/
+void SL_Framebuffer::realloc_fast_clears() noexcept
+{
+    if (mFastClear.valid())
+    {
+        mFastClear.init(width(), height());
+    }
+}
+
+
+
+/*-------------------------------------
+ * Enable or disable deferred clears. Disabling writes any pending clears.
+-------------------------------------*/
+int SL_Framebuffer::fast_clears(bool enabled) noexcept
+{
+    if (!enabled)
+    {
+        resolve_fast_clears();
+        mFastClear.terminate();
+        return 0;
+    }
+
+    if (mFastClear.valid())
+    {
+        return 0;
+    }
+
+    return mFastClear.init(width(), height());
+}
+
+
+
+/*-------------------------------------
+ * Defer clearing a color attachment
+-------------------------------------*/
+void SL_Framebuffer::fast_clear_color_buffer(unsigned index, const void* pColor) noexcept
+{
+    if (index < mNumColors && mColors[index].pTexels)
+    {
+        mFastClear.clear(index, pColor, mColors[index].bytesPerTexel);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Defer clearing the depth attachment. The depth hierarchy is reset
+ * immediately so rasterization remains conservative.
+-------------------------------------*/
+void SL_Framebuffer::fast_clear_depth_buffer(const void* pDepth) noexcept
+{
+    if (!mDepth.pTexels)
+    {
+        return;
+    }
+
+    switch (mDepth.bytesPerTexel)
+    {
+        case sizeof(ls::math::half):
+            mDepthHiZ.clear((float)*reinterpret_cast<const ls::math::half*>(pDepth));
+            break;
+
+        case sizeof(float):
+            mDepthHiZ.clear(*reinterpret_cast<const float*>(pDepth));
+            break;
+
+        case sizeof(double):
+            mDepthHiZ.clear((float)*reinterpret_cast<const double*>(pDepth));
+            break;
+
+        default:
+            return;
+    }
+
+    mFastClear.clear(SL_FAST_CLEAR_DEPTH_ATTACHMENT, pDepth, mDepth.bytesPerTexel);
+}
+
+
+
+/*-------------------------------------
+ * Write all pending clears on the current thread
+-------------------------------------*/
+void SL_Framebuffer::resolve_fast_clears() noexcept
+{
+    if (mFastClear.pending())
+    {
+        mFastClear.resolve(mColors, &mDepth);
+    }
 }
 
 
@@ -1209,6 +1362,9 @@ bool SL_Framebuffer::build_output_functions(SL_FboOutputFunctions& result, bool
     result.outputMask = (SL_FboOutputMask)(num_color_buffers() + (blendEnabled ? (unsigned)SL_FBO_OUTPUT_ATTACHMENT_0_1_2_3 : 0));
     result.pColorAttachments = mColors;
     result.pDepthAttachment = &mDepth;
+    result.pDepthHiZ = mDepthHiZ.valid() ? &mDepthHiZ : nullptr;
+    result.pFastClear = mFastClear.pending() ? &mFastClear : nullptr;
+    result.numSamples = (uint16_t)num_samples();
 
     if (!blendEnabled)
     {
@@ -0,0 +1,472 @@
+
+#include <limits> // std::numeric_limits
+#include <utility> // std::move()
+
+#include "lightsky/setup/Arch.h"
+#include "lightsky/setup/Macros.h" // LS_INLINE
+
+#include "lightsky/math/half.h"
+#include "lightsky/math/scalar_utils.h"
+
+#include "lightsky/utils/Copy.h"
+
+#include "softlight/SL_HiZBuffer.hpp"
+#include "softlight/SL_ShaderUtil.hpp" // sl_num_raster_tiles()
+#include "softlight/SL_Texture.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*--------------------------------------
+ * Number of 8x8 blocks along one axis of a raster tile
+--------------------------------------*/
+enum : int32_t
+{
+    _SL_HIZ_BLOCKS_PER_TILE = SL_RASTER_TILE_SIZE >> SL_HIZ_BLOCK_SHIFT
+};
+
+
+
+/*--------------------------------------
+ * Range which can never reject a primitive
+--------------------------------------*/
+inline LS_INLINE SL_DepthRange _sl_unbounded_depth_range() noexcept
+{
+    return SL_DepthRange{-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+}
+
+
+
+/*--------------------------------------
+ * Fill a subset of depth ranges with a single value
+--------------------------------------*/
+inline void _sl_fill_depth_ranges(SL_DepthRange* pRanges, size_t begin, size_t end, const SL_DepthRange& r) noexcept
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        pRanges[i] = r;
+    }
+}
+
+
+
+/*--------------------------------------
+ * Calculate the range of depth values within an 8x8 block
+--------------------------------------*/
+template <typename depth_type>
+inline SL_DepthRange _sl_calc_block_range(
+    const depth_type* pTexels,
+    int32_t width,
+    int32_t x0,
+    int32_t y0,
+    int32_t x1,
+    int32_t y1) noexcept
+{
+    float minDepth = std::numeric_limits<float>::infinity();
+    float maxDepth = -std::numeric_limits<float>::infinity();
+
+    for (int32_t y = y0; y < y1; ++y)
+    {
+        const depth_type* pRow = pTexels + width * y;
+
+        for (int32_t x = x0; x < x1; ++x)
+        {
+            const float d = (float)pRow[x];
+            minDepth = math::min(minDepth, d);
+            maxDepth = math::max(maxDepth, d);
+        }
+    }
+
+    return SL_DepthRange{minDepth, maxDepth};
+}
+
+
+
+#if defined(LS_X86_SSE)
+
+template <>
+inline SL_DepthRange _sl_calc_block_range<float>(
+    const float* pTexels,
+    int32_t width,
+    int32_t x0,
+    int32_t y0,
+    int32_t x1,
+    int32_t y1) noexcept
+{
+    if (x1 - x0 != SL_HIZ_BLOCK_SIZE)
+    {
+        float minDepth = std::numeric_limits<float>::infinity();
+        float maxDepth = -std::numeric_limits<float>::infinity();
+
+        for (int32_t y = y0; y < y1; ++y)
+        {
+            for (int32_t x = x0; x < x1; ++x)
+            {
+                minDepth = math::min(minDepth, pTexels[x + width * y]);
+                maxDepth = math::max(maxDepth, pTexels[x + width * y]);
+            }
+        }
+
+        return SL_DepthRange{minDepth, maxDepth};
+    }
+
+    __m128 minDepth = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    __m128 maxDepth = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+
+    for (int32_t y = y0; y < y1; ++y)
+    {
+        const float* pRow = pTexels + x0 + width * y;
+        const __m128 d0 = _mm_loadu_ps(pRow);
+        const __m128 d1 = _mm_loadu_ps(pRow + 4);
+
+        minDepth = _mm_min_ps(minDepth, _mm_min_ps(d0, d1));
+        maxDepth = _mm_max_ps(maxDepth, _mm_max_ps(d0, d1));
+    }
+
+    minDepth = _mm_min_ps(minDepth, _mm_shuffle_ps(minDepth, minDepth, 0x4E));
+    minDepth = _mm_min_ps(minDepth, _mm_shuffle_ps(minDepth, minDepth, 0xB1));
+    maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, 0x4E));
+    maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, 0xB1));
+
+    return SL_DepthRange{_mm_cvtss_f32(minDepth), _mm_cvtss_f32(maxDepth)};
+}
+
+#elif defined(LS_ARM_NEON)
+
+template <>
+inline SL_DepthRange _sl_calc_block_range<float>(
+    const float* pTexels,
+    int32_t width,
+    int32_t x0,
+    int32_t y0,
+    int32_t x1,
+    int32_t y1) noexcept
+{
+    if (x1 - x0 != SL_HIZ_BLOCK_SIZE)
+    {
+        float minDepth = std::numeric_limits<float>::infinity();
+        float maxDepth = -std::numeric_limits<float>::infinity();
+
+        for (int32_t y = y0; y < y1; ++y)
+        {
+            for (int32_t x = x0; x < x1; ++x)
+            {
+                minDepth = math::min(minDepth, pTexels[x + width * y]);
+                maxDepth = math::max(maxDepth, pTexels[x + width * y]);
+            }
+        }
+
+        return SL_DepthRange{minDepth, maxDepth};
+    }
+
+    float32x4_t minDepth = vdupq_n_f32(std::numeric_limits<float>::infinity());
+    float32x4_t maxDepth = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+
+    for (int32_t y = y0; y < y1; ++y)
+    {
+        const float* pRow = pTexels + x0 + width * y;
+        const float32x4_t d0 = vld1q_f32(pRow);
+        const float32x4_t d1 = vld1q_f32(pRow + 4);
+
+        minDepth = vminq_f32(minDepth, vminq_f32(d0, d1));
+        maxDepth = vmaxq_f32(maxDepth, vmaxq_f32(d0, d1));
+    }
+
+    float32x2_t minPair = vpmin_f32(vget_low_f32(minDepth), vget_high_f32(minDepth));
+    float32x2_t maxPair = vpmax_f32(vget_low_f32(maxDepth), vget_high_f32(maxDepth));
+    minPair = vpmin_f32(minPair, minPair);
+    maxPair = vpmax_f32(maxPair, maxPair);
+
+    return SL_DepthRange{vget_lane_f32(minPair, 0), vget_lane_f32(maxPair, 0)};
+}
+
+#endif
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_HiZBuffer Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_HiZBuffer::~SL_HiZBuffer() noexcept
+{
+    terminate();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_HiZBuffer::SL_HiZBuffer() noexcept :
+    mBlocksX{0},
+    mBlocksY{0},
+    mTilesX{0},
+    mTilesY{0},
+    mBlocks{nullptr},
+    mTiles{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Copy Constructor
+-------------------------------------*/
+SL_HiZBuffer::SL_HiZBuffer(const SL_HiZBuffer& h) noexcept :
+    SL_HiZBuffer{}
+{
+    *this = h;
+}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_HiZBuffer::SL_HiZBuffer(SL_HiZBuffer&& h) noexcept :
+    mBlocksX{h.mBlocksX},
+    mBlocksY{h.mBlocksY},
+    mTilesX{h.mTilesX},
+    mTilesY{h.mTilesY},
+    mBlocks{std::move(h.mBlocks)},
+    mTiles{std::move(h.mTiles)}
+{
+    h.mBlocksX = 0;
+    h.mBlocksY = 0;
+    h.mTilesX = 0;
+    h.mTilesY = 0;
+}
+
+
+
+/*-------------------------------------
+ * Copy Operator
+-------------------------------------*/
+SL_HiZBuffer& SL_HiZBuffer::operator=(const SL_HiZBuffer& h) noexcept
+{
+    if (this == &h)
+    {
+        return *this;
+    }
+
+    terminate();
+
+    if (h.valid())
+    {
+        const size_t numBlocks = (size_t)h.mBlocksX * (size_t)h.mBlocksY;
+        const size_t numTiles = (size_t)h.mTilesX * (size_t)h.mTilesY;
+
+        mBlocks = ls::utils::make_unique_aligned_array<SL_DepthRange>(numBlocks);
+        mTiles = ls::utils::make_unique_aligned_array<SL_DepthRange>(numTiles);
+
+        if (!mBlocks || !mTiles)
+        {
+            terminate();
+            return *this;
+        }
+
+        mBlocksX = h.mBlocksX;
+        mBlocksY = h.mBlocksY;
+        mTilesX = h.mTilesX;
+        mTilesY = h.mTilesY;
+
+        ls::utils::fast_memcpy(mBlocks.get(), h.mBlocks.get(), numBlocks * sizeof(SL_DepthRange));
+        ls::utils::fast_memcpy(mTiles.get(), h.mTiles.get(), numTiles * sizeof(SL_DepthRange));
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_HiZBuffer& SL_HiZBuffer::operator=(SL_HiZBuffer&& h) noexcept
+{
+    if (this != &h)
+    {
+        mBlocksX = h.mBlocksX;
+        h.mBlocksX = 0;
+
+        mBlocksY = h.mBlocksY;
+        h.mBlocksY = 0;
+
+        mTilesX = h.mTilesX;
+        h.mTilesX = 0;
+
+        mTilesY = h.mTilesY;
+        h.mTilesY = 0;
+
+        mBlocks = std::move(h.mBlocks);
+        mTiles = std::move(h.mTiles);
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Allocate ranges for a depth buffer. The contents of the depth buffer are
+ * unknown, so all ranges begin invalidated.
+-------------------------------------*/
+int SL_HiZBuffer::init(uint16_t width, uint16_t height) noexcept
+{
+    terminate();
+
+    if (!width || !height)
+    {
+        return -1;
+    }
+
+    const uint16_t blocksX = (uint16_t)((width + (SL_HIZ_BLOCK_SIZE-1)) >> SL_HIZ_BLOCK_SHIFT);
+    const uint16_t blocksY = (uint16_t)((height + (SL_HIZ_BLOCK_SIZE-1)) >> SL_HIZ_BLOCK_SHIFT);
+    const uint16_t tilesX = sl_num_raster_tiles<uint16_t>(width);
+    const uint16_t tilesY = sl_num_raster_tiles<uint16_t>(height);
+
+    mBlocks = ls::utils::make_unique_aligned_array<SL_DepthRange>((size_t)blocksX * (size_t)blocksY);
+    mTiles = ls::utils::make_unique_aligned_array<SL_DepthRange>((size_t)tilesX * (size_t)tilesY);
+
+    if (!mBlocks || !mTiles)
+    {
+        terminate();
+        return -2;
+    }
+
+    mBlocksX = blocksX;
+    mBlocksY = blocksY;
+    mTilesX = tilesX;
+    mTilesY = tilesY;
+
+    invalidate();
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Release all resources
+-------------------------------------*/
+void SL_HiZBuffer::terminate() noexcept
+{
+    mBlocksX = 0;
+    mBlocksY = 0;
+    mTilesX = 0;
+    mTilesY = 0;
+    mBlocks.reset();
+    mTiles.reset();
+}
+
+
+
+/*-------------------------------------
+ * Reset all ranges to a single depth value
+-------------------------------------*/
+void SL_HiZBuffer::clear(float depth) noexcept
+{
+    clear(depth, 1, 0);
+}
+
+
+
+/*-------------------------------------
+ * Reset a thread's partition of ranges to a single depth value
+-------------------------------------*/
+void SL_HiZBuffer::clear(float depth, uint16_t numThreads, uint16_t threadId) noexcept
+{
+    if (!valid())
+    {
+        return;
+    }
+
+    const SL_DepthRange r{depth, depth};
+    const size_t numBlocks = (size_t)mBlocksX * (size_t)mBlocksY;
+    const size_t numTiles = (size_t)mTilesX * (size_t)mTilesY;
+    const size_t blocksPerThread = (numBlocks + numThreads - 1) / numThreads;
+    const size_t tilesPerThread = (numTiles + numThreads - 1) / numThreads;
+
+    _sl_fill_depth_ranges(mBlocks.get(), math::min(numBlocks, blocksPerThread*threadId), math::min(numBlocks, blocksPerThread*(threadId+1u)), r);
+    _sl_fill_depth_ranges(mTiles.get(), math::min(numTiles, tilesPerThread*threadId), math::min(numTiles, tilesPerThread*(threadId+1u)), r);
+}
+
+
+
+/*-------------------------------------
+ * Disable rejection until ranges are updated again
+-------------------------------------*/
+void SL_HiZBuffer::invalidate() noexcept
+{
+    if (valid())
+    {
+        const SL_DepthRange r = _sl_unbounded_depth_range();
+        _sl_fill_depth_ranges(mBlocks.get(), 0, (size_t)mBlocksX * (size_t)mBlocksY, r);
+        _sl_fill_depth_ranges(mTiles.get(), 0, (size_t)mTilesX * (size_t)mTilesY, r);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Recalculate the modified blocks of a tile from its depth texels. Each bit
+ * of "dirtyBlocks" maps to a block in row-major order within the tile.
+-------------------------------------*/
+template <typename depth_type>
+void SL_HiZBuffer::update_tile(const SL_TextureView& depthBuffer, uint16_t tileX, uint16_t tileY, uint64_t dirtyBlocks) noexcept
+{
+    const depth_type* pTexels = reinterpret_cast<const depth_type*>(depthBuffer.pTexels);
+    const int32_t     width   = (int32_t)depthBuffer.width;
+    const int32_t     height  = (int32_t)depthBuffer.height;
+    const int32_t     bx0     = (int32_t)tileX * _SL_HIZ_BLOCKS_PER_TILE;
+    const int32_t     by0     = (int32_t)tileY * _SL_HIZ_BLOCKS_PER_TILE;
+    const int32_t     bx1     = math::min<int32_t>(bx0 + _SL_HIZ_BLOCKS_PER_TILE, mBlocksX);
+    const int32_t     by1     = math::min<int32_t>(by0 + _SL_HIZ_BLOCKS_PER_TILE, mBlocksY);
+
+    SL_DepthRange tileRange{std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+
+    for (int32_t by = by0; by < by1; ++by)
+    {
+        for (int32_t bx = bx0; bx < bx1; ++bx)
+        {
+            SL_DepthRange& r = mBlocks[bx + mBlocksX * by];
+            const uint64_t bit = 1ull << ((bx - bx0) + (by - by0) * _SL_HIZ_BLOCKS_PER_TILE);
+
+            if (dirtyBlocks & bit)
+            {
+                const int32_t x0 = bx << SL_HIZ_BLOCK_SHIFT;
+                const int32_t y0 = by << SL_HIZ_BLOCK_SHIFT;
+                const int32_t x1 = math::min<int32_t>(x0 + SL_HIZ_BLOCK_SIZE, width);
+                const int32_t y1 = math::min<int32_t>(y0 + SL_HIZ_BLOCK_SIZE, height);
+
+                r = _sl_calc_block_range<depth_type>(pTexels, width, x0, y0, x1, y1);
+            }
+
+            tileRange.minDepth = math::min(tileRange.minDepth, r.minDepth);
+            tileRange.maxDepth = math::max(tileRange.maxDepth, r.maxDepth);
+        }
+    }
+
+    mTiles[tileX + mTilesX * tileY] = tileRange;
+}
+
+
+
+template void SL_HiZBuffer::update_tile<ls::math::half>(const SL_TextureView&, uint16_t, uint16_t, uint64_t) noexcept;
+template void SL_HiZBuffer::update_tile<float>(const SL_TextureView&, uint16_t, uint16_t, uint64_t) noexcept;
+template void SL_HiZBuffer::update_tile<double>(const SL_TextureView&, uint16_t, uint16_t, uint64_t) noexcept;
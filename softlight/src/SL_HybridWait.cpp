@@ -0,0 +1,94 @@
+
+#include "softlight/SL_HybridWait.hpp"
+
+#if defined(LS_OS_LINUX)
+    #include <climits> // INT_MAX
+    #include <ctime> // timespec
+
+    #include <linux/futex.h> // FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+    #include <sys/syscall.h> // SYS_futex
+    #include <unistd.h> // syscall()
+#else
+    #include <chrono>
+#endif
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Parked threads re-check their conditions periodically in case a thread
+ * modified a condition without notifying them.
+-------------------------------------*/
+constexpr long _SL_MAX_PARK_NANOSECS = 1000000l;
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_HybridWait Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_HybridWait::SL_HybridWait() noexcept :
+    mEpoch{0},
+    mNumParked{0}
+{}
+
+
+
+/*-------------------------------------
+ * Sleep until the epoch changes
+-------------------------------------*/
+void SL_HybridWait::park(uint32_t epoch) noexcept
+{
+    mNumParked.fetch_add(1u, std::memory_order_seq_cst);
+
+    #if defined(LS_OS_LINUX)
+        // The kernel only puts this thread to sleep if the epoch has not
+        // changed since the caller last evaluated its condition.
+        const timespec timeout{0, _SL_MAX_PARK_NANOSECS};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&mEpoch), FUTEX_WAIT_PRIVATE, epoch, &timeout, nullptr, 0);
+
+    #else
+        std::unique_lock<std::mutex> lock{mLock};
+
+        if (mEpoch.load(std::memory_order_seq_cst) == epoch)
+        {
+            mCond.wait_for(lock, std::chrono::nanoseconds{_SL_MAX_PARK_NANOSECS});
+        }
+    #endif
+
+    mNumParked.fetch_sub(1u, std::memory_order_release);
+}
+
+
+
+/*-------------------------------------
+ * Wake all parked threads
+-------------------------------------*/
+void SL_HybridWait::wake() noexcept
+{
+    #if defined(LS_OS_LINUX)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&mEpoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+
+    #else
+        // Locking guarantees parked threads have either begun waiting or
+        // will observe the updated epoch.
+        {
+            std::lock_guard<std::mutex> lock{mLock};
+        }
+
+        mCond.notify_all();
+    #endif
+}
@@ -1,13 +1,195 @@
 
-#include <cmath>
+#include <cctype> // std::isspace(), std::isdigit(), std::tolower()
+#include <cstring> // std::strlen()
 #include <limits>
-#include <stdexcept>
-#include <string>
+#include <new> // std::nothrow
 
 #include "lightsky/utils/Log.h"
 
 #include "softlight/SL_Geometry.hpp"
 #include "softlight/SL_ImgFilePPM.hpp"
+#include "softlight/SL_MappedFile.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Dimensions and pixel data location of a binary PPM file
+-------------------------------------*/
+struct SL_PpmHeader
+{
+    uint64_t width;
+    uint64_t height;
+    uint64_t maxVal;
+    const unsigned char* pPixels;
+};
+
+
+
+/*-------------------------------------
+ * Read the next integer from a PPM header, skipping whitespace and comments
+-------------------------------------*/
+bool _sl_ppm_read_value(const char* pData, size_t numBytes, size_t& inOutPos, uint64_t& outVal) noexcept
+{
+    size_t pos = inOutPos;
+
+    while (pos < numBytes)
+    {
+        if (pData[pos] == '#')
+        {
+            while (pos < numBytes && pData[pos] != '\n' && pData[pos] != '\r')
+            {
+                ++pos;
+            }
+        }
+        else if (std::isspace((unsigned char)pData[pos]))
+        {
+            ++pos;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (pos >= numBytes || !std::isdigit((unsigned char)pData[pos]))
+    {
+        return false;
+    }
+
+    uint64_t val = 0;
+    while (pos < numBytes && std::isdigit((unsigned char)pData[pos]))
+    {
+        val = val * 10u + (uint64_t)(pData[pos] - '0');
+
+        // Large enough to reject any value without overflowing
+        if (val > (uint64_t)std::numeric_limits<uint32_t>::max())
+        {
+            return false;
+        }
+
+        ++pos;
+    }
+
+    outVal = val;
+    inOutPos = pos;
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Parse the header of a mapped PPM file
+-------------------------------------*/
+int _sl_ppm_read_header(const SL_MappedFile& f, SL_PpmHeader& outHeader, const char* const pFilename) noexcept
+{
+    const char* const pData = f.data();
+    const size_t numBytes = f.size();
+    size_t pos = 2;
+
+    if (numBytes < 2 || pData[0] != 'P' || pData[1] != '6')
+    {
+        LS_LOG_ERR("Unknown PPM format in ", pFilename, ". Only binary PPM images are supported.");
+        return -2;
+    }
+
+    if (!_sl_ppm_read_value(pData, numBytes, pos, outHeader.width)
+    || !_sl_ppm_read_value(pData, numBytes, pos, outHeader.height)
+    || !_sl_ppm_read_value(pData, numBytes, pos, outHeader.maxVal))
+    {
+        LS_LOG_ERR("Unable to read the PPM header from ", pFilename, '.');
+        return -2;
+    }
+
+    if (outHeader.width < 1 || outHeader.height < 1)
+    {
+        LS_LOG_ERR("Invalid PPM image size: ", outHeader.width, 'x', outHeader.height);
+        return -2;
+    }
+
+    // PPM images support up to 65536 values per pixel component
+    if (outHeader.maxVal < 1 || outHeader.maxVal > 65535)
+    {
+        LS_LOG_ERR("Unsupported maximum color value: ", outHeader.maxVal);
+        return -2;
+    }
+
+    // A single whitespace character separates the header from pixel data
+    if (pos >= numBytes || !std::isspace((unsigned char)pData[pos]))
+    {
+        LS_LOG_ERR("Invalid PPM header in ", pFilename, '.');
+        return -2;
+    }
+
+    ++pos;
+
+    const uint64_t bytesPerPixel = outHeader.maxVal < 256 ? 3u : 6u;
+    if ((numBytes - pos) / bytesPerPixel / outHeader.height < outHeader.width)
+    {
+        LS_LOG_ERR("PPM image data is truncated in ", pFilename, '.');
+        return -3;
+    }
+
+    outHeader.pPixels = reinterpret_cast<const unsigned char*>(pData + pos);
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Read a single color component from PPM pixel data
+-------------------------------------*/
+inline void _sl_ppm_read_component(const unsigned char*& pIn, uint8_t& outVal) noexcept
+{
+    outVal = *pIn++;
+}
+
+
+
+inline void _sl_ppm_read_component(const unsigned char*& pIn, uint16_t& outVal) noexcept
+{
+    // 16-bit components are stored in big-endian order
+    outVal = (uint16_t)(((unsigned)pIn[0] << 8u) | (unsigned)pIn[1]);
+    pIn += 2;
+}
+
+
+
+/*-------------------------------------
+ * Decode mapped pixel data into a texture buffer
+-------------------------------------*/
+template <SL_TexelOrder order, typename component_type>
+void _sl_ppm_decode(const unsigned char* pIn, const SL_TextureView& view) noexcept
+{
+    SL_ColorRGBType<component_type>* const pOut = reinterpret_cast<SL_ColorRGBType<component_type>*>(view.pTexels);
+
+    // PPM rows are stored top-down while channels are reversed, matching the
+    // layout of images decoded by FreeImage.
+    for (uint_fast32_t y = view.height; y--;)
+    {
+        for (uint_fast32_t x = 0; x < view.width; ++x)
+        {
+            SL_ColorRGBType<component_type>& c = pOut[sl_texel_index<order>(view, x, y)];
+            _sl_ppm_read_component(pIn, c.v[2]);
+            _sl_ppm_read_component(pIn, c.v[1]);
+            _sl_ppm_read_component(pIn, c.v[0]);
+        }
+    }
+}
+
+
+
+} // end anonymous namespace
 
 
 
@@ -62,131 +244,64 @@ int sl_img_save_ppm(const sl_lowp_t w, const sl_lowp_t h, const SL_ColorRGB8* co
 ------------------------------------------------------------------------------*/
 SL_ColorRGB8* sl_img_load_ppm(sl_lowp_t& w, sl_lowp_t& h, const char* const pFilename)
 {
-    uint64_t width = 0;
-    uint64_t height = 0;
-    uint64_t pixelMaxVal = 0;
-    std::string readBuffer;
-    std::string ppmType;
-    std::ifstream f(pFilename, std::ofstream::in | std::ofstream::binary);
-
-    // Read a single element from the PPM file
-    const auto readNextItem = [&]()->std::string&
-    {
-        do {
-            if (!f.good())
-            {
-                LS_LOG_ERR("Failed to read ", pFilename, ". End of file reached.");
-                readBuffer.clear();
-                return readBuffer;
-            }
-
-            f >> readBuffer;
-
-            // Check for and discard any comments.
-            std::string::size_type comment = readBuffer.find('#');
-
-            if (comment != std::string::npos)
-            {
-                // read the rest of the line and discard all comments
-                std::string discard{};
-                std::getline(f, discard);
-                readBuffer.resize(comment);
-            }
-        } while (!readBuffer.size());
-
-        return readBuffer;
-    };
-
-    ppmType = std::move(readNextItem());
-    if (ppmType.empty() || (ppmType != "P6" && ppmType != "P3"))
-    {
-        LS_LOG_ERR("Unknown PPM format in ", pFilename, ": ", ppmType);
-        return nullptr;
-    }
+    SL_MappedFile f;
+    SL_PpmHeader header;
 
-    // Exceptions can be removed if performance is critical
-    try
+    if (f.open(pFilename) != 0)
     {
-        width = std::stoull(readNextItem());
-        height = std::stoull(readNextItem());
-        pixelMaxVal = std::stoull(readNextItem());
-    }
-    catch (std::invalid_argument& ia)
-    {
-        LS_LOG_ERR("Unable to read value from PPM file: ", ia.what());
-        return nullptr;
-    }   
-    catch (std::out_of_range& oor)
-    {
-        LS_LOG_ERR("Unable to read number from PPM file: ", oor.what());
+        LS_LOG_ERR("Unable to open the PPM image ", pFilename, '.');
         return nullptr;
     }
 
-    if (width < 1 || width > (uint64_t)std::numeric_limits<sl_lowp_t>::max())
+    if (_sl_ppm_read_header(f, header, pFilename) != 0)
     {
-        LS_LOG_ERR("Invalid PPM image width: ", width);
         return nullptr;
     }
 
-    if (height < 1 || height > (uint64_t)std::numeric_limits<sl_lowp_t>::max())
+    if (header.width > (uint64_t)std::numeric_limits<sl_lowp_t>::max())
     {
-        LS_LOG_ERR("Invalid PPM image height: ", height);
+        LS_LOG_ERR("Invalid PPM image width: ", header.width);
         return nullptr;
     }
 
-    // PPM images support up to 65536 values per pixel component
-    if (pixelMaxVal > 65535)
+    if (header.height > (uint64_t)std::numeric_limits<sl_lowp_t>::max())
     {
-        LS_LOG_ERR("Unsupported maximum color value: ", pixelMaxVal);
+        LS_LOG_ERR("Invalid PPM image height: ", header.height);
         return nullptr;
     }
 
-    // discard remaining whitespace
-    int discard = isspace(f.peek());
-    do
-    {
-        if (!f.good())
-        {
-            LS_LOG_ERR("Bag stream encountered while streaming buffer data from ", pFilename);
-            return nullptr;
-        }
-
-        f.get();
-    } while (isspace(discard));
-
+    const uint64_t width = header.width;
+    const uint64_t height = header.height;
+    const unsigned char* pIn = header.pPixels;
     SL_ColorRGB8* const pImg = new SL_ColorRGB8[width * height];
 
     // iterate through the image height, then the width
     for (uint64_t i = 0; i < height; ++i)
     {
-        sl_lowp_t i2 = height - i - 1;
+        const uint64_t i2 = height - i - 1;
 
         for(uint64_t j = 0; j < width; ++j)
         {
             SL_ColorRGB8* p = pImg + (width * i2 + j);
 
             // PPM Images can be 8-bits or 16-bits per component.
-            if (pixelMaxVal < 256)
+            if (header.maxVal < 256)
             {
-                //f.read(reinterpret_cast<char*>(p->v), sizeof(uint8_t)*SL_ColorRGB8::num_components());
-                f.read(reinterpret_cast<char*>(&p->v[2]), sizeof(uint8_t));
-                f.read(reinterpret_cast<char*>(&p->v[1]), sizeof(uint8_t));
-                f.read(reinterpret_cast<char*>(&p->v[0]), sizeof(uint8_t));
+                _sl_ppm_read_component(pIn, p->v[2]);
+                _sl_ppm_read_component(pIn, p->v[1]);
+                _sl_ppm_read_component(pIn, p->v[0]);
             }
             else
             {
                 SL_ColorRGB16 p2;
-                //f.read(reinterpret_cast<char*>(p2.v), sizeof(uint16_t)*SL_ColorRGB16::num_components());
-                f.read(reinterpret_cast<char*>(&p2.v[2]), sizeof(uint16_t));
-                f.read(reinterpret_cast<char*>(&p2.v[1]), sizeof(uint16_t));
-                f.read(reinterpret_cast<char*>(&p2.v[0]), sizeof(uint16_t));
+                _sl_ppm_read_component(pIn, p2.v[2]);
+                _sl_ppm_read_component(pIn, p2.v[1]);
+                _sl_ppm_read_component(pIn, p2.v[0]);
                 *p = color_cast<uint8_t, uint16_t>(p2);
             }
         }
     }
 
-    f.close();
-
     w = (sl_lowp_t)width;
     h = (sl_lowp_t)height;
 
@@ -196,3 +311,97 @@ SL_ColorRGB8* sl_img_load_ppm(sl_lowp_t& w, sl_lowp_t& h, const char* const pFil
 }
 
 
+
+/*------------------------------------------------------------------------------
+ * Load Images Into Textures
+------------------------------------------------------------------------------*/
+int sl_img_load_ppm(SL_Texture& outTex, const char* const pFilename, SL_TexelOrder texelOrder) noexcept
+{
+    SL_MappedFile f;
+    SL_PpmHeader header;
+
+    if (f.open(pFilename) != 0)
+    {
+        LS_LOG_ERR("Unable to open the PPM image ", pFilename, '.');
+        return -1;
+    }
+
+    // Pixel data is read once, front to back
+    f.prefetch();
+
+    int retCode = _sl_ppm_read_header(f, header, pFilename);
+    if (retCode != 0)
+    {
+        return retCode;
+    }
+
+    if (header.width > (uint64_t)std::numeric_limits<uint16_t>::max()
+    || header.height > (uint64_t)std::numeric_limits<uint16_t>::max())
+    {
+        LS_LOG_ERR("Invalid PPM image size: ", header.width, 'x', header.height);
+        return -2;
+    }
+
+    const SL_ColorDataType type = header.maxVal < 256 ? SL_COLOR_RGB_8U : SL_COLOR_RGB_16U;
+    const uint16_t w = (uint16_t)header.width;
+    const uint16_t h = (uint16_t)header.height;
+
+    void* const pTexels = sl_texture_allocate(type, w, h, 1);
+    if (!pTexels)
+    {
+        LS_LOG_ERR("Unable to allocate memory for the PPM image ", pFilename, '.');
+        return -4;
+    }
+
+    SL_TextureView view;
+    sl_texture_view_from_buffer(view, w, h, type, pTexels);
+
+    if (type == SL_COLOR_RGB_8U)
+    {
+        if (texelOrder == SL_TexelOrder::SWIZZLED)
+        {
+            _sl_ppm_decode<SL_TexelOrder::SWIZZLED, uint8_t>(header.pPixels, view);
+        }
+        else
+        {
+            _sl_ppm_decode<SL_TexelOrder::ORDERED, uint8_t>(header.pPixels, view);
+        }
+    }
+    else
+    {
+        if (texelOrder == SL_TexelOrder::SWIZZLED)
+        {
+            _sl_ppm_decode<SL_TexelOrder::SWIZZLED, uint16_t>(header.pPixels, view);
+        }
+        else
+        {
+            _sl_ppm_decode<SL_TexelOrder::ORDERED, uint16_t>(header.pPixels, view);
+        }
+    }
+
+    outTex.adopt(type, w, h, 1, pTexels);
+
+    LS_LOG_MSG("Successfully loaded a ", w, 'x', h, " PPM image: ", pFilename);
+
+    return 0;
+}
+
+
+
+/*------------------------------------------------------------------------------
+ * Determine if a file name has a PPM extension
+------------------------------------------------------------------------------*/
+bool sl_img_is_ppm(const char* const pFilename) noexcept
+{
+    const size_t len = pFilename ? std::strlen(pFilename) : 0;
+    if (len < 4)
+    {
+        return false;
+    }
+
+    const char* const pExt = pFilename + len - 4;
+    return pExt[0] == '.'
+        && std::tolower((unsigned char)pExt[1]) == 'p'
+        && std::tolower((unsigned char)pExt[2]) == 'p'
+        && std::tolower((unsigned char)pExt[3]) == 'm';
+}
@@ -45,7 +45,9 @@ SL_IndexBuffer::SL_IndexBuffer() noexcept :
     mType{SL_DataType::VERTEX_DATA_INT},
     mBytesPerId{sl_bytes_per_vertex(SL_DataType::VERTEX_DATA_INT, SL_Dimension::VERTEX_DIMENSION_1)},
     mCount{0},
-    mBuffer{nullptr}
+    mBuffer{nullptr},
+    mExternal{},
+    mData{nullptr}
 {}
 
 
@@ -57,13 +59,16 @@ SL_IndexBuffer::SL_IndexBuffer(const SL_IndexBuffer& v) noexcept :
     mType{v.mType},
     mBytesPerId{v.mBytesPerId},
     mCount{v.mCount},
-    mBuffer{nullptr}
+    mBuffer{nullptr},
+    mExternal{},
+    mData{nullptr}
 {
-    if (v.mBuffer != nullptr)
+    if (v.mData != nullptr)
     {
         const uint32_t numBytes = v.mBytesPerId * v.mCount;
         mBuffer = ls::utils::make_unique_aligned_array<unsigned char>(numBytes + (_SL_IBO_PADDING_BYTES - (numBytes % _SL_IBO_PADDING_BYTES)));
-        ls::utils::fast_memcpy(mBuffer.get(), v.mBuffer.get(), numBytes);
+        mData = mBuffer.get();
+        ls::utils::fast_memcpy(mData, v.mData, numBytes);
     }
 }
 
@@ -76,10 +81,13 @@ SL_IndexBuffer::SL_IndexBuffer(SL_IndexBuffer&& v) noexcept :
     mType{v.mType},
     mBytesPerId{v.mBytesPerId},
     mCount{v.mCount},
-    mBuffer{std::move(v.mBuffer)}
+    mBuffer{std::move(v.mBuffer)},
+    mExternal{std::move(v.mExternal)},
+    mData{v.mData}
 {
     v.mType = SL_DataType::VERTEX_DATA_INT;
     v.mCount = 0;
+    v.mData = nullptr;
     v.mBytesPerId = sl_bytes_per_vertex(SL_DataType::VERTEX_DATA_INT, SL_Dimension::VERTEX_DIMENSION_1);
 }
 
@@ -95,13 +103,20 @@ SL_IndexBuffer& SL_IndexBuffer::operator=(const SL_IndexBuffer& v) noexcept
         mType = v.mType;
         mBytesPerId = v.mBytesPerId;
         mCount = v.mCount;
+        mExternal.reset();
 
-        if (v.mBuffer != nullptr)
+        if (v.mData != nullptr)
         {
             const uint32_t numBytes = v.mBytesPerId * v.mCount;
             mBuffer = ls::utils::make_unique_aligned_array<unsigned char>(numBytes + (_SL_IBO_PADDING_BYTES - (numBytes % _SL_IBO_PADDING_BYTES)));
-            ls::utils::fast_memcpy(mBuffer.get(), v.mBuffer.get(), numBytes);
+            ls::utils::fast_memcpy(mBuffer.get(), v.mData, numBytes);
         }
+        else
+        {
+            mBuffer.reset();
+        }
+
+        mData = mBuffer.get();
     }
     return *this;
 }
@@ -125,6 +140,10 @@ SL_IndexBuffer& SL_IndexBuffer::operator=(SL_IndexBuffer&& v) noexcept
         v.mCount = 0;
 
         mBuffer = std::move(v.mBuffer);
+        mExternal = std::move(v.mExternal);
+
+        mData = v.mData;
+        v.mData = nullptr;
     }
 
     return *this;
@@ -152,7 +171,9 @@ int SL_IndexBuffer::init(uint32_t numElements, SL_DataType type, const void* pDa
     mType = type;
     mBytesPerId = bytesPerType;
     mCount = numElements;
+    mExternal.reset();
     mBuffer = ls::utils::make_unique_aligned_array<unsigned char>(numBytes + (_SL_IBO_PADDING_BYTES - (numBytes % _SL_IBO_PADDING_BYTES)));
+    mData = mBuffer.get();
 
     if (pData != nullptr)
     {
@@ -164,6 +185,34 @@ int SL_IndexBuffer::init(uint32_t numElements, SL_DataType type, const void* pDa
 
 
 
+/*-------------------------------------
+ * Use indices allocated elsewhere without copying them. The allocation must
+ * remain readable for 16 bytes past the last index, the same padding which
+ * init() provides.
+-------------------------------------*/
+int SL_IndexBuffer::adopt(uint32_t numElements, SL_DataType type, const std::shared_ptr<unsigned char>& pData) noexcept
+{
+    LS_ASSERT(type == SL_DataType::VERTEX_DATA_BYTE
+    || type == SL_DataType::VERTEX_DATA_SHORT
+    || type == SL_DataType::VERTEX_DATA_INT);
+
+    if (!numElements || !pData)
+    {
+        return -1;
+    }
+
+    mType = type;
+    mBytesPerId = sl_bytes_per_vertex(type, SL_Dimension::VERTEX_DIMENSION_1);
+    mCount = numElements;
+    mBuffer.reset();
+    mExternal = pData;
+    mData = mExternal.get();
+
+    return 0;
+}
+
+
+
 /*-------------------------------------
  * Delete all data in *this.
 -------------------------------------*/
@@ -173,4 +222,6 @@ void SL_IndexBuffer::terminate() noexcept
     mBytesPerId = sl_bytes_per_vertex(mType, SL_Dimension::VERTEX_DIMENSION_1);
     mCount = 0;
     mBuffer.reset();
+    mExternal.reset();
+    mData = nullptr;
 }
@@ -37,25 +37,24 @@ void SL_LineProcessor::push_bin(
     uint_fast64_t binId;
 
     // Attempt to grab a bin index. Flush the bins if they've filled up.
-    while ((binId = active_num_bins_used().count.fetch_add(1, std::memory_order_acq_rel)) >= SL_SHADER_MAX_BINNED_PRIMS)
+    while ((binId = active_num_bins_used().count.fetch_add(1, std::memory_order_acq_rel)) >= mMaxBins)
     {
         flush_rasterizer<SL_LineRasterizer>();
     }
 
     // place a triangle into the next available bin
-    SL_FragmentBin* const pFragBins = active_frag_bins();
-    SL_FragmentBin& bin = pFragBins[binId];
+    SL_FragmentBin& bin = active_frag_bin(binId);
     bin.mScreenCoords[0] = p0;
     bin.mScreenCoords[1] = p1;
 
     for (unsigned i = 0; i < numVaryings; ++i)
     {
-        bin.mVaryings[i+SL_SHADER_MAX_VARYING_VECTORS*0] = a.varyings[i];
-        bin.mVaryings[i+SL_SHADER_MAX_VARYING_VECTORS*1] = b.varyings[i];
+        bin.mVaryings[i+numVaryings*0] = a.varyings[i];
+        bin.mVaryings[i+numVaryings*1] = b.varyings[i];
     }
 
     bin.primIndex = primIndex;
-    active_bin_index(binId).count = binId;
+    active_bin_index(binId) = (uint32_t)binId;
 }
 
 
@@ -188,6 +187,8 @@ void SL_LineProcessor::clip_and_process_lines(
 void SL_LineProcessor::process_verts(
     const SL_Mesh& m,
     size_t instanceId,
+    size_t begin,
+    size_t end,
     const ls::math::mat4_t<float>& scissorMat,
     const ls::math::vec4_t<float>& viewportDims) noexcept
 {
@@ -209,26 +210,15 @@ void SL_LineProcessor::process_verts(
     params.pVao       = &vao;
     params.pVbo       = &mContext->vbo(vao.get_vertex_buffer());
 
-    #if SL_VERTEX_CACHING_ENABLED
-        size_t begin;
-        size_t end;
-        constexpr size_t step = 2;
-
-        sl_calc_indexed_parition<2>(m.elementEnd-m.elementBegin, mNumThreads, mThreadId, begin, end);
-        begin += m.elementBegin;
-        end += m.elementBegin;
+    constexpr size_t step = 2;
 
+    #if SL_VERTEX_CACHING_ENABLED
         SL_PTVCache ptvCache{};
         const auto&& vertTransform = [&](size_t key, SL_TransformedVert& tv)->void {
             params.vertId = key;
             params.pVaryings = tv.varyings;
             tv.vert = scissorMat * vertShader(params);
         };
-
-    #else
-        const size_t begin = m.elementBegin + mThreadId * 2u;
-        const size_t end   = m.elementEnd;
-        const size_t step  = mNumThreads * 2u;
     #endif
 
     for (size_t i = begin; i < end; i += step)
@@ -291,19 +281,15 @@ void SL_LineProcessor::execute() noexcept
     const math::mat4&&      scissorMat   = viewState.scissor_matrix(fboDims[2], fboDims[3]);
     const math::vec4&&      viewportDims = viewState.viewport_rect(fboDims[2], fboDims[3]);
 
-    if (mNumInstances == 1)
-    {
-        for (size_t i = 0; i < mNumMeshes; ++i)
-        {
-            process_verts(mMeshes[i], 0, scissorMat, viewportDims);
-        }
-    }
-    else
+    constexpr size_t indicesPerBatch = SL_VERTEX_BATCH_SIZE * 2u;
+    size_t           meshId;
+    size_t           instanceId;
+    size_t           begin;
+    size_t           end;
+
+    while (next_vertex_batch(indicesPerBatch, meshId, instanceId, begin, end))
     {
-        for (size_t i = 0; i < mNumInstances; ++i)
-        {
-            process_verts(mMeshes[0], i, scissorMat, viewportDims);
-        }
+        process_verts(mMeshes[meshId], instanceId, begin, end, scissorMat, viewportDims);
     }
 
     this->cleanup<SL_LineRasterizer>();
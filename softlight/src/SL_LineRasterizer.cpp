@@ -1,10 +1,12 @@
 
+#include <utility> // std::swap()
+
 #include "lightsky/math/half.h"
 #include "lightsky/math/vec_utils.h"
 
-#include "softlight/SL_Geometry.hpp" // sl_draw_line_bresenham
 #include "softlight/SL_LineRasterizer.hpp"
 #include "softlight/SL_Framebuffer.hpp" // SL_Framebuffer
+#include "softlight/SL_ScanlineBounds.hpp" // sl_scanline_offset()
 #include "softlight/SL_Shader.hpp" // SL_FragmentShader
 #include "softlight/SL_Texture.hpp"
 
@@ -23,6 +25,11 @@ namespace utils = ls::utils;
 -----------------------------------------------------------------------------*/
 /*--------------------------------------
  * Enqueue line fragments for shading
+ *
+ * Pixels match the coverage of sl_draw_line_bresenham(). Rather than stepping
+ * along the entire line, each thread jumps directly to the pixels within the
+ * scanlines it owns. Up to four pixels are then depth-tested and queued at a
+ * time.
 --------------------------------------*/
 template <class DepthCmpFunc, typename depth_type>
 void SL_LineRasterizer::render_line(const SL_FragmentBin& bin, const SL_TextureView& depthBuf) noexcept
@@ -34,42 +41,43 @@ void SL_LineRasterizer::render_line(const SL_FragmentBin& bin, const SL_TextureV
     const float        z1            = screenCoord1[2];
     const math::vec2&& sc0           = math::vec2_cast(screenCoord0);
     const math::vec2&& sc1           = math::vec2_cast(screenCoord1);
-    const math::vec4&& p0            = math::vec4_cast(sc0, 0.f, 0.f);
-    math::vec2         clipCoords[2] = {sc0, sc1};
-    const float        dist          = math::inversesqrt(math::length_squared(sc1-sc0));
+    const float        lineLenSq     = math::length_squared(sc1-sc0);
+    const math::vec2&& lineDir       = (lineLenSq > 0.f) ? ((sc1-sc0) * math::rcp(lineLenSq)) : math::vec2{0.f};
+    const int32_t      numThreads    = (int32_t)mNumProcessors;
+    const int32_t      threadId      = (int32_t)mThreadId;
+    const depth_type*  pDepth        = (const depth_type*)depthBuf.pTexels;
+    const int32_t      depthW        = (int32_t)depthBuf.width;
+
+    // The interpolation factor of each pixel is its projection onto the line.
+    // It changes linearly along both axes.
+    const math::vec4 interpX{lineDir[0]};
+    const math::vec4 interpY{lineDir[1]};
+    const math::vec4 interp0{-math::dot(sc0, lineDir)};
 
     constexpr DepthCmpFunc depthCmp = {};
 
     SL_FragCoord* outCoords = mQueues;
     uint32_t numQueuedFrags = 0;
 
-    sl_draw_line_bresenham(
-        (uint16_t)clipCoords[0][0],
-        (uint16_t)clipCoords[0][1],
-        (uint16_t)clipCoords[1][0],
-        (uint16_t)clipCoords[1][1],
-        [&](uint16_t x, uint16_t y) noexcept->void
-        {
-            if ((LS_LIKELY(y % mNumProcessors) != mThreadId))
-            {
-                return;
-            }
-
-            const math::vec4&& p = (math::vec4)math::vec4_t<uint16_t>{x, y, 0, 0};
-            const float currLen  = math::length(p - p0);
-            const float interp   = currLen * dist;
-            const float z        = math::mix(z0, z1, interp);
+    const auto&& render_pixels = [&](const math::vec4_t<int32_t>& x, const math::vec4_t<int32_t>& y, int32_t numPixels) noexcept->void
+    {
+        const math::vec4&& xf     = (math::vec4)x;
+        const math::vec4&& yf     = (math::vec4)y;
+        const math::vec4&& interp = math::fmadd(xf, interpX, math::fmadd(yf, interpY, interp0));
+        const math::vec4&& z      = math::fmadd(interp, math::vec4{z1-z0}, math::vec4{z0});
 
-            const depth_type d = ((depth_type*)depthBuf.pTexels)[x + depthBuf.width * y];
-            if (!depthCmp(z, (float)d))
+        for (int32_t i = 0; i < numPixels; ++i)
+        {
+            const float d = (float)pDepth[x[i] + depthW * y[i]];
+            if (!depthCmp(z[i], d))
             {
-                return;
+                continue;
             }
 
-            outCoords->lineInterp[numQueuedFrags]  = interp;
-            outCoords->coord[numQueuedFrags].x     = x;
-            outCoords->coord[numQueuedFrags].y     = y;
-            outCoords->coord[numQueuedFrags].depth = z;
+            outCoords->lineInterp[numQueuedFrags]  = math::min(math::max(interp[i], 0.f), 1.f);
+            outCoords->coord[numQueuedFrags].x     = (uint16_t)x[i];
+            outCoords->coord[numQueuedFrags].y     = (uint16_t)y[i];
+            outCoords->coord[numQueuedFrags].depth = z[i];
 
             ++numQueuedFrags;
 
@@ -79,7 +87,74 @@ void SL_LineRasterizer::render_line(const SL_FragmentBin& bin, const SL_TextureV
                 flush_line_fragments<depth_type>(bin, SL_SHADER_MAX_QUEUED_FRAGS, outCoords);
             }
         }
-    );
+    };
+
+    // Setup for a Bresenham-style traversal along the major axis.
+    const int32_t xa    = (int32_t)(uint16_t)sc0[0];
+    const int32_t ya    = (int32_t)(uint16_t)sc0[1];
+    const int32_t xb    = (int32_t)(uint16_t)sc1[0];
+    const int32_t yb    = (int32_t)(uint16_t)sc1[1];
+    const bool    steep = math::abs(xa - xb) < math::abs(ya - yb);
+
+    int32_t majorA = steep ? ya : xa;
+    int32_t minorA = steep ? xa : ya;
+    int32_t majorB = steep ? yb : xb;
+    int32_t minorB = steep ? xb : yb;
+
+    if (majorA > majorB)
+    {
+        std::swap(majorA, majorB);
+        std::swap(minorA, minorB);
+    }
+
+    const int32_t dMajor    = majorB - majorA;
+    const int32_t dMinor    = math::abs(minorB - minorA);
+    const int32_t minorStep = (minorB > minorA) ? 1 : -1;
+
+    if (steep)
+    {
+        // Every pixel lies on its own scanline. Step between owned scanlines
+        // and calculate the horizontal offset of each pixel directly.
+        const int32_t iBegin = sl_scanline_offset<int32_t>(numThreads, threadId, majorA);
+        const int32_t iStep  = numThreads * 4;
+
+        for (int32_t i = iBegin; i <= dMajor; i += iStep)
+        {
+            const math::vec4_t<int32_t> iv{i, i + numThreads, i + numThreads * 2, i + numThreads * 3};
+            const math::vec4_t<int32_t> k{
+                (2 * dMinor * iv[0] + dMajor - 1) / (2 * dMajor),
+                (2 * dMinor * iv[1] + dMajor - 1) / (2 * dMajor),
+                (2 * dMinor * iv[2] + dMajor - 1) / (2 * dMajor),
+                (2 * dMinor * iv[3] + dMajor - 1) / (2 * dMajor)
+            };
+            const int32_t numPixels = math::min<int32_t>(4, (dMajor - i) / numThreads + 1);
+
+            render_pixels(math::vec4_t<int32_t>{minorA} + k * minorStep, math::vec4_t<int32_t>{majorA} + iv, numPixels);
+        }
+    }
+    else
+    {
+        // Each scanline contains a horizontal run of pixels. Only the runs
+        // within owned scanlines are visited.
+        const int32_t kBegin = (minorStep > 0)
+            ? sl_scanline_offset<int32_t>(numThreads, threadId, minorA)
+            : ((minorA - threadId + numThreads) % numThreads);
+
+        for (int32_t k = kBegin; k <= dMinor; k += numThreads)
+        {
+            // First & last pixels along the major axis which round to the
+            // current scanline.
+            const int32_t iBegin = (k > 0) ? ((2 * dMajor * k - dMajor + 2 * dMinor) / (2 * dMinor)) : 0;
+            const int32_t iEnd   = (k < dMinor) ? ((2 * dMajor * (k+1) - dMajor + 2 * dMinor) / (2 * dMinor)) : (dMajor + 1);
+            const int32_t y      = minorA + k * minorStep;
+
+            for (int32_t i = iBegin; i < iEnd; i += 4)
+            {
+                const int32_t x = majorA + i;
+                render_pixels(math::vec4_t<int32_t>{x, x+1, x+2, x+3}, math::vec4_t<int32_t>{y}, math::min(4, iEnd - i));
+            }
+        }
+    }
 
     // cleanup remaining fragments
     if (LS_LIKELY(numQueuedFrags > 0))
@@ -133,21 +208,21 @@ void SL_LineRasterizer::dispatch_bins() noexcept
     {
         for (uint64_t binId = 0; binId < mNumBins; ++binId)
         {
-            render_line<DepthCmpFunc, math::half>(mBins[binId], pDepthBuf);
+            render_line<DepthCmpFunc, math::half>(sl_frag_bin(mBins, mBinStride, binId), pDepthBuf);
         }
     }
     else if (depthBpp == sizeof(float))
     {
         for (uint64_t binId = 0; binId < mNumBins; ++binId)
         {
-            render_line<DepthCmpFunc, float>(mBins[binId], pDepthBuf);
+            render_line<DepthCmpFunc, float>(sl_frag_bin(mBins, mBinStride, binId), pDepthBuf);
         }
     }
     else if (depthBpp == sizeof(double))
     {
         for (uint64_t binId = 0; binId < mNumBins; ++binId)
         {
-            render_line<DepthCmpFunc, double>(mBins[binId], pDepthBuf);
+            render_line<DepthCmpFunc, double>(sl_frag_bin(mBins, mBinStride, binId), pDepthBuf);
         }
     }
 }
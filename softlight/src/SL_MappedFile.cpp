@@ -0,0 +1,187 @@
+
+#include "lightsky/setup/OS.h" // LS_OS_WINDOWS
+
+#if defined(LS_OS_WINDOWS)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif /* WIN32_LEAN_AND_MEAN */
+
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif /* NOMINMAX */
+
+    #include <windows.h>
+#else
+    #include <fcntl.h> // open()
+    #include <sys/mman.h> // mmap(), munmap(), madvise()
+    #include <sys/stat.h> // fstat()
+    #include <unistd.h> // close()
+#endif
+
+#include "softlight/SL_MappedFile.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_MappedFile Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_MappedFile::~SL_MappedFile() noexcept
+{
+    close();
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_MappedFile::SL_MappedFile() noexcept :
+    mNumBytes{0},
+    mData{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_MappedFile::SL_MappedFile(SL_MappedFile&& f) noexcept :
+    mNumBytes{f.mNumBytes},
+    mData{f.mData}
+{
+    f.mNumBytes = 0;
+    f.mData = nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_MappedFile& SL_MappedFile::operator=(SL_MappedFile&& f) noexcept
+{
+    if (this != &f)
+    {
+        close();
+
+        mNumBytes = f.mNumBytes;
+        f.mNumBytes = 0;
+
+        mData = f.mData;
+        f.mData = nullptr;
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Map a file into memory
+-------------------------------------*/
+int SL_MappedFile::open(const char* pFilename) noexcept
+{
+    close();
+
+    #if defined(LS_OS_WINDOWS)
+        HANDLE hFile = CreateFileA(pFilename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return -1;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart <= 0)
+        {
+            CloseHandle(hFile);
+            return -2;
+        }
+
+        // The view remains valid after both handles are closed
+        HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        CloseHandle(hFile);
+
+        if (!hMapping)
+        {
+            return -3;
+        }
+
+        void* pData = MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0);
+        CloseHandle(hMapping);
+
+        if (!pData)
+        {
+            return -3;
+        }
+
+        mNumBytes = (size_t)fileSize.QuadPart;
+        mData = reinterpret_cast<char*>(pData);
+
+    #else
+        const int fd = ::open(pFilename, O_RDONLY);
+        if (fd < 0)
+        {
+            return -1;
+        }
+
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size <= 0)
+        {
+            ::close(fd);
+            return -2;
+        }
+
+        // Private mappings let pages be modified in-place without writing
+        // back to the file. The mapping outlives the file descriptor.
+        void* pData = mmap(nullptr, (size_t)fileInfo.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (pData == MAP_FAILED)
+        {
+            return -3;
+        }
+
+        mNumBytes = (size_t)fileInfo.st_size;
+        mData = reinterpret_cast<char*>(pData);
+    #endif
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Unmap the current file
+-------------------------------------*/
+void SL_MappedFile::close() noexcept
+{
+    if (mData)
+    {
+        #if defined(LS_OS_WINDOWS)
+            UnmapViewOfFile(mData);
+        #else
+            munmap(mData, mNumBytes);
+        #endif
+    }
+
+    mNumBytes = 0;
+    mData = nullptr;
+}
+
+
+
+/*-------------------------------------
+ * Read the mapped pages ahead of time
+-------------------------------------*/
+void SL_MappedFile::prefetch() const noexcept
+{
+    #if !defined(LS_OS_WINDOWS)
+        if (mData)
+        {
+            madvise(mData, mNumBytes, MADV_WILLNEED);
+        }
+    #endif
+}
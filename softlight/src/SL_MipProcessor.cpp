@@ -0,0 +1,237 @@
+
+#include "lightsky/setup/Types.h" // ls::setup::IsFloat
+
+#include "lightsky/math/scalar_utils.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_MipProcessor.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions and namespaces
+-----------------------------------------------------------------------------*/
+namespace math = ls::math;
+
+namespace
+{
+
+
+
+/*-------------------------------------
+ * Weights of a Kaiser-windowed sinc (alpha = 4) for a 2:1 reduction. Taps
+ * are centered between the two source texels of each output texel.
+-------------------------------------*/
+constexpr float _SL_KAISER_WEIGHTS[6] = {
+    -0.020992482f,
+    0.094502333f,
+    0.426490149f,
+    0.426490149f,
+    0.094502333f,
+    -0.020992482f
+};
+
+
+
+/*-------------------------------------
+ * Index a texel in either a 2D or a layered texture
+-------------------------------------*/
+template <SL_TexelOrder order>
+inline LS_INLINE ptrdiff_t _sl_mip_index(const SL_TextureView& tex, uint_fast32_t x, uint_fast32_t y, uint_fast32_t z) noexcept
+{
+    return (tex.depth > 1) ? sl_texel_index<order>(tex, x, y, z) : sl_texel_index<order>(tex, x, y);
+}
+
+
+
+/*-------------------------------------
+ * Filters with negative lobes can overshoot normalized integer formats
+-------------------------------------*/
+template <typename value_type, typename float_color>
+inline LS_INLINE float_color _sl_mip_saturate(float_color c) noexcept
+{
+    if (!ls::setup::IsFloat<value_type>::value)
+    {
+        for (unsigned i = 0; i < sizeof(float_color) / sizeof(float); ++i)
+        {
+            c[i] = math::clamp(c[i], 0.f, 1.f);
+        }
+    }
+
+    return c;
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_MipProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Box filter
+-------------------------------------*/
+template <typename color_type, SL_TexelOrder order>
+void SL_MipProcessor::downsample_box() noexcept
+{
+    typedef typename color_type::value_type value_type;
+    typedef decltype(color_cast<float, value_type>(color_type{})) float_color;
+
+    const SL_TextureView&   src     = *mSrcTex;
+    const SL_TextureView&   dst     = *mDstTex;
+    const color_type* const pSrc    = reinterpret_cast<const color_type*>(src.pTexels);
+    color_type* const       pDst    = reinterpret_cast<color_type*>(dst.pTexels);
+    const uint_fast32_t     srcMaxX = (uint_fast32_t)src.width - 1u;
+    const uint_fast32_t     srcMaxY = (uint_fast32_t)src.height - 1u;
+    const uint_fast32_t     numRows = (uint_fast32_t)dst.height * (uint_fast32_t)dst.depth;
+
+    for (uint_fast32_t row = mThreadId; row < numRows; row += mNumThreads)
+    {
+        const uint_fast32_t z   = row / dst.height;
+        const uint_fast32_t y   = row % dst.height;
+        const uint_fast32_t sy0 = math::min<uint_fast32_t>(y*2u, srcMaxY);
+        const uint_fast32_t sy1 = math::min<uint_fast32_t>(y*2u+1u, srcMaxY);
+
+        for (uint_fast32_t x = 0; x < dst.width; ++x)
+        {
+            const uint_fast32_t sx0 = math::min<uint_fast32_t>(x*2u, srcMaxX);
+            const uint_fast32_t sx1 = math::min<uint_fast32_t>(x*2u+1u, srcMaxX);
+
+            const float_color&& c0 = color_cast<float, value_type>(pSrc[_sl_mip_index<order>(src, sx0, sy0, z)]);
+            const float_color&& c1 = color_cast<float, value_type>(pSrc[_sl_mip_index<order>(src, sx1, sy0, z)]);
+            const float_color&& c2 = color_cast<float, value_type>(pSrc[_sl_mip_index<order>(src, sx0, sy1, z)]);
+            const float_color&& c3 = color_cast<float, value_type>(pSrc[_sl_mip_index<order>(src, sx1, sy1, z)]);
+
+            pDst[_sl_mip_index<order>(dst, x, y, z)] = color_cast<value_type, float>((c0 + c1 + c2 + c3) * 0.25f);
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Kaiser filter
+-------------------------------------*/
+template <typename color_type, SL_TexelOrder order>
+void SL_MipProcessor::downsample_kaiser() noexcept
+{
+    typedef typename color_type::value_type value_type;
+    typedef decltype(color_cast<float, value_type>(color_type{})) float_color;
+
+    const SL_TextureView&   src     = *mSrcTex;
+    const SL_TextureView&   dst     = *mDstTex;
+    const color_type* const pSrc    = reinterpret_cast<const color_type*>(src.pTexels);
+    color_type* const       pDst    = reinterpret_cast<color_type*>(dst.pTexels);
+    const int_fast32_t      srcMaxX = (int_fast32_t)src.width - 1;
+    const int_fast32_t      srcMaxY = (int_fast32_t)src.height - 1;
+    const uint_fast32_t     numRows = (uint_fast32_t)dst.height * (uint_fast32_t)dst.depth;
+
+    for (uint_fast32_t row = mThreadId; row < numRows; row += mNumThreads)
+    {
+        const uint_fast32_t z = row / dst.height;
+        const int_fast32_t  y = (int_fast32_t)(row % dst.height);
+
+        for (int_fast32_t x = 0; x < (int_fast32_t)dst.width; ++x)
+        {
+            float_color accum{0.f};
+
+            for (int_fast32_t j = 0; j < 6; ++j)
+            {
+                const uint_fast32_t sy = (uint_fast32_t)math::clamp<int_fast32_t>(y*2 + j - 2, 0, srcMaxY);
+                float_color rowAccum{0.f};
+
+                for (int_fast32_t i = 0; i < 6; ++i)
+                {
+                    const uint_fast32_t sx = (uint_fast32_t)math::clamp<int_fast32_t>(x*2 + i - 2, 0, srcMaxX);
+                    rowAccum = rowAccum + color_cast<float, value_type>(pSrc[_sl_mip_index<order>(src, sx, sy, z)]) * _SL_KAISER_WEIGHTS[i];
+                }
+
+                accum = accum + rowAccum * _SL_KAISER_WEIGHTS[j];
+            }
+
+            pDst[_sl_mip_index<order>(dst, (uint_fast32_t)x, (uint_fast32_t)y, z)] = color_cast<value_type, float>(_sl_mip_saturate<value_type, float_color>(accum));
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Filter & texel order dispatch
+-------------------------------------*/
+template <typename color_type>
+void SL_MipProcessor::downsample() noexcept
+{
+    if (mFilter == SL_MIP_FILTER_KAISER)
+    {
+        if (mTexelOrder == SL_TexelOrder::SWIZZLED)
+        {
+            downsample_kaiser<color_type, SL_TexelOrder::SWIZZLED>();
+        }
+        else
+        {
+            downsample_kaiser<color_type, SL_TexelOrder::ORDERED>();
+        }
+    }
+    else
+    {
+        if (mTexelOrder == SL_TexelOrder::SWIZZLED)
+        {
+            downsample_box<color_type, SL_TexelOrder::SWIZZLED>();
+        }
+        else
+        {
+            downsample_box<color_type, SL_TexelOrder::ORDERED>();
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Run the mip processor
+-------------------------------------*/
+void SL_MipProcessor::execute() noexcept
+{
+    switch (mSrcTex->type)
+    {
+        case SL_COLOR_R_8U:        downsample<SL_ColorRType<uint8_t>>();           break;
+        case SL_COLOR_R_16U:       downsample<SL_ColorRType<uint16_t>>();          break;
+        case SL_COLOR_R_32U:       downsample<SL_ColorRType<uint32_t>>();          break;
+        case SL_COLOR_R_64U:       downsample<SL_ColorRType<uint64_t>>();          break;
+        case SL_COLOR_R_HALF:      downsample<SL_ColorRType<ls::math::half>>();    break;
+        case SL_COLOR_R_FLOAT:     downsample<SL_ColorRType<float>>();             break;
+        case SL_COLOR_R_DOUBLE:    downsample<SL_ColorRType<double>>();            break;
+
+        case SL_COLOR_RG_8U:       downsample<SL_ColorRGType<uint8_t>>();          break;
+        case SL_COLOR_RG_16U:      downsample<SL_ColorRGType<uint16_t>>();         break;
+        case SL_COLOR_RG_32U:      downsample<SL_ColorRGType<uint32_t>>();         break;
+        case SL_COLOR_RG_64U:      downsample<SL_ColorRGType<uint64_t>>();         break;
+        case SL_COLOR_RG_HALF:     downsample<SL_ColorRGType<ls::math::half>>();   break;
+        case SL_COLOR_RG_FLOAT:    downsample<SL_ColorRGType<float>>();            break;
+        case SL_COLOR_RG_DOUBLE:   downsample<SL_ColorRGType<double>>();           break;
+
+        case SL_COLOR_RGB_8U:      downsample<SL_ColorRGBType<uint8_t>>();         break;
+        case SL_COLOR_RGB_16U:     downsample<SL_ColorRGBType<uint16_t>>();        break;
+        case SL_COLOR_RGB_32U:     downsample<SL_ColorRGBType<uint32_t>>();        break;
+        case SL_COLOR_RGB_64U:     downsample<SL_ColorRGBType<uint64_t>>();        break;
+        case SL_COLOR_RGB_HALF:    downsample<SL_ColorRGBType<ls::math::half>>();  break;
+        case SL_COLOR_RGB_FLOAT:   downsample<SL_ColorRGBType<float>>();           break;
+        case SL_COLOR_RGB_DOUBLE:  downsample<SL_ColorRGBType<double>>();          break;
+
+        case SL_COLOR_RGBA_8U:     downsample<SL_ColorRGBAType<uint8_t>>();        break;
+        case SL_COLOR_RGBA_16U:    downsample<SL_ColorRGBAType<uint16_t>>();       break;
+        case SL_COLOR_RGBA_32U:    downsample<SL_ColorRGBAType<uint32_t>>();       break;
+        case SL_COLOR_RGBA_64U:    downsample<SL_ColorRGBAType<uint64_t>>();       break;
+        case SL_COLOR_RGBA_HALF:   downsample<SL_ColorRGBAType<ls::math::half>>(); break;
+        case SL_COLOR_RGBA_FLOAT:  downsample<SL_ColorRGBAType<float>>();          break;
+        case SL_COLOR_RGBA_DOUBLE: downsample<SL_ColorRGBAType<double>>();         break;
+
+        default:
+            // compressed formats are rejected by SL_Texture::init_mips()
+            break;
+    }
+}
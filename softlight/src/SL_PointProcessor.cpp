@@ -34,7 +34,7 @@ void SL_PointProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a)
     while (true)
     {
         binId = active_num_bins_used().count.fetch_add(1, std::memory_order_acq_rel);
-        if (LS_UNLIKELY(binId < SL_SHADER_MAX_BINNED_PRIMS))
+        if (LS_UNLIKELY(binId < mMaxBins))
         {
             break;
         }
@@ -43,8 +43,7 @@ void SL_PointProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a)
     }
 
     // place a triangle into the next available bin
-    SL_FragmentBin* const pFragBins = active_frag_bins();
-    SL_FragmentBin& bin = pFragBins[binId];
+    SL_FragmentBin& bin = active_frag_bin(binId);
     bin.mScreenCoords[0] = a.vert;
 
     for (unsigned i = 0; i < numVaryings; ++i)
@@ -53,7 +52,7 @@ void SL_PointProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a)
     }
 
     bin.primIndex = primIndex;
-    active_bin_index(binId).count = binId;
+    active_bin_index(binId) = (uint32_t)binId;
 }
 
 
@@ -64,6 +63,8 @@ void SL_PointProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a)
 void SL_PointProcessor::process_verts(
     const SL_Mesh& m,
     size_t instanceId,
+    size_t begin,
+    size_t end,
     const ls::math::mat4_t<float>& scissorMat,
     const ls::math::vec4_t<float>& viewportDims) noexcept
 {
@@ -84,13 +85,6 @@ void SL_PointProcessor::process_verts(
     params.pVao       = &vao;
     params.pVbo       = &mContext->vbo(vao.get_vertex_buffer());
 
-    size_t begin;
-    size_t end;
-    sl_calc_indexed_parition<1, true>(m.elementEnd-m.elementBegin, mNumThreads, mThreadId, begin, end);
-
-    begin += m.elementBegin;
-    end += m.elementBegin;
-
     SL_PTVCache ptvCache{};
     const auto&& vertTransform = [&](size_t key, SL_TransformedVert& tv)->void {
         params.vertId = key;
@@ -126,19 +120,15 @@ void SL_PointProcessor::execute() noexcept
     const math::mat4&&      scissorMat   = viewState.scissor_matrix(fboDims[2], fboDims[3]);
     const math::vec4&&      viewportDims = viewState.viewport_rect(fboDims[2], fboDims[3]);
 
-    if (mNumInstances == 1)
-    {
-        for (size_t i = 0; i < mNumMeshes; ++i)
-        {
-            process_verts(mMeshes[i], 0, scissorMat, viewportDims);
-        }
-    }
-    else
+    constexpr size_t indicesPerBatch = SL_VERTEX_BATCH_SIZE;
+    size_t           meshId;
+    size_t           instanceId;
+    size_t           begin;
+    size_t           end;
+
+    while (next_vertex_batch(indicesPerBatch, meshId, instanceId, begin, end))
     {
-        for (size_t i = 0; i < mNumInstances; ++i)
-        {
-            process_verts(mMeshes[0], i, scissorMat, viewportDims);
-        }
+        process_verts(mMeshes[meshId], instanceId, begin, end, scissorMat, viewportDims);
     }
 
     this->cleanup<SL_PointRasterizer>();
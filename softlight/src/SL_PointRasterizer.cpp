@@ -3,6 +3,7 @@
 
 #include "softlight/SL_PointRasterizer.hpp"
 #include "softlight/SL_Framebuffer.hpp" // SL_Framebuffer
+#include "softlight/SL_ScanlineBounds.hpp" // sl_scanline_offset()
 #include "softlight/SL_Shader.hpp" // SL_FragmentShader
 #include "softlight/SL_Texture.hpp"
 #include "softlight/SL_ViewportState.hpp"
@@ -21,7 +22,7 @@ namespace utils = ls::utils;
  * SL_FragmentProcessor Class
 -----------------------------------------------------------------------------*/
 /*--------------------------------------
- * Determine if a point can be rendered.
+ * Rasterize points as squares of "pointSize" pixels.
 --------------------------------------*/
 template <class DepthCmpFunc, typename depth_type>
 void SL_PointRasterizer::render_point() noexcept
@@ -37,33 +38,32 @@ void SL_PointRasterizer::render_point() noexcept
     SL_FboOutputFunctions&  fboOutFuncs = *mFragFuncs;
     SL_TextureView* const   pColorBufs  = fboOutFuncs.pColorAttachments;
     SL_TextureView&         pDepthBuf   = *fboOutFuncs.pDepthAttachment;
+    depth_type* const       pDepth      = (depth_type*)pDepthBuf.pTexels;
+    const int32_t           fboW        = (int32_t)pDepthBuf.width;
+    const int32_t           fboH        = (int32_t)pDepthBuf.height;
+    const int32_t           numThreads  = (int32_t)mNumProcessors;
+    const int32_t           threadId    = (int32_t)mThreadId;
+    const int32_t           spriteSize  = sl_point_sprite_size(mShader->pointSize);
+    const float             spriteHalf  = 0.5f * (float)(spriteSize - 1);
     SL_FragmentParam        fragParams;
 
     fragParams.pUniforms = pUniforms;
 
-    for (uint64_t binId = 0; binId < mNumBins; ++binId)
-    {
-        const SL_FragmentBin& bin = mBins[binId];
-        const math::vec4& screenCoord = bin.mScreenCoords[0];
-
-        fragParams.coord.x     = (uint16_t)screenCoord[0];
-        fragParams.coord.y     = (uint16_t)screenCoord[1];
-        fragParams.coord.depth = screenCoord[2];
-        if (LS_LIKELY(fragParams.coord.y % mNumProcessors != mThreadId))
-        {
-            continue;
-        }
+    // Single-pixel points were grouped by their owning thread before
+    // rasterization. Larger points may span the scanlines of several threads
+    // and must be visited by each of them.
+    uint32_t binBegin = 0;
+    uint32_t binEnd   = (uint32_t)mNumBins;
 
-        const depth_type d = ((depth_type*)pDepthBuf.pTexels)[fragParams.coord.x + pDepthBuf.width * fragParams.coord.y];
-        if (LS_UNLIKELY(!depthCmp(fragParams.coord.depth, (float)d)))
-        {
-            continue;
-        }
+    if (spriteSize == 1)
+    {
+        mTileRanges[threadId].bounds(binBegin, binEnd);
+    }
 
-        for (unsigned i = numVaryings; i--;)
-        {
-            fragParams.pVaryings[i] = bin.mVaryings[i];
-        }
+    const auto&& shade_fragment = [&](int32_t x, int32_t y) noexcept->void
+    {
+        fragParams.coord.x = (uint16_t)x;
+        fragParams.coord.y = (uint16_t)y;
 
         const bool haveOutputs = fragShader(fragParams);
         if (LS_LIKELY(haveOutputs))
@@ -92,7 +92,63 @@ void SL_PointRasterizer::render_point() noexcept
 
         if (LS_LIKELY(depthMask))
         {
-            ((depth_type*)pDepthBuf.pTexels)[fragParams.coord.x + pDepthBuf.width * fragParams.coord.y] = (depth_type)fragParams.coord.depth;
+            pDepth[x + fboW * y] = (depth_type)fragParams.coord.depth;
+        }
+    };
+
+    for (uint32_t i = binBegin; i < binEnd; ++i)
+    {
+        const SL_FragmentBin& bin = sl_frag_bin(mBins, mBinStride, mBinIds[i]);
+        const math::vec4& screenCoord = bin.mScreenCoords[0];
+
+        const int32_t x0 = math::max(0, (int32_t)math::floor(screenCoord[0] - spriteHalf));
+        const int32_t y0 = math::max(0, (int32_t)math::floor(screenCoord[1] - spriteHalf));
+        const int32_t x1 = math::min(fboW, (int32_t)math::floor(screenCoord[0] - spriteHalf) + spriteSize);
+        const int32_t y1 = math::min(fboH, (int32_t)math::floor(screenCoord[1] - spriteHalf) + spriteSize);
+
+        fragParams.coord.depth = screenCoord[2];
+
+        for (unsigned v = numVaryings; v--;)
+        {
+            fragParams.pVaryings[v] = bin.mVaryings[v];
+        }
+
+        if (spriteSize == 1)
+        {
+            if (x0 < x1 && y0 < y1 && depthCmp(fragParams.coord.depth, (float)pDepth[x0 + fboW * y0]))
+            {
+                shade_fragment(x0, y0);
+            }
+            continue;
+        }
+
+        // Sprites are depth-tested four pixels at a time within each
+        // scanline owned by this thread.
+        const math::vec4 depth{fragParams.coord.depth};
+
+        for (int32_t y = y0 + sl_scanline_offset<int32_t>(numThreads, threadId, y0); y < y1; y += numThreads)
+        {
+            const depth_type* const pRow = pDepth + fboW * y;
+
+            for (int32_t x = x0; x < x1; x += 4)
+            {
+                const int32_t numPixels = math::min(4, x1 - x);
+                const math::vec4 d{
+                    (float)pRow[x],
+                    (float)pRow[x + math::min(1, numPixels-1)],
+                    (float)pRow[x + math::min(2, numPixels-1)],
+                    (float)pRow[x + math::min(3, numPixels-1)]
+                };
+                const math::vec4_t<int>&& depthTest = depthCmp(depth, d);
+
+                for (int32_t p = 0; p < numPixels; ++p)
+                {
+                    if (depthTest[p])
+                    {
+                        shade_fragment(x + p, y);
+                    }
+                }
+            }
         }
     }
 }
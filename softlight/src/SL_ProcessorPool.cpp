@@ -11,10 +11,13 @@
 
 #include "softlight/SL_FragmentProcessor.hpp"
 #include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_HybridWait.hpp"
 #include "softlight/SL_ProcessorPool.hpp"
 #include "softlight/SL_ShaderProcessor.hpp"
 #include "softlight/SL_Shader.hpp"
 #include "softlight/SL_ShaderUtil.hpp" // SL_FragmentBin
+#include "softlight/SL_TaskQueue.hpp"
+#include "softlight/SL_Texture.hpp"
 
 
 
@@ -25,6 +28,114 @@ class SL_Framebuffer;
 
 
 
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+
+
+/*--------------------------------------
+ * Only filled triangles are rasterized in tiles which keep a framebuffer's
+ * depth hierarchy up to date. Other primitives must invalidate it if they
+ * write to the depth buffer. Depth ranges only cover the first sample of each
+ * pixel, so multisampled framebuffers bypass the hierarchy entirely.
+--------------------------------------*/
+inline void _sl_prepare_depth_hierarchy(SL_FboOutputFunctions& fboFuncs, const SL_Shader& s, SL_RenderMode renderMode) noexcept
+{
+    if (!fboFuncs.pDepthHiZ)
+    {
+        return;
+    }
+
+    if (fboFuncs.numSamples <= 1 && (renderMode == RENDER_MODE_TRIANGLES || renderMode == RENDER_MODE_INDEXED_TRIANGLES))
+    {
+        return;
+    }
+
+    if (s.pipelineState.depth_mask() == SL_DEPTH_MASK_ON)
+    {
+        fboFuncs.pDepthHiZ->invalidate();
+    }
+
+    fboFuncs.pDepthHiZ = nullptr;
+}
+
+
+
+/*--------------------------------------
+ * Determine if a render mode uses the tiled triangle rasterizer.
+--------------------------------------*/
+inline bool _sl_rasterizes_tiles(SL_RenderMode renderMode) noexcept
+{
+    #if SL_TILED_RASTERIZATION_ENABLED
+        return renderMode == RENDER_MODE_TRIANGLES || renderMode == RENDER_MODE_INDEXED_TRIANGLES;
+    #else
+        (void)renderMode;
+        return false;
+    #endif
+}
+
+
+
+/*--------------------------------------
+ * Number of screen-space tiles used by the tiled triangle rasterizer.
+--------------------------------------*/
+inline uint32_t _sl_num_raster_tiles(const SL_TextureView& depthBuffer) noexcept
+{
+    return sl_num_raster_tiles<uint32_t>(depthBuffer.width) * sl_num_raster_tiles<uint32_t>(depthBuffer.height);
+}
+
+
+
+/*--------------------------------------
+ * Number of bins a draw may fill before flushing. A capacity of 0 uses
+ * every bin which fits into a vertex processing buffer.
+--------------------------------------*/
+inline uint32_t _sl_draw_bin_capacity(uint32_t binCapacity, size_t numVaryings) noexcept
+{
+    const uint32_t maxBins = (uint32_t)sl_frag_bin_capacity(numVaryings);
+    return (binCapacity > 0u && binCapacity < maxBins) ? binCapacity : maxBins;
+}
+
+
+
+/*--------------------------------------
+ * Screen area each thread may bin before the rasterizer is invoked early.
+ * Meshes of small triangles rarely reach this limit and keep batching up to
+ * the bin capacity, while large triangles get flushed sooner.
+--------------------------------------*/
+inline float _sl_draw_binned_area_limit(SL_BinFlushPolicy policy, float coverageLimit, const SL_FboOutputFunctions& fboFuncs, unsigned numThreads) noexcept
+{
+    if (policy != SL_BIN_FLUSH_ADAPTIVE || !(coverageLimit > 0.f) || !fboFuncs.pDepthAttachment)
+    {
+        return 0.f;
+    }
+
+    const float screenArea = (float)fboFuncs.pDepthAttachment->width * (float)fboFuncs.pDepthAttachment->height;
+    return (screenArea * coverageLimit) / (float)numThreads;
+}
+
+
+
+/*--------------------------------------
+ * Meshes can share a dispatch if they're rasterized identically.
+--------------------------------------*/
+inline bool _sl_render_modes_compatible(SL_RenderMode a, SL_RenderMode b) noexcept
+{
+    const bool wireA = (a == RENDER_MODE_TRI_WIRE) || (a == RENDER_MODE_INDEXED_TRI_WIRE);
+    const bool wireB = (b == RENDER_MODE_TRI_WIRE) || (b == RENDER_MODE_INDEXED_TRI_WIRE);
+
+    return (sl_processor_type_for_draw_mode(a) == sl_processor_type_for_draw_mode(b)) && (wireA == wireB);
+}
+
+
+
+} // end anonymous namespace
+
+
+
 /*-----------------------------------------------------------------------------
  * SL_ProcessorPool Class
 -----------------------------------------------------------------------------*/
@@ -47,9 +158,19 @@ SL_ProcessorPool::~SL_ProcessorPool() noexcept
 SL_ProcessorPool::SL_ProcessorPool(unsigned numThreads) noexcept :
     mVertProcBuffers{ls::utils::make_unique_aligned_array<SL_VertProcessBuffer>(SL_VERT_PROCESSOR_MAX_BUFFERS)},
     mShadingSemaphore{ls::utils::make_unique_aligned_pointer<SL_BinCounterAtomic<uint_fast64_t>>()},
+    mWaitSignal{ls::utils::make_unique_aligned_pointer<SL_HybridWait>()},
     mFragQueues{ls::utils::make_unique_aligned_array<SL_FragCoord>(numThreads)},
+    mVertexStats{ls::utils::make_unique_aligned_pointer<SL_VertexReuseStats>()},
+    mFlushStats{ls::utils::make_unique_aligned_pointer<SL_BinFlushStats>()},
+    mTaskRanges{ls::utils::make_unique_aligned_array<SL_TaskRange>(numThreads * (1u + SL_VERT_PROCESSOR_MAX_BUFFERS))},
+    mTileBins{nullptr, nullptr, nullptr, 0, 0, 0},
+    mBatchOffsets{},
     mWorkers{numThreads > 1 ? ls::utils::make_unique_aligned_array<SL_ProcessorPool::ThreadedWorker>(numThreads - 1) : nullptr},
-    mNumThreads{numThreads}
+    mNumThreads{numThreads},
+    mBinCapacity{0},
+    mFlushPolicy{SL_BIN_FLUSH_DEFAULT},
+    mBinCoverageLimit{(float)SL_BIN_COVERAGE_LIMIT},
+    mSpinBudget{SL_WAIT_SPIN_BUDGET}
 {
     LS_ASSERT(numThreads > 0);
 
@@ -81,9 +202,19 @@ SL_ProcessorPool::SL_ProcessorPool() noexcept :
 SL_ProcessorPool::SL_ProcessorPool(const SL_ProcessorPool& p) noexcept :
     mVertProcBuffers{ls::utils::make_unique_aligned_array<SL_VertProcessBuffer>(SL_VERT_PROCESSOR_MAX_BUFFERS)},
     mShadingSemaphore{ls::utils::make_unique_aligned_pointer<SL_BinCounterAtomic<uint_fast64_t>>()},
+    mWaitSignal{ls::utils::make_unique_aligned_pointer<SL_HybridWait>()},
     mFragQueues{ls::utils::make_unique_aligned_array<SL_FragCoord>(p.mNumThreads)},
+    mVertexStats{ls::utils::make_unique_aligned_pointer<SL_VertexReuseStats>()},
+    mFlushStats{ls::utils::make_unique_aligned_pointer<SL_BinFlushStats>()},
+    mTaskRanges{ls::utils::make_unique_aligned_array<SL_TaskRange>(p.mNumThreads * (1u + SL_VERT_PROCESSOR_MAX_BUFFERS))},
+    mTileBins{nullptr, nullptr, nullptr, 0, 0, 0},
+    mBatchOffsets{},
     mWorkers{p.mNumThreads > 1 ? ls::utils::make_unique_aligned_array<SL_ProcessorPool::ThreadedWorker>(p.mNumThreads - 1) : nullptr},
-    mNumThreads{p.mNumThreads}
+    mNumThreads{p.mNumThreads},
+    mBinCapacity{p.mBinCapacity},
+    mFlushPolicy{p.mFlushPolicy},
+    mBinCoverageLimit{p.mBinCoverageLimit},
+    mSpinBudget{p.mSpinBudget}
 {
     ls::utils::set_thread_affinity(ls::utils::get_thread_id(), 0);
 
@@ -104,10 +235,23 @@ SL_ProcessorPool::SL_ProcessorPool(const SL_ProcessorPool& p) noexcept :
 SL_ProcessorPool::SL_ProcessorPool(SL_ProcessorPool&& p) noexcept :
     mVertProcBuffers{std::move(p.mVertProcBuffers)},
     mShadingSemaphore{std::move(p.mShadingSemaphore)},
+    mWaitSignal{std::move(p.mWaitSignal)},
     mFragQueues{std::move(p.mFragQueues)},
+    mVertexStats{std::move(p.mVertexStats)},
+    mFlushStats{std::move(p.mFlushStats)},
+    mTaskRanges{std::move(p.mTaskRanges)},
+    mTileBins{std::move(p.mTileBins)},
+    mBatchOffsets{std::move(p.mBatchOffsets)},
     mWorkers{std::move(p.mWorkers)},
-    mNumThreads{p.mNumThreads}
+    mNumThreads{p.mNumThreads},
+    mBinCapacity{p.mBinCapacity},
+    mFlushPolicy{p.mFlushPolicy},
+    mBinCoverageLimit{p.mBinCoverageLimit},
+    mSpinBudget{p.mSpinBudget}
 {
+    p.mTileBins.maxBins = 0;
+    p.mTileBins.maxTiles = 0;
+    p.mTileBins.maxBinIds = 0;
     p.mNumThreads = 1;
 }
 
@@ -118,7 +262,17 @@ SL_ProcessorPool::SL_ProcessorPool(SL_ProcessorPool&& p) noexcept :
 --------------------------------------*/
 SL_ProcessorPool& SL_ProcessorPool::operator=(const SL_ProcessorPool& p) noexcept
 {
-    if (this == &p || concurrency() == p.concurrency())
+    if (this == &p)
+    {
+        return *this;
+    }
+
+    mBinCapacity = p.mBinCapacity;
+    mFlushPolicy = p.mFlushPolicy;
+    mBinCoverageLimit = p.mBinCoverageLimit;
+    mSpinBudget = p.mSpinBudget;
+
+    if (concurrency() == p.concurrency())
     {
         return *this;
     }
@@ -142,7 +296,16 @@ SL_ProcessorPool& SL_ProcessorPool::operator=(SL_ProcessorPool&& p) noexcept
 
     mVertProcBuffers = std::move(p.mVertProcBuffers);
     mShadingSemaphore = std::move(p.mShadingSemaphore);
+    mWaitSignal = std::move(p.mWaitSignal);
     mFragQueues = std::move(p.mFragQueues);
+    mVertexStats = std::move(p.mVertexStats);
+    mFlushStats = std::move(p.mFlushStats);
+    mTaskRanges = std::move(p.mTaskRanges);
+    mTileBins = std::move(p.mTileBins);
+    p.mTileBins.maxBins = 0;
+    p.mTileBins.maxTiles = 0;
+    p.mTileBins.maxBinIds = 0;
+    mBatchOffsets = std::move(p.mBatchOffsets);
 
     for (unsigned i = 0; i < mNumThreads-1u; ++i)
     {
@@ -154,6 +317,11 @@ SL_ProcessorPool& SL_ProcessorPool::operator=(SL_ProcessorPool&& p) noexcept
     mNumThreads = p.mNumThreads;
     p.mNumThreads = 1;
 
+    mBinCapacity = p.mBinCapacity;
+    mFlushPolicy = p.mFlushPolicy;
+    mBinCoverageLimit = p.mBinCoverageLimit;
+    mSpinBudget = p.mSpinBudget;
+
     return *this;
 }
 
@@ -177,47 +345,21 @@ void SL_ProcessorPool::flush() noexcept
 -------------------------------------*/
 void SL_ProcessorPool::wait() noexcept
 {
-    // Each thread will pause except for the main thread.
-    unsigned currentIters;
-
+    // Each thread will pause except for the main thread. Poll each worker
+    // briefly before sleeping until it finishes.
     for (unsigned threadId = 0; threadId < mNumThreads - 1u; ++threadId)
     {
-        currentIters = 1;
+        ThreadedWorker& worker = mWorkers[threadId];
 
-        while (!mWorkers[threadId].ready())
+        for (uint32_t numSpins = 0; !worker.ready(); ++numSpins)
         {
-            switch (currentIters)
+            if (numSpins < mSpinBudget)
             {
-                case 32:
-                    mWorkers[threadId].wait();
-                    break;
-
-                case 16:
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-
-                case 8:
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-
-                case 4:
-                    ls::setup::cpu_yield();
-                    ls::setup::cpu_yield();
-
-                case 2:
-                    ls::setup::cpu_yield();
-
-                default:
-                    ls::setup::cpu_yield();
-                    currentIters = currentIters + currentIters;
+                ls::setup::cpu_yield();
+            }
+            else
+            {
+                worker.wait();
             }
         }
     }
@@ -240,6 +382,13 @@ unsigned SL_ProcessorPool::concurrency(unsigned inNumThreads) noexcept
 
     mVertProcBuffers = ls::utils::make_unique_aligned_array<SL_VertProcessBuffer>(SL_VERT_PROCESSOR_MAX_BUFFERS);
     mFragQueues = ls::utils::make_unique_aligned_array<SL_FragCoord>(inNumThreads);
+    mTaskRanges = ls::utils::make_unique_aligned_array<SL_TaskRange>(inNumThreads * (1u + SL_VERT_PROCESSOR_MAX_BUFFERS));
+    mTileBins.bins.reset();
+    mTileBins.tileOffsets.reset();
+    mTileBins.binIds.reset();
+    mTileBins.maxBins = 0;
+    mTileBins.maxTiles = 0;
+    mTileBins.maxBinIds = 0;
 
     mWorkers.reset();
     if (inNumThreads > 1)
@@ -276,33 +425,99 @@ unsigned SL_ProcessorPool::concurrency(unsigned inNumThreads) noexcept
 
 
 /*-------------------------------------
+ * Ensure there's room to gather the tiles overlapped by a number of bins.
+ * The per-tile lists themselves are grown while flushing bins.
 -------------------------------------*/
-void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh& m, size_t numInstances, const SL_Shader& s, SL_Framebuffer& fbo) noexcept
+SL_TileBinLists* SL_ProcessorPool::reserve_tile_bins(uint32_t maxBins, uint32_t numTiles) noexcept
+{
+    if (mTileBins.maxBins < maxBins)
+    {
+        mTileBins.bins = ls::utils::make_unique_aligned_array<SL_TileBin>(maxBins);
+        mTileBins.maxBins = maxBins;
+    }
+
+    if (mTileBins.maxTiles < numTiles)
+    {
+        mTileBins.tileOffsets = ls::utils::make_unique_aligned_array<uint32_t>(numTiles + 1u);
+        mTileBins.maxTiles = numTiles;
+    }
+
+    return &mTileBins;
+}
+
+
+
+/*-------------------------------------
+ * Assign each thread a range of vertex batches
+-------------------------------------*/
+void SL_ProcessorPool::distribute_vertex_batches(const SL_Mesh* meshes, size_t numMeshes, size_t numInstances) noexcept
+{
+    const size_t elementsPerBatch = SL_VERTEX_BATCH_SIZE * sl_vertices_per_primitive(meshes[0].mode);
+
+    mBatchOffsets.resize(numMeshes + 1u);
+    mBatchOffsets[0] = 0;
+
+    for (size_t i = 0; i < numMeshes; ++i)
+    {
+        const size_t numElements = meshes[i].elementEnd - meshes[i].elementBegin;
+        mBatchOffsets[i+1u] = mBatchOffsets[i] + (uint32_t)((numElements + elementsPerBatch - 1u) / elementsPerBatch);
+    }
+
+    // Instanced draws only contain one mesh. Batches are numbered
+    // consecutively through each instance.
+    const uint64_t numBatches = (uint64_t)mBatchOffsets[numMeshes] * (uint64_t)numInstances;
+
+    for (unsigned t = 0; t < mNumThreads; ++t)
+    {
+        const uint32_t begin = (uint32_t)((numBatches * t) / mNumThreads);
+        const uint32_t end   = (uint32_t)((numBatches * (t+1u)) / mNumThreads);
+        mTaskRanges[t].reset(begin, end);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Process a set of meshes which share a rasterizer
+-------------------------------------*/
+void SL_ProcessorPool::run_vertex_processors(const SL_Context& c, const SL_Mesh* meshes, size_t numMeshes, size_t numInstances, const SL_Shader& s, const SL_FboOutputFunctions& fboOutputs) noexcept
 {
     // Reserve enough space for each thread to contain all triangles
     mShadingSemaphore->count.store(mNumThreads);
     clear_fragment_bins();
+    distribute_vertex_batches(meshes, numMeshes, numInstances);
 
-    const SL_RenderMode renderMode = m.mode;
+    const SL_RenderMode renderMode = meshes[0].mode;
     SL_ShaderProcessor task;
     task.mType = sl_processor_type_for_draw_mode(renderMode);
 
-    SL_FboOutputFunctions fboFuncs;
-    fbo.build_output_functions(fboFuncs, s.pipelineState.blend_mode() != SL_BlendMode::SL_BLEND_OFF);
+    SL_FboOutputFunctions fboFuncs = fboOutputs;
+    _sl_prepare_depth_hierarchy(fboFuncs, s, renderMode);
 
     SL_VertexProcessor* vertTask  = task.processor_for_draw_mode(renderMode);
     vertTask->mNumThreads         = (int16_t)mNumThreads;
     vertTask->mProcessBufferIndex = 0;
     vertTask->mProcessBuffer      = mVertProcBuffers.get();
+    vertTask->mBinStride          = (uint32_t)sl_frag_bin_stride(s.pipelineState.num_varyings());
+    vertTask->mMaxBins            = _sl_draw_bin_capacity(mBinCapacity, s.pipelineState.num_varyings());
+    vertTask->mBinnedArea         = 0.f;
+    vertTask->mMaxBinnedArea      = _sl_draw_binned_area_limit(mFlushPolicy, mBinCoverageLimit, fboFuncs, mNumThreads);
     vertTask->mBusyProcessors     = mShadingSemaphore.get();
+    vertTask->mWaitSignal         = mWaitSignal.get();
+    vertTask->mSpinBudget         = mSpinBudget;
     vertTask->mShader             = &s;
     vertTask->mContext            = &c;
     vertTask->mFragFuncs          = &fboFuncs;
-    vertTask->mRenderMode         = m.mode;
-    vertTask->mNumMeshes          = 1;
+    vertTask->mRenderMode         = renderMode;
+    vertTask->mNumMeshes          = numMeshes;
     vertTask->mNumInstances       = numInstances;
-    vertTask->mMeshes             = &m;
+    vertTask->mMeshes             = meshes;
     vertTask->mFragQueues         = mFragQueues.get();
+    vertTask->mTileBins           = _sl_rasterizes_tiles(renderMode) ? reserve_tile_bins(vertTask->mMaxBins, _sl_num_raster_tiles(*fboFuncs.pDepthAttachment)) : nullptr;
+    vertTask->mVertexStats        = mVertexStats.get();
+    vertTask->mFlushStats         = mFlushStats.get();
+    vertTask->mTaskRanges         = mTaskRanges.get();
+    vertTask->mBatchOffsets       = mBatchOffsets.data();
 
     // Divide all vertex processing amongst the available worker threads. Let
     // The threads work out between themselves how to partition the data.
@@ -330,53 +545,38 @@ void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh&
 
 /*-------------------------------------
 -------------------------------------*/
-void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh* meshes, size_t numMeshes, const SL_Shader& s, SL_Framebuffer& fbo) noexcept
+void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh& m, size_t numInstances, const SL_Shader& s, SL_Framebuffer& fbo) noexcept
 {
-    // Reserve enough space for each thread to contain all triangles
-    mShadingSemaphore->count.store(mNumThreads);
-    clear_fragment_bins();
+    SL_FboOutputFunctions fboFuncs;
+    fbo.build_output_functions(fboFuncs, s.pipelineState.blend_mode() != SL_BlendMode::SL_BLEND_OFF);
 
-    const SL_RenderMode renderMode = meshes[0].mode;
-    SL_ShaderProcessor task;
-    task.mType = sl_processor_type_for_draw_mode(renderMode);
+    run_vertex_processors(c, &m, 1, numInstances, s, fboFuncs);
+}
 
+
+
+/*-------------------------------------
+-------------------------------------*/
+void SL_ProcessorPool::run_shader_processors(const SL_Context& c, const SL_Mesh* meshes, size_t numMeshes, const SL_Shader& s, SL_Framebuffer& fbo) noexcept
+{
     SL_FboOutputFunctions fboFuncs;
     fbo.build_output_functions(fboFuncs, s.pipelineState.blend_mode() != SL_BlendMode::SL_BLEND_OFF);
 
-    SL_VertexProcessor* vertTask = task.processor_for_draw_mode(renderMode);
-    vertTask->mNumThreads         = (int16_t)mNumThreads;
-    vertTask->mProcessBufferIndex = 0;
-    vertTask->mProcessBuffer      = mVertProcBuffers.get();
-    vertTask->mBusyProcessors     = mShadingSemaphore.get();
-    vertTask->mShader             = &s;
-    vertTask->mContext            = &c;
-    vertTask->mFragFuncs          = &fboFuncs;
-    vertTask->mRenderMode         = meshes->mode;
-    vertTask->mNumMeshes          = numMeshes;
-    vertTask->mNumInstances       = 1;
-    vertTask->mMeshes             = meshes;
-    vertTask->mFragQueues         = mFragQueues.get();
-
-    // Divide all vertex processing amongst the available worker threads. Let
-    // The threads work out between themselves how to partition the data.
-    for (uint16_t threadId = 0; threadId < mNumThreads; ++threadId)
+    // Meshes may use different render modes. Consecutive meshes which share
+    // a rasterizer are processed together, as a single pool of batches, so
+    // draw order is preserved between modes.
+    for (size_t first = 0; first < numMeshes;)
     {
-        vertTask->mThreadId = threadId;
+        size_t last = first + 1u;
 
-        // Busy waiting will be enabled the moment the first flush occurs on each
-        // thread.
-        if (threadId < mNumThreads-1)
+        while (last < numMeshes && _sl_render_modes_compatible(meshes[first].mode, meshes[last].mode))
         {
-            SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
-            worker.push(task);
+            ++last;
         }
-    }
-
-    flush();
-    task();
 
-    // Each thread should now pause except for the main thread.
-    wait();
+        run_vertex_processors(c, meshes+first, last-first, 1, s, fboFuncs);
+        first = last;
+    }
 }
 
 
@@ -389,11 +589,64 @@ void SL_ProcessorPool::clear_fragment_bins() noexcept
     for (unsigned i = 0; i < SL_VERT_PROCESSOR_MAX_BUFFERS; ++i)
     {
         mVertProcBuffers[i].mBinsUsed.count = 0;
+        mVertProcBuffers[i].mCoverageFlush.count = 0;
         mVertProcBuffers[i].mFragProcessors.count.store(0);
     }
 }
 
 
+/*-------------------------------------
+ * Ratio of referenced vertices to vertex shader invocations
+-------------------------------------*/
+float SL_ProcessorPool::vertex_reuse_ratio() const noexcept
+{
+    const uint_fast64_t numReferenced = mVertexStats->mNumVertsReferenced.count.load(std::memory_order_acquire);
+    const uint_fast64_t numShaded = mVertexStats->mNumVertsShaded.count.load(std::memory_order_acquire);
+
+    return numShaded ? ((float)numReferenced / (float)numShaded) : 0.f;
+}
+
+
+
+/*-------------------------------------
+ * Reset all vertex reuse counters
+-------------------------------------*/
+void SL_ProcessorPool::reset_vertex_stats() noexcept
+{
+    mVertexStats->mNumVertsReferenced.count.store(0, std::memory_order_release);
+    mVertexStats->mNumVertsShaded.count.store(0, std::memory_order_release);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the number of times bins were flushed to the rasterizer
+-------------------------------------*/
+SL_BinFlushCounts SL_ProcessorPool::bin_flush_counts() const noexcept
+{
+    return SL_BinFlushCounts{
+        (uint64_t)mFlushStats->mNumFlushes.count.load(std::memory_order_acquire),
+        (uint64_t)mFlushStats->mNumBinsFlushed.count.load(std::memory_order_acquire),
+        (uint64_t)mFlushStats->mNumCapacityFlushes.count.load(std::memory_order_acquire),
+        (uint64_t)mFlushStats->mNumCoverageFlushes.count.load(std::memory_order_acquire)
+    };
+}
+
+
+
+/*-------------------------------------
+ * Reset all bin flushing counters
+-------------------------------------*/
+void SL_ProcessorPool::reset_bin_flush_stats() noexcept
+{
+    mFlushStats->mNumFlushes.count.store(0, std::memory_order_release);
+    mFlushStats->mNumBinsFlushed.count.store(0, std::memory_order_release);
+    mFlushStats->mNumCapacityFlushes.count.store(0, std::memory_order_release);
+    mFlushStats->mNumCoverageFlushes.count.store(0, std::memory_order_release);
+}
+
+
+
 /*-------------------------------------
  * Execute a texture blit across threads
 -------------------------------------*/
@@ -407,7 +660,8 @@ void SL_ProcessorPool::run_blit_processors(
     uint16_t dstX0,
     uint16_t dstY0,
     uint16_t dstX1,
-    uint16_t dstY1) noexcept
+    uint16_t dstY1,
+    SL_BlitFilter filter) noexcept
 {
     SL_ShaderProcessor processor;
     LS_ASSERT(!sl_is_compressed_color(inTex->type) && !sl_is_compressed_color(outTex->type));
@@ -426,6 +680,7 @@ void SL_ProcessorPool::run_blit_processors(
     blitter.dstY1       = dstY1;
     blitter.mSrcTex     = inTex;
     blitter.mDstTex     = outTex;
+    blitter.mFilter     = filter;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -500,7 +755,7 @@ void SL_ProcessorPool::run_blit_compressed_processors(
 /*-------------------------------------
  * Clear a framebuffer's attachment across threads
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_TextureView* outTex) noexcept
+void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_TextureView* outTex, SL_HiZBuffer* depthHiZ) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -508,8 +763,10 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_TextureView*
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId   = 0;
     blitter.mNumThreads = (uint16_t)mNumThreads;
+    blitter.mFastClear  = nullptr;
     blitter.mTexture    = inColor;
     blitter.mBackBuffer = outTex;
+    blitter.mDepthHiZ   = depthHiZ;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -533,7 +790,7 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, SL_TextureView*
 /*-------------------------------------
  * Clear a framebuffer across threads
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* depth, SL_TextureView* colorBuf, SL_TextureView* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* depth, SL_TextureView* colorBuf, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -541,6 +798,7 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* dep
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId   = 0;
     blitter.mNumThreads = (uint16_t)mNumThreads;
+    blitter.mFastClear  = nullptr;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -550,10 +808,12 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* dep
 
         blitter.mBackBuffer = colorBuf;
         blitter.mTexture = inColor;
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = depthBuf;
         blitter.mTexture = depth;
+        blitter.mDepthHiZ = depthHiZ;
         worker.push(processor);
     }
 
@@ -562,10 +822,12 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* dep
     blitter.mThreadId = (uint16_t)(mNumThreads - 1u);
     blitter.mBackBuffer = colorBuf;
     blitter.mTexture = inColor;
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = depthBuf;
     blitter.mTexture = depth;
+    blitter.mDepthHiZ = depthHiZ;
     blitter.execute();
 
     // Each thread should now pause except for the main thread.
@@ -577,7 +839,7 @@ void SL_ProcessorPool::run_clear_processors(const void* inColor, const void* dep
 /*-------------------------------------
  * Clear a framebuffer across threads (2 attachments)
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_TextureView*, 2>& colorBufs, SL_TextureView* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& inColors, const void* depth, const std::array<SL_TextureView*, 2>& colorBufs, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -585,6 +847,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& in
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId   = 0;
     blitter.mNumThreads = (uint16_t)mNumThreads;
+    blitter.mFastClear  = nullptr;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -594,14 +857,17 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& in
 
         blitter.mBackBuffer = colorBufs[0];
         blitter.mTexture = inColors[0];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = colorBufs[1];
         blitter.mTexture = inColors[1];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = depthBuf;
         blitter.mTexture = depth;
+        blitter.mDepthHiZ = depthHiZ;
         worker.push(processor);
     }
 
@@ -610,14 +876,17 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& in
     blitter.mThreadId = (uint16_t)(mNumThreads - 1u);
     blitter.mBackBuffer = colorBufs[0];
     blitter.mTexture = inColors[0];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = colorBufs[1];
     blitter.mTexture = inColors[1];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = depthBuf;
     blitter.mTexture = depth;
+    blitter.mDepthHiZ = depthHiZ;
     blitter.execute();
 
     // Each thread should now pause except for the main thread.
@@ -629,7 +898,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 2>& in
 /*-------------------------------------
  * Clear a framebuffer across threads (3 attachments)
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_TextureView*, 3>& colorBufs, SL_TextureView* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& inColors, const void* depth, const std::array<SL_TextureView*, 3>& colorBufs, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -637,6 +906,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& in
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId   = 0;
     blitter.mNumThreads = (uint16_t)mNumThreads;
+    blitter.mFastClear  = nullptr;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -646,18 +916,22 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& in
 
         blitter.mBackBuffer = colorBufs[0];
         blitter.mTexture = inColors[0];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = colorBufs[1];
         blitter.mTexture = inColors[1];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = colorBufs[2];
         blitter.mTexture = inColors[2];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = depthBuf;
         blitter.mTexture = depth;
+        blitter.mDepthHiZ = depthHiZ;
         worker.push(processor);
     }
 
@@ -666,18 +940,22 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& in
     blitter.mThreadId = (uint16_t)(mNumThreads - 1u);
     blitter.mBackBuffer = colorBufs[0];
     blitter.mTexture = inColors[0];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = colorBufs[1];
     blitter.mTexture = inColors[1];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = colorBufs[2];
     blitter.mTexture = inColors[2];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = depthBuf;
     blitter.mTexture = depth;
+    blitter.mDepthHiZ = depthHiZ;
     blitter.execute();
 
     // Each thread should now pause except for the main thread.
@@ -689,7 +967,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 3>& in
 /*-------------------------------------
  * Clear a framebuffer across threads (4 attachments)
 -------------------------------------*/
-void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_TextureView*, 4>& colorBufs, SL_TextureView* depthBuf) noexcept
+void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& inColors, const void* depth, const std::array<SL_TextureView*, 4>& colorBufs, SL_TextureView* depthBuf, SL_HiZBuffer* depthHiZ) noexcept
 {
     SL_ShaderProcessor processor;
     processor.mType = SL_CLEAR_PROCESSOR;
@@ -697,6 +975,7 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& in
     SL_ClearProcessor& blitter = processor.mClear;
     blitter.mThreadId   = 0;
     blitter.mNumThreads = (uint16_t)mNumThreads;
+    blitter.mFastClear  = nullptr;
 
     // Process most of the rendering on other threads first.
     for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
@@ -706,22 +985,27 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& in
 
         blitter.mBackBuffer = colorBufs[0];
         blitter.mTexture = inColors[0];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = colorBufs[1];
         blitter.mTexture = inColors[1];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = colorBufs[2];
         blitter.mTexture = inColors[2];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = colorBufs[3];
         blitter.mTexture = inColors[3];
+        blitter.mDepthHiZ = nullptr;
         worker.push(processor);
 
         blitter.mBackBuffer = depthBuf;
         blitter.mTexture = depth;
+        blitter.mDepthHiZ = depthHiZ;
         worker.push(processor);
     }
 
@@ -730,24 +1014,168 @@ void SL_ProcessorPool::run_clear_processors(const std::array<const void*, 4>& in
     blitter.mThreadId = (uint16_t)(mNumThreads - 1u);
     blitter.mBackBuffer = colorBufs[0];
     blitter.mTexture = inColors[0];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = colorBufs[1];
     blitter.mTexture = inColors[1];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = colorBufs[2];
     blitter.mTexture = inColors[2];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = colorBufs[3];
     blitter.mTexture = inColors[3];
+    blitter.mDepthHiZ = nullptr;
     blitter.execute();
 
     blitter.mBackBuffer = depthBuf;
     blitter.mTexture = depth;
+    blitter.mDepthHiZ = depthHiZ;
     blitter.execute();
 
     // Each thread should now pause except for the main thread.
     wait();
 }
+
+
+
+/*-------------------------------------
+ * Write the pending clears of every framebuffer tile across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_resolve_processors(SL_FastClear* fastClear, SL_TextureView* colorBufs, SL_TextureView* depthBuf) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_CLEAR_PROCESSOR;
+
+    SL_ClearProcessor& blitter = processor.mClear;
+    blitter.mThreadId    = 0;
+    blitter.mNumThreads  = (uint16_t)mNumThreads;
+    blitter.mTexture     = nullptr;
+    blitter.mBackBuffer  = colorBufs;
+    blitter.mDepthHiZ    = nullptr;
+    blitter.mFastClear   = fastClear;
+    blitter.mDepthBuffer = depthBuf;
+
+    // Process most of the rendering on other threads first.
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        blitter.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.push(processor);
+    }
+
+    flush();
+    blitter.mThreadId = (uint16_t)(mNumThreads - 1u);
+    blitter.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+
+    fastClear->mark_resolved();
+}
+
+
+
+/*-------------------------------------
+ * Generate each mip level of a texture across threads. Every level depends
+ * on the one before it, so the pool is synchronized between levels.
+-------------------------------------*/
+void SL_ProcessorPool::run_mip_processors(SL_Texture& tex, SL_MipFilter filter, SL_TexelOrder order) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_MIP_PROCESSOR;
+
+    SL_MipProcessor& mipGen = processor.mMipGenerator;
+    mipGen.mNumThreads = (uint16_t)mNumThreads;
+    mipGen.mFilter     = filter;
+    mipGen.mTexelOrder = order;
+
+    for (uint16_t level = 1; level < tex.num_mips(); ++level)
+    {
+        mipGen.mSrcTex = &tex.mip(level-1u);
+        mipGen.mDstTex = &tex.mip(level);
+
+        for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+        {
+            mipGen.mThreadId = threadId;
+
+            SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+            worker.push(processor);
+        }
+
+        flush();
+        mipGen.mThreadId = (uint16_t)(mNumThreads - 1u);
+        mipGen.execute();
+
+        wait();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Average the samples of a multisampled texture across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_sample_resolve_processors(const SL_TextureView* inTex, SL_TextureView* outTex) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_SAMPLE_RESOLVE_PROCESSOR;
+
+    SL_SampleResolveProcessor& resolver = processor.mSampleResolver;
+    resolver.mNumThreads = (uint16_t)mNumThreads;
+    resolver.mSrcTex     = inTex;
+    resolver.mDstTex     = outTex;
+
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        resolver.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.push(processor);
+    }
+
+    flush();
+    resolver.mThreadId = (uint16_t)(mNumThreads - 1u);
+    resolver.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+}
+
+
+
+/*-------------------------------------
+ * Encode or decode a block-compressed texture across threads
+-------------------------------------*/
+void SL_ProcessorPool::run_block_compress_processors(const SL_TextureView* inTex, SL_TextureView* outTex, SL_TexelOrder order, bool decompress) noexcept
+{
+    SL_ShaderProcessor processor;
+    processor.mType = SL_BLOCK_COMPRESS_PROCESSOR;
+
+    SL_BlockCompressProcessor& compressor = processor.mBlockCompressor;
+    compressor.mNumThreads = (uint16_t)mNumThreads;
+    compressor.mTexelOrder = order;
+    compressor.mDecompress = decompress;
+    compressor.mSrcTex     = inTex;
+    compressor.mDstTex     = outTex;
+
+    for (uint16_t threadId = 0; threadId < mNumThreads - 1; ++threadId)
+    {
+        compressor.mThreadId = threadId;
+
+        SL_ProcessorPool::ThreadedWorker& worker = mWorkers[threadId];
+        worker.push(processor);
+    }
+
+    flush();
+    compressor.mThreadId = (uint16_t)(mNumThreads - 1u);
+    compressor.execute();
+
+    // Each thread should now pause except for the main thread.
+    wait();
+}
@@ -0,0 +1,93 @@
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_SampleResolveProcessor.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_SampleResolveProcessor Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Average the samples of each texel
+-------------------------------------*/
+template <typename color_type>
+void SL_SampleResolveProcessor::resolve_samples() noexcept
+{
+    typedef typename color_type::value_type value_type;
+    typedef decltype(color_cast<float, value_type>(color_type{})) float_color;
+
+    const SL_TextureView&   src          = *mSrcTex;
+    const SL_TextureView&   dst          = *mDstTex;
+    const color_type* const pSrc         = reinterpret_cast<const color_type*>(src.pTexels);
+    color_type* const       pDst         = reinterpret_cast<color_type*>(dst.pTexels);
+    const uint_fast32_t     width        = (uint_fast32_t)dst.width;
+    const uint_fast32_t     height       = (uint_fast32_t)dst.height;
+    const uint_fast32_t     numSamples   = (uint_fast32_t)src.depth;
+    const ptrdiff_t         sampleStride = (ptrdiff_t)src.width * (ptrdiff_t)src.height;
+    const float             weight       = 1.f / (float)numSamples;
+
+    for (uint_fast32_t y = mThreadId; y < height; y += mNumThreads)
+    {
+        const color_type* pSrcRow = pSrc + sl_texel_index(src, 0, y);
+        color_type*       pDstRow = pDst + sl_texel_index(dst, 0, y);
+
+        for (uint_fast32_t x = 0; x < width; ++x)
+        {
+            float_color accum = color_cast<float, value_type>(pSrcRow[x]);
+
+            for (uint_fast32_t s = 1; s < numSamples; ++s)
+            {
+                accum = accum + color_cast<float, value_type>(pSrcRow[x + sampleStride * s]);
+            }
+
+            pDstRow[x] = color_cast<value_type, float>(accum * weight);
+        }
+    }
+}
+
+
+
+/*-------------------------------------
+ * Run the sample resolver
+-------------------------------------*/
+void SL_SampleResolveProcessor::execute() noexcept
+{
+    switch (mSrcTex->type)
+    {
+        case SL_COLOR_R_8U:        resolve_samples<SL_ColorRType<uint8_t>>();           break;
+        case SL_COLOR_R_16U:       resolve_samples<SL_ColorRType<uint16_t>>();          break;
+        case SL_COLOR_R_32U:       resolve_samples<SL_ColorRType<uint32_t>>();          break;
+        case SL_COLOR_R_64U:       resolve_samples<SL_ColorRType<uint64_t>>();          break;
+        case SL_COLOR_R_HALF:      resolve_samples<SL_ColorRType<ls::math::half>>();    break;
+        case SL_COLOR_R_FLOAT:     resolve_samples<SL_ColorRType<float>>();             break;
+        case SL_COLOR_R_DOUBLE:    resolve_samples<SL_ColorRType<double>>();            break;
+
+        case SL_COLOR_RG_8U:       resolve_samples<SL_ColorRGType<uint8_t>>();          break;
+        case SL_COLOR_RG_16U:      resolve_samples<SL_ColorRGType<uint16_t>>();         break;
+        case SL_COLOR_RG_32U:      resolve_samples<SL_ColorRGType<uint32_t>>();         break;
+        case SL_COLOR_RG_64U:      resolve_samples<SL_ColorRGType<uint64_t>>();         break;
+        case SL_COLOR_RG_HALF:     resolve_samples<SL_ColorRGType<ls::math::half>>();   break;
+        case SL_COLOR_RG_FLOAT:    resolve_samples<SL_ColorRGType<float>>();            break;
+        case SL_COLOR_RG_DOUBLE:   resolve_samples<SL_ColorRGType<double>>();           break;
+
+        case SL_COLOR_RGB_8U:      resolve_samples<SL_ColorRGBType<uint8_t>>();         break;
+        case SL_COLOR_RGB_16U:     resolve_samples<SL_ColorRGBType<uint16_t>>();        break;
+        case SL_COLOR_RGB_32U:     resolve_samples<SL_ColorRGBType<uint32_t>>();        break;
+        case SL_COLOR_RGB_64U:     resolve_samples<SL_ColorRGBType<uint64_t>>();        break;
+        case SL_COLOR_RGB_HALF:    resolve_samples<SL_ColorRGBType<ls::math::half>>();  break;
+        case SL_COLOR_RGB_FLOAT:   resolve_samples<SL_ColorRGBType<float>>();           break;
+        case SL_COLOR_RGB_DOUBLE:  resolve_samples<SL_ColorRGBType<double>>();          break;
+
+        case SL_COLOR_RGBA_8U:     resolve_samples<SL_ColorRGBAType<uint8_t>>();        break;
+        case SL_COLOR_RGBA_16U:    resolve_samples<SL_ColorRGBAType<uint16_t>>();       break;
+        case SL_COLOR_RGBA_32U:    resolve_samples<SL_ColorRGBAType<uint32_t>>();       break;
+        case SL_COLOR_RGBA_64U:    resolve_samples<SL_ColorRGBAType<uint64_t>>();       break;
+        case SL_COLOR_RGBA_HALF:   resolve_samples<SL_ColorRGBAType<ls::math::half>>(); break;
+        case SL_COLOR_RGBA_FLOAT:  resolve_samples<SL_ColorRGBAType<float>>();          break;
+        case SL_COLOR_RGBA_DOUBLE: resolve_samples<SL_ColorRGBAType<double>>();         break;
+
+        default:
+            // compressed formats are rejected by SL_Context::resolve_samples()
+            break;
+    }
+}
@@ -0,0 +1,1650 @@
+
+#include <cstdio> // std::rename(), std::remove()
+#include <cstring> // std::memcmp()
+#include <fstream>
+#include <new> // std::nothrow
+#include <utility> // std::move
+
+#include <sys/types.h>
+#include <sys/stat.h> // stat()
+
+#include "lightsky/setup/Macros.h" // LS_ARRAY_SIZE
+#include "lightsky/setup/OS.h" // LS_OS_WINDOWS
+
+#include "lightsky/utils/Copy.h"
+#include "lightsky/utils/Log.h"
+
+#include "softlight/SL_Animation.hpp"
+#include "softlight/SL_AnimationChannel.hpp"
+#include "softlight/SL_AnimationKeyList.hpp"
+#include "softlight/SL_BoundingBox.hpp"
+#include "softlight/SL_Camera.hpp"
+#include "softlight/SL_ImgFile.hpp"
+#include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_MappedFile.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_SceneFileCache.hpp"
+#include "softlight/SL_SceneGraph.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_Transform.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+
+
+namespace math = ls::math;
+namespace utils = ls::utils;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Anonymous helper functions
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+// Cached arrays of matrices and keyframes are copied directly into memory
+static_assert(sizeof(math::mat4) == sizeof(float) * 16, "Cached matrices require tightly packed floats.");
+static_assert(sizeof(math::vec3) == sizeof(float) * 3, "Cached vectors require tightly packed floats.");
+static_assert(sizeof(math::quat) == sizeof(float) * 4, "Cached quaternions require tightly packed floats.");
+static_assert(sizeof(SL_AnimPrecision) == sizeof(float), "Cached keyframe times must be single-precision.");
+
+constexpr char     _SL_SCENE_CACHE_MAGIC[4]   = {'S', 'L', 'S', 'C'};
+constexpr uint32_t _SL_SCENE_CACHE_BYTE_ORDER = 0x01020304u;
+constexpr uint32_t _SL_SCENE_CACHE_NO_TEXTURE = 0xFFFFFFFFu;
+constexpr uint64_t _SL_SCENE_CACHE_NO_BUFFER  = ~(uint64_t)0;
+
+// Index buffers must remain readable past their last element
+constexpr uint64_t _SL_SCENE_CACHE_IBO_PADDING = 16;
+
+
+
+/*-------------------------------------
+ * Pack load options into a bitmask
+-------------------------------------*/
+inline uint32_t _sl_pack_load_opts(const SL_SceneLoadOpts& opts) noexcept
+{
+    return 0u
+        | ((uint32_t)opts.packUvs          << 0u)
+        | ((uint32_t)opts.packNormals      << 1u)
+        | ((uint32_t)opts.packBoneIds      << 2u)
+        | ((uint32_t)opts.packBoneWeights  << 3u)
+        | ((uint32_t)opts.genFlatNormals   << 4u)
+        | ((uint32_t)opts.genSmoothNormals << 5u)
+        | ((uint32_t)opts.genTangents      << 6u)
+        | ((uint32_t)opts.swizzleTexels    << 7u)
+        | ((uint32_t)opts.compressTextures << 8u);
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the size and modification time of a file
+-------------------------------------*/
+bool _sl_file_stats(const std::string& path, uint64_t& outBytes, int64_t& outTime) noexcept
+{
+    struct stat fileInfo;
+
+    if (stat(path.c_str(), &fileInfo) != 0)
+    {
+        return false;
+    }
+
+    outBytes = (uint64_t)fileInfo.st_size;
+    outTime = (int64_t)fileInfo.st_mtime;
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Append bytes to a cache, returning their offset
+-------------------------------------*/
+uint64_t _sl_cache_append(std::vector<char>& blob, const void* pData, size_t numBytes, size_t alignment) noexcept
+{
+    const size_t offset = (blob.size() + alignment - 1) & ~(alignment - 1);
+
+    blob.resize(offset + numBytes, '\0');
+
+    if (numBytes)
+    {
+        utils::fast_memcpy(blob.data() + offset, pData, numBytes);
+    }
+
+    return (uint64_t)offset;
+}
+
+
+
+/*-------------------------------------
+ * Append a section to a cache
+-------------------------------------*/
+void _sl_cache_add_section(
+    SL_SceneCacheHeader& header,
+    std::vector<char>& blob,
+    SL_SceneCacheSection section,
+    const void* pData,
+    size_t numBytes,
+    size_t count) noexcept
+{
+    SL_SceneCacheSectionInfo& info = header.sections[section];
+    info.offset   = _sl_cache_append(blob, pData, numBytes, SL_SCENE_CACHE_SECTION_ALIGNMENT);
+    info.numBytes = (uint64_t)numBytes;
+    info.count    = (uint64_t)count;
+}
+
+
+
+/*-------------------------------------
+ * Append an array of records to a cache
+-------------------------------------*/
+template <typename container_type>
+inline void _sl_cache_add_records(
+    SL_SceneCacheHeader& header,
+    std::vector<char>& blob,
+    SL_SceneCacheSection section,
+    const container_type& records) noexcept
+{
+    typedef typename container_type::value_type record_type;
+    _sl_cache_add_section(header, blob, section, records.data(), records.size() * sizeof(record_type), records.size());
+}
+
+
+
+/*-------------------------------------
+ * Append a list of strings to a cache
+-------------------------------------*/
+template <typename container_type>
+void _sl_cache_add_strings(
+    SL_SceneCacheHeader& header,
+    std::vector<char>& blob,
+    SL_SceneCacheSection section,
+    const container_type& strings) noexcept
+{
+    // String lengths are stored first, followed by all characters
+    std::vector<char> bytes(sizeof(uint32_t) * strings.size());
+
+    for (size_t i = 0; i < strings.size(); ++i)
+    {
+        const uint32_t length = (uint32_t)strings[i].size();
+        utils::fast_memcpy(bytes.data() + sizeof(uint32_t) * i, &length, sizeof(uint32_t));
+        bytes.insert(bytes.end(), strings[i].begin(), strings[i].end());
+    }
+
+    _sl_cache_add_section(header, blob, section, bytes.data(), bytes.size(), strings.size());
+}
+
+
+
+/*-------------------------------------
+ * Read a list of strings from a cache
+-------------------------------------*/
+template <typename container_type>
+bool _sl_cache_read_strings(const char* pCache, const SL_SceneCacheSectionInfo& info, container_type& outStrings) noexcept
+{
+    if (info.count > info.numBytes / sizeof(uint32_t))
+    {
+        return false;
+    }
+
+    const uint64_t tableBytes = sizeof(uint32_t) * info.count;
+
+    const char* pLengths  = pCache + info.offset;
+    const char* pChars    = pLengths + tableBytes;
+    uint64_t    remaining = info.numBytes - tableBytes;
+
+    outStrings.reserve(outStrings.size() + info.count);
+
+    for (uint64_t i = 0; i < info.count; ++i)
+    {
+        uint32_t length;
+        utils::fast_memcpy(&length, pLengths + sizeof(uint32_t) * i, sizeof(uint32_t));
+
+        if (length > remaining)
+        {
+            return false;
+        }
+
+        outStrings.emplace_back(pChars, (size_t)length);
+        pChars += length;
+        remaining -= length;
+    }
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the records of a section
+-------------------------------------*/
+template <typename record_type>
+inline const record_type* _sl_cache_records(const char* pCache, const SL_SceneCacheSectionInfo& info) noexcept
+{
+    return reinterpret_cast<const record_type*>(pCache + info.offset);
+}
+
+
+
+/*-------------------------------------
+ * Size of each record in a section (0 for variable-length sections)
+-------------------------------------*/
+uint64_t _sl_cache_record_size(SL_SceneCacheSection section) noexcept
+{
+    switch (section)
+    {
+        case SL_SCENE_CACHE_VAO_GROUPS:          return sizeof(SL_SceneCacheVaoGroup);
+        case SL_SCENE_CACHE_VAOS:                return sizeof(SL_SceneCacheVao);
+        case SL_SCENE_CACHE_VBOS:                return sizeof(SL_SceneCacheBuffer);
+        case SL_SCENE_CACHE_IBOS:                return sizeof(SL_SceneCacheBuffer);
+        case SL_SCENE_CACHE_NODES:               return sizeof(SL_SceneCacheNode);
+        case SL_SCENE_CACHE_NODE_PARENTS:        return sizeof(uint64_t);
+        case SL_SCENE_CACHE_BASE_TRANSFORMS:     return sizeof(math::mat4);
+        case SL_SCENE_CACHE_CURRENT_TRANSFORMS:  return sizeof(SL_SceneCacheTransform);
+        case SL_SCENE_CACHE_MODEL_MATRICES:      return sizeof(math::mat4);
+        case SL_SCENE_CACHE_NODE_MESH_COUNTS:    return sizeof(uint64_t);
+        case SL_SCENE_CACHE_NODE_MESH_IDS:       return sizeof(uint64_t);
+        case SL_SCENE_CACHE_MESHES:              return sizeof(SL_SceneCacheMesh);
+        case SL_SCENE_CACHE_MATERIALS:           return sizeof(SL_SceneCacheMaterial);
+        case SL_SCENE_CACHE_MESH_BOUNDS:         return sizeof(SL_SceneCacheBounds);
+        case SL_SCENE_CACHE_MESH_SKELETONS:      return sizeof(SL_SceneCacheSkeleton);
+        case SL_SCENE_CACHE_INV_BONE_TRANSFORMS: return sizeof(math::mat4);
+        case SL_SCENE_CACHE_BONE_OFFSETS:        return sizeof(math::mat4);
+        case SL_SCENE_CACHE_CAMERAS:             return sizeof(SL_SceneCacheCamera);
+        case SL_SCENE_CACHE_ANIMATIONS:          return sizeof(SL_SceneCacheAnimation);
+        case SL_SCENE_CACHE_ANIMATION_TRACKS:    return sizeof(SL_SceneCacheAnimTrack);
+        case SL_SCENE_CACHE_NODE_ANIM_COUNTS:    return sizeof(uint64_t);
+        case SL_SCENE_CACHE_ANIM_CHANNELS:       return sizeof(SL_SceneCacheAnimChannel);
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Ensure all sections lie within a cache file
+-------------------------------------*/
+bool _sl_cache_validate_sections(const SL_SceneCacheHeader& header, uint64_t fileBytes) noexcept
+{
+    for (uint32_t i = 0; i < SL_SCENE_CACHE_NUM_SECTIONS; ++i)
+    {
+        const SL_SceneCacheSectionInfo& info = header.sections[i];
+        const uint64_t recordSize = _sl_cache_record_size((SL_SceneCacheSection)i);
+
+        if (info.offset % SL_SCENE_CACHE_SECTION_ALIGNMENT)
+        {
+            return false;
+        }
+
+        if (info.numBytes && info.offset < sizeof(SL_SceneCacheHeader))
+        {
+            return false;
+        }
+
+        if (info.offset > fileBytes || info.numBytes > fileBytes - info.offset)
+        {
+            return false;
+        }
+
+        if (recordSize && (info.count > info.numBytes / recordSize || info.count * recordSize != info.numBytes))
+        {
+            return false;
+        }
+    }
+
+    // Per-node arrays must match the number of nodes
+    const uint64_t numNodes = header.sections[SL_SCENE_CACHE_NODES].count;
+    if (header.sections[SL_SCENE_CACHE_NODE_PARENTS].count != numNodes
+    || header.sections[SL_SCENE_CACHE_NODE_NAMES].count != numNodes
+    || header.sections[SL_SCENE_CACHE_BASE_TRANSFORMS].count != numNodes
+    || header.sections[SL_SCENE_CACHE_CURRENT_TRANSFORMS].count != numNodes
+    || header.sections[SL_SCENE_CACHE_MODEL_MATRICES].count != numNodes)
+    {
+        return false;
+    }
+
+    // Per-mesh arrays must match the number of meshes
+    const uint64_t numMeshes = header.sections[SL_SCENE_CACHE_MESHES].count;
+    if (header.sections[SL_SCENE_CACHE_MESH_BOUNDS].count != numMeshes
+    || header.sections[SL_SCENE_CACHE_MESH_SKELETONS].count != numMeshes)
+    {
+        return false;
+    }
+
+    if (header.sections[SL_SCENE_CACHE_INV_BONE_TRANSFORMS].count != header.sections[SL_SCENE_CACHE_BONE_OFFSETS].count)
+    {
+        return false;
+    }
+
+    return header.sections[SL_SCENE_CACHE_ANIMATION_NAMES].count == header.sections[SL_SCENE_CACHE_ANIMATIONS].count;
+}
+
+
+
+/*-------------------------------------
+ * Sum an array of cached counts
+-------------------------------------*/
+bool _sl_cache_sum_counts(const uint64_t* pCounts, uint64_t numCounts, uint64_t& outSum) noexcept
+{
+    outSum = 0;
+
+    for (uint64_t i = 0; i < numCounts; ++i)
+    {
+        if (pCounts[i] > ~(uint64_t)0 - outSum)
+        {
+            return false;
+        }
+
+        outSum += pCounts[i];
+    }
+
+    return true;
+}
+
+
+
+/*-------------------------------------
+ * Ensure a buffer lies within a cache file
+-------------------------------------*/
+inline bool _sl_cache_validate_buffer(const SL_SceneCacheBuffer& buffer, uint64_t paddingBytes, uint64_t fileBytes) noexcept
+{
+    if (buffer.offset % SL_SCENE_CACHE_PAGE_SIZE)
+    {
+        return false;
+    }
+
+    if (buffer.offset > fileBytes || paddingBytes > fileBytes - buffer.offset)
+    {
+        return false;
+    }
+
+    return buffer.numBytes <= fileBytes - buffer.offset - paddingBytes;
+}
+
+
+
+/*-------------------------------------
+ * Ensure a vertex attribute lies within its vertex buffer
+-------------------------------------*/
+inline bool _sl_cache_validate_binding(const SL_SceneCacheBinding& binding, uint64_t vboBytes) noexcept
+{
+    if (binding.dimens > VERTEX_DIMENSION_4 || binding.offset < 0 || binding.stride < 0)
+    {
+        return false;
+    }
+
+    const uint64_t attribBytes = sl_bytes_per_vertex((SL_DataType)binding.type, (SL_Dimension)binding.dimens);
+
+    return attribBytes
+        && (uint64_t)binding.offset <= vboBytes
+        && attribBytes <= vboBytes - (uint64_t)binding.offset
+        && (uint64_t)binding.stride <= vboBytes;
+}
+
+
+
+/*-------------------------------------
+ * Count the elements which can be drawn from a validated VAO
+-------------------------------------*/
+uint64_t _sl_cache_max_elements(const SL_SceneCacheVao& vao, const SL_SceneCacheBuffer* pVbos, const SL_SceneCacheBuffer* pIbos) noexcept
+{
+    if (vao.iboId != _SL_SCENE_CACHE_NO_BUFFER)
+    {
+        const SL_SceneCacheBuffer& ibo = pIbos[vao.iboId];
+        return ibo.numBytes ? ibo.count : 0;
+    }
+
+    if (vao.vboId == _SL_SCENE_CACHE_NO_BUFFER || !vao.numBindings)
+    {
+        return 0;
+    }
+
+    const uint64_t vboBytes = pVbos[vao.vboId].numBytes;
+    uint64_t maxVerts = ~(uint64_t)0;
+
+    for (uint64_t i = 0; i < vao.numBindings; ++i)
+    {
+        const SL_SceneCacheBinding& b = vao.bindings[i];
+        const uint64_t attribBytes = sl_bytes_per_vertex((SL_DataType)b.type, (SL_Dimension)b.dimens);
+
+        if (b.stride)
+        {
+            const uint64_t numVerts = (vboBytes - (uint64_t)b.offset - attribBytes) / (uint64_t)b.stride + 1;
+            maxVerts = (numVerts < maxVerts) ? numVerts : maxVerts;
+        }
+    }
+
+    return maxVerts;
+}
+
+
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_SceneFileCache Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_SceneFileCache::~SL_SceneFileCache() noexcept
+{
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_SceneFileCache::SL_SceneFileCache() noexcept :
+    mFile{nullptr}
+{}
+
+
+
+/*-------------------------------------
+ * Move Constructor
+-------------------------------------*/
+SL_SceneFileCache::SL_SceneFileCache(SL_SceneFileCache&& c) noexcept :
+    mFile{std::move(c.mFile)}
+{}
+
+
+
+/*-------------------------------------
+ * Move Operator
+-------------------------------------*/
+SL_SceneFileCache& SL_SceneFileCache::operator=(SL_SceneFileCache&& c) noexcept
+{
+    if (this != &c)
+    {
+        mFile = std::move(c.mFile);
+    }
+
+    return *this;
+}
+
+
+
+/*-------------------------------------
+ * Release the current mapping
+-------------------------------------*/
+void SL_SceneFileCache::unload() noexcept
+{
+    mFile.reset();
+}
+
+
+
+/*-------------------------------------
+ * Convert a transformation into a cache record
+-------------------------------------*/
+void SL_SceneFileCache::save_transform(const SL_Transform& t, SL_SceneCacheTransform& outTransform) noexcept
+{
+    outTransform.flags = t.mFlags;
+    outTransform.type  = (uint32_t)t.mType;
+
+    utils::fast_memcpy(outTransform.position,    &t.mPosition,    sizeof(outTransform.position));
+    utils::fast_memcpy(outTransform.scaling,     &t.mScaling,     sizeof(outTransform.scaling));
+    utils::fast_memcpy(outTransform.orientation, &t.mOrientation, sizeof(outTransform.orientation));
+    utils::fast_memcpy(outTransform.modelMat,    &t.mModelMat,    sizeof(outTransform.modelMat));
+}
+
+
+
+/*-------------------------------------
+ * Convert a cache record into a transformation
+-------------------------------------*/
+void SL_SceneFileCache::load_transform(const SL_SceneCacheTransform& t, SL_Transform& outTransform) noexcept
+{
+    outTransform.mFlags = t.flags;
+    outTransform.mType  = (SL_TransformType)t.type;
+
+    utils::fast_memcpy(&outTransform.mPosition,    t.position,    sizeof(t.position));
+    utils::fast_memcpy(&outTransform.mScaling,     t.scaling,     sizeof(t.scaling));
+    utils::fast_memcpy(&outTransform.mOrientation, t.orientation, sizeof(t.orientation));
+    utils::fast_memcpy(&outTransform.mModelMat,    t.modelMat,    sizeof(t.modelMat));
+}
+
+
+
+/*-------------------------------------
+ * Convert a camera into a cache record
+-------------------------------------*/
+void SL_SceneFileCache::save_camera(const SL_Camera& c, SL_SceneCacheCamera& outCamera) noexcept
+{
+    outCamera.isDirty  = c.mIsDirty ? 1u : 0u;
+    outCamera.projType = (uint32_t)c.mProjType;
+    outCamera.fov      = c.mFov;
+    outCamera.aspectW  = c.mAspectW;
+    outCamera.aspectH  = c.mAspectH;
+    outCamera.zNear    = c.mZNear;
+    outCamera.zFar     = c.mZFar;
+
+    utils::fast_memcpy(outCamera.projection, &c.mProjection, sizeof(outCamera.projection));
+}
+
+
+
+/*-------------------------------------
+ * Convert a cache record into a camera
+-------------------------------------*/
+void SL_SceneFileCache::load_camera(const SL_SceneCacheCamera& c, SL_Camera& outCamera) noexcept
+{
+    outCamera.mIsDirty  = c.isDirty != 0;
+    outCamera.mProjType = (SL_ProjectionType)c.projType;
+    outCamera.mFov      = c.fov;
+    outCamera.mAspectW  = c.aspectW;
+    outCamera.mAspectH  = c.aspectH;
+    outCamera.mZNear    = c.zNear;
+    outCamera.mZFar     = c.zFar;
+
+    utils::fast_memcpy(&outCamera.mProjection, c.projection, sizeof(c.projection));
+}
+
+
+
+/*-------------------------------------
+ * Append keyframes to a cache
+-------------------------------------*/
+template <typename data_t>
+void SL_SceneFileCache::save_keys(const SL_AnimationKeyList<data_t>& keys, std::vector<char>& outKeys) noexcept
+{
+    const size_t numFrames = keys.mNumFrames;
+
+    if (numFrames)
+    {
+        const char* pTimes = reinterpret_cast<const char*>(keys.mKeyTimes.get());
+        const char* pData = reinterpret_cast<const char*>(keys.mKeyData.get());
+
+        outKeys.insert(outKeys.end(), pTimes, pTimes + sizeof(SL_AnimPrecision) * numFrames);
+        outKeys.insert(outKeys.end(), pData, pData + sizeof(data_t) * numFrames);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Read keyframes from a cache
+-------------------------------------*/
+template <typename data_t>
+const char* SL_SceneFileCache::load_keys(const char* pKeys, uint32_t numFrames, SL_AnimationKeyList<data_t>& outKeys) noexcept
+{
+    outKeys.clear();
+
+    if (!numFrames)
+    {
+        return pKeys;
+    }
+
+    outKeys.mKeyTimes.reset((SL_AnimPrecision*)utils::aligned_malloc(sizeof(SL_AnimPrecision) * numFrames));
+    outKeys.mKeyData.reset((data_t*)utils::aligned_malloc(sizeof(data_t) * numFrames));
+
+    if (!outKeys.mKeyTimes || !outKeys.mKeyData)
+    {
+        outKeys.clear();
+        return nullptr;
+    }
+
+    outKeys.mNumFrames = numFrames;
+
+    utils::fast_memcpy(outKeys.mKeyTimes.get(), pKeys, sizeof(SL_AnimPrecision) * numFrames);
+    pKeys += sizeof(SL_AnimPrecision) * numFrames;
+
+    utils::fast_memcpy(outKeys.mKeyData.get(), pKeys, sizeof(data_t) * numFrames);
+    pKeys += sizeof(data_t) * numFrames;
+
+    return pKeys;
+}
+
+
+
+/*-------------------------------------
+ * Write a scene into a cache file
+-------------------------------------*/
+SL_SceneCacheStatus SL_SceneFileCache::save(
+    const std::string& cachePath,
+    const std::string& sourcePath,
+    const SL_SceneLoadOpts& opts,
+    const SL_SceneGraph& graph,
+    const std::vector<SL_VaoGroup>& vaoGroups,
+    const std::unordered_map<std::string, const SL_Texture*>& texPaths) noexcept
+{
+    SL_SceneCacheHeader header;
+    std::memset(&header, 0, sizeof(SL_SceneCacheHeader));
+    utils::fast_memcpy(header.magic, _SL_SCENE_CACHE_MAGIC, sizeof(header.magic));
+    header.version   = SL_SCENE_CACHE_VERSION;
+    header.byteOrder = _SL_SCENE_CACHE_BYTE_ORDER;
+    header.loadOpts  = _sl_pack_load_opts(opts);
+
+    if (!sourcePath.empty() && !_sl_file_stats(sourcePath, header.sourceBytes, header.sourceTime))
+    {
+        LS_LOG_ERR("\tUnable to cache ", sourcePath, ": the source file could not be found.");
+        return SL_SCENE_CACHE_FILE_NOT_FOUND;
+    }
+
+    const SL_Context& context = graph.mContext;
+    std::vector<char> blob(sizeof(SL_SceneCacheHeader), '\0');
+
+    // Textures are stored as paths, in the order they appear in the context
+    const SL_AlignedVector<SL_Texture*>& textures = context.textures();
+    std::unordered_map<const SL_Texture*, uint32_t> textureIds;
+    std::vector<std::string> texturePaths(textures.size());
+
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        textureIds[textures[i]] = (uint32_t)i;
+    }
+
+    for (const std::pair<const std::string, const SL_Texture*>& p : texPaths)
+    {
+        uint64_t fileBytes;
+        int64_t fileTime;
+
+        // Embedded textures have no file to reload from
+        if (!_sl_file_stats(p.first, fileBytes, fileTime))
+        {
+            LS_LOG_ERR("\tUnable to cache ", sourcePath, ": the texture ", p.first, " is not an external file.");
+            return SL_SCENE_CACHE_WRITE_ERROR;
+        }
+
+        const std::unordered_map<const SL_Texture*, uint32_t>::const_iterator iter = textureIds.find(p.second);
+        if (iter != textureIds.end())
+        {
+            texturePaths[iter->second] = p.first;
+        }
+    }
+
+    _sl_cache_add_strings(header, blob, SL_SCENE_CACHE_TEXTURES, texturePaths);
+
+    // VAOs
+    {
+        std::vector<SL_SceneCacheVaoGroup> groups(vaoGroups.size());
+        for (size_t i = 0; i < vaoGroups.size(); ++i)
+        {
+            groups[i].vertType    = (uint32_t)vaoGroups[i].vertType;
+            groups[i].numVboBytes = vaoGroups[i].numVboBytes;
+            groups[i].vboOffset   = vaoGroups[i].vboOffset;
+            groups[i].meshOffset  = vaoGroups[i].meshOffset;
+            groups[i].baseVert    = vaoGroups[i].baseVert;
+        }
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_VAO_GROUPS, groups);
+
+        const SL_AlignedVector<SL_VertexArray>& vaos = context.vaos();
+        std::vector<SL_SceneCacheVao> outVaos(vaos.size());
+        for (size_t i = 0; i < vaos.size(); ++i)
+        {
+            const SL_VertexArray& vao = vaos[i];
+            SL_SceneCacheVao& outVao = outVaos[i];
+
+            std::memset(&outVao, 0, sizeof(SL_SceneCacheVao));
+            outVao.vboId       = vao.has_vertex_buffer() ? (uint64_t)vao.get_vertex_buffer() : _SL_SCENE_CACHE_NO_BUFFER;
+            outVao.iboId       = vao.has_index_buffer() ? (uint64_t)vao.get_index_buffer() : _SL_SCENE_CACHE_NO_BUFFER;
+            outVao.numBindings = (uint64_t)vao.num_bindings();
+
+            for (size_t j = 0; j < vao.num_bindings(); ++j)
+            {
+                outVao.bindings[j].dimens = (uint32_t)vao.dimensions(j);
+                outVao.bindings[j].type   = (uint32_t)vao.type(j);
+                outVao.bindings[j].offset = (int64_t)vao.offset(j);
+                outVao.bindings[j].stride = (int64_t)vao.stride(j);
+            }
+        }
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_VAOS, outVaos);
+    }
+
+    // Node hierarchy
+    {
+        std::vector<SL_SceneCacheNode> nodes(graph.mNodes.size());
+        std::vector<uint64_t> parents(graph.mNodeParentIds.size());
+        std::vector<SL_SceneCacheTransform> transforms(graph.mCurrentTransforms.size());
+
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            nodes[i].type   = (uint64_t)graph.mNodes[i].type;
+            nodes[i].dataId = (uint64_t)graph.mNodes[i].dataId;
+        }
+
+        for (size_t i = 0; i < parents.size(); ++i)
+        {
+            parents[i] = (graph.mNodeParentIds[i] == SCENE_NODE_ROOT_ID) ? ~(uint64_t)0 : (uint64_t)graph.mNodeParentIds[i];
+        }
+
+        for (size_t i = 0; i < transforms.size(); ++i)
+        {
+            save_transform(graph.mCurrentTransforms[i], transforms[i]);
+        }
+
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_NODES,              nodes);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_NODE_PARENTS,       parents);
+        _sl_cache_add_strings(header, blob, SL_SCENE_CACHE_NODE_NAMES,         graph.mNodeNames);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_BASE_TRANSFORMS,    graph.mBaseTransforms);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_CURRENT_TRANSFORMS, transforms);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_MODEL_MATRICES,     graph.mModelMatrices);
+    }
+
+    // Meshes
+    {
+        std::vector<uint64_t> meshCounts(graph.mNumNodeMeshes.size());
+        std::vector<uint64_t> meshIds;
+
+        for (size_t i = 0; i < meshCounts.size(); ++i)
+        {
+            meshCounts[i] = (uint64_t)graph.mNumNodeMeshes[i];
+
+            for (size_t j = 0; j < graph.mNumNodeMeshes[i]; ++j)
+            {
+                meshIds.push_back((uint64_t)graph.mNodeMeshes[i][j]);
+            }
+        }
+
+        std::vector<SL_SceneCacheMesh> meshes(graph.mMeshes.size());
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            const SL_Mesh& m = graph.mMeshes[i];
+            meshes[i].vaoId        = (uint64_t)m.vaoId;
+            meshes[i].elementBegin = (uint64_t)m.elementBegin;
+            meshes[i].elementEnd   = (uint64_t)m.elementEnd;
+            meshes[i].mode         = (uint32_t)m.mode;
+            meshes[i].materialId   = m.materialId;
+        }
+
+        std::vector<SL_SceneCacheMaterial> materials(graph.mMaterials.size());
+        for (size_t i = 0; i < materials.size(); ++i)
+        {
+            const SL_Material& m = graph.mMaterials[i];
+            SL_SceneCacheMaterial& outMaterial = materials[i];
+
+            for (unsigned t = 0; t < SL_MATERIAL_MAX_TEXTURES; ++t)
+            {
+                const std::unordered_map<const SL_Texture*, uint32_t>::const_iterator iter = textureIds.find(m.pTextures[t]);
+                outMaterial.textures[t] = (m.pTextures[t] && iter != textureIds.end()) ? iter->second : _SL_SCENE_CACHE_NO_TEXTURE;
+            }
+
+            for (unsigned c = 0; c < 4; ++c)
+            {
+                outMaterial.ambient[c]  = m.ambient[c];
+                outMaterial.diffuse[c]  = m.diffuse[c];
+                outMaterial.specular[c] = m.specular[c];
+            }
+
+            outMaterial.shininess = m.shininess;
+        }
+
+        std::vector<SL_SceneCacheBounds> bounds(graph.mMeshBounds.size());
+        for (size_t i = 0; i < bounds.size(); ++i)
+        {
+            utils::fast_memcpy(bounds[i].maxPoint, &graph.mMeshBounds[i].max_point(), sizeof(bounds[i].maxPoint));
+            utils::fast_memcpy(bounds[i].minPoint, &graph.mMeshBounds[i].min_point(), sizeof(bounds[i].minPoint));
+        }
+
+        std::vector<SL_SceneCacheSkeleton> skeletons(graph.mMeshSkeletons.size());
+        for (size_t i = 0; i < skeletons.size(); ++i)
+        {
+            skeletons[i].index = (uint64_t)graph.mMeshSkeletons[i].index;
+            skeletons[i].count = (uint64_t)graph.mMeshSkeletons[i].count;
+        }
+
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_NODE_MESH_COUNTS,     meshCounts);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_NODE_MESH_IDS,        meshIds);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_MESHES,               meshes);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_MATERIALS,            materials);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_MESH_BOUNDS,          bounds);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_MESH_SKELETONS,       skeletons);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_INV_BONE_TRANSFORMS,  graph.mInvBoneTransforms);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_BONE_OFFSETS,         graph.mBoneOffsets);
+    }
+
+    // Cameras
+    {
+        std::vector<SL_SceneCacheCamera> cameras(graph.mCameras.size());
+        for (size_t i = 0; i < cameras.size(); ++i)
+        {
+            save_camera(graph.mCameras[i], cameras[i]);
+        }
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_CAMERAS, cameras);
+    }
+
+    // Animations
+    {
+        std::vector<SL_SceneCacheAnimation> animations(graph.mAnimations.size());
+        std::vector<std::string> animNames(graph.mAnimations.size());
+        std::vector<SL_SceneCacheAnimTrack> tracks;
+
+        for (size_t i = 0; i < animations.size(); ++i)
+        {
+            const SL_Animation& anim = graph.mAnimations[i];
+
+            animations[i].playMode    = (uint32_t)anim.play_mode();
+            animations[i].numTracks   = (uint32_t)anim.size();
+            animations[i].firstTrack  = (uint64_t)tracks.size();
+            animations[i].totalTicks  = anim.duration();
+            animations[i].ticksPerSec = anim.ticks_per_sec();
+            animNames[i] = anim.name();
+
+            for (size_t t = 0; t < anim.size(); ++t)
+            {
+                tracks.push_back(SL_SceneCacheAnimTrack{
+                    (uint64_t)anim.animations()[t],
+                    (uint64_t)anim.tracks()[t],
+                    (uint64_t)anim.transforms()[t]
+                });
+            }
+        }
+
+        std::vector<uint64_t> channelCounts(graph.mNodeAnims.size());
+        std::vector<SL_SceneCacheAnimChannel> channels;
+        std::vector<char> keys;
+
+        for (size_t i = 0; i < channelCounts.size(); ++i)
+        {
+            channelCounts[i] = (uint64_t)graph.mNodeAnims[i].size();
+
+            for (const SL_AnimationChannel& c : graph.mNodeAnims[i])
+            {
+                channels.push_back(SL_SceneCacheAnimChannel{
+                    (uint32_t)c.mAnimMode,
+                    (uint32_t)c.mPosFrames.size(),
+                    (uint32_t)c.mScaleFrames.size(),
+                    (uint32_t)c.mOrientFrames.size(),
+                    (uint64_t)keys.size()
+                });
+
+                save_keys(c.mPosFrames, keys);
+                save_keys(c.mScaleFrames, keys);
+                save_keys(c.mOrientFrames, keys);
+            }
+        }
+
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_ANIMATIONS,       animations);
+        _sl_cache_add_strings(header, blob, SL_SCENE_CACHE_ANIMATION_NAMES,  animNames);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_ANIMATION_TRACKS, tracks);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_NODE_ANIM_COUNTS, channelCounts);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_ANIM_CHANNELS,    channels);
+        _sl_cache_add_section(header, blob, SL_SCENE_CACHE_ANIM_KEYS, keys.data(), keys.size(), keys.size());
+    }
+
+    // Vertex and index data is placed last, on page boundaries, so all
+    // other records remain contiguous at the beginning of the file.
+    {
+        const SL_AlignedVector<SL_VertexBuffer>& vbos = context.vbos();
+        std::vector<SL_SceneCacheBuffer> outVbos(vbos.size());
+
+        for (size_t i = 0; i < vbos.size(); ++i)
+        {
+            std::memset(&outVbos[i], 0, sizeof(SL_SceneCacheBuffer));
+
+            if (vbos[i].valid())
+            {
+                outVbos[i].offset   = _sl_cache_append(blob, vbos[i].data(), vbos[i].num_bytes(), SL_SCENE_CACHE_PAGE_SIZE);
+                outVbos[i].numBytes = (uint64_t)vbos[i].num_bytes();
+                outVbos[i].count    = (uint64_t)vbos[i].num_bytes();
+            }
+        }
+
+        const SL_AlignedVector<SL_IndexBuffer>& ibos = context.ibos();
+        std::vector<SL_SceneCacheBuffer> outIbos(ibos.size());
+        const char padding[_SL_SCENE_CACHE_IBO_PADDING] = {'\0'};
+
+        for (size_t i = 0; i < ibos.size(); ++i)
+        {
+            std::memset(&outIbos[i], 0, sizeof(SL_SceneCacheBuffer));
+
+            if (ibos[i].valid())
+            {
+                outIbos[i].offset   = _sl_cache_append(blob, ibos[i].data(), ibos[i].num_bytes(), SL_SCENE_CACHE_PAGE_SIZE);
+                outIbos[i].numBytes = (uint64_t)ibos[i].num_bytes();
+                outIbos[i].count    = (uint64_t)ibos[i].count();
+                outIbos[i].type     = (uint32_t)ibos[i].type();
+
+                _sl_cache_append(blob, padding, sizeof(padding), 1);
+            }
+        }
+
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_VBOS, outVbos);
+        _sl_cache_add_records(header, blob, SL_SCENE_CACHE_IBOS, outIbos);
+    }
+
+    utils::fast_memcpy(blob.data(), &header, sizeof(SL_SceneCacheHeader));
+
+    // Write to a temporary file so a partially-written cache is never read
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream fout{tempPath, std::ios::binary | std::ios::out | std::ios::trunc};
+        if (!fout.good())
+        {
+            LS_LOG_ERR("\tUnable to open the scene cache ", tempPath, " for writing.");
+            return SL_SCENE_CACHE_WRITE_ERROR;
+        }
+
+        fout.write(blob.data(), (std::streamsize)blob.size());
+        fout.close();
+
+        if (fout.fail())
+        {
+            LS_LOG_ERR("\tUnable to write ", blob.size(), " bytes to the scene cache ", tempPath, '.');
+            std::remove(tempPath.c_str());
+            return SL_SCENE_CACHE_WRITE_ERROR;
+        }
+    }
+
+    #if defined(LS_OS_WINDOWS)
+        // rename() does not replace existing files on Windows
+        std::remove(cachePath.c_str());
+    #endif
+
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+    {
+        LS_LOG_ERR("\tUnable to move the scene cache ", tempPath, " to ", cachePath, '.');
+        std::remove(tempPath.c_str());
+        return SL_SCENE_CACHE_WRITE_ERROR;
+    }
+
+    LS_LOG_MSG("\tWrote ", blob.size(), " bytes to the scene cache ", cachePath, '.');
+
+    return SL_SCENE_CACHE_SUCCESS;
+}
+
+
+
+/*-------------------------------------
+ * Reload textures referenced by a cache
+-------------------------------------*/
+int SL_SceneFileCache::load_textures(
+    const SL_SceneCacheHeader& header,
+    const SL_SceneLoadOpts& opts,
+    SL_SceneGraph& outGraph,
+    std::vector<const SL_Texture*>& outTextures,
+    std::unordered_map<std::string, const SL_Texture*>& outTexPaths) noexcept
+{
+    std::vector<std::string> paths;
+    if (!_sl_cache_read_strings(mFile->data(), header.sections[SL_SCENE_CACHE_TEXTURES], paths))
+    {
+        return -1;
+    }
+
+    SL_Context& context = outGraph.mContext;
+    const SL_TexelOrder texelOrder = opts.swizzleTexels ? SL_TexelOrder::SWIZZLED : SL_TexelOrder::ORDERED;
+    utils::Pointer<SL_ImgFile> imgLoader{new SL_ImgFile{}};
+
+    outTextures.reserve(paths.size());
+
+    for (const std::string& path : paths)
+    {
+        if (path.empty())
+        {
+            outTextures.push_back(nullptr);
+            continue;
+        }
+
+        const std::unordered_map<std::string, const SL_Texture*>::const_iterator iter = outTexPaths.find(path);
+        if (iter != outTexPaths.end())
+        {
+            outTextures.push_back(iter->second);
+            continue;
+        }
+
+        if (imgLoader->load(path.c_str()) != SL_ImgFile::ImgStatus::FILE_LOAD_SUCCESS)
+        {
+            LS_LOG_ERR("\t\tFailed to load a cached texture: ", path);
+            outTextures.push_back(nullptr);
+            continue;
+        }
+
+        const size_t texId = context.create_texture();
+        SL_Texture& t = context.texture(texId);
+
+        if (t.init(*imgLoader, texelOrder) != 0)
+        {
+            LS_LOG_ERR("\t\tFailed to initialize a cached texture: ", path);
+            context.destroy_texture(texId);
+            outTextures.push_back(nullptr);
+            continue;
+        }
+
+        if (opts.compressTextures)
+        {
+            sl_texture_compress(t, texelOrder);
+        }
+
+        outTexPaths[path] = &t;
+        outTextures.push_back(&t);
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Adopt vertex and index data from a cache
+-------------------------------------*/
+int SL_SceneFileCache::load_buffers(const SL_SceneCacheHeader& header, SL_SceneGraph& outGraph) noexcept
+{
+    SL_Context& context = outGraph.mContext;
+    char* const pCache = mFile->data();
+    const uint64_t fileBytes = (uint64_t)mFile->size();
+
+    const SL_SceneCacheSectionInfo& vboInfo = header.sections[SL_SCENE_CACHE_VBOS];
+    const SL_SceneCacheBuffer* pVbos = _sl_cache_records<SL_SceneCacheBuffer>(pCache, vboInfo);
+
+    for (uint64_t i = 0; i < vboInfo.count; ++i)
+    {
+        const SL_SceneCacheBuffer& buffer = pVbos[i];
+        SL_VertexBuffer& vbo = context.vbo(context.create_vbo());
+
+        // Empty buffers are kept so VAOs reference the same indices
+        if (!buffer.numBytes)
+        {
+            continue;
+        }
+
+        if (!_sl_cache_validate_buffer(buffer, 0, fileBytes))
+        {
+            return -1;
+        }
+
+        // Buffers share ownership of the mapping, keeping it alive after
+        // *this is unloaded.
+        const std::shared_ptr<unsigned char> pData{mFile, reinterpret_cast<unsigned char*>(pCache + buffer.offset)};
+        if (vbo.adopt((size_t)buffer.numBytes, pData) != 0)
+        {
+            return -1;
+        }
+    }
+
+    const SL_SceneCacheSectionInfo& iboInfo = header.sections[SL_SCENE_CACHE_IBOS];
+    const SL_SceneCacheBuffer* pIbos = _sl_cache_records<SL_SceneCacheBuffer>(pCache, iboInfo);
+
+    for (uint64_t i = 0; i < iboInfo.count; ++i)
+    {
+        const SL_SceneCacheBuffer& buffer = pIbos[i];
+        SL_IndexBuffer& ibo = context.ibo(context.create_ibo());
+
+        if (!buffer.numBytes)
+        {
+            continue;
+        }
+
+        if (!_sl_cache_validate_buffer(buffer, _SL_SCENE_CACHE_IBO_PADDING, fileBytes))
+        {
+            return -1;
+        }
+
+        const SL_DataType type = (SL_DataType)buffer.type;
+        if (type != VERTEX_DATA_BYTE && type != VERTEX_DATA_SHORT && type != VERTEX_DATA_INT)
+        {
+            return -1;
+        }
+
+        if (buffer.count > buffer.numBytes / sl_bytes_per_type(type) || buffer.count > 0xFFFFFFFFu)
+        {
+            return -1;
+        }
+
+        const std::shared_ptr<unsigned char> pData{mFile, reinterpret_cast<unsigned char*>(pCache + buffer.offset)};
+        if (ibo.adopt((uint32_t)buffer.count, type, pData) != 0)
+        {
+            return -1;
+        }
+    }
+
+    const SL_SceneCacheSectionInfo& vaoInfo = header.sections[SL_SCENE_CACHE_VAOS];
+    const SL_SceneCacheVao* pVaos = _sl_cache_records<SL_SceneCacheVao>(pCache, vaoInfo);
+
+    for (uint64_t i = 0; i < vaoInfo.count; ++i)
+    {
+        const SL_SceneCacheVao& inVao = pVaos[i];
+        SL_VertexArray& vao = context.vao(context.create_vao());
+
+        if (inVao.numBindings > LS_ARRAY_SIZE(inVao.bindings))
+        {
+            return -1;
+        }
+
+        if (inVao.vboId != _SL_SCENE_CACHE_NO_BUFFER)
+        {
+            if (inVao.vboId >= vboInfo.count)
+            {
+                return -1;
+            }
+            vao.set_vertex_buffer((size_t)inVao.vboId);
+        }
+
+        if (inVao.iboId != _SL_SCENE_CACHE_NO_BUFFER)
+        {
+            if (inVao.iboId >= iboInfo.count)
+            {
+                return -1;
+            }
+            vao.set_index_buffer((size_t)inVao.iboId);
+        }
+
+        if (vao.set_num_bindings((size_t)inVao.numBindings) != (int)inVao.numBindings)
+        {
+            return -1;
+        }
+
+        // Attributes can only be read from a vertex buffer
+        if (inVao.numBindings && inVao.vboId == _SL_SCENE_CACHE_NO_BUFFER)
+        {
+            return -1;
+        }
+
+        for (uint64_t j = 0; j < inVao.numBindings; ++j)
+        {
+            const SL_SceneCacheBinding& b = inVao.bindings[j];
+
+            if (!_sl_cache_validate_binding(b, pVbos[inVao.vboId].numBytes))
+            {
+                return -1;
+            }
+
+            vao.set_binding((size_t)j, (ptrdiff_t)b.offset, (ptrdiff_t)b.stride, (SL_Dimension)b.dimens, (SL_DataType)b.type);
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Load the node hierarchy from a cache
+-------------------------------------*/
+int SL_SceneFileCache::load_nodes(const SL_SceneCacheHeader& header, SL_SceneGraph& outGraph) noexcept
+{
+    const char* const pCache = mFile->data();
+    const size_t numNodes = (size_t)header.sections[SL_SCENE_CACHE_NODES].count;
+
+    const SL_SceneCacheNode* pNodes = _sl_cache_records<SL_SceneCacheNode>(pCache, header.sections[SL_SCENE_CACHE_NODES]);
+    outGraph.mNodes.resize(numNodes);
+
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+        // Node data must reference the arrays matching the node's type
+        uint64_t numData;
+
+        switch (pNodes[i].type)
+        {
+            case NODE_TYPE_EMPTY:
+                numData = 0;
+                break;
+
+            case NODE_TYPE_MESH:
+                numData = header.sections[SL_SCENE_CACHE_NODE_MESH_COUNTS].count;
+                break;
+
+            case NODE_TYPE_CAMERA:
+                numData = header.sections[SL_SCENE_CACHE_CAMERAS].count;
+                break;
+
+            case NODE_TYPE_BONE:
+                numData = header.sections[SL_SCENE_CACHE_INV_BONE_TRANSFORMS].count;
+                break;
+
+            default:
+                return -1;
+        }
+
+        if (pNodes[i].type != NODE_TYPE_EMPTY && pNodes[i].dataId >= numData)
+        {
+            return -1;
+        }
+
+        outGraph.mNodes[i].type   = (SL_SceneNodeType)pNodes[i].type;
+        outGraph.mNodes[i].dataId = (size_t)pNodes[i].dataId;
+    }
+
+    const uint64_t* pParents = _sl_cache_records<uint64_t>(pCache, header.sections[SL_SCENE_CACHE_NODE_PARENTS]);
+    outGraph.mNodeParentIds.resize(numNodes);
+
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+        if (pParents[i] != ~(uint64_t)0 && pParents[i] >= numNodes)
+        {
+            return -1;
+        }
+
+        outGraph.mNodeParentIds[i] = (pParents[i] == ~(uint64_t)0) ? (size_t)SCENE_NODE_ROOT_ID : (size_t)pParents[i];
+    }
+
+    if (!_sl_cache_read_strings(pCache, header.sections[SL_SCENE_CACHE_NODE_NAMES], outGraph.mNodeNames))
+    {
+        return -1;
+    }
+
+    outGraph.mBaseTransforms.resize(numNodes);
+    utils::fast_memcpy(outGraph.mBaseTransforms.data(), pCache + header.sections[SL_SCENE_CACHE_BASE_TRANSFORMS].offset, sizeof(math::mat4) * numNodes);
+
+    const SL_SceneCacheTransform* pTransforms = _sl_cache_records<SL_SceneCacheTransform>(pCache, header.sections[SL_SCENE_CACHE_CURRENT_TRANSFORMS]);
+    outGraph.mCurrentTransforms.resize(numNodes);
+
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+        load_transform(pTransforms[i], outGraph.mCurrentTransforms[i]);
+    }
+
+    outGraph.mModelMatrices.resize(numNodes);
+    utils::fast_memcpy(outGraph.mModelMatrices.data(), pCache + header.sections[SL_SCENE_CACHE_MODEL_MATRICES].offset, sizeof(math::mat4) * numNodes);
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Load meshes, materials, bones, and cameras from a cache
+-------------------------------------*/
+int SL_SceneFileCache::load_meshes(const SL_SceneCacheHeader& header, const std::vector<const SL_Texture*>& textures, SL_SceneGraph& outGraph) noexcept
+{
+    const char* const pCache = mFile->data();
+
+    // Mesh IDs of each node
+    const SL_SceneCacheSectionInfo& countInfo = header.sections[SL_SCENE_CACHE_NODE_MESH_COUNTS];
+    const SL_SceneCacheSectionInfo& idInfo = header.sections[SL_SCENE_CACHE_NODE_MESH_IDS];
+    const uint64_t* pCounts = _sl_cache_records<uint64_t>(pCache, countInfo);
+    const uint64_t* pIds = _sl_cache_records<uint64_t>(pCache, idInfo);
+    uint64_t totalIds;
+
+    if (!_sl_cache_sum_counts(pCounts, countInfo.count, totalIds) || totalIds != idInfo.count)
+    {
+        return -1;
+    }
+
+    const uint64_t numMeshes = header.sections[SL_SCENE_CACHE_MESHES].count;
+
+    outGraph.mNumNodeMeshes.reserve((size_t)countInfo.count);
+    outGraph.mNodeMeshes.reserve((size_t)countInfo.count);
+
+    for (uint64_t i = 0; i < countInfo.count; ++i)
+    {
+        const size_t numNodeMeshes = (size_t)pCounts[i];
+        utils::Pointer<size_t[]> meshIds{numNodeMeshes ? new(std::nothrow) size_t[numNodeMeshes] : nullptr};
+
+        if (numNodeMeshes && !meshIds)
+        {
+            return -2;
+        }
+
+        for (size_t j = 0; j < numNodeMeshes; ++j)
+        {
+            if (*pIds >= numMeshes)
+            {
+                return -1;
+            }
+
+            meshIds[j] = (size_t)*pIds++;
+        }
+
+        outGraph.mNumNodeMeshes.push_back(numNodeMeshes);
+        outGraph.mNodeMeshes.emplace_back(std::move(meshIds));
+    }
+
+    // Meshes and their bounds. Each mesh must draw from a loaded VAO using
+    // one of the cached materials, and skeletons must reference cached nodes.
+    const uint64_t numVaos = header.sections[SL_SCENE_CACHE_VAOS].count;
+    const uint64_t numNodes = header.sections[SL_SCENE_CACHE_NODES].count;
+    const uint64_t numMaterials = header.sections[SL_SCENE_CACHE_MATERIALS].count;
+    const SL_SceneCacheVao* pVaos = _sl_cache_records<SL_SceneCacheVao>(pCache, header.sections[SL_SCENE_CACHE_VAOS]);
+    const SL_SceneCacheBuffer* pVbos = _sl_cache_records<SL_SceneCacheBuffer>(pCache, header.sections[SL_SCENE_CACHE_VBOS]);
+    const SL_SceneCacheBuffer* pIbos = _sl_cache_records<SL_SceneCacheBuffer>(pCache, header.sections[SL_SCENE_CACHE_IBOS]);
+    const SL_SceneCacheMesh* pMeshes = _sl_cache_records<SL_SceneCacheMesh>(pCache, header.sections[SL_SCENE_CACHE_MESHES]);
+    const SL_SceneCacheBounds* pBounds = _sl_cache_records<SL_SceneCacheBounds>(pCache, header.sections[SL_SCENE_CACHE_MESH_BOUNDS]);
+    const SL_SceneCacheSkeleton* pSkeletons = _sl_cache_records<SL_SceneCacheSkeleton>(pCache, header.sections[SL_SCENE_CACHE_MESH_SKELETONS]);
+
+    outGraph.mMeshes.resize((size_t)numMeshes);
+    outGraph.mMeshBounds.resize((size_t)numMeshes);
+    outGraph.mMeshSkeletons.resize((size_t)numMeshes);
+
+    for (size_t i = 0; i < numMeshes; ++i)
+    {
+        const SL_SceneCacheMesh& inMesh = pMeshes[i];
+        const SL_SceneCacheSkeleton& inSkeleton = pSkeletons[i];
+
+        if (inMesh.vaoId >= numVaos || inMesh.materialId >= numMaterials)
+        {
+            return -1;
+        }
+
+        if (inMesh.elementBegin > inMesh.elementEnd
+        || inMesh.elementEnd > _sl_cache_max_elements(pVaos[inMesh.vaoId], pVbos, pIbos))
+        {
+            return -1;
+        }
+
+        // Meshes without bones have no skeleton index
+        if (inSkeleton.count && (inSkeleton.index > numNodes || inSkeleton.count > numNodes - inSkeleton.index))
+        {
+            return -1;
+        }
+
+        SL_Mesh& m = outGraph.mMeshes[i];
+        m.vaoId        = (size_t)inMesh.vaoId;
+        m.elementBegin = (size_t)inMesh.elementBegin;
+        m.elementEnd   = (size_t)inMesh.elementEnd;
+        m.mode         = (SL_RenderMode)inMesh.mode;
+        m.materialId   = inMesh.materialId;
+
+        const float* const pMax = pBounds[i].maxPoint;
+        const float* const pMin = pBounds[i].minPoint;
+        outGraph.mMeshBounds[i].max_point(math::vec4{pMax[0], pMax[1], pMax[2], pMax[3]});
+        outGraph.mMeshBounds[i].min_point(math::vec4{pMin[0], pMin[1], pMin[2], pMin[3]});
+
+        outGraph.mMeshSkeletons[i].index = (size_t)inSkeleton.index;
+        outGraph.mMeshSkeletons[i].count = (size_t)inSkeleton.count;
+    }
+
+    // Materials
+    const SL_SceneCacheMaterial* pMaterials = _sl_cache_records<SL_SceneCacheMaterial>(pCache, header.sections[SL_SCENE_CACHE_MATERIALS]);
+
+    outGraph.mMaterials.resize((size_t)numMaterials);
+
+    for (size_t i = 0; i < numMaterials; ++i)
+    {
+        const SL_SceneCacheMaterial& inMaterial = pMaterials[i];
+        SL_Material& m = outGraph.mMaterials[i];
+
+        sl_reset(m);
+
+        for (unsigned t = 0; t < SL_MATERIAL_MAX_TEXTURES; ++t)
+        {
+            const uint32_t texId = inMaterial.textures[t];
+
+            if (texId != _SL_SCENE_CACHE_NO_TEXTURE)
+            {
+                if (texId >= textures.size())
+                {
+                    return -1;
+                }
+                m.pTextures[t] = textures[texId];
+            }
+        }
+
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            m.ambient[c]  = inMaterial.ambient[c];
+            m.diffuse[c]  = inMaterial.diffuse[c];
+            m.specular[c] = inMaterial.specular[c];
+        }
+
+        m.shininess = inMaterial.shininess;
+    }
+
+    // Bones
+    const size_t numBones = (size_t)header.sections[SL_SCENE_CACHE_INV_BONE_TRANSFORMS].count;
+
+    outGraph.mInvBoneTransforms.resize(numBones);
+    utils::fast_memcpy(outGraph.mInvBoneTransforms.data(), pCache + header.sections[SL_SCENE_CACHE_INV_BONE_TRANSFORMS].offset, sizeof(math::mat4) * numBones);
+
+    outGraph.mBoneOffsets.resize(numBones);
+    utils::fast_memcpy(outGraph.mBoneOffsets.data(), pCache + header.sections[SL_SCENE_CACHE_BONE_OFFSETS].offset, sizeof(math::mat4) * numBones);
+
+    // Cameras
+    const size_t numCameras = (size_t)header.sections[SL_SCENE_CACHE_CAMERAS].count;
+    const SL_SceneCacheCamera* pCameras = _sl_cache_records<SL_SceneCacheCamera>(pCache, header.sections[SL_SCENE_CACHE_CAMERAS]);
+
+    outGraph.mCameras.resize(numCameras);
+
+    for (size_t i = 0; i < numCameras; ++i)
+    {
+        load_camera(pCameras[i], outGraph.mCameras[i]);
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Load animations and keyframes from a cache
+-------------------------------------*/
+int SL_SceneFileCache::load_animations(const SL_SceneCacheHeader& header, SL_SceneGraph& outGraph) noexcept
+{
+    const char* const pCache = mFile->data();
+
+    // Number of channels animating each node
+    const SL_SceneCacheSectionInfo& countInfo = header.sections[SL_SCENE_CACHE_NODE_ANIM_COUNTS];
+    const uint64_t* pCounts = _sl_cache_records<uint64_t>(pCache, countInfo);
+
+    // Animation tracks
+    std::vector<std::string> names;
+    const size_t numAnims = (size_t)header.sections[SL_SCENE_CACHE_ANIMATIONS].count;
+
+    if (!_sl_cache_read_strings(pCache, header.sections[SL_SCENE_CACHE_ANIMATION_NAMES], names) || names.size() != numAnims)
+    {
+        return -1;
+    }
+
+    const uint64_t numNodes = header.sections[SL_SCENE_CACHE_NODES].count;
+    const uint64_t numTracks = header.sections[SL_SCENE_CACHE_ANIMATION_TRACKS].count;
+    const SL_SceneCacheAnimation* pAnims = _sl_cache_records<SL_SceneCacheAnimation>(pCache, header.sections[SL_SCENE_CACHE_ANIMATIONS]);
+    const SL_SceneCacheAnimTrack* pTracks = _sl_cache_records<SL_SceneCacheAnimTrack>(pCache, header.sections[SL_SCENE_CACHE_ANIMATION_TRACKS]);
+
+    outGraph.mAnimations.resize(numAnims);
+
+    for (size_t i = 0; i < numAnims; ++i)
+    {
+        const SL_SceneCacheAnimation& inAnim = pAnims[i];
+        SL_Animation& anim = outGraph.mAnimations[i];
+
+        if (inAnim.firstTrack > numTracks || inAnim.numTracks > numTracks - inAnim.firstTrack)
+        {
+            return -1;
+        }
+
+        anim.name(std::move(names[i]));
+        anim.play_mode((SL_AnimPlayMode)inAnim.playMode);
+        anim.duration(inAnim.totalTicks);
+        anim.ticks_per_sec(inAnim.ticksPerSec);
+        anim.reserve(inAnim.numTracks);
+
+        for (uint64_t t = inAnim.firstTrack; t < inAnim.firstTrack + inAnim.numTracks; ++t)
+        {
+            const SL_SceneCacheAnimTrack& inTrack = pTracks[t];
+
+            if (inTrack.channelId >= countInfo.count
+            || inTrack.trackId >= pCounts[inTrack.channelId]
+            || inTrack.transformId >= numNodes)
+            {
+                return -1;
+            }
+
+            anim.add_channel((size_t)inTrack.channelId, (size_t)inTrack.trackId, (size_t)inTrack.transformId);
+        }
+    }
+
+    // Per-node channels
+    const SL_SceneCacheSectionInfo& channelInfo = header.sections[SL_SCENE_CACHE_ANIM_CHANNELS];
+    const SL_SceneCacheSectionInfo& keyInfo = header.sections[SL_SCENE_CACHE_ANIM_KEYS];
+    const SL_SceneCacheAnimChannel* pChannels = _sl_cache_records<SL_SceneCacheAnimChannel>(pCache, channelInfo);
+    const char* const pKeys = pCache + keyInfo.offset;
+    uint64_t totalChannels;
+
+    if (!_sl_cache_sum_counts(pCounts, countInfo.count, totalChannels) || totalChannels != channelInfo.count)
+    {
+        return -1;
+    }
+
+    outGraph.mNodeAnims.resize((size_t)countInfo.count);
+
+    for (uint64_t i = 0; i < countInfo.count; ++i)
+    {
+        SL_AlignedVector<SL_AnimationChannel>& nodeChannels = outGraph.mNodeAnims[(size_t)i];
+        nodeChannels.resize((size_t)pCounts[i]);
+
+        for (SL_AnimationChannel& c : nodeChannels)
+        {
+            const SL_SceneCacheAnimChannel& inChannel = *pChannels++;
+            const uint64_t vec3Bytes = sizeof(SL_AnimPrecision) + sizeof(math::vec3);
+            const uint64_t quatBytes = sizeof(SL_AnimPrecision) + sizeof(math::quat);
+            const uint64_t numBytes =
+                vec3Bytes * inChannel.numPosFrames
+                + vec3Bytes * inChannel.numScaleFrames
+                + quatBytes * inChannel.numOrientFrames;
+
+            if (inChannel.keyOffset > keyInfo.numBytes || numBytes > keyInfo.numBytes - inChannel.keyOffset)
+            {
+                return -1;
+            }
+
+            const char* pChannelKeys = pKeys + inChannel.keyOffset;
+            c.mAnimMode = (SL_AnimationFlag)inChannel.animMode;
+
+            pChannelKeys = load_keys(pChannelKeys, inChannel.numPosFrames, c.mPosFrames);
+            pChannelKeys = pChannelKeys ? load_keys(pChannelKeys, inChannel.numScaleFrames, c.mScaleFrames) : nullptr;
+            pChannelKeys = pChannelKeys ? load_keys(pChannelKeys, inChannel.numOrientFrames, c.mOrientFrames) : nullptr;
+
+            if (!pChannelKeys)
+            {
+                return -2;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Load a scene from a cache file
+-------------------------------------*/
+SL_SceneCacheStatus SL_SceneFileCache::load(
+    const std::string& cachePath,
+    const std::string& sourcePath,
+    const SL_SceneLoadOpts& opts,
+    SL_SceneGraph& outGraph,
+    std::vector<SL_VaoGroup>& outVaoGroups,
+    std::unordered_map<std::string, const SL_Texture*>& outTexPaths) noexcept
+{
+    unload();
+
+    std::shared_ptr<SL_MappedFile> pFile{new(std::nothrow) SL_MappedFile{}};
+    if (!pFile)
+    {
+        return SL_SCENE_CACHE_OUT_OF_MEMORY;
+    }
+
+    if (pFile->open(cachePath.c_str()) != 0)
+    {
+        return SL_SCENE_CACHE_FILE_NOT_FOUND;
+    }
+
+    if (pFile->size() < sizeof(SL_SceneCacheHeader))
+    {
+        LS_LOG_ERR("\tThe scene cache ", cachePath, " is too small to contain a header.");
+        return SL_SCENE_CACHE_INVALID_HEADER;
+    }
+
+    const SL_SceneCacheHeader& header = *reinterpret_cast<const SL_SceneCacheHeader*>(pFile->data());
+
+    if (std::memcmp(header.magic, _SL_SCENE_CACHE_MAGIC, sizeof(header.magic)) != 0
+    || header.version != SL_SCENE_CACHE_VERSION
+    || header.byteOrder != _SL_SCENE_CACHE_BYTE_ORDER)
+    {
+        LS_LOG_ERR("\tThe scene cache ", cachePath, " was written by an incompatible version or platform.");
+        return SL_SCENE_CACHE_INVALID_HEADER;
+    }
+
+    if (header.loadOpts != _sl_pack_load_opts(opts))
+    {
+        return SL_SCENE_CACHE_STALE;
+    }
+
+    if (!sourcePath.empty())
+    {
+        uint64_t sourceBytes;
+        int64_t sourceTime;
+
+        if (!_sl_file_stats(sourcePath, sourceBytes, sourceTime)
+        || sourceBytes != header.sourceBytes
+        || sourceTime != header.sourceTime)
+        {
+            return SL_SCENE_CACHE_STALE;
+        }
+    }
+
+    if (!_sl_cache_validate_sections(header, (uint64_t)pFile->size()))
+    {
+        LS_LOG_ERR("\tThe scene cache ", cachePath, " is corrupt.");
+        return SL_SCENE_CACHE_CORRUPT;
+    }
+
+    LS_LOG_MSG("Loading the scene cache ", cachePath, '.');
+
+    // Read the mapping ahead of time since nearly all of it will be touched
+    pFile->prefetch();
+    mFile = std::move(pFile);
+
+    outGraph.terminate();
+    outVaoGroups.clear();
+    outTexPaths.clear();
+
+    const SL_SceneCacheSectionInfo& groupInfo = header.sections[SL_SCENE_CACHE_VAO_GROUPS];
+    const SL_SceneCacheVaoGroup* pGroups = _sl_cache_records<SL_SceneCacheVaoGroup>(mFile->data(), groupInfo);
+
+    outVaoGroups.resize((size_t)groupInfo.count);
+
+    for (size_t i = 0; i < outVaoGroups.size(); ++i)
+    {
+        outVaoGroups[i].vertType    = (SL_CommonVertType)pGroups[i].vertType;
+        outVaoGroups[i].numVboBytes = pGroups[i].numVboBytes;
+        outVaoGroups[i].vboOffset   = pGroups[i].vboOffset;
+        outVaoGroups[i].meshOffset  = pGroups[i].meshOffset;
+        outVaoGroups[i].baseVert    = pGroups[i].baseVert;
+    }
+
+    std::vector<const SL_Texture*> textures;
+    int ret = load_textures(header, opts, outGraph, textures, outTexPaths);
+
+    if (ret == 0)
+    {
+        ret = load_buffers(header, outGraph);
+    }
+
+    if (ret == 0)
+    {
+        ret = load_nodes(header, outGraph);
+    }
+
+    if (ret == 0)
+    {
+        ret = load_meshes(header, textures, outGraph);
+    }
+
+    if (ret == 0)
+    {
+        ret = load_animations(header, outGraph);
+    }
+
+    if (ret != 0)
+    {
+        LS_LOG_ERR("\tFailed to load the scene cache ", cachePath, " (", ret, ").");
+        outGraph.terminate();
+        outVaoGroups.clear();
+        outTexPaths.clear();
+        unload();
+
+        return (ret == -2) ? SL_SCENE_CACHE_OUT_OF_MEMORY : SL_SCENE_CACHE_CORRUPT;
+    }
+
+    LS_LOG_MSG(
+        "\tDone. Successfully loaded the scene cache \"", cachePath, ".\"",
+        "\n\t\tTotal Meshes:     ", outGraph.mMeshes.size(),
+        "\n\t\tTotal Bones:      ", outGraph.mBoneOffsets.size(),
+        "\n\t\tTotal Textures:   ", outGraph.mContext.textures().size(),
+        "\n\t\tTotal Nodes:      ", outGraph.mNodes.size(),
+        "\n\t\tTotal Cameras:    ", outGraph.mCameras.size(),
+        "\n\t\tTotal Animations: ", outGraph.mAnimations.size(),
+        '\n'
+    );
+
+    return SL_SCENE_CACHE_SUCCESS;
+}
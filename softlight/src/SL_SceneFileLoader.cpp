@@ -1,7 +1,9 @@
 
 #include <algorithm> // std::replace
+#include <atomic>
 #include <utility> // std::move
 #include <string>
+#include <thread>
 
 #include "lightsky/setup/OS.h" // LS_OS_WINDOWS
 
@@ -13,7 +15,9 @@
 #include "softlight/SL_Camera.hpp"
 #include "softlight/SL_Config.hpp" // SL_VERTEX_CACHING_ENABLED
 #include "softlight/SL_ImgFile.hpp"
+#include "softlight/SL_ImgFilePPM.hpp"
 #include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_SceneFileCache.hpp"
 #include "softlight/SL_SceneFileLoader.hpp"
 #include "softlight/SL_SceneFileUtility.hpp"
 #include "softlight/SL_Texture.hpp"
@@ -28,6 +32,25 @@ namespace utils = ls::utils;
 
 
 
+/*-----------------------------------------------------------------------------
+ * Anonymous helper structures
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+// Location of a single mesh within the shared VBO and IBO of a scene
+struct SL_MeshImportRange
+{
+    size_t vaoId;
+    size_t vboOffset;
+    size_t baseVert;
+    size_t baseIndex;
+};
+
+} // end anonymous namespace
+
+
+
 /*-----------------------------------------------------------------------------
  * SL_VaoGroup Class
 -----------------------------------------------------------------------------*/
@@ -139,6 +162,7 @@ SL_SceneLoadOpts sl_default_scene_load_opts() noexcept
     opts.genSmoothNormals = true;
     opts.genTangents = false;
     opts.swizzleTexels = false;
+    opts.compressTextures = false;
 
     return opts;
 }
@@ -589,6 +613,50 @@ bool SL_SceneFileLoader::load(const std::string& filename, SL_SceneLoadOpts opts
 
 
 
+/*-------------------------------------
+ * Load a set of meshes from a file, or its cache
+-------------------------------------*/
+bool SL_SceneFileLoader::load(const std::string& filename, const std::string& cachePath, SL_SceneLoadOpts opts) noexcept
+{
+    unload();
+
+    SL_SceneFileCache cache;
+    const SL_SceneCacheStatus cacheStatus = cache.load(
+        cachePath,
+        filename,
+        opts,
+        mPreloader.mSceneData,
+        mPreloader.mVaoGroups,
+        mLoadedTextures
+    );
+
+    if (cacheStatus == SL_SCENE_CACHE_SUCCESS)
+    {
+        mPreloader.mFilepath = filename;
+        mPreloader.mLoadOpts = opts;
+        return true;
+    }
+
+    if (cacheStatus != SL_SCENE_CACHE_FILE_NOT_FOUND)
+    {
+        LS_LOG_MSG("\tThe scene cache ", cachePath, " cannot be used (", (int)cacheStatus, "). Reimporting ", filename, '.');
+    }
+
+    if (!load(filename, opts))
+    {
+        return false;
+    }
+
+    if (cache.save(cachePath, filename, opts, mPreloader.mSceneData, mPreloader.mVaoGroups, mLoadedTextures) != SL_SCENE_CACHE_SUCCESS)
+    {
+        LS_LOG_ERR("\tWarning: Unable to write the scene cache ", cachePath, " for ", filename, '.');
+    }
+
+    return true;
+}
+
+
+
 /*-------------------------------------
  * Load a set of meshes from a file
 -------------------------------------*/
@@ -625,13 +693,20 @@ bool SL_SceneFileLoader::load_scene(const aiScene* const pScene, SL_SceneLoadOpt
         return false;
     }
 
-    if (import_materials(pScene) != 0)
+    std::vector<SL_SceneTextureJob> textureJobs;
+    std::vector<std::thread> textureThreads;
+
+    if (import_materials(pScene, textureJobs) != 0)
     {
         LS_LOG_ERR("\tError: Unable to load materials for the 3D mesh ", filename, "!\n");
         unload();
         return false;
     }
 
+    // Images are decoded in the background while the node hierarchy, bones,
+    // and vertices are imported.
+    decode_textures(textureJobs, textureThreads);
+
     // Find all bone nodes and store their offset matrices
     std::unordered_map<std::string, math::mat4>& offsets = mPreloader.mBoneOffsets;
 
@@ -675,6 +750,7 @@ bool SL_SceneFileLoader::load_scene(const aiScene* const pScene, SL_SceneLoadOpt
             if (!import_bone_data(i, pMesh, outMeshMarker->baseVert, opts))
             {
                 LS_LOG_ERR("\t\tUnable to import bone data for the mesh ", pMesh->mName.C_Str());
+                wait_for_textures(textureJobs, textureThreads);
                 return false;
             }
 
@@ -685,10 +761,16 @@ bool SL_SceneFileLoader::load_scene(const aiScene* const pScene, SL_SceneLoadOpt
     if (!import_mesh_data(pScene, opts))
     {
         LS_LOG_ERR("\tError: Failed to load the 3D mesh ", filename, "!\n");
+        wait_for_textures(textureJobs, textureThreads);
         unload();
         return false;
     }
 
+    if (!wait_for_textures(textureJobs, textureThreads))
+    {
+        LS_LOG_ERR("\tWarning: Failed to load some textures from ", filename, "!\n");
+    }
+
     if (!import_animations(pScene))
     {
         LS_LOG_ERR("\tWarning: Failed to animations from ", filename, "!\n");
@@ -823,7 +905,7 @@ bool SL_SceneFileLoader::allocate_gpu_data() noexcept
 /*-------------------------------------
  *
 -------------------------------------*/
-int SL_SceneFileLoader::import_materials(const aiScene* const pScene) noexcept
+int SL_SceneFileLoader::import_materials(const aiScene* const pScene, std::vector<SL_SceneTextureJob>& outTextureJobs) noexcept
 {
     static constexpr aiTextureType texTypes[] = {
         aiTextureType_DIFFUSE,
@@ -841,7 +923,6 @@ int SL_SceneFileLoader::import_materials(const aiScene* const pScene) noexcept
     };
 
     const unsigned numMaterials = pScene->mNumMaterials;
-    utils::Pointer<SL_ImgFile> imgLoader{new SL_ImgFile{}};
 
     LS_LOG_MSG("\tImporting ", numMaterials, " materials from the imported mesh.");
 
@@ -860,7 +941,7 @@ int SL_SceneFileLoader::import_materials(const aiScene* const pScene) noexcept
 
         for (unsigned j = 0; j < LS_ARRAY_SIZE(texTypes); ++j)
         {
-            import_texture_path(pScene, i, texTypes[j], *imgLoader, mLoadedTextures);
+            import_texture_path(pScene, i, texTypes[j], outTextureJobs, mLoadedTextures);
         }
 
         aiColor3D inMatColor;
@@ -920,7 +1001,7 @@ void SL_SceneFileLoader::import_texture_path(
     const aiScene* const pScene,
     const unsigned materialIndex,
     const int slotType,
-    SL_ImgFile& imgLoader,
+    std::vector<SL_SceneTextureJob>& textureJobs,
     std::unordered_map<std::string, const SL_Texture*>& loadedTextures
 ) noexcept
 {
@@ -928,8 +1009,6 @@ void SL_SceneFileLoader::import_texture_path(
     SL_Material& newMaterial = mPreloader.mSceneData.mMaterials[materialIndex];
     const SL_Texture** const pTextures = newMaterial.pTextures;
 
-    imgLoader.unload();
-
     const unsigned maxTexCount = math::min<unsigned>(SL_MATERIAL_MAX_TEXTURES, pMaterial->GetTextureCount((aiTextureType)slotType));
     unsigned materialTexOffset = 0;
 
@@ -978,7 +1057,6 @@ void SL_SceneFileLoader::import_texture_path(
     // iterate
     aiString inPath;
     aiTextureMapMode inWrapMode[3] = {aiTextureMapMode::aiTextureMapMode_Wrap};
-    const SL_Texture* pTexture = nullptr;
 
     for (unsigned i = 0; i < maxTexCount; ++i)
     {
@@ -1032,19 +1110,14 @@ void SL_SceneFileLoader::import_texture_path(
         }
         else
         {
-            pTexture = load_texture_at_path(texPath, imgLoader, pEmbeddedTex);
-
-            if (pTexture != nullptr)
-            {
-                loadedTextures[texPath] = pTexture;
-                pTextures[materialTexOffset] = pTexture;
-            }
-            else
-            {
-                LS_LOG_ERR("\t\t\tFailed to load a texture: ", texPath);
-                pTextures[materialTexOffset] = nullptr;
-                continue;
-            }
+            // Textures are allocated here so materials can reference them.
+            // Their images are decoded later by decode_textures().
+            SL_Context& context = mPreloader.mSceneData.mContext;
+            SL_Texture& t = context.texture(context.create_texture());
+
+            textureJobs.push_back(SL_SceneTextureJob{texPath, pEmbeddedTex, &t, false});
+            loadedTextures[texPath] = &t;
+            pTextures[materialTexOffset] = &t;
         }
     }
 }
@@ -1054,13 +1127,24 @@ void SL_SceneFileLoader::import_texture_path(
 /*-------------------------------------
  * Attempt to load a texture from the local filesystem
 -------------------------------------*/
-SL_Texture* SL_SceneFileLoader::load_texture_at_path(const std::string& path, SL_ImgFile& imgLoader, const aiTexture* pEmbeddedTex) noexcept
+bool SL_SceneFileLoader::load_texture_at_path(SL_SceneTextureJob& job, SL_ImgFile& imgLoader) const noexcept
 {
+    const aiTexture* const pEmbeddedTex = job.pEmbeddedTex;
+    const SL_TexelOrder texelOrder = mPreloader.mLoadOpts.swizzleTexels ? SL_TexelOrder::SWIZZLED : SL_TexelOrder::ORDERED;
+
+    imgLoader.unload();
+
     if (!pEmbeddedTex)
     {
-        if (imgLoader.load(path.c_str()) != SL_ImgFile::ImgStatus::FILE_LOAD_SUCCESS)
+        // Binary PPM files are decoded directly into texture memory
+        if (sl_img_is_ppm(job.path.c_str()))
         {
-            return nullptr;
+            return sl_img_load_ppm(*job.pTexture, job.path.c_str(), texelOrder) == 0;
+        }
+
+        if (imgLoader.load(job.path.c_str()) != SL_ImgFile::ImgStatus::FILE_LOAD_SUCCESS)
+        {
+            return false;
         }
     }
     else if (pEmbeddedTex->mHeight != 0)
@@ -1074,7 +1158,7 @@ SL_Texture* SL_SceneFileLoader::load_texture_at_path(const std::string& path, SL
         if (imgLoader.load_memory_raw(pEmbeddedTex->pcData, dataType, pEmbeddedTex->mWidth, pEmbeddedTex->mHeight) != SL_ImgFile::ImgStatus::FILE_LOAD_SUCCESS)
         {
             LS_LOG_ERR("\t\tUnknown texture format, \"", pEmbeddedTex->achFormatHint, ",\" for embedded texture: ", pEmbeddedTex->mFilename.C_Str());
-            return nullptr;
+            return false;
         }
     }
     else
@@ -1082,23 +1166,113 @@ SL_Texture* SL_SceneFileLoader::load_texture_at_path(const std::string& path, SL
         if (imgLoader.load_memory_file(pEmbeddedTex->pcData, pEmbeddedTex->mWidth, pEmbeddedTex->mFilename.C_Str()) != SL_ImgFile::ImgStatus::FILE_LOAD_SUCCESS)
         {
             LS_LOG_ERR("\t\tInternal error while loading embedded texture: ", pEmbeddedTex->mFilename.C_Str());
-            return nullptr;
+            return false;
         }
     }
 
+    const bool loaded = job.pTexture->init(imgLoader, texelOrder) == 0;
+
+    // Release the decoded image before the next job so each thread holds at
+    // most one copy of an image.
+    imgLoader.unload();
+
+    return loaded;
+}
+
+
+
+/*-------------------------------------
+ * Decode textures on worker threads
+-------------------------------------*/
+void SL_SceneFileLoader::decode_textures(std::vector<SL_SceneTextureJob>& textureJobs, std::vector<std::thread>& outThreads) noexcept
+{
+    const size_t numJobs = textureJobs.size();
+    if (!numJobs)
+    {
+        return;
+    }
+
+    const unsigned numThreads = (unsigned)math::min<size_t>(numJobs, math::max<unsigned>(1u, mPreloader.mSceneData.mContext.num_threads()));
+
+    LS_LOG_MSG("\tDecoding ", numJobs, " textures using ", numThreads, " threads.");
+
+    // Each texture was allocated ahead of time, so workers only decode
+    // images into textures they exclusively own.
+    for (unsigned threadId = 0; threadId < numThreads; ++threadId)
+    {
+        outThreads.emplace_back([this, &textureJobs, threadId, numThreads, numJobs]() -> void
+        {
+            utils::Pointer<SL_ImgFile> imgLoader{new SL_ImgFile{}};
+            const SL_SceneLoadOpts& opts = mPreloader.mLoadOpts;
+            const SL_TexelOrder texelOrder = opts.swizzleTexels ? SL_TexelOrder::SWIZZLED : SL_TexelOrder::ORDERED;
+
+            for (size_t i = threadId; i < numJobs; i += numThreads)
+            {
+                textureJobs[i].loaded = load_texture_at_path(textureJobs[i], *imgLoader);
+
+                // Formats without a block-compressed equivalent are kept
+                if (textureJobs[i].loaded && opts.compressTextures)
+                {
+                    sl_texture_compress(*textureJobs[i].pTexture, texelOrder);
+                }
+            }
+        });
+    }
+}
+
+
+
+/*-------------------------------------
+ * Wait for textures to finish decoding
+-------------------------------------*/
+bool SL_SceneFileLoader::wait_for_textures(std::vector<SL_SceneTextureJob>& textureJobs, std::vector<std::thread>& threads) noexcept
+{
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    threads.clear();
+
     SL_SceneGraph& graph = mPreloader.mSceneData;
-    const size_t loadedTexture = graph.mContext.create_texture();
-    SL_Texture& t = graph.mContext.texture(loadedTexture);
+    bool allLoaded = true;
 
-    SL_TexelOrder texelOrder = mPreloader.mLoadOpts.swizzleTexels ? SL_TexelOrder::SWIZZLED : SL_TexelOrder::ORDERED;
-    //if (t.init(imgLoader, SL_TexelOrder::ORDERED) != 0)
-    if (t.init(imgLoader, texelOrder) != 0)
+    for (const SL_SceneTextureJob& job : textureJobs)
     {
-        graph.mContext.destroy_texture(loadedTexture);
-        return nullptr;
+        if (job.loaded)
+        {
+            continue;
+        }
+
+        LS_LOG_ERR("\t\t\tFailed to load a texture: ", job.path);
+        allLoaded = false;
+        mLoadedTextures.erase(job.path);
+
+        for (SL_Material& m : graph.mMaterials)
+        {
+            for (unsigned i = 0; i < SL_MATERIAL_MAX_TEXTURES; ++i)
+            {
+                if (m.pTextures[i] == job.pTexture)
+                {
+                    m.pTextures[i] = nullptr;
+                }
+            }
+        }
+
+        const SL_AlignedVector<SL_Texture*>& textures = graph.mContext.textures();
+        for (size_t i = textures.size(); i--;)
+        {
+            if (textures[i] == job.pTexture)
+            {
+                graph.mContext.destroy_texture(i);
+                break;
+            }
+        }
     }
 
-    return &t;
+    textureJobs.clear();
+
+    return allLoaded;
 }
 
 
@@ -1121,44 +1295,86 @@ bool SL_SceneFileLoader::import_mesh_data(const aiScene* const pScene, const SL_
     SL_IndexBuffer&                   ibo          = renderData.ibo(renderData.ibos().size()-1);
     size_t                            baseIndex    = 0;
     char* const                       pVbo         = reinterpret_cast<char*>(vbo.data());
-    char*                             pIbo         = reinterpret_cast<char*>(ibo.data());
+    char* const                       pIbo         = reinterpret_cast<char*>(ibo.data());
+    const size_t                      indexBytes   = sl_index_byte_size(mPreloader.mSceneInfo.indexType);
+    const unsigned                    numMeshes    = pScene->mNumMeshes;
 
-    // vertex data in ASSIMP is not interleaved. It has to be converted into
-    // the internally used vertex format which is recommended for use on mobile
-    // devices.
-    for (unsigned meshId = 0; meshId < pScene->mNumMeshes; ++meshId)
+    // Assign the range of vertices and indices of each mesh up-front so
+    // meshes can be packed into the shared VBO and IBO independently.
+    std::vector<SL_MeshImportRange> ranges(numMeshes);
+
+    for (unsigned meshId = 0; meshId < numMeshes; ++meshId)
     {
         const aiMesh* const     pMesh       = pScene->mMeshes[meshId];
         const SL_CommonVertType vertType    = sl_convert_assimp_verts(pMesh, opts);
         const size_t            meshGroupId = get_mesh_group_marker(vertType, mPreloader.mVaoGroups);
         SL_VaoGroup&            meshGroup   = tempVboMarks[meshGroupId];
-        size_t                  numIndices  = 0;
+        SL_MeshImportRange&     range       = ranges[meshId];
 
         LS_ASSERT(meshGroup.vertType == vertType);
 
-        SL_Mesh& mesh   = meshes[meshId];
-        SL_BoundingBox& box = bounds[meshId];
-        mesh.materialId = (uint32_t)pMesh->mMaterialIndex;
-        mesh.vaoId      = meshGroupId;
-
-        box.min_point(math::vec4{std::numeric_limits<float>::max()});
-        box.max_point(math::vec4{-std::numeric_limits<float>::max()});
-
-        // get the offset to the current mesh so it can be sent to a VBO
-        const size_t meshOffset = meshGroup.vboOffset + meshGroup.meshOffset;
-        sl_upload_mesh_vertices(
-            pMesh, meshGroup.baseVert,
-            pVbo + meshOffset,
-            meshGroup.vertType,
-            mPreloader.mBones);
+        range.vaoId      = meshGroupId;
+        range.vboOffset  = meshGroup.vboOffset + meshGroup.meshOffset;
+        range.baseVert   = meshGroup.baseVert;
+        range.baseIndex  = baseIndex;
 
         // increment the mesh offset for the next mesh
         meshGroup.meshOffset += sl_vertex_stride(meshGroup.vertType) * pMesh->mNumVertices;
-        pIbo = upload_mesh_indices(pMesh, pIbo, baseIndex, meshGroup.baseVert, mesh, numIndices);
         meshGroup.baseVert += pMesh->mNumVertices;
-        baseIndex += numIndices;
 
-        sl_update_mesh_bounds(pMesh, box);
+        for (unsigned faceId = 0; faceId < pMesh->mNumFaces; ++faceId)
+        {
+            baseIndex += pMesh->mFaces[faceId].mNumIndices;
+        }
+    }
+
+    // vertex data in ASSIMP is not interleaved. It has to be converted into
+    // the internally used vertex format which is recommended for use on mobile
+    // devices.
+    std::atomic_uint nextMesh{0};
+
+    const auto uploadMeshes = [&]() -> void
+    {
+        for (unsigned meshId = nextMesh.fetch_add(1); meshId < numMeshes; meshId = nextMesh.fetch_add(1))
+        {
+            const aiMesh* const       pMesh      = pScene->mMeshes[meshId];
+            const SL_MeshImportRange& range      = ranges[meshId];
+            const SL_VaoGroup&        meshGroup  = tempVboMarks[range.vaoId];
+            size_t                    numIndices = 0;
+
+            SL_Mesh& mesh   = meshes[meshId];
+            SL_BoundingBox& box = bounds[meshId];
+            mesh.materialId = (uint32_t)pMesh->mMaterialIndex;
+            mesh.vaoId      = range.vaoId;
+
+            box.min_point(math::vec4{std::numeric_limits<float>::max()});
+            box.max_point(math::vec4{-std::numeric_limits<float>::max()});
+
+            sl_upload_mesh_vertices(
+                pMesh, range.baseVert,
+                pVbo + range.vboOffset,
+                meshGroup.vertType,
+                mPreloader.mBones);
+
+            upload_mesh_indices(pMesh, pIbo + range.baseIndex * indexBytes, range.baseIndex, range.baseVert, mesh, numIndices);
+
+            sl_update_mesh_bounds(pMesh, box);
+        }
+    };
+
+    const unsigned numThreads = math::min<unsigned>(numMeshes, math::max<unsigned>(1u, renderData.num_threads()));
+    std::vector<std::thread> threads;
+
+    for (unsigned i = 1; i < numThreads; ++i)
+    {
+        threads.emplace_back(uploadMeshes);
+    }
+
+    uploadMeshes();
+
+    for (std::thread& t : threads)
+    {
+        t.join();
     }
 
     LS_LOG_MSG("\t\tDone.");
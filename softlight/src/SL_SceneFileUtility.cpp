@@ -170,6 +170,21 @@ inline char* set_mesh_vertex_data(char* const pVert, const data_t& data) noexcep
 
 
 
+/*-------------------------------------
+ * Retrieve the bone data of a vertex without modifying the bone map, so
+ * meshes can be uploaded from multiple threads. Vertices without bones
+ * receive zeroed weights.
+-------------------------------------*/
+inline const SL_BoneData& get_mesh_bone_data(const uint32_t index, const std::unordered_map<uint32_t, SL_BoneData>& boneData) noexcept
+{
+    static const SL_BoneData emptyBone{};
+
+    const std::unordered_map<uint32_t, SL_BoneData>::const_iterator iter = boneData.find(index);
+    return (iter != boneData.end()) ? iter->second : emptyBone;
+}
+
+
+
 /*-------------------------------------
  * Calculate the vertex positions for a mesh.
 -------------------------------------*/
@@ -325,10 +340,10 @@ char* sl_calc_mesh_geometry_tangent_packed(
 char* sl_calc_mesh_geometry_bone_id(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept
 {
-    const SL_BoneData& bone = boneData[index];
+    const SL_BoneData& bone = get_mesh_bone_data(index, boneData);
     return set_mesh_vertex_data(pVbo, bone.ids32);
 }
 
@@ -341,10 +356,10 @@ char* sl_calc_mesh_geometry_bone_id(
 char* sl_calc_mesh_geometry_bone_id_packed(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept
 {
-    const SL_BoneData& bone = boneData[index];
+    const SL_BoneData& bone = get_mesh_bone_data(index, boneData);
     return set_mesh_vertex_data(pVbo, bone.ids16);
 }
 
@@ -357,10 +372,10 @@ char* sl_calc_mesh_geometry_bone_id_packed(
 char* sl_calc_mesh_geometry_bone_weight(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept
 {
-    const SL_BoneData& bone = boneData[index];
+    const SL_BoneData& bone = get_mesh_bone_data(index, boneData);
     return set_mesh_vertex_data(pVbo, bone.weights32);
 }
 
@@ -373,10 +388,10 @@ char* sl_calc_mesh_geometry_bone_weight(
 char* sl_calc_mesh_geometry_bone_weight_packed(
     const uint32_t index,
     char* pVbo,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept
 {
-    const SL_BoneData& bone = boneData[index];
+    const SL_BoneData& bone = get_mesh_bone_data(index, boneData);
     return set_mesh_vertex_data(pVbo, bone.weights16);
 }
 
@@ -390,7 +405,7 @@ unsigned sl_upload_mesh_vertices(
     const uint32_t baseVert,
     char* const pVbo,
     const SL_CommonVertType vertTypes,
-    std::unordered_map<uint32_t, SL_BoneData>& boneData
+    const std::unordered_map<uint32_t, SL_BoneData>& boneData
 ) noexcept
 {
     //const unsigned vertStride  = sl_vertex_stride(vertTypes);
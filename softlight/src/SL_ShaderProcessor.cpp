@@ -37,6 +37,28 @@ SL_ShaderType sl_processor_type_for_draw_mode(SL_RenderMode drawMode) noexcept
 
 
 
+/*--------------------------------------
+ * Number of elements consumed by each primitive of a render mode
+--------------------------------------*/
+unsigned sl_vertices_per_primitive(SL_RenderMode drawMode) noexcept
+{
+    switch (sl_processor_type_for_draw_mode(drawMode))
+    {
+        case SL_POINT_PROCESSOR:
+            return 1u;
+
+        case SL_LINE_PROCESSOR:
+            return 2u;
+
+        default:
+            break;
+    }
+
+    return 3u;
+}
+
+
+
 /*--------------------------------------
  * Destructor
 --------------------------------------*/
@@ -87,6 +109,18 @@ SL_ShaderProcessor::SL_ShaderProcessor(const SL_ShaderProcessor& sp) noexcept :
         case SL_CLEAR_PROCESSOR:
             mClear = sp.mClear;
             break;
+
+        case SL_MIP_PROCESSOR:
+            mMipGenerator = sp.mMipGenerator;
+            break;
+
+        case SL_SAMPLE_RESOLVE_PROCESSOR:
+            mSampleResolver = sp.mSampleResolver;
+            break;
+
+        case SL_BLOCK_COMPRESS_PROCESSOR:
+            mBlockCompressor = sp.mBlockCompressor;
+            break;
     }
 }
 
@@ -123,6 +157,18 @@ SL_ShaderProcessor::SL_ShaderProcessor(SL_ShaderProcessor&& sp) noexcept :
         case SL_CLEAR_PROCESSOR:
             mClear = sp.mClear;
             break;
+
+        case SL_MIP_PROCESSOR:
+            mMipGenerator = sp.mMipGenerator;
+            break;
+
+        case SL_SAMPLE_RESOLVE_PROCESSOR:
+            mSampleResolver = sp.mSampleResolver;
+            break;
+
+        case SL_BLOCK_COMPRESS_PROCESSOR:
+            mBlockCompressor = sp.mBlockCompressor;
+            break;
     }
 }
 
@@ -162,6 +208,18 @@ SL_ShaderProcessor& SL_ShaderProcessor::operator=(const SL_ShaderProcessor& sp)
             case SL_CLEAR_PROCESSOR:
                 mClear = sp.mClear;
                 break;
+
+            case SL_MIP_PROCESSOR:
+                mMipGenerator = sp.mMipGenerator;
+                break;
+
+            case SL_SAMPLE_RESOLVE_PROCESSOR:
+                mSampleResolver = sp.mSampleResolver;
+                break;
+
+            case SL_BLOCK_COMPRESS_PROCESSOR:
+                mBlockCompressor = sp.mBlockCompressor;
+                break;
         }
     }
 
@@ -204,6 +262,18 @@ SL_ShaderProcessor& SL_ShaderProcessor::operator=(SL_ShaderProcessor&& sp) noexc
             case SL_CLEAR_PROCESSOR:
                 mClear = sp.mClear;
                 break;
+
+            case SL_MIP_PROCESSOR:
+                mMipGenerator = sp.mMipGenerator;
+                break;
+
+            case SL_SAMPLE_RESOLVE_PROCESSOR:
+                mSampleResolver = sp.mSampleResolver;
+                break;
+
+            case SL_BLOCK_COMPRESS_PROCESSOR:
+                mBlockCompressor = sp.mBlockCompressor;
+                break;
         }
     }
 
@@ -1,5 +1,7 @@
 
 #include <cstddef> // ptrdiff_t
+#include <new> // std::nothrow
+#include <utility> // std::move()
 
 #include "lightsky/setup/OS.h"
 
@@ -12,6 +14,7 @@
 #include "lightsky/utils/Copy.h"
 #include "lightsky/utils/Pointer.h" // aligned allocation
 
+#include "softlight/SL_BlockCompressProcessor.hpp"
 #include "softlight/SL_ImgFile.hpp"
 #include "softlight/SL_Texture.hpp"
 
@@ -92,6 +95,30 @@ char* _sl_copy_texture(size_t w, size_t h, size_t d, size_t bpt, const char* pDa
 
 
 
+/*-------------------------------------
+ * Block-compressed textures store one element per 4x4 group of texels
+-------------------------------------*/
+inline size_t _sl_storage_dimen(SL_ColorDataType type, size_t numTexels) noexcept
+{
+    return sl_is_block_compressed_color(type) ? ((numTexels + 3u) >> 2u) : numTexels;
+}
+
+
+
+/*-------------------------------------
+ *
+-------------------------------------*/
+inline void _sl_free_texture(char* pTexels) noexcept
+{
+    #if defined(LS_OS_WINDOWS)
+    ls::utils::aligned_free(pTexels);
+    #else
+    free(pTexels);
+    #endif
+}
+
+
+
 } // end anonymous namespace
 
 
@@ -131,6 +158,61 @@ void sl_texture_view_from_buffer(SL_TextureView& outView, uint16_t w, uint16_t h
 
 
 
+/*-------------------------------------
+ * Allocate storage for a texture
+-------------------------------------*/
+void* sl_texture_allocate(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d) noexcept
+{
+    return _sl_allocate_texture(_sl_storage_dimen(type, w), _sl_storage_dimen(type, h), d, sl_bytes_per_color(type));
+}
+
+
+
+/*-------------------------------------
+ * Free storage which was never adopted by a texture
+-------------------------------------*/
+void sl_texture_free(void* pTexels) noexcept
+{
+    _sl_free_texture((char*)pTexels);
+}
+
+
+
+/*-------------------------------------
+ * Block-compress a texture on the calling thread
+-------------------------------------*/
+int sl_texture_compress(SL_Texture& tex, SL_TexelOrder order) noexcept
+{
+    const SL_TextureView& src = tex.view();
+    const SL_ColorDataType blockType = sl_block_compressed_color_for(src.type);
+
+    if (!src.pTexels || blockType == src.type)
+    {
+        return -1;
+    }
+
+    SL_Texture compressed;
+    if (compressed.init(blockType, src.width, src.height, src.depth) != 0)
+    {
+        return -2;
+    }
+
+    SL_BlockCompressProcessor compressor;
+    compressor.mThreadId   = 0;
+    compressor.mNumThreads = 1;
+    compressor.mTexelOrder = order;
+    compressor.mDecompress = false;
+    compressor.mSrcTex     = &src;
+    compressor.mDstTex     = &compressed.view();
+    compressor.execute();
+
+    tex = std::move(compressed);
+
+    return 0;
+}
+
+
+
 /*-----------------------------------------------------------------------------
  * SL_Texture
 -----------------------------------------------------------------------------*/
@@ -157,7 +239,9 @@ SL_Texture::SL_Texture() noexcept :
         0,
         nullptr,
         SL_COLOR_RGB_DEFAULT
-    }
+    },
+    mMips{nullptr},
+    mNumMips{0}
 {}
 
 
@@ -173,10 +257,22 @@ SL_Texture::SL_Texture(const SL_Texture& r) noexcept :
         r.mView.depth,
         r.mView.bytesPerTexel,
         r.mView.numChannels,
-        _sl_copy_texture(r.mView.width, r.mView.height, r.mView.depth, r.mView.bytesPerTexel, r.mView.pTexels),
+        _sl_copy_texture(_sl_storage_dimen(r.mView.type, r.mView.width), _sl_storage_dimen(r.mView.type, r.mView.height), r.mView.depth, r.mView.bytesPerTexel, r.mView.pTexels),
         r.mView.type
+    },
+    mMips{nullptr},
+    mNumMips{r.mView.pTexels ? (uint16_t)1u : (uint16_t)0u}
+{
+    if (r.mNumMips > 1 && init_mips(r.mNumMips) == 0)
+    {
+        for (uint16_t i = 1; i < mNumMips; ++i)
+        {
+            const SL_TextureView& inMip = r.mMips[i-1u];
+            _sl_free_texture(mMips[i-1u].pTexels);
+            mMips[i-1u].pTexels = _sl_copy_texture(inMip.width, inMip.height, inMip.depth, inMip.bytesPerTexel, inMip.pTexels);
+        }
     }
-{}
+}
 
 
 
@@ -193,8 +289,13 @@ SL_Texture::SL_Texture(SL_Texture&& r) noexcept :
         r.mView.numChannels,
         r.mView.pTexels,
         r.mView.type
-    }
+    },
+    mMips{r.mMips},
+    mNumMips{r.mNumMips}
 {
+    r.mMips = nullptr;
+    r.mNumMips = 0;
+
     r.mView.width = 0;
     r.mView.height = 0;
     r.mView.depth = 0;
@@ -224,8 +325,19 @@ SL_Texture& SL_Texture::operator=(const SL_Texture& r) noexcept
     mView.depth = r.mView.depth;
     mView.bytesPerTexel = r.mView.bytesPerTexel;
     mView.numChannels = r.mView.numChannels;
-    mView.pTexels = _sl_copy_texture(r.mView.width, r.mView.height, r.mView.depth, r.mView.bytesPerTexel, r.mView.pTexels);
+    mView.pTexels = _sl_copy_texture(_sl_storage_dimen(r.mView.type, r.mView.width), _sl_storage_dimen(r.mView.type, r.mView.height), r.mView.depth, r.mView.bytesPerTexel, r.mView.pTexels);
     mView.type = r.mView.type;
+    mNumMips = mView.pTexels ? 1 : 0;
+
+    if (r.mNumMips > 1 && init_mips(r.mNumMips) == 0)
+    {
+        for (uint16_t i = 1; i < mNumMips; ++i)
+        {
+            const SL_TextureView& inMip = r.mMips[i-1u];
+            _sl_free_texture(mMips[i-1u].pTexels);
+            mMips[i-1u].pTexels = _sl_copy_texture(inMip.width, inMip.height, inMip.depth, inMip.bytesPerTexel, inMip.pTexels);
+        }
+    }
 
     return *this;
 }
@@ -265,6 +377,12 @@ SL_Texture& SL_Texture::operator=(SL_Texture&& r) noexcept
     mView.type = r.mView.type;
     r.mView.type = SL_COLOR_RGB_DEFAULT;
 
+    mMips = r.mMips;
+    r.mMips = nullptr;
+
+    mNumMips = r.mNumMips;
+    r.mNumMips = 0;
+
     return *this;
 }
 
@@ -276,7 +394,7 @@ SL_Texture& SL_Texture::operator=(SL_Texture&& r) noexcept
 int SL_Texture::init(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d) noexcept
 {
     const size_t bpt = sl_bytes_per_color(type);
-    char* pData = _sl_allocate_texture(w, h, d, bpt);
+    char* pData = _sl_allocate_texture(_sl_storage_dimen(type, w), _sl_storage_dimen(type, h), d, bpt);
 
     if (!pData)
     {
@@ -289,6 +407,7 @@ int SL_Texture::init(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d)
     }
 
     sl_texture_view_from_buffer(mView, w, h, d, type, pData);
+    mNumMips = 1;
 
     return 0;
 }
@@ -353,24 +472,128 @@ int SL_Texture::init(const SL_ImgFile& imgFile, SL_TexelOrder texelOrder) noexce
 
 
 
+/*-------------------------------------
+ * Take ownership of pre-allocated texels
+-------------------------------------*/
+int SL_Texture::adopt(SL_ColorDataType type, uint16_t w, uint16_t h, uint16_t d, void* pTexels) noexcept
+{
+    if (!pTexels)
+    {
+        return -1;
+    }
+
+    if (mView.pTexels)
+    {
+        terminate();
+    }
+
+    sl_texture_view_from_buffer(mView, w, h, d, type, pTexels);
+    mNumMips = 1;
+
+    return 0;
+}
+
+
+
 /*-------------------------------------
  *
 -------------------------------------*/
 void SL_Texture::terminate() noexcept
 {
+    terminate_mips();
+    mNumMips = 0;
+
     mView.width = 0;
     mView.height = 0;
     mView.depth = 0;
     mView.bytesPerTexel = 0;
     mView.numChannels = 0;
 
-    #if defined(LS_OS_WINDOWS)
-    ls::utils::aligned_free(mView.pTexels);
-    #else
-    free(mView.pTexels);
-    #endif
+    _sl_free_texture(mView.pTexels);
 
     mView.pTexels = nullptr;
 
     mView.type = SL_COLOR_RGB_DEFAULT;
 }
+
+
+
+/*-------------------------------------
+ * Allocate storage for a chain of mip levels. Each level is half the width
+ * and height of the previous one while retaining the same depth. Passing 0
+ * allocates every level down to 1x1. Texel data is generated separately,
+ * using SL_Context::generate_mips().
+-------------------------------------*/
+int SL_Texture::init_mips(uint16_t numLevels) noexcept
+{
+    if (!mView.pTexels)
+    {
+        return -1;
+    }
+
+    if (sl_is_compressed_color(mView.type) || sl_is_block_compressed_color(mView.type))
+    {
+        return -2;
+    }
+
+    const uint16_t maxLevels = sl_calc_mip_levels(mView.width, mView.height);
+    if (!numLevels || numLevels > maxLevels)
+    {
+        numLevels = maxLevels;
+    }
+
+    terminate_mips();
+
+    if (numLevels < 2)
+    {
+        return 0;
+    }
+
+    mMips = new(std::nothrow) SL_TextureView[numLevels-1u];
+    if (!mMips)
+    {
+        return -3;
+    }
+
+    uint16_t w = mView.width;
+    uint16_t h = mView.height;
+
+    for (uint16_t i = 1; i < numLevels; ++i)
+    {
+        w = ls::math::max<uint16_t>(1u, w >> 1u);
+        h = ls::math::max<uint16_t>(1u, h >> 1u);
+
+        char* const pData = _sl_allocate_texture(w, h, mView.depth, mView.bytesPerTexel);
+        if (!pData)
+        {
+            terminate_mips();
+            return -3;
+        }
+
+        sl_texture_view_from_buffer(mMips[i-1u], w, h, mView.depth, mView.type, pData);
+        mNumMips = i+1u;
+    }
+
+    return 0;
+}
+
+
+
+/*-------------------------------------
+ * Release all mip levels except for the base texture
+-------------------------------------*/
+void SL_Texture::terminate_mips() noexcept
+{
+    if (mMips)
+    {
+        for (uint16_t i = 1; i < mNumMips; ++i)
+        {
+            _sl_free_texture(mMips[i-1u].pTexels);
+        }
+
+        delete [] mMips;
+        mMips = nullptr;
+    }
+
+    mNumMips = mView.pTexels ? 1 : 0;
+}
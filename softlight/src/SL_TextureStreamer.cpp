@@ -0,0 +1,271 @@
+
+#include <algorithm> // std::max()
+#include <new> // std::nothrow
+#include <utility> // std::move
+
+#include "lightsky/utils/Log.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_ImgFile.hpp"
+#include "softlight/SL_ImgFilePPM.hpp"
+#include "softlight/SL_TextureStreamer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * SL_TextureStreamer Class
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Destructor
+-------------------------------------*/
+SL_TextureStreamer::~SL_TextureStreamer() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mLock};
+        mRunning = false;
+        mPending.clear();
+    }
+
+    mPendingSignal.notify_all();
+
+    for (std::thread& t : mThreads)
+    {
+        t.join();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Constructor
+-------------------------------------*/
+SL_TextureStreamer::SL_TextureStreamer(SL_Context& context, unsigned numThreads) noexcept :
+    mContext{&context},
+    mLock{},
+    mPendingSignal{},
+    mDecodedSignal{},
+    mStreams{},
+    mPending{},
+    mDecoded{},
+    mNumDecoding{0},
+    mRunning{true},
+    mThreads{}
+{
+    numThreads = std::max(1u, numThreads);
+    mThreads.reserve(numThreads);
+
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        mThreads.emplace_back(&SL_TextureStreamer::decode_textures, this);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Thread entry point
+-------------------------------------*/
+void SL_TextureStreamer::decode_textures() noexcept
+{
+    // Image files are reused between requests to avoid reallocating
+    // FreeImage's bitmap containers.
+    SL_ImgFile imgFile;
+    std::unique_lock<std::mutex> lock{mLock};
+
+    while (true)
+    {
+        mPendingSignal.wait(lock, [this]()->bool { return !mPending.empty() || !mRunning; });
+
+        if (!mRunning)
+        {
+            break;
+        }
+
+        const size_t handle = mPending.front();
+        SL_TextureStream* const pStream = mStreams[handle].get();
+        mPending.pop_front();
+        ++mNumDecoding;
+
+        // Only this thread touches the staging texture until the request is
+        // marked as decoded.
+        lock.unlock();
+
+        bool loaded;
+
+        // Binary PPM files are decoded directly into the staging texture
+        if (sl_img_is_ppm(pStream->path.c_str()))
+        {
+            loaded = sl_img_load_ppm(pStream->staged, pStream->path.c_str(), pStream->texelOrder) == 0;
+        }
+        else
+        {
+            loaded = imgFile.load(pStream->path.c_str()) == SL_ImgFile::ImgStatus::FILE_LOAD_SUCCESS;
+            if (loaded)
+            {
+                loaded = pStream->staged.init(imgFile, pStream->texelOrder) == 0;
+            }
+
+            imgFile.unload();
+        }
+
+        if (!loaded)
+        {
+            LS_LOG_ERR("\tUnable to stream the texture ", pStream->path, '.');
+            pStream->staged.terminate();
+        }
+
+        lock.lock();
+
+        if (loaded)
+        {
+            pStream->status = SL_TEXTURE_STREAM_DECODED;
+            mDecoded.push_back(handle);
+        }
+        else
+        {
+            pStream->status = SL_TEXTURE_STREAM_FAILED;
+        }
+
+        --mNumDecoding;
+        mDecodedSignal.notify_all();
+    }
+}
+
+
+
+/*-------------------------------------
+ * Request a texture be loaded
+-------------------------------------*/
+size_t SL_TextureStreamer::request(
+    const std::string& path,
+    SL_ColorDataType placeholderType,
+    const void* pPlaceholderTexel,
+    SL_TexelOrder texelOrder) noexcept
+{
+    SL_TextureStream* pStream = new(std::nothrow) SL_TextureStream{path, texelOrder, nullptr, SL_Texture{}, SL_TEXTURE_STREAM_PENDING};
+    if (!pStream)
+    {
+        return SL_TEXTURE_STREAM_INVALID_HANDLE;
+    }
+
+    const size_t texId = mContext->create_texture();
+    SL_Texture& tex = mContext->texture(texId);
+
+    if (tex.init(placeholderType, 1, 1, 1) != 0)
+    {
+        LS_LOG_ERR("\tUnable to allocate a placeholder for the texture ", path, '.');
+        mContext->destroy_texture(texId);
+        delete pStream;
+        return SL_TEXTURE_STREAM_INVALID_HANDLE;
+    }
+
+    // A single texel is stored at the same location in every texel order
+    const char zeroTexel[sizeof(SL_ColorRGBAd)] = {0};
+    tex.set_texel(0, 0, 0, pPlaceholderTexel ? pPlaceholderTexel : zeroTexel);
+    pStream->pTexture = &tex;
+
+    size_t handle;
+    {
+        std::lock_guard<std::mutex> lock{mLock};
+        handle = mStreams.size();
+        mStreams.emplace_back(pStream);
+        mPending.push_back(handle);
+    }
+
+    mPendingSignal.notify_one();
+
+    return handle;
+}
+
+
+
+/*-------------------------------------
+ * Bind all decoded textures
+-------------------------------------*/
+size_t SL_TextureStreamer::update() noexcept
+{
+    std::vector<size_t> decoded;
+    {
+        std::lock_guard<std::mutex> lock{mLock};
+        decoded.swap(mDecoded);
+    }
+
+    if (decoded.empty())
+    {
+        return 0;
+    }
+
+    // Submitted draws may still be sampling the placeholders
+    mContext->finish();
+
+    for (size_t handle : decoded)
+    {
+        SL_TextureStream* const pStream = mStreams[handle].get();
+        *pStream->pTexture = std::move(pStream->staged);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mLock};
+        for (size_t handle : decoded)
+        {
+            mStreams[handle]->status = SL_TEXTURE_STREAM_RESIDENT;
+        }
+    }
+
+    return decoded.size();
+}
+
+
+
+/*-------------------------------------
+ * Wait for all requests to be decoded
+-------------------------------------*/
+void SL_TextureStreamer::wait() noexcept
+{
+    std::unique_lock<std::mutex> lock{mLock};
+    mDecodedSignal.wait(lock, [this]()->bool { return mPending.empty() && !mNumDecoding; });
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the status of a request
+-------------------------------------*/
+SL_TextureStreamStatus SL_TextureStreamer::status(size_t handle) const noexcept
+{
+    std::lock_guard<std::mutex> lock{mLock};
+    return handle < mStreams.size() ? mStreams[handle]->status : SL_TEXTURE_STREAM_INVALID;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve the context index of a streamed texture
+-------------------------------------*/
+size_t SL_TextureStreamer::texture_id(size_t handle) const noexcept
+{
+    const SL_Texture* const pTexture = texture(handle);
+    const SL_AlignedVector<SL_Texture*>& textures = mContext->textures();
+
+    // Texture indices shift whenever a texture is destroyed
+    for (size_t i = 0; pTexture && i < textures.size(); ++i)
+    {
+        if (textures[i] == pTexture)
+        {
+            return i;
+        }
+    }
+
+    return SL_TEXTURE_STREAM_INVALID_HANDLE;
+}
+
+
+
+/*-------------------------------------
+ * Retrieve a streamed texture
+-------------------------------------*/
+const SL_Texture* SL_TextureStreamer::texture(size_t handle) const noexcept
+{
+    std::lock_guard<std::mutex> lock{mLock};
+    return handle < mStreams.size() ? mStreams[handle]->pTexture : nullptr;
+}
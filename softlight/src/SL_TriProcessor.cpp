@@ -235,6 +235,104 @@ inline LS_INLINE math::vec4_t<size_t> get_next_vertex3(const SL_IndexBuffer* LS_
 
 
 
+/*--------------------------------------
+ * Calculate the clip-space visibility & screen-space coordinates of all
+ * vertices in a batch
+--------------------------------------*/
+inline void project_vert_batch(SL_PTVBatch& batch, const math::vec4& viewportDims) noexcept
+{
+    const uint32_t numVerts = batch.mNumVerts;
+
+    #if defined(LS_X86_SSE2)
+        const __m128 halfW = _mm_set1_ps(viewportDims[2] * 0.5f);
+        const __m128 halfH = _mm_set1_ps(viewportDims[3] * 0.5f);
+        const __m128 offX  = _mm_set1_ps(viewportDims[0]);
+        const __m128 offY  = _mm_set1_ps(viewportDims[1]);
+        const __m128 one   = _mm_set1_ps(1.f);
+        const __m128 zero  = _mm_setzero_ps();
+        const __m128 sign  = _mm_set1_ps(-0.f);
+
+        // Batch storage is a multiple of 4 vertices so reading past the
+        // last vertex is safe.
+        for (uint32_t v = 0; v < numVerts; v += 4)
+        {
+            __m128 x = batch.mVerts[v+0].vert.simd;
+            __m128 y = batch.mVerts[v+1].vert.simd;
+            __m128 z = batch.mVerts[v+2].vert.simd;
+            __m128 w = batch.mVerts[v+3].vert.simd;
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            const __m128 wn     = _mm_or_ps(w, sign);
+            const __m128 inX    = _mm_and_ps(_mm_cmple_ps(wn, x), _mm_cmpge_ps(w, x));
+            const __m128 inY    = _mm_and_ps(_mm_cmple_ps(wn, y), _mm_cmpge_ps(w, y));
+            const __m128 inZ    = _mm_and_ps(_mm_cmple_ps(wn, z), _mm_cmpge_ps(w, z));
+            const int    inside = _mm_movemask_ps(_mm_and_ps(_mm_and_ps(inX, inY), inZ));
+            const int    front  = _mm_movemask_ps(_mm_cmpgt_ps(w, zero));
+
+            batch.mClipFlags[v+0] = (uint8_t)(((inside << 1) & 0x02) | ((front >> 0) & 0x01));
+            batch.mClipFlags[v+1] = (uint8_t)(((inside >> 0) & 0x02) | ((front >> 1) & 0x01));
+            batch.mClipFlags[v+2] = (uint8_t)(((inside >> 1) & 0x02) | ((front >> 2) & 0x01));
+            batch.mClipFlags[v+3] = (uint8_t)(((inside >> 2) & 0x02) | ((front >> 3) & 0x01));
+
+            // perspective divide, followed by the NDC->screen transform. Both
+            // use the same operations as sl_perspective_divide() and
+            // sl_ndc_to_screen_coords() so batched vertices land on the same
+            // pixels as vertices transformed one at a time.
+            #if defined(LS_X86_SSSE3)
+                const __m128 wInv = _mm_rcp_ps(w);
+            #else
+                const __m128 wInv = _mm_div_ps(one, w);
+            #endif
+
+            x = _mm_add_ps(_mm_mul_ps(x, wInv), one);
+            y = _mm_add_ps(_mm_mul_ps(y, wInv), one);
+
+            #if defined(LS_X86_FMA)
+                x = _mm_floor_ps(_mm_fmadd_ps(x, halfW, offX));
+                y = _mm_floor_ps(_mm_fmadd_ps(y, halfH, offY));
+            #else
+                x = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(x, halfW), offX)));
+                y = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(y, halfH), offY)));
+            #endif
+
+            x = _mm_max_ps(x, zero);
+            y = _mm_max_ps(y, zero);
+            z = _mm_mul_ps(z, wInv);
+            w = wInv;
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            batch.mScreenVerts[v+0].simd = x;
+            batch.mScreenVerts[v+1].simd = y;
+            batch.mScreenVerts[v+2].simd = z;
+            batch.mScreenVerts[v+3].simd = w;
+        }
+
+    #else
+        const float halfW = viewportDims[2] * 0.5f;
+        const float halfH = viewportDims[3] * 0.5f;
+
+        for (uint32_t v = 0; v < numVerts; ++v)
+        {
+            const math::vec4& p  = batch.mVerts[v].vert;
+            const float       w  = p[3];
+            const float       wn = (w < 0.f) ? w : -w;
+            const bool inside = (p[0] >= wn && p[0] <= w) && (p[1] >= wn && p[1] <= w) && (p[2] >= wn && p[2] <= w);
+
+            batch.mClipFlags[v] = (uint8_t)((inside ? 0x02 : 0x00) | (w > 0.f ? 0x01 : 0x00));
+
+            const float wInv = math::rcp(w);
+            batch.mScreenVerts[v] = math::vec4{
+                math::max(math::floor(math::fmadd(p[0]*wInv+1.f, halfW, viewportDims[0])), 0.f),
+                math::max(math::floor(math::fmadd(p[1]*wInv+1.f, halfH, viewportDims[1])), 0.f),
+                p[2] * wInv,
+                wInv
+            };
+        }
+    #endif
+}
+
+
+
 } // end anonymous namespace
 
 
@@ -277,8 +375,10 @@ void SL_TriProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a, co
             math::vec4{0.f}
         });
 
-        // A 2D cross product is simply the determinant of a 2x2 matrix
-        const float denom = math::rcp(math::cross(zy, xy));
+        // A 2D cross product is simply the determinant of a 2x2 matrix. Its
+        // magnitude is also twice the triangle's area.
+        const float area2 = math::cross(zy, xy);
+        const float denom = math::rcp(area2);
         //const float denom = math::rcp(math::determinant(math::mat2{zy, xy}));
 
         // cross-products
@@ -289,11 +389,18 @@ void SL_TriProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a, co
         // Check if the output bin is full
         uint_fast64_t binId;
 
+        // Join any flush another thread started early, otherwise it would
+        // stall until the remaining bins fill up.
+        if (LS_UNLIKELY(mMaxBinnedArea > 0.f && active_frag_processors().count.load(std::memory_order_relaxed) > 0))
+        {
+            flush_rasterizer<SL_TriRasterizer>();
+        }
+
         // Attempt to grab a bin index. Flush the bins if they've filled up.
         do
         {
             binId = active_num_bins_used().count.fetch_add(1, std::memory_order_acq_rel);
-            if (LS_LIKELY(binId < SL_SHADER_MAX_BINNED_PRIMS))
+            if (LS_LIKELY(binId < mMaxBins))
             {
                 break;
             }
@@ -303,8 +410,7 @@ void SL_TriProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a, co
         while (true);
 
         // place a triangle into the next available bin
-        SL_FragmentBin* const pFragBins = active_frag_bins();
-        SL_FragmentBin& bin = pFragBins[binId];
+        SL_FragmentBin& bin = active_frag_bin(binId);
         bin.mScreenCoords[0] = p0;
         bin.mScreenCoords[1] = p1;
         bin.mScreenCoords[2] = p2;
@@ -317,28 +423,33 @@ void SL_TriProcessor::push_bin(size_t primIndex, const SL_TransformedVert& a, co
     switch (numVaryings)
     {
         case 4:
-            bin.mVaryings[3+SL_SHADER_MAX_VARYING_VECTORS*0] = a.varyings[3];
-            bin.mVaryings[3+SL_SHADER_MAX_VARYING_VECTORS*1] = b.varyings[3];
-            bin.mVaryings[3+SL_SHADER_MAX_VARYING_VECTORS*2] = c.varyings[3];
+            bin.mVaryings[3+numVaryings*0] = a.varyings[3];
+            bin.mVaryings[3+numVaryings*1] = b.varyings[3];
+            bin.mVaryings[3+numVaryings*2] = c.varyings[3];
 
         case 3:
-            bin.mVaryings[2+SL_SHADER_MAX_VARYING_VECTORS*0] = a.varyings[2];
-            bin.mVaryings[2+SL_SHADER_MAX_VARYING_VECTORS*1] = b.varyings[2];
-            bin.mVaryings[2+SL_SHADER_MAX_VARYING_VECTORS*2] = c.varyings[2];
+            bin.mVaryings[2+numVaryings*0] = a.varyings[2];
+            bin.mVaryings[2+numVaryings*1] = b.varyings[2];
+            bin.mVaryings[2+numVaryings*2] = c.varyings[2];
 
         case 2:
-            bin.mVaryings[1+SL_SHADER_MAX_VARYING_VECTORS*0] = a.varyings[1];
-            bin.mVaryings[1+SL_SHADER_MAX_VARYING_VECTORS*1] = b.varyings[1];
-            bin.mVaryings[1+SL_SHADER_MAX_VARYING_VECTORS*2] = c.varyings[1];
+            bin.mVaryings[1+numVaryings*0] = a.varyings[1];
+            bin.mVaryings[1+numVaryings*1] = b.varyings[1];
+            bin.mVaryings[1+numVaryings*2] = c.varyings[1];
 
         case 1:
-            bin.mVaryings[0+SL_SHADER_MAX_VARYING_VECTORS*0] = a.varyings[0];
-            bin.mVaryings[0+SL_SHADER_MAX_VARYING_VECTORS*1] = b.varyings[0];
-            bin.mVaryings[0+SL_SHADER_MAX_VARYING_VECTORS*2] = c.varyings[0];
+            bin.mVaryings[0+numVaryings*0] = a.varyings[0];
+            bin.mVaryings[0+numVaryings*1] = b.varyings[0];
+            bin.mVaryings[0+numVaryings*2] = c.varyings[0];
     }
 
     bin.primIndex = primIndex;
-    active_bin_index(binId).count = binId;
+    active_bin_index(binId) = (uint32_t)binId;
+
+    if (mMaxBinnedArea > 0.f)
+    {
+        flush_on_coverage<SL_TriRasterizer>(math::abs(area2) * 0.5f);
+    }
 }
 
 
@@ -527,6 +638,8 @@ template <bool usingIndices>
 void SL_TriProcessor::process_verts(
     const SL_Mesh& m,
     size_t instanceId,
+    size_t begin,
+    size_t end,
     const ls::math::mat4_t<float>& scissorMat,
     const ls::math::vec4_t<float>& viewportDims) noexcept
 {
@@ -547,28 +660,18 @@ void SL_TriProcessor::process_verts(
     const size_t numElements = m.elementEnd - m.elementBegin;
     const size_t primOffset = numElements * instanceId;
 
-    #if SL_VERTEX_CACHING_ENABLED
-        size_t begin;
-        size_t end;
-        constexpr size_t step = 3;
-
-        sl_calc_indexed_parition<3, true>(numElements, mNumThreads, mThreadId, begin, end);
-        begin += m.elementBegin;
-        end += m.elementBegin;
+    constexpr size_t step = 3;
 
+    #if SL_VERTEX_CACHING_ENABLED
         SL_PTVCache ptvCache{};
+        uint_fast64_t numVertsShaded = 0;
         const auto&& vertTransform = [&](size_t key, SL_TransformedVert& tv) noexcept -> void
         {
             params.vertId = key;
             params.pVaryings = tv.varyings;
             tv.vert = scissorMat * vertShader(params);
+            ++numVertsShaded;
         };
-
-    #else
-        //const size_t begin = m.elementBegin + mThreadId * 3u;
-        const size_t begin = m.elementBegin + ((instanceId + mThreadId) % mNumThreads) * 3u;
-        const size_t end   = m.elementEnd;
-        const size_t step  = mNumThreads * 3u;
     #endif
 
     for (size_t i = begin; i < end; i += step)
@@ -637,6 +740,16 @@ void SL_TriProcessor::process_verts(
             }
         #endif
     }
+
+    // Vertices referenced by this thread
+    const uint_fast64_t numVertsReferenced = (begin < end) ? ((end - begin + step - 1u) / step) * 3u : 0u;
+
+    #if !SL_VERTEX_CACHING_ENABLED
+        const uint_fast64_t numVertsShaded = numVertsReferenced;
+    #endif
+
+    mNumVertsReferenced += numVertsReferenced;
+    mNumVertsShaded += numVertsShaded;
 }
 
 
@@ -644,6 +757,8 @@ void SL_TriProcessor::process_verts(
 template void SL_TriProcessor::process_verts<true>(
     const SL_Mesh&,
     size_t,
+    size_t,
+    size_t,
     const ls::math::mat4_t<float>&,
     const ls::math::vec4_t<float>&
 ) noexcept;
@@ -653,6 +768,198 @@ template void SL_TriProcessor::process_verts<true>(
 template void SL_TriProcessor::process_verts<false>(
     const SL_Mesh&,
     size_t,
+    size_t,
+    size_t,
+    const ls::math::mat4_t<float>&,
+    const ls::math::vec4_t<float>&
+) noexcept;
+
+
+
+/*--------------------------------------
+ * Process triangles in batches, transforming each unique vertex once
+--------------------------------------*/
+template <bool usingIndices>
+void SL_TriProcessor::process_vert_batches(
+    const SL_Mesh& m,
+    size_t instanceId,
+    size_t begin,
+    size_t end,
+    const ls::math::mat4_t<float>& scissorMat,
+    const ls::math::vec4_t<float>& viewportDims) noexcept
+{
+    constexpr size_t      indicesPerBatch = SL_VERTEX_BATCH_SIZE * 3u;
+    constexpr uint32_t    numLanes        = SL_SHADER_VERT_BATCH_SIZE;
+    const auto            vertShader      = mShader->pVertShader;
+    const auto            batchShader     = mShader->pVertBatchShader;
+    const uint32_t        numVaryings     = (uint32_t)mShader->pipelineState.num_varyings();
+    const SL_CullMode     cullMode        = mShader->pipelineState.cull_mode();
+    const SL_VertexArray& vao             = mContext->vao(m.vaoId);
+    const SL_IndexBuffer* pIbo            = usingIndices ? &mContext->ibo(vao.get_index_buffer()) : nullptr;
+
+    SL_VertexParam params;
+    params.pUniforms  = mShader->pUniforms;
+    params.instanceId = instanceId;
+    params.pVao       = &vao;
+    params.pVbo       = &mContext->vbo(vao.get_vertex_buffer());
+
+    SL_VertexBatchParam batchParams;
+    batchParams.pUniforms  = mShader->pUniforms;
+    batchParams.instanceId = instanceId;
+    batchParams.pVao       = &vao;
+    batchParams.pVbo       = params.pVbo;
+
+    const size_t numElements = m.elementEnd - m.elementBegin;
+    const size_t primOffset  = numElements * instanceId;
+
+    SL_PTVBatch        batch;
+    SL_TransformedVert pVert0;
+    SL_TransformedVert pVert1;
+    SL_TransformedVert pVert2;
+    uint_fast64_t      numVertsReferenced = 0;
+    uint_fast64_t      numVertsShaded     = 0;
+
+    for (size_t batchBegin = begin; batchBegin < end; batchBegin += indicesPerBatch)
+    {
+        const size_t batchEnd = math::min(batchBegin + indicesPerBatch, end);
+
+        // Gather all unique vertices referenced by the current batch
+        if (usingIndices)
+        {
+            batch.reset();
+
+            for (size_t i = batchBegin, t = 0; i < batchEnd; i += 3, t += 3)
+            {
+                const math::vec4_t<size_t>&& vertId = get_next_vertex3(pIbo, i);
+                batch.mTriSlots[t+0] = batch.insert((uint32_t)vertId.v[0]);
+                batch.mTriSlots[t+1] = batch.insert((uint32_t)vertId.v[1]);
+                batch.mTriSlots[t+2] = batch.insert((uint32_t)vertId.v[2]);
+            }
+        }
+        else
+        {
+            batch.mNumVerts = (uint32_t)(batchEnd - batchBegin);
+
+            for (uint32_t v = 0; v < batch.mNumVerts; ++v)
+            {
+                batch.mVertIds[v]  = (uint32_t)(batchBegin + v);
+                batch.mTriSlots[v] = (uint16_t)v;
+            }
+        }
+
+        if (batchShader)
+        {
+            for (uint32_t v = 0; v < batch.mNumVerts; v += numLanes)
+            {
+                const uint32_t numBatchVerts = math::min(numLanes, batch.mNumVerts - v);
+
+                for (uint32_t l = 0; l < numLanes; ++l)
+                {
+                    batchParams.vertId[l] = batch.mVertIds[v + math::min(l, numBatchVerts-1u)];
+                }
+
+                batchParams.laneMask = (1u << numBatchVerts) - 1u;
+                batchShader(batchParams);
+
+                // Return to AoS form for clipping & binning
+                for (uint32_t l = 0; l < numBatchVerts; ++l)
+                {
+                    SL_TransformedVert& tv = batch.mVerts[v+l];
+                    const math::vec4 p{batchParams.position[0][l], batchParams.position[1][l], batchParams.position[2][l], batchParams.position[3][l]};
+                    tv.vert = scissorMat * p;
+
+                    for (uint32_t k = 0; k < numVaryings; ++k)
+                    {
+                        tv.varyings[k] = math::vec4{batchParams.pVaryings[k][0][l], batchParams.pVaryings[k][1][l], batchParams.pVaryings[k][2][l], batchParams.pVaryings[k][3][l]};
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (uint32_t v = 0; v < batch.mNumVerts; ++v)
+            {
+                SL_TransformedVert& tv = batch.mVerts[v];
+                params.vertId    = batch.mVertIds[v];
+                params.pVaryings = tv.varyings;
+                tv.vert          = scissorMat * vertShader(params);
+            }
+        }
+
+        project_vert_batch(batch, viewportDims);
+
+        numVertsReferenced += batchEnd - batchBegin;
+        numVertsShaded     += batch.mNumVerts;
+
+        // Assemble triangles from the transformed vertices
+        for (size_t i = batchBegin, t = 0; i < batchEnd; i += 3, t += 3)
+        {
+            const uint_fast32_t s0 = batch.mTriSlots[t+0];
+            const uint_fast32_t s1 = batch.mTriSlots[t+1];
+            const uint_fast32_t s2 = batch.mTriSlots[t+2];
+            const SL_TransformedVert& v0 = batch.mVerts[s0];
+            const SL_TransformedVert& v1 = batch.mVerts[s1];
+            const SL_TransformedVert& v2 = batch.mVerts[s2];
+
+            if (LS_LIKELY(cullMode != SL_CULL_OFF))
+            {
+                const float det = face_determinant(v0.vert, v1.vert, v2.vert);
+                const bool culled = (cullMode == SL_CULL_FRONT_FACE) ^ math::sign_mask(det);
+                if (culled)
+                {
+                    continue;
+                }
+            }
+
+            // Clip-space culling, using the visibility of each vertex
+            const uint_fast32_t f0 = batch.mClipFlags[s0];
+            const uint_fast32_t f1 = batch.mClipFlags[s1];
+            const uint_fast32_t f2 = batch.mClipFlags[s2];
+            const uint_fast32_t visible = f0 & f1 & f2 & 0x02u;
+            const SL_ClipStatus visStatus = (SL_ClipStatus)(visible | (visible >> 1u) | ((f0 | f1 | f2) & 0x01u));
+
+            if (visStatus == SL_CLIP_STATUS_FULLY_VISIBLE)
+            {
+                // Vertices may be shared with other triangles in the batch.
+                // Copy them before modifying.
+                pVert0      = v0;
+                pVert1      = v1;
+                pVert2      = v2;
+                pVert0.vert = batch.mScreenVerts[s0];
+                pVert1.vert = batch.mScreenVerts[s1];
+                pVert2.vert = batch.mScreenVerts[s2];
+
+                push_bin(primOffset+i, pVert0, pVert1, pVert2);
+            }
+            else if (visStatus == SL_CLIP_STATUS_PARTIALLY_VISIBLE)
+            {
+                clip_and_process_tris(primOffset+i, viewportDims, v0, v1, v2);
+            }
+        }
+    }
+
+    mNumVertsReferenced += numVertsReferenced;
+    mNumVertsShaded += numVertsShaded;
+}
+
+
+
+template void SL_TriProcessor::process_vert_batches<true>(
+    const SL_Mesh&,
+    size_t,
+    size_t,
+    size_t,
+    const ls::math::mat4_t<float>&,
+    const ls::math::vec4_t<float>&
+) noexcept;
+
+
+
+template void SL_TriProcessor::process_vert_batches<false>(
+    const SL_Mesh&,
+    size_t,
+    size_t,
+    size_t,
     const ls::math::mat4_t<float>&,
     const ls::math::vec4_t<float>&
 ) noexcept;
@@ -674,43 +981,51 @@ void SL_TriProcessor::execute() noexcept
     const math::mat4&&      scissorMat   = viewState.scissor_matrix(fboDims[2], fboDims[3]);
     const math::vec4&&      viewportDims = viewState.viewport_rect(fboDims[2], fboDims[3]);
 
-    if (mNumInstances == 1)
+    // Indexed meshes are batched to share vertex transformations. Batching
+    // non-indexed meshes only helps when vertices can be shaded with SIMD.
+    const bool batchIndices  = SL_VERTEX_REUSE_ENABLED || (mShader->pVertBatchShader != nullptr);
+    const bool batchVertices = mShader->pVertBatchShader != nullptr;
+
+    constexpr size_t indicesPerBatch = SL_VERTEX_BATCH_SIZE * 3u;
+    size_t           meshId;
+    size_t           instanceId;
+    size_t           begin;
+    size_t           end;
+
+    mNumVertsReferenced = 0;
+    mNumVertsShaded     = 0;
+
+    while (next_vertex_batch(indicesPerBatch, meshId, instanceId, begin, end))
     {
-        for (size_t i = 0; i < mNumMeshes; ++i)
-        {
-            const SL_Mesh& m = mMeshes[i];
-            const bool usingIndices = (m.mode == RENDER_MODE_INDEXED_TRIANGLES) || (m.mode == RENDER_MODE_INDEXED_TRI_WIRE);
+        const SL_Mesh& m            = mMeshes[meshId];
+        const bool     usingIndices = (m.mode == RENDER_MODE_INDEXED_TRIANGLES) || (m.mode == RENDER_MODE_INDEXED_TRI_WIRE);
 
-            if (usingIndices)
+        if (usingIndices)
+        {
+            if (batchIndices)
             {
-                process_verts<true>(m, 0, scissorMat, viewportDims);
+                process_vert_batches<true>(m, instanceId, begin, end, scissorMat, viewportDims);
             }
             else
             {
-                process_verts<false>(m, 0, scissorMat, viewportDims);
+                process_verts<true>(m, instanceId, begin, end, scissorMat, viewportDims);
             }
         }
-    }
-    else
-    {
-        const SL_Mesh& m = mMeshes[0];
-        const bool usingIndices = (m.mode == RENDER_MODE_INDEXED_TRIANGLES) || (m.mode == RENDER_MODE_INDEXED_TRI_WIRE);
-
-        if (usingIndices)
+        else
         {
-            for (size_t i = 0; i < mNumInstances; ++i)
+            if (batchVertices)
             {
-                process_verts<true>(m, i, scissorMat, viewportDims);
+                process_vert_batches<false>(m, instanceId, begin, end, scissorMat, viewportDims);
             }
-        }
-        else
-        {
-            for (size_t i = 0; i < mNumInstances; ++i)
+            else
             {
-                process_verts<false>(m, i, scissorMat, viewportDims);
+                process_verts<false>(m, instanceId, begin, end, scissorMat, viewportDims);
             }
         }
     }
 
+    mVertexStats->mNumVertsReferenced.count.fetch_add(mNumVertsReferenced, std::memory_order_relaxed);
+    mVertexStats->mNumVertsShaded.count.fetch_add(mNumVertsShaded, std::memory_order_relaxed);
+
     this->cleanup<SL_TriRasterizer>();
 }
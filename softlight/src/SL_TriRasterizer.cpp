@@ -1,4 +1,7 @@
 
+#include <algorithm> // std::fill_n
+#include <type_traits> // std::is_same
+
 #include "lightsky/setup/Api.h" // LS_IMPERATIVE
 
 #include "lightsky/utils/Assertions.h" // LS_DEBUG_ASSERT
@@ -12,6 +15,7 @@
 #include "softlight/SL_Shader.hpp" // SL_FragmentShader
 #include "softlight/SL_ShaderProcessor.hpp" // SL_FragmentBin
 #include "softlight/SL_ShaderUtil.hpp" // sl_scanline_offset()
+#include "softlight/SL_TaskQueue.hpp" // sl_acquire_task()
 #include "softlight/SL_Texture.hpp"
 #include "softlight/SL_TriRasterizer.hpp"
 #include "softlight/SL_ViewportState.hpp"
@@ -103,10 +107,279 @@ inline LS_INLINE math::vec4 _sl_get_depth_texel4(const depth_type* LS_RESTRICT_P
 
 
 
+/*--------------------------------------
+ * Convert and store up to 4 depth texels, one for each bit set in "mask"
+--------------------------------------*/
+template <typename depth_type>
+inline LS_INLINE void _sl_set_depth_texel4(depth_type* LS_RESTRICT_PTR pDepth, const math::vec4& z, unsigned mask)
+{
+    if (mask & 0x01u) pDepth[0] = (depth_type)z[0];
+    if (mask & 0x02u) pDepth[1] = (depth_type)z[1];
+    if (mask & 0x04u) pDepth[2] = (depth_type)z[2];
+    if (mask & 0x08u) pDepth[3] = (depth_type)z[3];
+}
+
+#if defined(LS_X86_AVX)
+template <>
+inline LS_INLINE void _sl_set_depth_texel4<float>(float* LS_RESTRICT_PTR pDepth, const math::vec4& z, unsigned mask)
+{
+    const __m128i bits  = _mm_set_epi32(0x08, 0x04, 0x02, 0x01);
+    const __m128i lanes = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32((int)mask), bits), bits);
+    _mm_maskstore_ps(pDepth, lanes, z.simd);
+}
+
+#endif
+
+
+
+#if SL_HIZ_ENABLED
+
+/*--------------------------------------
+ * Shrink a tile's region to the 8x8 blocks of a depth hierarchy which a bin
+ * may pass a depth test against. Returns false if every block overlapped by
+ * the bin is rejected. All blocks which may be written to are marked in
+ * "outBlocks."
+--------------------------------------*/
+template <class DepthCmpFunc>
+inline bool _sl_hiz_test_region(
+    const SL_HiZBuffer& hiZ,
+    const SL_TileBin& tileBin,
+    const int32_t tx,
+    const int32_t ty,
+    math::vec4_t<int32_t>& region,
+    uint64_t& outBlocks) noexcept
+{
+    constexpr SL_HiZRejectFunc<DepthCmpFunc> rejectFunc;
+    constexpr int32_t blocksPerTile = SL_RASTER_TILE_SIZE >> SL_HIZ_BLOCK_SHIFT;
+
+    if (rejectFunc(tileBin.minZ, tileBin.maxZ, hiZ.tile((uint16_t)tx, (uint16_t)ty)))
+    {
+        return false;
+    }
+
+    const int32_t tileBX = tx * blocksPerTile;
+    const int32_t tileBY = ty * blocksPerTile;
+    const int32_t bx0    = math::max<int32_t>(tileBin.bx0, tileBX);
+    const int32_t by0    = math::max<int32_t>(tileBin.by0, tileBY);
+    const int32_t bx1    = math::min<int32_t>(tileBin.bx1, math::min<int32_t>(tileBX + blocksPerTile, hiZ.blocks_x()) - 1);
+    const int32_t by1    = math::min<int32_t>(tileBin.by1, math::min<int32_t>(tileBY + blocksPerTile, hiZ.blocks_y()) - 1);
+
+    int32_t minBX = bx1 + 1;
+    int32_t maxBX = bx0 - 1;
+    int32_t minBY = by1 + 1;
+    int32_t maxBY = by0 - 1;
+
+    for (int32_t by = by0; by <= by1; ++by)
+    {
+        for (int32_t bx = bx0; bx <= bx1; ++bx)
+        {
+            if (!rejectFunc(tileBin.minZ, tileBin.maxZ, hiZ.block((uint16_t)bx, (uint16_t)by)))
+            {
+                minBX = math::min(minBX, bx);
+                maxBX = math::max(maxBX, bx);
+                minBY = math::min(minBY, by);
+                maxBY = math::max(maxBY, by);
+            }
+        }
+    }
+
+    if (minBX > maxBX)
+    {
+        return false;
+    }
+
+    region[0] = math::max(region[0], minBX << SL_HIZ_BLOCK_SHIFT);
+    region[1] = math::min(region[1], (maxBX + 1) << SL_HIZ_BLOCK_SHIFT);
+    region[2] = math::max(region[2], minBY << SL_HIZ_BLOCK_SHIFT);
+    region[3] = math::min(region[3], (maxBY + 1) << SL_HIZ_BLOCK_SHIFT);
+
+    const uint64_t rowBlocks = ((1ull << (maxBX - minBX + 1)) - 1ull) << (minBX - tileBX);
+    for (int32_t by = minBY; by <= maxBY; ++by)
+    {
+        outBlocks |= rowBlocks << ((by - tileBY) * blocksPerTile);
+    }
+
+    return true;
+}
+
+#endif /* SL_HIZ_ENABLED */
+
+
+
+/*--------------------------------------
+ * Standard 2x & 4x sample locations, relative to a pixel's center, in
+ * 1/16th pixel increments.
+--------------------------------------*/
+constexpr float _SL_SAMPLE_LOCATIONS_X[3][4] = {
+    { 0.f,         0.f,        0.f,         0.f},
+    { 4.f/16.f,   -4.f/16.f,   0.f,         0.f},
+    {-2.f/16.f,    6.f/16.f,  -6.f/16.f,    2.f/16.f}
+};
+
+constexpr float _SL_SAMPLE_LOCATIONS_Y[3][4] = {
+    { 0.f,         0.f,        0.f,         0.f},
+    { 4.f/16.f,   -4.f/16.f,   0.f,         0.f},
+    {-6.f/16.f,   -2.f/16.f,   2.f/16.f,    6.f/16.f}
+};
+
+
+
+/*--------------------------------------
+ * Determine which samples are within a triangle, given the barycentric
+ * coordinates of up to 4 samples. Each set bit in the return value
+ * represents a covered sample.
+--------------------------------------*/
+inline LS_INLINE unsigned _sl_sample_coverage(const math::vec4& b0, const math::vec4& b1, const math::vec4& b2) noexcept
+{
+    #if defined(LS_X86_SSE)
+        const __m128 zero   = _mm_setzero_ps();
+        const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(b0.simd, zero), _mm_cmpge_ps(b1.simd, zero)), _mm_cmpge_ps(b2.simd, zero));
+        return (unsigned)_mm_movemask_ps(inside);
+
+    #elif defined(LS_ARM_NEON)
+        const int32_t     shifts[4] = {0, 1, 2, 3};
+        const float32x4_t zero      = vdupq_n_f32(0.f);
+        const uint32x4_t  inside    = vandq_u32(vandq_u32(vcgeq_f32(b0.simd, zero), vcgeq_f32(b1.simd, zero)), vcgeq_f32(b2.simd, zero));
+        const uint32x4_t  bits      = vshlq_u32(vshrq_n_u32(inside, 31), vld1q_s32(shifts));
+
+        #if defined(LS_ARCH_AARCH64)
+            return (unsigned)vaddvq_u32(bits);
+        #else
+            const uint32x2_t sums = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+            return (unsigned)vget_lane_u32(vpadd_u32(sums, sums), 0);
+        #endif
+
+    #else
+        unsigned mask = 0;
+        for (unsigned s = 0; s < 4; ++s)
+        {
+            mask |= (unsigned)(b0[s] >= 0.f && b1[s] >= 0.f && b2[s] >= 0.f) << s;
+        }
+        return mask;
+    #endif
+}
+
+
+
 } // end anonymous namespace
 
 
 
+/*-----------------------------------------------------------------------------
+ * Tile Binning
+-----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Group visible bins by the screen-space tiles they overlap
+-------------------------------------*/
+void sl_bin_raster_tiles(
+    SL_TileBinLists& tileLists,
+    const SL_FragmentBin* pBins,
+    size_t binStride,
+    const uint32_t* pBinIds,
+    uint32_t numBins,
+    const SL_TextureView& depthBuffer,
+    bool useMsaa) noexcept
+{
+    const int32_t fboW     = (int32_t)depthBuffer.width;
+    const int32_t fboH     = (int32_t)depthBuffer.height;
+    const int32_t tilesX   = sl_num_raster_tiles<int32_t>(fboW);
+    const int32_t numTiles = tilesX * sl_num_raster_tiles<int32_t>(fboH);
+
+    SL_TileBin* const tileBins    = tileLists.bins.get();
+    uint32_t* const   tileOffsets = tileLists.tileOffsets.get();
+    uint32_t          numTileBins = 0;
+
+    // Multisampled triangles are scanned one pixel beyond their bounds
+    const int32_t bboxMargin = useMsaa ? 1 : 0;
+
+    std::fill_n(tileOffsets, numTiles + 1, 0u);
+
+    // Bins remain in their sorted order so blending and early depth
+    // rejection behave identically to scanline-interleaved rasterization.
+    for (uint32_t i = 0; i < numBins; ++i)
+    {
+        const uint32_t    binId   = pBinIds[i];
+        const math::vec4* pPoints = sl_frag_bin(pBins, binStride, binId).mScreenCoords;
+
+        const int32_t bboxMinX = math::max((int32_t)math::min(pPoints[0][0], pPoints[1][0], pPoints[2][0]) - bboxMargin, 0);
+        const int32_t bboxMinY = math::max((int32_t)math::min(pPoints[0][1], pPoints[1][1], pPoints[2][1]) - bboxMargin, 0);
+        const int32_t bboxMaxX = math::min((int32_t)math::max(pPoints[0][0], pPoints[1][0], pPoints[2][0]) + 1, fboW-1);
+        const int32_t bboxMaxY = math::min((int32_t)math::max(pPoints[0][1], pPoints[1][1], pPoints[2][1]) + 1, fboH-1);
+
+        if (LS_UNLIKELY(bboxMinX > bboxMaxX || bboxMinY > bboxMaxY))
+        {
+            continue;
+        }
+
+        const int32_t tx0 = bboxMinX >> SL_RASTER_TILE_SHIFT;
+        const int32_t ty0 = bboxMinY >> SL_RASTER_TILE_SHIFT;
+        const int32_t tx1 = bboxMaxX >> SL_RASTER_TILE_SHIFT;
+        const int32_t ty1 = bboxMaxY >> SL_RASTER_TILE_SHIFT;
+
+        #if SL_HIZ_ENABLED
+            tileBins[numTileBins++] = SL_TileBin{
+                binId,
+                (uint16_t)tx0, (uint16_t)tx1, (uint16_t)ty0, (uint16_t)ty1,
+                (uint16_t)(bboxMinX >> SL_HIZ_BLOCK_SHIFT), (uint16_t)(bboxMaxX >> SL_HIZ_BLOCK_SHIFT),
+                (uint16_t)(bboxMinY >> SL_HIZ_BLOCK_SHIFT), (uint16_t)(bboxMaxY >> SL_HIZ_BLOCK_SHIFT),
+                math::min(pPoints[0][2], pPoints[1][2], pPoints[2][2]),
+                math::max(pPoints[0][2], pPoints[1][2], pPoints[2][2])
+            };
+        #else
+            tileBins[numTileBins++] = SL_TileBin{binId, (uint16_t)tx0, (uint16_t)tx1, (uint16_t)ty0, (uint16_t)ty1};
+        #endif
+
+        // Count the bins overlapping each tile, offset by one for the
+        // prefix sum below.
+        for (int32_t ty = ty0; ty <= ty1; ++ty)
+        {
+            for (int32_t tx = tx0; tx <= tx1; ++tx)
+            {
+                ++tileOffsets[ty * tilesX + tx + 1];
+            }
+        }
+    }
+
+    for (int32_t t = 0; t < numTiles; ++t)
+    {
+        tileOffsets[t+1] += tileOffsets[t];
+    }
+
+    const uint32_t numBinIds = tileOffsets[numTiles];
+    if (tileLists.maxBinIds < numBinIds)
+    {
+        const uint32_t maxBinIds = numBinIds + (numBinIds >> 1u);
+        tileLists.binIds = utils::make_unique_aligned_array<uint32_t>(maxBinIds);
+        tileLists.maxBinIds = maxBinIds;
+    }
+
+    // Scatter bins into their tiles. Each tile's offset is advanced to the
+    // start of the next tile, then restored afterwards.
+    uint32_t* const binIds = tileLists.binIds.get();
+
+    for (uint32_t i = 0; i < numTileBins; ++i)
+    {
+        const SL_TileBin& tileBin = tileBins[i];
+
+        for (int32_t ty = tileBin.y0; ty <= tileBin.y1; ++ty)
+        {
+            for (int32_t tx = tileBin.x0; tx <= tileBin.x1; ++tx)
+            {
+                binIds[tileOffsets[ty * tilesX + tx]++] = i;
+            }
+        }
+    }
+
+    for (int32_t t = numTiles; t > 0; --t)
+    {
+        tileOffsets[t] = tileOffsets[t-1];
+    }
+
+    tileOffsets[0] = 0;
+}
+
+
+
 /*-----------------------------------------------------------------------------
  * SL_TriRasterizer Class
 -----------------------------------------------------------------------------*/
@@ -117,7 +390,7 @@ template <class DepthCmpFunc, typename depth_type>
 void SL_TriRasterizer::render_wireframe(const SL_TextureView& depthBuffer) const noexcept
 {
     constexpr DepthCmpFunc depthCmpFunc;
-    const SL_BinCounter<uint32_t>* pBinIds = mBinIds;
+    const uint32_t* pBinIds = mBinIds;
     const SL_FragmentBin* pBins = mBins;
     const uint32_t numBins = (uint32_t)mNumBins;
 
@@ -128,8 +401,8 @@ void SL_TriRasterizer::render_wireframe(const SL_TextureView& depthBuffer) const
 
     for (uint32_t i = 0; i < numBins; ++i)
     {
-        const uint32_t binId = pBinIds[i].count;
-        const SL_FragmentBin& bin = pBins[binId];
+        const uint32_t binId = pBinIds[i];
+        const SL_FragmentBin& bin = sl_frag_bin(pBins, mBinStride, binId);
 
         uint32_t          numQueuedFrags = 0;
         const math::vec4* pPoints        = bin.mScreenCoords;
@@ -233,139 +506,6 @@ void SL_TriRasterizer::render_wireframe(const SL_TextureView& depthBuffer) const
 
 
 
-/*--------------------------------------
- * Triangle Rasterization, scalar
---------------------------------------*/
-template <class DepthCmpFunc, typename depth_type>
-void SL_TriRasterizer::render_triangle(const SL_TextureView& depthBuffer) const noexcept
-{
-    constexpr DepthCmpFunc depthCmpFunc;
-    const SL_BinCounter<uint32_t>* pBinIds = mBinIds;
-    const SL_FragmentBin* pBins = mBins;
-    const uint32_t numBins = (uint32_t)mNumBins;
-
-    SL_FragCoord*         outCoords    = mQueues;
-    const int32_t         yOffset      = (int32_t)mThreadId;
-    const int32_t         increment    = (int32_t)mNumProcessors;
-    SL_ScanlineBounds     scanline;
-
-    for (uint32_t i = 0; i < numBins; ++i)
-    {
-        const uint32_t binId = pBinIds[i].count;
-        const SL_FragmentBin& bin = pBins[binId];
-
-        uint32_t          numQueuedFrags = 0;
-        const math::vec4* pPoints        = bin.mScreenCoords;
-        const int32_t     bboxMinY       = (int32_t)math::min(pPoints[0][1], pPoints[1][1], pPoints[2][1]);
-        const int32_t     bboxMaxY       = (int32_t)math::max(pPoints[0][1], pPoints[1][1], pPoints[2][1]);
-        const int32_t     scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
-
-        int32_t y = bboxMinY + scanLineOffset;
-        if (y >= bboxMaxY)
-        {
-            continue;
-        }
-
-        const math::vec4 depth{pPoints[0][2], pPoints[1][2], pPoints[2][2], 0.f};
-
-        scanline.init(pPoints[0], pPoints[1], pPoints[2]);
-
-        const math::vec4* bcClipSpace = bin.mBarycentricCoords;
-
-        do
-        {
-            // calculate the bounds of the current scan-line
-            const float yf = (float)y;
-
-            // In this rasterizer, we're only rendering the absolute pixels
-            // contained within the triangle edges. However this will serve as
-            // a guard against any pixels we don't want to render.
-            int32_t x;
-            int32_t xMax;
-            scanline.step(yf, x, xMax);
-
-            if (LS_UNLIKELY((uint32_t)x >= (uint32_t)xMax))
-            {
-                y += increment;
-                continue;
-            }
-
-            math::vec4&& xf{(float)x};
-            const math::vec4&& bcY = math::fmadd(bcClipSpace[1], math::vec4{yf}, bcClipSpace[2]);
-            math::vec4&& bcX = math::fmadd(bcClipSpace[0], xf, bcY);
-            const depth_type* pDepth = (depth_type*)depthBuffer.pTexels + (x + (int32_t)depthBuffer.width * y);
-
-            do
-            {
-                // calculate barycentric coordinates
-                const float d  = _sl_get_depth_texel<depth_type>(pDepth);
-                const float z  = math::dot(depth, bcX);
-                const int_fast32_t&& depthTest = depthCmpFunc(z, d);
-
-                if (LS_LIKELY(depthTest))
-                {
-                    outCoords->bc[numQueuedFrags]          = bcX;
-                    outCoords->coord[numQueuedFrags].x     = (uint16_t)x;
-                    outCoords->coord[numQueuedFrags].y     = (uint16_t)y;
-                    outCoords->coord[numQueuedFrags].depth = z;
-
-                    ++numQueuedFrags;
-
-                    if (LS_UNLIKELY(numQueuedFrags == SL_SHADER_MAX_QUEUED_FRAGS))
-                    {
-                        numQueuedFrags = 0;
-                        flush_tri_fragments<depth_type>(bin, SL_SHADER_MAX_QUEUED_FRAGS, outCoords);
-                    }
-                }
-
-                bcX += bcClipSpace[0];
-                ++x;
-                ++pDepth;
-            } while (LS_UNLIKELY(x < xMax));
-
-            y += increment;
-        } while (LS_UNLIKELY(y < bboxMaxY));
-
-        // cleanup remaining fragments
-        if (LS_LIKELY(numQueuedFrags > 0))
-        {
-            flush_tri_fragments<depth_type>(bin, numQueuedFrags, outCoords);
-        }
-    }
-}
-
-
-
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncLT, ls::math::half>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncLT, float>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncLT, double>(const SL_TextureView&) const noexcept;
-
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncLE, ls::math::half>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncLE, float>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncLE, double>(const SL_TextureView&) const noexcept;
-
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncGT, ls::math::half>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncGT, float>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncGT, double>(const SL_TextureView&) const noexcept;
-
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncGE, ls::math::half>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncGE, float>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncGE, double>(const SL_TextureView&) const noexcept;
-
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncEQ, ls::math::half>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncEQ, float>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncEQ, double>(const SL_TextureView&) const noexcept;
-
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncNE, ls::math::half>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncNE, float>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncNE, double>(const SL_TextureView&) const noexcept;
-
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncOFF, ls::math::half>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncOFF, float>(const SL_TextureView&) const noexcept;
- template void SL_TriRasterizer::render_triangle<SL_DepthFuncOFF, double>(const SL_TextureView&) const noexcept;
-
-
-
 /*-------------------------------------
  * Render a triangle using 4 elements at a time
 -------------------------------------*/
@@ -410,87 +550,94 @@ inline LS_INLINE void _sl_vec4_outer_ps(const __m128 v1, const __m128 v2, __m128
 
 
 template <class DepthCmpFunc, typename depth_type>
-void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& LS_RESTRICT_PTR depthBuffer) const noexcept
+void SL_TriRasterizer::render_triangle_region(
+    const SL_FragmentBin& bin,
+    const SL_TextureView& LS_RESTRICT_PTR depthBuffer,
+    const math::vec4_t<int32_t>& region,
+    const int32_t yOffset,
+    const int32_t increment) const noexcept
 {
-    constexpr DepthCmpFunc         depthCmpFunc;
-    const SL_BinCounter<uint32_t>* pBinIds = mBinIds;
-    const SL_FragmentBin* const    pBins   = mBins;
-    const uint32_t                 numBins = (uint32_t)mNumBins;
+    constexpr DepthCmpFunc depthCmpFunc;
+    SL_FragCoord*          outCoords = mQueues;
+    SL_ScanlineBounds      scanline;
+    const bool             depthOnly = mShader->pipelineState.num_render_targets() == SL_RENDER_TARGET_COUNT_0;
 
-    SL_FragCoord*     outCoords    = mQueues;
-    const int32_t     yOffset      = (int32_t)mThreadId;
-    const int32_t     increment    = (int32_t)mNumProcessors;
-    SL_ScanlineBounds scanline;
+    const __m128 points0 = _mm_load_ps(reinterpret_cast<const float*>(bin.mScreenCoords+0));
+    const __m128 points1 = _mm_load_ps(reinterpret_cast<const float*>(bin.mScreenCoords+1));
+    const __m128 points2 = _mm_load_ps(reinterpret_cast<const float*>(bin.mScreenCoords+2));
 
-    for (uint32_t i = 0; i < numBins; ++i)
+    const int32_t bboxMinY       = math::max(_mm_extract_epi32(_mm_cvtps_epi32(_mm_min_ps(_mm_min_ps(points0, points1), points2)), 1), region[2]);
+    const int32_t bboxMaxY       = math::min(_mm_extract_epi32(_mm_cvtps_epi32(_mm_max_ps(_mm_max_ps(points0, points1), points2)), 1), region[3]);
+    const int32_t scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
+
+    int32_t y = bboxMinY + scanLineOffset;
+    if (LS_UNLIKELY(y >= bboxMaxY))
     {
-        const uint32_t binId = pBinIds[i].count;
-        const SL_FragmentBin& bin = pBins[binId];
+        return;
+    }
+
+    const __m128i clipMinX = _mm_set1_epi32(region[0]);
+    const __m128i clipMaxX = _mm_set1_epi32(region[1]);
 
-        const __m128 points0 = _mm_load_ps(reinterpret_cast<const float*>(bin.mScreenCoords+0));
-        const __m128 points1 = _mm_load_ps(reinterpret_cast<const float*>(bin.mScreenCoords+1));
-        const __m128 points2 = _mm_load_ps(reinterpret_cast<const float*>(bin.mScreenCoords+2));
+    const __m128 d01   = _mm_unpackhi_ps(points0, points1);
+    const __m128 depth = _mm_insert_ps(d01, points2, 0xA8);
 
-        const int32_t bboxMinY       = _mm_extract_epi32(_mm_cvtps_epi32(_mm_min_ps(_mm_min_ps(points0, points1), points2)), 1);
-        const int32_t bboxMaxY       = _mm_extract_epi32(_mm_cvtps_epi32(_mm_max_ps(_mm_max_ps(points0, points1), points2)), 1);
-        const int32_t scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
+    scanline.init(math::vec4{points0}, math::vec4{points1}, math::vec4{points2});
 
-        int32_t y = bboxMinY + scanLineOffset;
-        if (LS_UNLIKELY(y >= bboxMaxY))
+    const __m128 bcClipSpace0   = _mm_load_ps(reinterpret_cast<const float*>(bin.mBarycentricCoords+0));
+    const __m128 bcClipSpace1   = _mm_load_ps(reinterpret_cast<const float*>(bin.mBarycentricCoords+1));
+    const __m128 bcClipSpace2   = _mm_load_ps(reinterpret_cast<const float*>(bin.mBarycentricCoords+2));
+    unsigned     numQueuedFrags = 0;
+
+    do
+    {
+        // In this rasterizer, we're only rendering the absolute pixels
+        // contained within the triangle edges. However this will serve as a
+        // guard against any pixels we don't want to render.
+        __m128i xMin;
+        __m128i xMax;
+        // calculate the bounds of the current scan-line
+        const __m128 yf = _mm_cvtepi32_ps(_mm_set1_epi32(y));
+        scanline.step(yf, xMin, xMax);
+        xMin = _mm_max_epi32(xMin, clipMinX);
+        xMax = _mm_min_epi32(xMax, clipMaxX);
+
+        if (LS_UNLIKELY(!_mm_test_all_ones(_mm_cmplt_epi32(xMin, xMax))))
         {
+            y += increment;
             continue;
         }
 
-        const __m128 d01   = _mm_unpackhi_ps(points0, points1);
-        const __m128 depth = _mm_insert_ps(d01, points2, 0xA8);
-
-        scanline.init(math::vec4{points0}, math::vec4{points1}, math::vec4{points2});
+        const int32_t     y16    = y << 16;
+        depth_type*       pDepth = (depth_type*)depthBuffer.pTexels + (_mm_cvtsi128_si32(xMin) + (int32_t)depthBuffer.width * y);
+        const __m128      bcY    = _mm_fmadd_ps(bcClipSpace1, yf, bcClipSpace2);
+        __m128i           x4     = _mm_add_epi32(_mm_set_epi32(3, 2, 1, 0), xMin);
 
-        const __m128 bcClipSpace0   = _mm_load_ps(reinterpret_cast<const float*>(bin.mBarycentricCoords+0));
-        const __m128 bcClipSpace1   = _mm_load_ps(reinterpret_cast<const float*>(bin.mBarycentricCoords+1));
-        const __m128 bcClipSpace2   = _mm_load_ps(reinterpret_cast<const float*>(bin.mBarycentricCoords+2));
-        unsigned     numQueuedFrags = 0;
+        __m128 bc[4];
+        _sl_vec4_outer_ps(_mm_cvtepi32_ps(x4), bcClipSpace0, bc);
+        bc[0] = _mm_add_ps(bc[0], bcY);
+        bc[1] = _mm_add_ps(bc[1], bcY);
+        bc[2] = _mm_add_ps(bc[2], bcY);
+        bc[3] = _mm_add_ps(bc[3], bcY);
+        const __m128 bcX = _mm_mul_ps(bcClipSpace0, _mm_set1_ps(4.f));
 
         do
         {
-            // In this rasterizer, we're only rendering the absolute pixels
-            // contained within the triangle edges. However this will serve as a
-            // guard against any pixels we don't want to render.
-            __m128i xMin;
-            __m128i xMax;
-            // calculate the bounds of the current scan-line
-            const __m128 yf = _mm_cvtepi32_ps(_mm_set1_epi32(y));
-            scanline.step(yf, xMin, xMax);
-
-            if (LS_UNLIKELY(!_mm_test_all_ones(_mm_cmplt_epi32(xMin, xMax))))
-            {
-                y += increment;
-                continue;
-            }
-
-            const int32_t     y16    = y << 16;
-            const depth_type* pDepth = (depth_type*)depthBuffer.pTexels + (_mm_cvtsi128_si32(xMin) + (int32_t)depthBuffer.width * y);
-            const __m128      bcY    = _mm_fmadd_ps(bcClipSpace1, yf, bcClipSpace2);
-            __m128i           x4     = _mm_add_epi32(_mm_set_epi32(3, 2, 1, 0), xMin);
-
-            __m128 bc[4];
-            _sl_vec4_outer_ps(_mm_cvtepi32_ps(x4), bcClipSpace0, bc);
-            bc[0] = _mm_add_ps(bc[0], bcY);
-            bc[1] = _mm_add_ps(bc[1], bcY);
-            bc[2] = _mm_add_ps(bc[2], bcY);
-            bc[3] = _mm_add_ps(bc[3], bcY);
-            const __m128 bcX = _mm_mul_ps(bcClipSpace0, _mm_set1_ps(4.f));
-
-            do
+            // calculate barycentric coordinates and perform a depth test
+            const __m128  xBound    = _mm_castsi128_ps(_mm_cmplt_epi32(x4, xMax));
+            const __m128  z         = _sl_mul_vec4_mat4_ps(depth, bc);
+            const __m128  d         = _sl_get_depth_texel4<depth_type>(pDepth).simd;
+            const __m128  depthTestV = _mm_and_ps(xBound, depthCmpFunc(z, d));
+            const int32_t depthTestI = _mm_movemask_ps(depthTestV);
+
+            if (LS_LIKELY(depthTestI))
             {
-                // calculate barycentric coordinates and perform a depth test
-                const __m128  xBound    = _mm_castsi128_ps(_mm_cmplt_epi32(x4, xMax));
-                const __m128  z         = _sl_mul_vec4_mat4_ps(depth, bc);
-                const __m128  d         = _sl_get_depth_texel4<depth_type>(pDepth).simd;
-                const __m128  depthTestV = _mm_and_ps(xBound, depthCmpFunc(z, d));
-                const int32_t depthTestI = _mm_movemask_ps(depthTestV);
-
-                if (LS_LIKELY(depthTestI))
+                if (depthOnly)
+                {
+                    // Shaders without outputs only need to update the depth buffer
+                    _sl_set_depth_texel4<depth_type>(pDepth, math::vec4{z}, (unsigned)depthTestI);
+                }
+                else
                 {
                     {
                         bc[2] = _mm_blendv_ps(bc[3], bc[2], _mm_permute_ps(depthTestV, 0xAA));
@@ -535,26 +682,26 @@ void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& LS_RESTRICT_PT
                         numQueuedFrags = 0;
                     }
                 }
+            }
 
-                bc[0] = _mm_add_ps(bc[0], bcX);
-                bc[1] = _mm_add_ps(bc[1], bcX);
-                bc[2] = _mm_add_ps(bc[2], bcX);
-                bc[3] = _mm_add_ps(bc[3], bcX);
-
-                x4 = _mm_add_epi32(x4, _mm_set1_epi32(4));
+            bc[0] = _mm_add_ps(bc[0], bcX);
+            bc[1] = _mm_add_ps(bc[1], bcX);
+            bc[2] = _mm_add_ps(bc[2], bcX);
+            bc[3] = _mm_add_ps(bc[3], bcX);
 
-                pDepth += 4;
-            }
-            while (_mm_movemask_epi8(_mm_cmplt_epi32(x4, xMax)));
+            x4 = _mm_add_epi32(x4, _mm_set1_epi32(4));
 
-            y += increment;
+            pDepth += 4;
         }
-        while (LS_UNLIKELY(y < bboxMaxY));
+        while (_mm_movemask_epi8(_mm_cmplt_epi32(x4, xMax)));
 
-        if (LS_LIKELY(0 < numQueuedFrags))
-        {
-            flush_tri_fragments<depth_type>(bin, numQueuedFrags, outCoords);
-        }
+        y += increment;
+    }
+    while (LS_UNLIKELY(y < bboxMaxY));
+
+    if (LS_LIKELY(0 < numQueuedFrags))
+    {
+        flush_tri_fragments<depth_type>(bin, numQueuedFrags, outCoords);
     }
 }
 
@@ -644,84 +791,91 @@ inline LS_INLINE void _sl_vec4_outer_ps(const float32x4_t& v1, const float32x4_t
 
 
 template <class DepthCmpFunc, typename depth_type>
-void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& depthBuffer) const noexcept
+void SL_TriRasterizer::render_triangle_region(
+    const SL_FragmentBin& bin,
+    const SL_TextureView& depthBuffer,
+    const math::vec4_t<int32_t>& region,
+    const int32_t yOffset,
+    const int32_t increment) const noexcept
 {
-    constexpr DepthCmpFunc         depthCmpFunc;
-    const SL_BinCounter<uint32_t>* pBinIds = mBinIds;
-    const SL_FragmentBin* const    pBins   = mBins;
-    const uint32_t                 numBins = (uint32_t)mNumBins;
-
-    SL_FragCoord*     outCoords    = mQueues;
-    const int32_t     yOffset      = (int32_t)mThreadId;
-    const int32_t     increment    = (int32_t)mNumProcessors;
-    SL_ScanlineBounds scanline;
-
-    for (uint32_t i = 0; i < numBins; ++i)
+    constexpr DepthCmpFunc depthCmpFunc;
+    SL_FragCoord*          outCoords      = mQueues;
+    SL_ScanlineBounds      scanline;
+    unsigned               numQueuedFrags = 0;
+    const bool             depthOnly      = mShader->pipelineState.num_render_targets() == SL_RENDER_TARGET_COUNT_0;
+
+    const float32x4x4_t points         = vld4q_f32(reinterpret_cast<const float*>(bin.mScreenCoords));
+    const int32x4_t     pointsY        = vcvtq_s32_f32(points.val[1]);
+    const int32_t       bboxMinY       = math::max(_sl_bbox_min_y(pointsY), region[2]);
+    const int32_t       bboxMaxY       = math::min(_sl_bbox_max_y(pointsY), region[3]);
+    const int32_t       scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
+
+    int32_t y = bboxMinY + scanLineOffset;
+    if (LS_UNLIKELY(y >= bboxMaxY))
     {
-        const uint32_t binId = pBinIds[i].count;
-        const SL_FragmentBin& bin = pBins[binId];
-        unsigned numQueuedFrags = 0;
-
-        const float32x4x4_t points         = vld4q_f32(reinterpret_cast<const float*>(bin.mScreenCoords));
-        const int32x4_t     pointsY        = vcvtq_s32_f32(points.val[1]);
-        const int32_t       bboxMinY       = _sl_bbox_min_y(pointsY);
-        const int32_t       bboxMaxY       = _sl_bbox_max_y(pointsY);
-        const int32_t       scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
-
-        int32_t y = bboxMinY + scanLineOffset;
-        if (LS_UNLIKELY(y >= bboxMaxY))
-        {
-            continue;
-        }
+        return;
+    }
 
-        const float32x4_t depth = vsetq_lane_f32(0.f, points.val[2], 3);
+    const int32x4_t clipMinX = vdupq_n_s32(region[0]);
+    const int32x4_t clipMaxX = vdupq_n_s32(region[1]);
 
-        scanline.init(points);
+    const float32x4_t depth = vsetq_lane_f32(0.f, points.val[2], 3);
 
-        const float32x4x3_t bcClipSpace = {
-            vld1q_f32(reinterpret_cast<const float*>(bin.mBarycentricCoords + 0)),
-            vld1q_f32(reinterpret_cast<const float*>(bin.mBarycentricCoords + 1)),
-            vld1q_f32(reinterpret_cast<const float*>(bin.mBarycentricCoords + 2))
-        };
+    scanline.init(points);
 
-        do
-        {
-            // calculate the bounds of the current scan-line
-            const float32x4_t yf = vdupq_n_f32((float)y);
+    const float32x4x3_t bcClipSpace = {
+        vld1q_f32(reinterpret_cast<const float*>(bin.mBarycentricCoords + 0)),
+        vld1q_f32(reinterpret_cast<const float*>(bin.mBarycentricCoords + 1)),
+        vld1q_f32(reinterpret_cast<const float*>(bin.mBarycentricCoords + 2))
+    };
 
-            // In this rasterizer, we're only rendering the absolute pixels
-            // contained within the triangle edges. However this will serve as a
-            // guard against any pixels we don't want to render.
-            int32x4_t xMin;
-            int32x4_t xMax;
-            scanline.step(yf, xMin, xMax);
+    do
+    {
+        // calculate the bounds of the current scan-line
+        const float32x4_t yf = vdupq_n_f32((float)y);
+
+        // In this rasterizer, we're only rendering the absolute pixels
+        // contained within the triangle edges. However this will serve as a
+        // guard against any pixels we don't want to render.
+        int32x4_t xMin;
+        int32x4_t xMax;
+        scanline.step(yf, xMin, xMax);
+        xMin = vmaxq_s32(xMin, clipMinX);
+        xMax = vminq_s32(xMax, clipMaxX);
+
+        if (LS_LIKELY(vgetq_lane_u32(vcltq_s32(xMin, xMax), 0)))
+        {
+            constexpr int32_t indices[4] = {0, 1, 2, 3};
+            depth_type*       pDepth = (depth_type*)depthBuffer.pTexels + (vgetq_lane_s32(xMin, 0) + (int32_t)depthBuffer.width * y);
+            const float32x4_t bcY    = vmlaq_f32(bcClipSpace.val[2], bcClipSpace.val[1], yf);
+            int32x4_t         x4     = vaddq_s32(vld1q_s32(indices), xMin);
+            const int32x4_t   xMax4  = xMax;
+            const float32x4_t bcX    = vmulq_f32(bcClipSpace.val[0], vdupq_n_f32(4.f));
+
+            float32x4x4_t bc;
+            _sl_vec4_outer_ps(vcvtq_f32_s32(x4), bcClipSpace.val[0], bc);
+            bc.val[0] = vaddq_f32(bc.val[0], bcY);
+            bc.val[1] = vaddq_f32(bc.val[1], bcY);
+            bc.val[2] = vaddq_f32(bc.val[2], bcY);
+            bc.val[3] = vaddq_f32(bc.val[3], bcY);
 
-            if (LS_LIKELY(vgetq_lane_u32(vcltq_s32(xMin, xMax), 0)))
+            do
             {
-                constexpr int32_t indices[4] = {0, 1, 2, 3};
-                const depth_type* pDepth = (depth_type*)depthBuffer.pTexels + (vgetq_lane_s32(xMin, 0) + (int32_t)depthBuffer.width * y);
-                const float32x4_t bcY    = vmlaq_f32(bcClipSpace.val[2], bcClipSpace.val[1], yf);
-                int32x4_t         x4     = vaddq_s32(vld1q_s32(indices), xMin);
-                const int32x4_t   xMax4  = xMax;
-                const float32x4_t bcX    = vmulq_f32(bcClipSpace.val[0], vdupq_n_f32(4.f));
-
-                float32x4x4_t bc;
-                _sl_vec4_outer_ps(vcvtq_f32_s32(x4), bcClipSpace.val[0], bc);
-                bc.val[0] = vaddq_f32(bc.val[0], bcY);
-                bc.val[1] = vaddq_f32(bc.val[1], bcY);
-                bc.val[2] = vaddq_f32(bc.val[2], bcY);
-                bc.val[3] = vaddq_f32(bc.val[3], bcY);
-
-                do
+                // calculate barycentric coordinates and perform a depth test
+                const uint32x4_t  xBound     = vshrq_n_u32(vcltq_s32(x4, xMax4), 31);
+                const float32x4_t d          = _sl_get_depth_texel4<depth_type>(pDepth).simd;
+                const float32x4_t z          = _sl_mul_vec4_mat4_ps(depth, bc);
+                const uint32x4_t  storeMask4 = vandq_u32(xBound, vreinterpretq_u32_f32(depthCmpFunc(z, d)));
+                const uint32x2_t  boundsTest = vorr_u32(vget_low_u32(storeMask4), vget_high_u32(storeMask4));
+
+                if (LS_LIKELY(vget_lane_u64(vreinterpret_u64_u32(boundsTest), 0) != 0))
                 {
-                    // calculate barycentric coordinates and perform a depth test
-                    const uint32x4_t  xBound     = vshrq_n_u32(vcltq_s32(x4, xMax4), 31);
-                    const float32x4_t d          = _sl_get_depth_texel4<depth_type>(pDepth).simd;
-                    const float32x4_t z          = _sl_mul_vec4_mat4_ps(depth, bc);
-                    const uint32x4_t  storeMask4 = vandq_u32(xBound, vreinterpretq_u32_f32(depthCmpFunc(z, d)));
-                    const uint32x2_t  boundsTest = vorr_u32(vget_low_u32(storeMask4), vget_high_u32(storeMask4));
-
-                    if (LS_LIKELY(vget_lane_u64(vreinterpret_u64_u32(boundsTest), 0) != 0))
+                    if (depthOnly)
+                    {
+                        // Shaders without outputs only need to update the depth buffer
+                        _sl_set_depth_texel4<depth_type>(pDepth, math::vec4{z}, (vgetq_lane_u32(storeMask4, 0) << 0) | (vgetq_lane_u32(storeMask4, 1) << 1) | (vgetq_lane_u32(storeMask4, 2) << 2) | (vgetq_lane_u32(storeMask4, 3) << 3));
+                    }
+                    else
                     {
                         const unsigned storeMask0 = numQueuedFrags;
                         const unsigned storeMask1 = vgetq_lane_u32(storeMask4, 0) + storeMask0;
@@ -763,25 +917,25 @@ void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& depthBuffer) c
                             numQueuedFrags = 0;
                         }
                     }
-
-                    pDepth += 4;
-                    bc.val[0] = vaddq_f32(bc.val[0], bcX);
-                    bc.val[1] = vaddq_f32(bc.val[1], bcX);
-                    bc.val[2] = vaddq_f32(bc.val[2], bcX);
-                    bc.val[3] = vaddq_f32(bc.val[3], bcX);
-                    x4 = vaddq_s32(x4, vdupq_n_s32(4));
                 }
-                while (vgetq_lane_u32(vcltq_s32(x4, xMax4), 0));
-            }
 
-            y += increment;
+                pDepth += 4;
+                bc.val[0] = vaddq_f32(bc.val[0], bcX);
+                bc.val[1] = vaddq_f32(bc.val[1], bcX);
+                bc.val[2] = vaddq_f32(bc.val[2], bcX);
+                bc.val[3] = vaddq_f32(bc.val[3], bcX);
+                x4 = vaddq_s32(x4, vdupq_n_s32(4));
+            }
+            while (vgetq_lane_u32(vcltq_s32(x4, xMax4), 0));
         }
-        while (y < bboxMaxY);
 
-        if (LS_LIKELY(0 < numQueuedFrags))
-        {
-            flush_tri_fragments<depth_type>(bin, numQueuedFrags, outCoords);
-        }
+        y += increment;
+    }
+    while (y < bboxMaxY);
+
+    if (LS_LIKELY(0 < numQueuedFrags))
+    {
+        flush_tri_fragments<depth_type>(bin, numQueuedFrags, outCoords);
     }
 }
 
@@ -804,76 +958,80 @@ inline LS_INLINE ls::math::vec4_t<int> _sl_cmp_vec4_lt(const ls::math::vec4_t<in
 
 
 template <class DepthCmpFunc, typename depth_type>
-void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& depthBuffer) const noexcept
+void SL_TriRasterizer::render_triangle_region(
+    const SL_FragmentBin& bin,
+    const SL_TextureView& depthBuffer,
+    const math::vec4_t<int32_t>& region,
+    const int32_t yOffset,
+    const int32_t increment) const noexcept
 {
-    constexpr DepthCmpFunc         depthCmpFunc;
-    const SL_BinCounter<uint32_t>* pBinIds = mBinIds;
-    const SL_FragmentBin* const    pBins   = mBins;
-    const uint32_t                 numBins = (uint32_t)mNumBins;
+    constexpr DepthCmpFunc depthCmpFunc;
+    SL_FragCoord*          outCoords = mQueues;
+    SL_ScanlineBounds      scanline;
+    const bool             depthOnly = mShader->pipelineState.num_render_targets() == SL_RENDER_TARGET_COUNT_0;
+
+    unsigned          numQueuedFrags = 0;
+    const math::vec4* pPoints        = bin.mScreenCoords;
+    const int32_t     bboxMinY       = math::max((int32_t)math::min(pPoints[0][1], pPoints[1][1], pPoints[2][1]), region[2]);
+    const int32_t     bboxMaxY       = math::min((int32_t)math::max(pPoints[0][1], pPoints[1][1], pPoints[2][1]), region[3]);
+    const int32_t     scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
+
+    int32_t y = bboxMinY + scanLineOffset;
+    if (LS_UNLIKELY(y >= bboxMaxY))
+    {
+        return;
+    }
 
-    SL_FragCoord*     outCoords    = mQueues;
-    const int32_t     yOffset      = (int32_t)mThreadId;
-    const int32_t     increment    = (int32_t)mNumProcessors;
-    SL_ScanlineBounds scanline;
+    const math::vec4 depth{pPoints[0][2], pPoints[1][2], pPoints[2][2], 0.f};
 
-    for (uint32_t i = 0; i < numBins; ++i)
-    {
-        const uint32_t binId = pBinIds[i].count;
-        const SL_FragmentBin& bin = pBins[binId];
+    scanline.init(pPoints[0], pPoints[1], pPoints[2]);
 
-        unsigned          numQueuedFrags = 0;
-        const math::vec4* pPoints        = bin.mScreenCoords;
-        const int32_t     bboxMinY       = (int32_t)math::min(pPoints[0][1], pPoints[1][1], pPoints[2][1]);
-        const int32_t     bboxMaxY       = (int32_t)math::max(pPoints[0][1], pPoints[1][1], pPoints[2][1]);
-        const int32_t     scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
+    const math::vec4* bcClipSpace = bin.mBarycentricCoords;
 
-        int32_t y = bboxMinY + scanLineOffset;
-        if (LS_UNLIKELY(y >= bboxMaxY))
+    do
+    {
+        // calculate the bounds of the current scan-line
+        const float yf = (float)y;
+
+        // In this rasterizer, we're only rendering the absolute pixels
+        // contained within the triangle edges. However this will serve as a
+        // guard against any pixels we don't want to render.
+        int32_t xMin;
+        int32_t xMax;
+        scanline.step(yf, xMin, xMax);
+        xMin = math::max(xMin, region[0]);
+        xMax = math::min(xMax, region[1]);
+
+        if (LS_LIKELY((uint32_t)xMin < (uint32_t)xMax))
         {
-            continue;
-        }
+            depth_type*        pDepth = (depth_type*)depthBuffer.pTexels + (xMin + (int32_t)depthBuffer.width * y);
+            const math::vec4&& bcY    = math::fmadd(bcClipSpace[1], math::vec4{yf}, bcClipSpace[2]);
+            math::vec4i&&      x4     = math::vec4i{0, 1, 2, 3} + xMin;
+            const math::vec4i  xMax4  {xMax};
+            math::mat4&&       bc     = math::outer((math::vec4)x4, bcClipSpace[0]) + bcY;
+            const math::vec4&& bcX    = bcClipSpace[0] * 4.f;
 
-        const math::vec4 depth{pPoints[0][2], pPoints[1][2], pPoints[2][2], 0.f};
-
-        scanline.init(pPoints[0], pPoints[1], pPoints[2]);
-
-        const math::vec4* bcClipSpace = bin.mBarycentricCoords;
-
-        do
-        {
-            // calculate the bounds of the current scan-line
-            const float yf = (float)y;
+            do
+            {
+                // calculate barycentric coordinates and perform a depth test
+                const math::vec4i&& xBound = _sl_cmp_vec4_lt(x4, xMax4);
+                const math::vec4&&  d      = _sl_get_depth_texel4<depth_type>(pDepth);
+                const math::vec4&&  z      = depth * bc;
 
-            // In this rasterizer, we're only rendering the absolute pixels
-            // contained within the triangle edges. However this will serve as a
-            // guard against any pixels we don't want to render.
-            int32_t xMin;
-            int32_t xMax;
-            scanline.step(yf, xMin, xMax);
+                math::vec4i&& storeMask4 = depthCmpFunc(z, d);
+                storeMask4[0] &= xBound[0];
+                storeMask4[1] &= xBound[1];
+                storeMask4[2] &= xBound[2];
+                storeMask4[3] &= xBound[3];
 
-            if (LS_LIKELY((uint32_t)xMin < (uint32_t)xMax))
-            {
-                const depth_type*  pDepth = (depth_type*)depthBuffer.pTexels + (xMin + (int32_t)depthBuffer.width * y);
-                const math::vec4&& bcY    = math::fmadd(bcClipSpace[1], math::vec4{yf}, bcClipSpace[2]);
-                math::vec4i&&      x4     = math::vec4i{0, 1, 2, 3} + xMin;
-                const math::vec4i  xMax4  {xMax};
-                math::mat4&&       bc     = math::outer((math::vec4)x4, bcClipSpace[0]) + bcY;
-                const math::vec4&& bcX    = bcClipSpace[0] * 4.f;
-
-                do
+                if (LS_LIKELY(storeMask4 != 0))
                 {
-                    // calculate barycentric coordinates and perform a depth test
-                    const math::vec4i&& xBound = _sl_cmp_vec4_lt(x4, xMax4);
-                    const math::vec4&&  d      = _sl_get_depth_texel4<depth_type>(pDepth);
-                    const math::vec4&&  z      = depth * bc;
-
-                    math::vec4i&& storeMask4 = depthCmpFunc(z, d);
-                    storeMask4[0] &= xBound[0];
-                    storeMask4[1] &= xBound[1];
-                    storeMask4[2] &= xBound[2];
-                    storeMask4[3] &= xBound[3];
-
-                    if (LS_LIKELY(storeMask4 != 0))
+                    if (depthOnly)
+                    {
+                        // Shaders without outputs only need to update the depth buffer
+                        _sl_set_depth_texel4<depth_type>(pDepth, z, (unsigned)(storeMask4[0] | (storeMask4[1] << 1) | (storeMask4[2] << 2) | (storeMask4[3] << 3)));
+                    }
+                    else
                     {
                         const unsigned storeMask0 = numQueuedFrags;
                         const unsigned storeMask1 = storeMask4[0]+storeMask0;
@@ -903,28 +1061,367 @@ void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& depthBuffer) c
                             numQueuedFrags = 0;
                         }
                     }
+                }
+
+                pDepth += 4;
+                bc += bcX;
+                x4 += 4;
+            }
+            while (x4.v[0] < xMax);
+        }
+
+        y += increment;
+    }
+    while (y < bboxMaxY);
+
+    if (LS_LIKELY(0 < numQueuedFrags))
+    {
+        flush_tri_fragments<depth_type>(bin, numQueuedFrags, outCoords);
+    }
+}
+
+
+
+#endif
+
+
+
+/*-------------------------------------
+ * Render a triangle in 2x2 quads of fragments. When scanlines are interleaved
+ * across threads, each thread owns pairs of scanlines so a quad is never
+ * split between threads.
+-------------------------------------*/
+template <class DepthCmpFunc, typename depth_type>
+void SL_TriRasterizer::render_triangle_quads(
+    const SL_FragmentBin& bin,
+    const SL_TextureView& depthBuffer,
+    const math::vec4_t<int32_t>& region,
+    const int32_t yOffset,
+    const int32_t increment) const noexcept
+{
+    constexpr DepthCmpFunc depthCmpFunc;
+    SL_FragCoord*          outCoords = mQueues;
+    SL_ScanlineBounds      scanline;
+    const bool             depthOnly = mShader->pipelineState.num_render_targets() == SL_RENDER_TARGET_COUNT_0;
+
+    unsigned          numQueuedFrags = 0;
+    const math::vec4* pPoints        = bin.mScreenCoords;
+    const int32_t     bboxMinY       = math::max((int32_t)math::min(pPoints[0][1], pPoints[1][1], pPoints[2][1]), region[2]);
+    const int32_t     bboxMaxY       = math::min((int32_t)math::max(pPoints[0][1], pPoints[1][1], pPoints[2][1]), region[3]);
+    const int32_t     quadMinY       = bboxMinY >> 1;
+    const int32_t     scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, quadMinY);
+
+    int32_t y = (quadMinY + scanLineOffset) << 1;
+    if (LS_UNLIKELY(y >= bboxMaxY))
+    {
+        return;
+    }
+
+    const math::vec4 depth{pPoints[0][2], pPoints[1][2], pPoints[2][2], 0.f};
+
+    scanline.init(pPoints[0], pPoints[1], pPoints[2]);
+
+    const math::vec4* bcClipSpace = bin.mBarycentricCoords;
+
+    do
+    {
+        // Scanline bounds of the top and bottom rows of each quad. Rows
+        // outside of the triangle are left empty.
+        int32_t xMin[2];
+        int32_t xMax[2];
+
+        for (int32_t r = 0; r < 2; ++r)
+        {
+            const int32_t row = y + r;
+
+            if (row >= bboxMinY && row < bboxMaxY)
+            {
+                scanline.step((float)row, xMin[r], xMax[r]);
+                xMin[r] = math::max(xMin[r], region[0]);
+                xMax[r] = math::min(xMax[r], region[1]);
+            }
+            else
+            {
+                xMin[r] = region[1];
+                xMax[r] = region[0];
+            }
+        }
+
+        const int32_t xBegin = math::min(xMin[0], xMin[1]) & ~1;
+        const int32_t xEnd   = math::max(xMax[0], xMax[1]);
+
+        if (LS_LIKELY(xBegin < xEnd))
+        {
+            const math::vec4&& bcY     = math::fmadd(bcClipSpace[1], math::vec4{(float)y}, bcClipSpace[2]);
+            depth_type*        pDepth0 = (depth_type*)depthBuffer.pTexels + (int32_t)depthBuffer.width * y;
+            depth_type*        pDepth1 = pDepth0 + depthBuffer.width;
+
+            for (int32_t x = xBegin; x < xEnd; x += 2)
+            {
+                const int32_t x1 = x + 1;
+
+                uint32_t laneMask = 0;
+                laneMask |= (uint32_t)(x  >= xMin[0] && x  < xMax[0]) << 0;
+                laneMask |= (uint32_t)(x1 >= xMin[0] && x1 < xMax[0]) << 1;
+                laneMask |= (uint32_t)(x  >= xMin[1] && x  < xMax[1]) << 2;
+                laneMask |= (uint32_t)(x1 >= xMin[1] && x1 < xMax[1]) << 3;
+
+                if (!laneMask)
+                {
+                    continue;
+                }
+
+                // Helper lanes extrapolate their barycentric coordinates
+                // beyond the triangle's edges.
+                math::vec4 bc[4];
+                bc[0] = math::fmadd(bcClipSpace[0], math::vec4{(float)x}, bcY);
+                bc[1] = bc[0] + bcClipSpace[0];
+                bc[2] = bc[0] + bcClipSpace[1];
+                bc[3] = bc[1] + bcClipSpace[1];
+
+                float z[4];
+                for (uint32_t l = 0; l < 4; ++l)
+                {
+                    z[l] = math::dot(depth, bc[l]);
+
+                    if (laneMask & (1u << l))
+                    {
+                        depth_type* pDepth = ((l & 2u) ? pDepth1 : pDepth0) + x + (int32_t)(l & 1u);
+
+                        if (!depthCmpFunc(z[l], _sl_get_depth_texel<depth_type>(pDepth)))
+                        {
+                            laneMask &= ~(1u << l);
+                        }
+                        else if (depthOnly)
+                        {
+                            // Depth matches the values written when quads
+                            // are shaded, keeping depth prepasses exact.
+                            *pDepth = (depth_type)z[l];
+                        }
+                    }
+                }
+
+                if (!laneMask || depthOnly)
+                {
+                    continue;
+                }
 
-                    pDepth += 4;
-                    bc += bcX;
-                    x4 += 4;
+                for (uint32_t l = 0; l < 4; ++l)
+                {
+                    outCoords->bc[numQueuedFrags+l]    = bc[l];
+                    outCoords->coord[numQueuedFrags+l] = SL_FragCoordXYZ{(uint16_t)(x + (int32_t)(l & 1u)), (uint16_t)(y + (int32_t)(l >> 1u)), z[l]};
+                }
+
+                outCoords->quadMask[numQueuedFrags >> 2] = (uint8_t)laneMask;
+                numQueuedFrags += 4;
+
+                if (LS_UNLIKELY(numQueuedFrags == SL_SHADER_MAX_QUEUED_FRAGS))
+                {
+                    flush_tri_quads<depth_type>(bin, numQueuedFrags, outCoords);
+                    numQueuedFrags = 0;
                 }
-                while (x4.v[0] < xMax);
             }
+        }
 
-            y += increment;
+        y += increment << 1;
+    }
+    while (y < bboxMaxY);
+
+    if (LS_LIKELY(0 < numQueuedFrags))
+    {
+        flush_tri_quads<depth_type>(bin, numQueuedFrags, outCoords);
+    }
+}
+
+
+
+/*-------------------------------------
+ * Render a triangle into a multisampled framebuffer. Coverage & depth are
+ * evaluated at every sample while the fragment shader runs once per pixel,
+ * at the pixel's center.
+-------------------------------------*/
+template <class DepthCmpFunc, typename depth_type>
+void SL_TriRasterizer::render_triangle_msaa(
+    const SL_FragmentBin& bin,
+    const SL_TextureView& depthBuffer,
+    const math::vec4_t<int32_t>& region,
+    const int32_t yOffset,
+    const int32_t increment) const noexcept
+{
+    constexpr DepthCmpFunc depthCmpFunc;
+    SL_FragCoord*          outCoords     = mQueues;
+    SL_ScanlineBounds      scanline;
+    const SL_PipelineState pipeline      = mShader->pipelineState;
+    const bool             depthOnly     = pipeline.num_render_targets() == SL_RENDER_TARGET_COUNT_0;
+    const bool             haveDepthMask = pipeline.depth_mask() == SL_DEPTH_MASK_ON;
+    const unsigned         numSamples    = depthBuffer.depth;
+    const unsigned         samplesMask   = (1u << numSamples) - 1u;
+    const ptrdiff_t        sampleStride  = (ptrdiff_t)depthBuffer.width * (ptrdiff_t)depthBuffer.height;
+
+    unsigned          numQueuedFrags = 0;
+    const math::vec4* pPoints        = bin.mScreenCoords;
+    const float       yMinF          = math::min(pPoints[0][1], pPoints[1][1], pPoints[2][1]);
+    const float       yMaxF          = math::max(pPoints[0][1], pPoints[1][1], pPoints[2][1]);
+
+    // Samples lie within half a pixel of each pixel's center
+    const int32_t bboxMinY       = math::max((int32_t)yMinF - 1, region[2]);
+    const int32_t bboxMaxY       = math::min((int32_t)yMaxF + 2, region[3]);
+    const int32_t scanLineOffset = sl_scanline_offset<int32_t>(increment, yOffset, bboxMinY);
+
+    int32_t y = bboxMinY + scanLineOffset;
+    if (LS_UNLIKELY(y >= bboxMaxY))
+    {
+        return;
+    }
+
+    const math::vec4 depth{pPoints[0][2], pPoints[1][2], pPoints[2][2], 0.f};
+    const math::vec4* bcClipSpace = bin.mBarycentricCoords;
+
+    // Offsets from the barycentric coordinates of a pixel's center to each
+    // of its samples, one sample per lane.
+    const unsigned   sampleSet = numSamples >> 1u;
+    const math::vec4 sampleX{_SL_SAMPLE_LOCATIONS_X[sampleSet][0], _SL_SAMPLE_LOCATIONS_X[sampleSet][1], _SL_SAMPLE_LOCATIONS_X[sampleSet][2], _SL_SAMPLE_LOCATIONS_X[sampleSet][3]};
+    const math::vec4 sampleY{_SL_SAMPLE_LOCATIONS_Y[sampleSet][0], _SL_SAMPLE_LOCATIONS_Y[sampleSet][1], _SL_SAMPLE_LOCATIONS_Y[sampleSet][2], _SL_SAMPLE_LOCATIONS_Y[sampleSet][3]};
+    const math::vec4 sampleBc0 = math::fmadd(sampleX, math::vec4{bcClipSpace[0][0]}, sampleY * bcClipSpace[1][0]);
+    const math::vec4 sampleBc1 = math::fmadd(sampleX, math::vec4{bcClipSpace[0][1]}, sampleY * bcClipSpace[1][1]);
+    const math::vec4 sampleBc2 = math::fmadd(sampleX, math::vec4{bcClipSpace[0][2]}, sampleY * bcClipSpace[1][2]);
+    const math::vec4 sampleZ   = sampleBc0 * depth[0] + sampleBc1 * depth[1] + sampleBc2 * depth[2];
+
+    scanline.init(pPoints[0], pPoints[1], pPoints[2]);
+
+    do
+    {
+        const float yf = (float)y;
+
+        // Span every sample row of the current scanline, including any
+        // vertex which lies between them.
+        int32_t xMin0, xMax0, xMin1, xMax1;
+        scanline.step(math::clamp(yf - 0.5f, yMinF, yMaxF), xMin0, xMax0);
+        scanline.step(math::clamp(yf + 0.5f, yMinF, yMaxF), xMin1, xMax1);
+
+        float vertMinX = (float)region[1];
+        float vertMaxX = (float)region[0];
+        for (unsigned v = 0; v < 3; ++v)
+        {
+            if (math::abs(pPoints[v][1] - yf) <= 0.5f)
+            {
+                vertMinX = math::min(vertMinX, pPoints[v][0]);
+                vertMaxX = math::max(vertMaxX, pPoints[v][0]);
+            }
         }
-        while (y < bboxMaxY);
 
-        if (LS_LIKELY(0 < numQueuedFrags))
+        const int32_t xMin = math::max(math::min(xMin0, xMin1, (int32_t)vertMinX) - 1, region[0]);
+        const int32_t xMax = math::min(math::max(xMax0, xMax1, (int32_t)vertMaxX) + 2, region[1]);
+
+        if (LS_LIKELY(xMin < xMax))
         {
-            flush_tri_fragments<depth_type>(bin, numQueuedFrags, outCoords);
+            depth_type*        pDepth = (depth_type*)depthBuffer.pTexels + (xMin + (int32_t)depthBuffer.width * y);
+            const math::vec4&& bcY    = math::fmadd(bcClipSpace[1], math::vec4{yf}, bcClipSpace[2]);
+            math::vec4&&       bc     = math::fmadd(bcClipSpace[0], math::vec4{(float)xMin}, bcY);
+            const uint16_t     y16    = (uint16_t)y;
+
+            for (int32_t x = xMin; x < xMax; ++x, ++pDepth, bc += bcClipSpace[0])
+            {
+                // Per-sample coverage, 1 sample per SIMD lane
+                unsigned coverage = samplesMask & _sl_sample_coverage(
+                    sampleBc0 + bc[0],
+                    sampleBc1 + bc[1],
+                    sampleBc2 + bc[2]);
+
+                if (!coverage)
+                {
+                    continue;
+                }
+
+                const math::vec4&& z = sampleZ + math::dot(depth, bc);
+
+                for (unsigned s = 0; s < numSamples; ++s)
+                {
+                    if ((coverage & (1u << s)) && !depthCmpFunc(z[s], _sl_get_depth_texel<depth_type>(pDepth + sampleStride * s)))
+                    {
+                        coverage &= ~(1u << s);
+                    }
+                }
+
+                if (!coverage)
+                {
+                    continue;
+                }
+
+                if (haveDepthMask || depthOnly)
+                {
+                    for (unsigned s = 0; s < numSamples; ++s)
+                    {
+                        if (coverage & (1u << s))
+                        {
+                            pDepth[sampleStride * s] = (depth_type)z[s];
+                        }
+                    }
+                }
+
+                if (depthOnly)
+                {
+                    continue;
+                }
+
+                outCoords->bc[numQueuedFrags]         = bc;
+                outCoords->coord[numQueuedFrags]      = SL_FragCoordXYZ{(uint16_t)x, y16, math::dot(depth, bc)};
+                outCoords->sampleMask[numQueuedFrags] = (uint8_t)coverage;
+
+                if (LS_UNLIKELY(++numQueuedFrags == SL_SHADER_MAX_QUEUED_FRAGS))
+                {
+                    flush_tri_samples(bin, numQueuedFrags, outCoords);
+                    numQueuedFrags = 0;
+                }
+            }
         }
+
+        y += increment;
+    }
+    while (y < bboxMaxY);
+
+    if (LS_LIKELY(0 < numQueuedFrags))
+    {
+        flush_tri_samples(bin, numQueuedFrags, outCoords);
     }
 }
 
 
 
-#endif
+/*-------------------------------------
+ * Render triangles using interleaved scanlines per-thread
+-------------------------------------*/
+template <class DepthCmpFunc, typename depth_type>
+void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& depthBuffer) const noexcept
+{
+    const uint32_t*             pBinIds   = mBinIds;
+    const SL_FragmentBin* const pBins     = mBins;
+    const size_t                binStride = mBinStride;
+    const uint32_t              numBins   = (uint32_t)mNumBins;
+    const int32_t               yOffset   = (int32_t)mThreadId;
+    const int32_t               increment = (int32_t)mNumProcessors;
+    const math::vec4_t<int32_t> region{0, (int32_t)depthBuffer.width, 0, (int32_t)depthBuffer.height};
+    const bool                  useQuads  = mShader->pFragQuadShader != nullptr;
+    const bool                  useMsaa   = mFragFuncs->numSamples > 1;
+
+    for (uint32_t i = 0; i < numBins; ++i)
+    {
+        const SL_FragmentBin& bin = sl_frag_bin(pBins, binStride, pBinIds[i]);
+
+        if (useMsaa)
+        {
+            render_triangle_msaa<DepthCmpFunc, depth_type>(bin, depthBuffer, region, yOffset, increment);
+        }
+        else if (useQuads)
+        {
+            render_triangle_quads<DepthCmpFunc, depth_type>(bin, depthBuffer, region, yOffset, increment);
+        }
+        else
+        {
+            render_triangle_region<DepthCmpFunc, depth_type>(bin, depthBuffer, region, yOffset, increment);
+        }
+    }
+}
 
 
 
@@ -958,6 +1455,152 @@ void SL_TriRasterizer::render_triangle_simd(const SL_TextureView& depthBuffer) c
 
 
 
+/*-------------------------------------
+ * Render triangles using screen-space tiles per-thread
+-------------------------------------*/
+template <class DepthCmpFunc, typename depth_type>
+void SL_TriRasterizer::render_triangle_tiled(const SL_TextureView& depthBuffer) const noexcept
+{
+    const SL_FragmentBin* const pBins       = mBins;
+    const size_t                binStride   = mBinStride;
+    const int32_t               threadId    = (int32_t)mThreadId;
+    const int32_t               numThreads  = (int32_t)mNumProcessors;
+    const int32_t               fboW        = (int32_t)depthBuffer.width;
+    const int32_t               fboH        = (int32_t)depthBuffer.height;
+    const int32_t               tilesX      = sl_num_raster_tiles<int32_t>(fboW);
+    const bool                  useQuads    = mShader->pFragQuadShader != nullptr;
+    const bool                  useMsaa     = mFragFuncs->numSamples > 1;
+    const SL_TileBin* const     tileBins    = mTileBins->bins.get();
+    const uint32_t* const       tileOffsets = mTileBins->tileOffsets.get();
+    const uint32_t* const       tileBinIds  = mTileBins->binIds.get();
+
+    #if SL_HIZ_ENABLED
+        // The depth hierarchy is only needed when primitives can be rejected
+        // or the depth buffer may change.
+        const bool    haveDepthMask = mShader->pipelineState.depth_mask() == SL_DEPTH_MASK_ON;
+        SL_HiZBuffer* pHiZ          = (haveDepthMask || !std::is_same<DepthCmpFunc, SL_DepthFuncOFF>::value) ? mFragFuncs->pDepthHiZ : nullptr;
+    #endif
+
+    // Deferred clears are written into each tile before it's rendered to
+    SL_FastClear* const pFastClear = mFragFuncs->pFastClear;
+
+    // Rasterize one tile at a time so its depth & color texels remain
+    // resident in cache while every overlapping primitive is processed.
+    // Threads start with the tiles they own, in row-major order, then steal
+    // tiles from busier threads. Each tile is claimed by only one thread.
+    uint32_t ownerId;
+    uint32_t ownedTileId;
+
+    while (sl_acquire_task(mTileRanges, (uint32_t)numThreads, (uint32_t)threadId, ownerId, ownedTileId))
+    {
+        const int32_t  tileId   = (int32_t)ownerId + (int32_t)ownedTileId * numThreads;
+        const uint32_t binBegin = tileOffsets[tileId];
+        const uint32_t binEnd   = tileOffsets[tileId + 1];
+
+        // Pending clears remain in tiles which no primitive overlaps
+        if (binBegin == binEnd)
+        {
+            continue;
+        }
+
+        const int32_t ty = tileId / tilesX;
+        const int32_t tx = tileId - ty * tilesX;
+        const int32_t y0 = ty << SL_RASTER_TILE_SHIFT;
+        const int32_t y1 = math::min(y0 + (int32_t)SL_RASTER_TILE_SIZE, fboH);
+        const int32_t x0 = tx << SL_RASTER_TILE_SHIFT;
+        const int32_t x1 = math::min(x0 + (int32_t)SL_RASTER_TILE_SIZE, fboW);
+        const math::vec4_t<int32_t> region{x0, x1, y0, y1};
+
+        #if SL_HIZ_ENABLED
+            uint64_t dirtyBlocks = 0;
+        #endif
+
+        if (pFastClear)
+        {
+            pFastClear->resolve_tile((uint16_t)tx, (uint16_t)ty, mFragFuncs->pColorAttachments, mFragFuncs->pDepthAttachment);
+        }
+
+        for (uint32_t i = binBegin; i < binEnd; ++i)
+        {
+            const SL_TileBin& tileBin = tileBins[tileBinIds[i]];
+
+            #if SL_HIZ_ENABLED
+                // Skip any 8x8 blocks where the bin is occluded
+                if (pHiZ)
+                {
+                    math::vec4_t<int32_t> hiZRegion = region;
+                    if (_sl_hiz_test_region<DepthCmpFunc>(*pHiZ, tileBin, tx, ty, hiZRegion, dirtyBlocks))
+                    {
+                        if (useQuads)
+                        {
+                            render_triangle_quads<DepthCmpFunc, depth_type>(sl_frag_bin(pBins, binStride, tileBin.binId), depthBuffer, hiZRegion, 0, 1);
+                        }
+                        else
+                        {
+                            render_triangle_region<DepthCmpFunc, depth_type>(sl_frag_bin(pBins, binStride, tileBin.binId), depthBuffer, hiZRegion, 0, 1);
+                        }
+                    }
+                    continue;
+                }
+            #endif
+
+            if (useMsaa)
+            {
+                render_triangle_msaa<DepthCmpFunc, depth_type>(sl_frag_bin(pBins, binStride, tileBin.binId), depthBuffer, region, 0, 1);
+            }
+            else if (useQuads)
+            {
+                render_triangle_quads<DepthCmpFunc, depth_type>(sl_frag_bin(pBins, binStride, tileBin.binId), depthBuffer, region, 0, 1);
+            }
+            else
+            {
+                render_triangle_region<DepthCmpFunc, depth_type>(sl_frag_bin(pBins, binStride, tileBin.binId), depthBuffer, region, 0, 1);
+            }
+        }
+
+        #if SL_HIZ_ENABLED
+            // Only this thread claimed the current tile, allowing its depth
+            // ranges to be updated without synchronization.
+            if (haveDepthMask && dirtyBlocks)
+            {
+                pHiZ->update_tile<depth_type>(depthBuffer, (uint16_t)tx, (uint16_t)ty, dirtyBlocks);
+            }
+        #endif
+    }
+}
+
+
+
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLT, ls::math::half>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLT, float>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLT, double>(const SL_TextureView&) const noexcept;
+
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLE, ls::math::half>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLE, float>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncLE, double>(const SL_TextureView&) const noexcept;
+
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGT, ls::math::half>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGT, float>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGT, double>(const SL_TextureView&) const noexcept;
+
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGE, ls::math::half>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGE, float>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncGE, double>(const SL_TextureView&) const noexcept;
+
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncEQ, ls::math::half>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncEQ, float>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncEQ, double>(const SL_TextureView&) const noexcept;
+
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncNE, ls::math::half>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncNE, float>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncNE, double>(const SL_TextureView&) const noexcept;
+
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncOFF, ls::math::half>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncOFF, float>(const SL_TextureView&) const noexcept;
+ template void SL_TriRasterizer::render_triangle_tiled<SL_DepthFuncOFF, double>(const SL_TextureView&) const noexcept;
+
+
+
 /*-------------------------------------
  * Dispatch the fragment processor with the correct depth-comparison function
 -------------------------------------*/
@@ -987,23 +1630,37 @@ void SL_TriRasterizer::dispatch_bins() noexcept
 
         case RENDER_MODE_TRIANGLES:
         case RENDER_MODE_INDEXED_TRIANGLES:
-            // Triangles assign scan-lines per thread for rasterization.
-            // There's No need to subdivide the output framebuffer
-            if (depthBpp == sizeof(math::half))
-            {
-                //render_triangle<DepthCmpFunc, math::half>(pDepthBuf);
-                render_triangle_simd<DepthCmpFunc, math::half>(pDepthBuf);
-            }
-            else if (depthBpp == sizeof(float))
-            {
-                //render_triangle<DepthCmpFunc, float>(pDepthBuf);
-                render_triangle_simd<DepthCmpFunc, float>(pDepthBuf);
-            }
-            else if (depthBpp == sizeof(double))
-            {
-                //render_triangle<DepthCmpFunc, double>(pDepthBuf);
-                render_triangle_simd<DepthCmpFunc, double>(pDepthBuf);
-            }
+            #if SL_TILED_RASTERIZATION_ENABLED
+                // Triangles are rasterized within the screen-space tiles
+                // owned by each thread.
+                if (depthBpp == sizeof(math::half))
+                {
+                    render_triangle_tiled<DepthCmpFunc, math::half>(pDepthBuf);
+                }
+                else if (depthBpp == sizeof(float))
+                {
+                    render_triangle_tiled<DepthCmpFunc, float>(pDepthBuf);
+                }
+                else if (depthBpp == sizeof(double))
+                {
+                    render_triangle_tiled<DepthCmpFunc, double>(pDepthBuf);
+                }
+            #else
+                // Triangles assign scan-lines per thread for rasterization.
+                // There's No need to subdivide the output framebuffer
+                if (depthBpp == sizeof(math::half))
+                {
+                    render_triangle_simd<DepthCmpFunc, math::half>(pDepthBuf);
+                }
+                else if (depthBpp == sizeof(float))
+                {
+                    render_triangle_simd<DepthCmpFunc, float>(pDepthBuf);
+                }
+                else if (depthBpp == sizeof(double))
+                {
+                    render_triangle_simd<DepthCmpFunc, double>(pDepthBuf);
+                }
+            #endif
             break;
 
         default:
@@ -1029,7 +1686,14 @@ template void SL_TriRasterizer::dispatch_bins<SL_DepthFuncOFF>() noexcept;
 -------------------------------------*/
 void SL_TriRasterizer::execute() noexcept
 {
-    const SL_DepthTest depthTestType = mShader->pipelineState.depth_test();
+    const SL_PipelineState& pipeline      = mShader->pipelineState;
+    const SL_DepthTest      depthTestType = pipeline.depth_test();
+
+    // Nothing can be written without color outputs or a depth mask
+    if (LS_UNLIKELY(pipeline.num_render_targets() == SL_RENDER_TARGET_COUNT_0 && pipeline.depth_mask() == SL_DEPTH_MASK_OFF))
+    {
+        return;
+    }
 
     switch (depthTestType)
     {
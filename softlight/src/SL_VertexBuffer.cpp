@@ -20,7 +20,9 @@ SL_VertexBuffer::~SL_VertexBuffer() noexcept
 --------------------------------------*/
 SL_VertexBuffer::SL_VertexBuffer() noexcept :
     mNumBytes{},
-    mBuffer{}
+    mBuffer{},
+    mExternal{},
+    mData{nullptr}
 {}
 
 
@@ -30,11 +32,13 @@ SL_VertexBuffer::SL_VertexBuffer() noexcept :
 --------------------------------------*/
 SL_VertexBuffer::SL_VertexBuffer(const SL_VertexBuffer& v) noexcept :
     mNumBytes{v.mNumBytes},
-    mBuffer{(v.mBuffer == nullptr) ? nullptr : (unsigned char*)ls::utils::aligned_malloc(v.mNumBytes)}
+    mBuffer{(v.mData == nullptr) ? nullptr : (unsigned char*)ls::utils::aligned_malloc(v.mNumBytes)},
+    mExternal{},
+    mData{mBuffer.get()}
 {
-    if (v.mBuffer != nullptr)
+    if (v.mData != nullptr)
     {
-        ls::utils::fast_memcpy(mBuffer.get(), v.mBuffer.get(), v.mNumBytes);
+        ls::utils::fast_memcpy(mBuffer.get(), v.mData, v.mNumBytes);
     }
 }
 
@@ -45,9 +49,12 @@ SL_VertexBuffer::SL_VertexBuffer(const SL_VertexBuffer& v) noexcept :
 --------------------------------------*/
 SL_VertexBuffer::SL_VertexBuffer(SL_VertexBuffer&& v) noexcept :
     mNumBytes{v.mNumBytes},
-    mBuffer{std::move(v.mBuffer)}
+    mBuffer{std::move(v.mBuffer)},
+    mExternal{std::move(v.mExternal)},
+    mData{v.mData}
 {
     v.mNumBytes = 0;
+    v.mData = nullptr;
 }
 
 
@@ -60,12 +67,19 @@ SL_VertexBuffer& SL_VertexBuffer::operator=(const SL_VertexBuffer& v) noexcept
     if (this != &v)
     {
         mNumBytes = v.mNumBytes;
+        mExternal.reset();
 
-        if (v.mBuffer != nullptr)
+        if (v.mData != nullptr)
         {
             mBuffer.reset((unsigned char*)ls::utils::aligned_malloc(v.mNumBytes));
-            ls::utils::fast_memcpy(mBuffer.get(), v.mBuffer.get(), v.mNumBytes);
+            ls::utils::fast_memcpy(mBuffer.get(), v.mData, v.mNumBytes);
         }
+        else
+        {
+            mBuffer.reset();
+        }
+
+        mData = mBuffer.get();
     }
     return *this;
 }
@@ -83,6 +97,10 @@ SL_VertexBuffer& SL_VertexBuffer::operator=(SL_VertexBuffer&& v) noexcept
         v.mNumBytes = 0;
 
         mBuffer = std::move(v.mBuffer);
+        mExternal = std::move(v.mExternal);
+
+        mData = v.mData;
+        v.mData = nullptr;
     }
 
     return *this;
@@ -101,7 +119,9 @@ int SL_VertexBuffer::init(size_t numBytes, const void* pData) noexcept
     }
 
     mNumBytes = numBytes;
+    mExternal.reset();
     mBuffer.reset((unsigned char*)ls::utils::aligned_malloc(numBytes));
+    mData = mBuffer.get();
 
     if (pData != nullptr)
     {
@@ -113,6 +133,27 @@ int SL_VertexBuffer::init(size_t numBytes, const void* pData) noexcept
 
 
 
+/*--------------------------------------
+ * Use memory allocated elsewhere without copying it. The input pointer
+ * keeps its underlying allocation alive for as long as *this references it.
+--------------------------------------*/
+int SL_VertexBuffer::adopt(size_t numBytes, const std::shared_ptr<unsigned char>& pData) noexcept
+{
+    if (!numBytes || !pData)
+    {
+        return -1;
+    }
+
+    mNumBytes = numBytes;
+    mBuffer.reset();
+    mExternal = pData;
+    mData = mExternal.get();
+
+    return 0;
+}
+
+
+
 /*--------------------------------------
  * Delete all data used by *this.
 --------------------------------------*/
@@ -120,4 +161,6 @@ void SL_VertexBuffer::terminate() noexcept
 {
     mNumBytes = 0;
     mBuffer.reset();
+    mExternal.reset();
+    mData = nullptr;
 }
@@ -1,12 +1,19 @@
 
+#include <algorithm> // std::upper_bound
+
 #include "lightsky/setup/Types.h"
 
 #include "lightsky/utils/Sort.hpp" // utils::sort_radix
 
 #include "softlight/SL_Context.hpp"
+#include "softlight/SL_FastClear.hpp"
+#include "softlight/SL_Framebuffer.hpp" // SL_FboOutputFunctions
+#include "softlight/SL_HybridWait.hpp"
 #include "softlight/SL_LineRasterizer.hpp"
 #include "softlight/SL_PointRasterizer.hpp"
 #include "softlight/SL_Shader.hpp" // SL_Shader
+#include "softlight/SL_ShaderProcessor.hpp" // sl_vertices_per_primitive()
+#include "softlight/SL_TaskQueue.hpp" // sl_acquire_task()
 #include "softlight/SL_TriRasterizer.hpp"
 #include "softlight/SL_VertexProcessor.hpp"
 #include "softlight/SL_ViewportState.hpp"
@@ -24,47 +31,66 @@ namespace
 
 
 
-/*-------------------------------------
- * Exponential CPU-yielding to reduce spinlock overhead
--------------------------------------*/
-template <typename IntegralType>
-inline LS_INLINE IntegralType _sl_cpu_yield_exponential(IntegralType yieldCount) noexcept
+/*--------------------------------------
+ * Write the pending clears of each tile which binned primitives may touch.
+ * Only rasterizers which don't resolve clears per-tile need this. Tiles are
+ * resolved on the calling thread while all others wait to rasterize.
+--------------------------------------*/
+void _sl_resolve_binned_tiles(
+    SL_FastClear& clears,
+    const SL_FboOutputFunctions& fboFuncs,
+    const SL_FragmentBin* pBins,
+    size_t binStride,
+    const uint32_t* pBinIds,
+    uint_fast64_t numBins,
+    unsigned numVerts,
+    float margin) noexcept
 {
-    static_assert(ls::setup::IsIntegral<IntegralType>::value, "Need an integer type to count exponential yielding.");
-    constexpr IntegralType maxIters = 2;
+    const float maxX = (float)(fboFuncs.pDepthAttachment->width - 1u);
+    const float maxY = (float)(fboFuncs.pDepthAttachment->height - 1u);
 
-    switch (yieldCount)
+    for (uint_fast64_t i = 0; i < numBins && clears.pending(); ++i)
     {
-        case 2:
-            ls::setup::cpu_yield();
-            ls::setup::cpu_yield();
-            ls::setup::cpu_yield();
-            ls::setup::cpu_yield();
-
-        case 1:
-            ls::setup::cpu_yield();
-            ls::setup::cpu_yield();
-
-        default:
-            ls::setup::cpu_yield();
-    }
+        const math::vec4* pPoints = sl_frag_bin(pBins, binStride, pBinIds[i]).mScreenCoords;
 
-    return ls::math::min<IntegralType>(yieldCount+1, maxIters);
-}
+        float x0 = pPoints[0][0];
+        float x1 = pPoints[0][0];
+        float y0 = pPoints[0][1];
+        float y1 = pPoints[0][1];
 
+        for (unsigned v = 1; v < numVerts; ++v)
+        {
+            x0 = math::min(x0, pPoints[v][0]);
+            x1 = math::max(x1, pPoints[v][0]);
+            y0 = math::min(y0, pPoints[v][1]);
+            y1 = math::max(y1, pPoints[v][1]);
+        }
 
+        x0 = math::max(x0 - margin, 0.f);
+        y0 = math::max(y0 - margin, 0.f);
+        x1 = math::min(x1 + margin + 1.f, maxX);
+        y1 = math::min(y1 + margin + 1.f, maxY);
 
-/*-------------------------------------
- * Exponential CPU-yielding to reduce spinlock overhead
--------------------------------------*/
-template <typename WaitCondition>
-inline LS_INLINE void _sl_cpu_yield_loop(const WaitCondition& cond) noexcept
-{
-    uint_fast32_t yieldCount = 0;
+        if (LS_UNLIKELY(!(x0 <= x1 && y0 <= y1)))
+        {
+            continue;
+        }
 
-    while (cond())
-    {
-        yieldCount = _sl_cpu_yield_exponential<uint_fast32_t>(yieldCount);
+        const uint16_t tx0 = (uint16_t)((uint32_t)x0 >> SL_RASTER_TILE_SHIFT);
+        const uint16_t ty0 = (uint16_t)((uint32_t)y0 >> SL_RASTER_TILE_SHIFT);
+        const uint16_t tx1 = (uint16_t)((uint32_t)x1 >> SL_RASTER_TILE_SHIFT);
+        const uint16_t ty1 = (uint16_t)((uint32_t)y1 >> SL_RASTER_TILE_SHIFT);
+
+        for (uint16_t ty = ty0; ty <= ty1; ++ty)
+        {
+            for (uint16_t tx = tx0; tx <= tx1; ++tx)
+            {
+                if (clears.pending(tx, ty))
+                {
+                    clears.resolve_tile(tx, ty, fboFuncs.pColorAttachments, fboFuncs.pDepthAttachment);
+                }
+            }
+        }
     }
 }
 
@@ -77,6 +103,47 @@ inline LS_INLINE void _sl_cpu_yield_loop(const WaitCondition& cond) noexcept
 /*-----------------------------------------------------------------------------
  * SL_VertexProcessor Class
 -----------------------------------------------------------------------------*/
+/*-------------------------------------
+ * Retrieve the next batch of primitives
+-------------------------------------*/
+bool SL_VertexProcessor::next_vertex_batch(size_t elementsPerBatch, size_t& outMeshId, size_t& outInstanceId, size_t& outBegin, size_t& outEnd) noexcept
+{
+    const uint32_t* const pBatchOffsets = mBatchOffsets;
+    uint32_t              rangeId;
+    uint32_t              batchId;
+
+    // Each thread begins with a contiguous range of batches so neighboring
+    // primitives, and their shared vertices, remain on the same thread. Idle
+    // threads then steal batches from the end of other threads' ranges.
+    if (!sl_acquire_task(mTaskRanges, (uint32_t)mNumThreads, (uint32_t)mThreadId, rangeId, batchId))
+    {
+        return false;
+    }
+
+    size_t meshBatchId;
+
+    if (mNumInstances > 1)
+    {
+        outMeshId     = 0;
+        outInstanceId = batchId / pBatchOffsets[1];
+        meshBatchId   = batchId - outInstanceId * pBatchOffsets[1];
+    }
+    else
+    {
+        outMeshId     = (size_t)(std::upper_bound(pBatchOffsets+1, pBatchOffsets+mNumMeshes+1, batchId) - (pBatchOffsets+1));
+        outInstanceId = 0;
+        meshBatchId   = batchId - pBatchOffsets[outMeshId];
+    }
+
+    const SL_Mesh& m = mMeshes[outMeshId];
+    outBegin = m.elementBegin + meshBatchId * elementsPerBatch;
+    outEnd   = math::min(outBegin + elementsPerBatch, m.elementEnd);
+
+    return true;
+}
+
+
+
 /*-------------------------------------
  * Execute the rasterizer
 -------------------------------------*/
@@ -90,39 +157,61 @@ void SL_VertexProcessor::flush_rasterizer() noexcept
     const int_fast64_t    syncPoint1   = -numThreads - 1;
     const int_fast64_t    tileId       = active_frag_processors().count.fetch_add(1ll, std::memory_order_acq_rel);
     const SL_FragmentBin* pBins        = active_frag_bins();
+    const size_t          binStride    = mBinStride;
     uint_fast64_t         maxElements;
     int_fast64_t          syncPoint2;
 
+    // Wake any threads parked in cleanup() so they can join this flush.
+    if (tileId == 0)
+    {
+        mWaitSignal->notify_all();
+    }
+
     // Sort the bins based on their depth.
     if (LS_UNLIKELY(tileId == numThreads-1u))
     {
-        maxElements = math::min<uint_fast64_t>(active_num_bins_used().count.load(std::memory_order_consume), SL_SHADER_MAX_BINNED_PRIMS);
+        const uint_fast64_t numBinsUsed = active_num_bins_used().count.load(std::memory_order_consume);
+        maxElements = math::min<uint_fast64_t>(numBinsUsed, mMaxBins);
+
+        mFlushStats->mNumFlushes.count.fetch_add(1, std::memory_order_relaxed);
+        mFlushStats->mNumBinsFlushed.count.fetch_add(maxElements, std::memory_order_relaxed);
+
+        // Bins are only claimed past capacity by threads which need to flush
+        // them before binning more primitives.
+        if (mProcessBuffer[mProcessBufferIndex].mCoverageFlush.count.exchange(0, std::memory_order_acq_rel))
+        {
+            mFlushStats->mNumCoverageFlushes.count.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (numBinsUsed > mMaxBins)
+        {
+            mFlushStats->mNumCapacityFlushes.count.fetch_add(1, std::memory_order_relaxed);
+        }
 
         // Try to perform depth sorting once, and only once, per opaque draw
         // call to reduce depth-buffer access during rasterization. Sorting
         // primitives multiple times here in the vertex processor will
         // increase latency before invoking the fragment processor.
         const bool shouldDepthSort = ls::setup::IsSame<RasterizerType, SL_TriRasterizer>::value && (active_buffer_index() == next_buffer_index());
-        const bool canDepthSort = shouldDepthSort && (maxElements < SL_SHADER_MAX_BINNED_PRIMS);
+        const bool canDepthSort = shouldDepthSort && (maxElements < mMaxBins);
 
         // Blended fragments get sorted by their primitive index for
         // consistency.
         if (LS_UNLIKELY(mShader->pipelineState.blend_mode() != SL_BLEND_OFF))
         {
-            SL_BinCounter<uint32_t>* const pActiveBinIds = active_bin_indices();
-            SL_BinCounter<uint32_t>* const pTempBinIds = active_temp_bin_indices();
+            uint32_t* const pActiveBinIds = active_bin_indices();
+            uint32_t* const pTempBinIds = active_temp_bin_indices();
 
-            utils::sort_radix<SL_BinCounter<uint32_t>>(pActiveBinIds, pTempBinIds, (uint64_t)maxElements, [&](const SL_BinCounter<uint32_t>& val) noexcept->unsigned long long
+            utils::sort_radix<uint32_t>(pActiveBinIds, pTempBinIds, (uint64_t)maxElements, [&](const uint32_t& val) noexcept->unsigned long long
             {
-                return (unsigned long long)pBins[val.count].primIndex;
+                return (unsigned long long)sl_frag_bin(pBins, binStride, val).primIndex;
             });
         }
         else if (canDepthSort)
         {
-            SL_BinCounter<uint32_t>* const pActiveBinIds = active_bin_indices();
-            SL_BinCounter<uint32_t>* const pTempBinIds = active_temp_bin_indices();
+            uint32_t* const pActiveBinIds = active_bin_indices();
+            uint32_t* const pTempBinIds = active_temp_bin_indices();
 
-            utils::sort_radix<SL_BinCounter<uint32_t>>(pActiveBinIds, pTempBinIds, (uint64_t)maxElements, [&](const SL_BinCounter<uint32_t>& val) noexcept->unsigned long long
+            utils::sort_radix<uint32_t>(pActiveBinIds, pTempBinIds, (uint64_t)maxElements, [&](const uint32_t& val) noexcept->unsigned long long
             {
                 // flip sign, otherwise the sorting goes from back-to-front
                 // due to the sortable nature of floats.
@@ -131,22 +220,84 @@ void SL_VertexProcessor::flush_rasterizer() noexcept
                 {
                     float f;
                     int32_t i;
-                } w{pBins[val.count].mScreenCoords[0][3]};
+                } w{sl_frag_bin(pBins, binStride, val).mScreenCoords[0][3]};
                 return (unsigned long long) -w.i;
             });
         }
 
+        // Filled triangles are rasterized one screen-space tile at a time.
+        const bool rastersTiles = SL_TILED_RASTERIZATION_ENABLED
+            && ls::setup::IsSame<RasterizerType, SL_TriRasterizer>::value
+            && (mRenderMode == RENDER_MODE_TRIANGLES || mRenderMode == RENDER_MODE_INDEXED_TRIANGLES);
+
+        // Each thread begins rasterizing the tiles it owns, then steals from
+        // other threads. Bins are grouped by tile once, here, so each tile
+        // only visits the primitives overlapping it. All threads have
+        // finished with this buffer's tiles by the time they join its next
+        // flush.
+        if (rastersTiles)
+        {
+            const uint32_t numTiles = sl_num_raster_tiles<uint32_t>(mFragFuncs->pDepthAttachment->width) * sl_num_raster_tiles<uint32_t>(mFragFuncs->pDepthAttachment->height);
+            SL_TaskRange* const pTileRanges = active_tile_ranges();
+
+            for (uint32_t t = 0; t < (uint32_t)numThreads; ++t)
+            {
+                pTileRanges[t].reset(0, (t < numTiles) ? ((numTiles - t + (uint32_t)numThreads - 1u) / (uint32_t)numThreads) : 0u);
+            }
+
+            sl_bin_raster_tiles(*mTileBins, pBins, binStride, active_bin_indices(), (uint32_t)maxElements, *mFragFuncs->pDepthAttachment, mFragFuncs->numSamples > 1);
+        }
+
+        // Single-pixel points are grouped by the thread which owns their
+        // scanline. Each thread then only visits its own points.
+        if (ls::setup::IsSame<RasterizerType, SL_PointRasterizer>::value && sl_point_sprite_size(mShader->pointSize) == 1)
+        {
+            uint32_t* const pActiveBinIds = active_bin_indices();
+            uint32_t* const pTempBinIds = active_temp_bin_indices();
+            SL_TaskRange* const pThreadRanges = active_tile_ranges();
+
+            utils::sort_radix<uint32_t>(pActiveBinIds, pTempBinIds, (uint64_t)maxElements, [&](const uint32_t& val) noexcept->unsigned long long
+            {
+                return (unsigned long long)((uint32_t)sl_frag_bin(pBins, binStride, val).mScreenCoords[0][1] % (uint32_t)numThreads);
+            });
+
+            uint32_t begin = 0;
+            for (uint32_t t = 0; t < (uint32_t)numThreads; ++t)
+            {
+                uint32_t end = begin;
+                while (end < (uint32_t)maxElements && ((uint32_t)sl_frag_bin(pBins, binStride, pActiveBinIds[end]).mScreenCoords[0][1] % (uint32_t)numThreads) == t)
+                {
+                    ++end;
+                }
+
+                pThreadRanges[t].reset(begin, end);
+                begin = end;
+            }
+        }
+
+        // Only filled triangles resolve pending clears as they rasterize
+        // each tile. Other primitives may write anywhere within their bounds,
+        // including the extra pixel scanned around multisampled primitives.
+        if (mFragFuncs->pFastClear && !rastersTiles)
+        {
+            const bool  isPoint = ls::setup::IsSame<RasterizerType, SL_PointRasterizer>::value;
+            const float margin  = isPoint ? (float)(sl_point_sprite_size(mShader->pointSize) / 2 + 1) : 1.f;
+
+            _sl_resolve_binned_tiles(*mFragFuncs->pFastClear, *mFragFuncs, pBins, binStride, active_bin_indices(), maxElements, sl_vertices_per_primitive(mRenderMode), margin);
+        }
+
         // Let all threads know they can process fragments.
         active_frag_processors().count.store(syncPoint1, std::memory_order_release);
+        mWaitSignal->notify_all();
     }
     else
     {
-        _sl_cpu_yield_loop([&]() noexcept -> bool
+        mWaitSignal->wait([&]() noexcept -> bool
         {
             return active_frag_processors().count.load(std::memory_order_consume) > 0;
-        });
+        }, mSpinBudget);
 
-        maxElements = math::min<uint_fast64_t>(active_num_bins_used().count.load(std::memory_order_consume), SL_SHADER_MAX_BINNED_PRIMS);
+        maxElements = math::min<uint_fast64_t>(active_num_bins_used().count.load(std::memory_order_consume), mMaxBins);
     }
 
     RasterizerType rasterizer;
@@ -154,11 +305,14 @@ void SL_VertexProcessor::flush_rasterizer() noexcept
     rasterizer.mMode = mRenderMode;
     rasterizer.mNumProcessors = (uint32_t)mNumThreads;
     rasterizer.mNumBins = maxElements;
+    rasterizer.mBinStride = mBinStride;
     rasterizer.mShader = mShader;
     rasterizer.mFragFuncs = mFragFuncs;
     rasterizer.mBinIds = active_bin_indices();
     rasterizer.mBins = pBins;
     rasterizer.mQueues = mFragQueues + mThreadId;
+    rasterizer.mTileRanges = active_tile_ranges();
+    rasterizer.mTileBins = mTileBins;
 
     rasterizer.execute();
 
@@ -169,19 +323,41 @@ void SL_VertexProcessor::flush_rasterizer() noexcept
     {
         active_num_bins_used().count.store(0, std::memory_order_release);
         active_frag_processors().count.store(0, std::memory_order_release);
+        mWaitSignal->notify_all();
     }
     else if (active_buffer_index() == next_buffer_index())
     {
-        _sl_cpu_yield_loop([&]() noexcept -> bool {
+        mWaitSignal->wait([&]() noexcept -> bool {
             return active_frag_processors().count.load(std::memory_order_consume) < 0;
-        });
+        }, mSpinBudget);
     }
 
+    mBinnedArea = 0.f;
     flip_process_buffers();
 }
 
 
 
+/*-------------------------------------
+ * Track the screen area of binned primitives
+-------------------------------------*/
+template <typename RasterizerType>
+void SL_VertexProcessor::flush_on_coverage(float primArea) noexcept
+{
+    // Large primitives keep every thread busy in the rasterizer. Invoke it
+    // early, rather than leaving a few large primitives in the bins while
+    // the remaining vertices are transformed.
+    mBinnedArea += primArea;
+
+    if (LS_UNLIKELY(mBinnedArea >= mMaxBinnedArea))
+    {
+        mProcessBuffer[mProcessBufferIndex].mCoverageFlush.count.store(1, std::memory_order_release);
+        flush_rasterizer<RasterizerType>();
+    }
+}
+
+
+
 /*--------------------------------------
  * Perform a final sync
 --------------------------------------*/
@@ -191,9 +367,13 @@ void SL_VertexProcessor::cleanup() noexcept
     static_assert(ls::setup::IsBaseOf<SL_FragmentProcessor, RasterizerType>::value, "Template parameter 'RasterizerType' must derive from SL_FragmentProcessor.");
 
     uint_fast64_t numActiveFragProcessors;
-    uint_fast32_t currentIters = 0;
 
-    mBusyProcessors->count.fetch_sub(1, std::memory_order_acq_rel);
+    // The last thread to finish processing vertices must wake any others
+    // which are parked below.
+    if (mBusyProcessors->count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        mWaitSignal->notify_all();
+    }
 
     do
     {
@@ -203,7 +383,11 @@ void SL_VertexProcessor::cleanup() noexcept
         }
         else
         {
-            currentIters = _sl_cpu_yield_exponential<uint_fast32_t>(currentIters);
+            mWaitSignal->wait([&]() noexcept -> bool
+            {
+                return active_frag_processors().count.load(std::memory_order_acquire) <= 0
+                    && mBusyProcessors->count.load(std::memory_order_acquire) != 0;
+            }, mSpinBudget);
         }
 
         numActiveFragProcessors = mBusyProcessors->count.load(std::memory_order_acquire);
@@ -225,6 +409,8 @@ template void SL_VertexProcessor::flush_rasterizer<SL_PointRasterizer>() noexcep
 template void SL_VertexProcessor::flush_rasterizer<SL_LineRasterizer>() noexcept;
 template void SL_VertexProcessor::flush_rasterizer<SL_TriRasterizer>() noexcept;
 
+template void SL_VertexProcessor::flush_on_coverage<SL_TriRasterizer>(float) noexcept;
+
 template void SL_VertexProcessor::cleanup<SL_PointRasterizer>() noexcept;
 template void SL_VertexProcessor::cleanup<SL_LineRasterizer>() noexcept;
 template void SL_VertexProcessor::cleanup<SL_TriRasterizer>() noexcept;
@@ -0,0 +1,132 @@
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Draw a set of overlapping triangles and validate the output
+-----------------------------------------------------------------------------*/
+constexpr uint16_t FBO_WIDTH  = 64;
+constexpr uint16_t FBO_HEIGHT = 48;
+constexpr unsigned NUM_TRIS   = 8;
+
+
+
+int draw_and_validate(SL_Context& context, const SL_Mesh& mesh, size_t shaderId, size_t fboId, size_t colorId)
+{
+    context.clear_color_buffer(fboId, 0, math::vec4_t<double>{0.0});
+    context.draw(mesh, shaderId, fboId);
+
+    const SL_Texture& texColor = context.texture(colorId);
+
+    for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+        {
+            const float count = texColor.texel<float>(x, y);
+
+            if (count != (float)NUM_TRIS)
+            {
+                std::cerr << "Pixel (" << x << ", " << y << ") was shaded " << count << " times." << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    const SL_BinFlushCounts&& counts = context.bin_flush_counts();
+
+    std::cout
+        << "Flushes:          " << counts.numFlushes
+        << "\nBins Flushed:     " << counts.numBinsFlushed
+        << "\nCapacity Flushes: " << counts.numCapacityFlushes
+        << "\nCoverage Flushes: " << counts.numCoverageFlushes
+        << std::endl;
+
+    return 0;
+}
+
+
+
+int main()
+{
+    int retCode = 0;
+
+    SL_Context context;
+    context.num_threads(4);
+
+    const size_t colorId  = context.create_texture();
+    const size_t depthId  = context.create_texture();
+    const size_t fboId    = context.create_framebuffer();
+    const size_t vaoId    = context.create_vao();
+    const size_t vboId    = context.create_vbo();
+    const size_t shaderId = context.create_shader(sl_test_vert_shader(), sl_test_frag_shader(SL_BLEND_ADDITIVE, SL_DEPTH_MASK_OFF, SL_DEPTH_TEST_OFF));
+
+    if (sl_test_init_framebuffer(context, fboId, colorId, depthId, FBO_WIDTH, FBO_HEIGHT) != 0)
+    {
+        return -1;
+    }
+
+    // Several stacked triangles which cover the entire screen
+    math::vec4 verts[NUM_TRIS*3];
+    for (unsigned i = 0; i < NUM_TRIS; ++i)
+    {
+        verts[i*3+0] = math::vec4{-1.f, -1.f, 0.f, 1.f};
+        verts[i*3+1] = math::vec4{ 3.f, -1.f, 0.f, 1.f};
+        verts[i*3+2] = math::vec4{-1.f,  3.f, 0.f, 1.f};
+    }
+
+    if (sl_test_init_vertices(context, vaoId, vboId, verts, NUM_TRIS*3) != 0)
+    {
+        return -1;
+    }
+
+    SL_Mesh m;
+    m.elementBegin = 0;
+    m.elementEnd   = NUM_TRIS*3;
+    m.vaoId        = vaoId;
+    m.mode         = RENDER_MODE_TRIANGLES;
+
+    // Tiny bins must be flushed as soon as they fill up
+    context.bin_flush_policy(SL_BIN_FLUSH_ON_CAPACITY);
+    context.bin_capacity(2);
+    context.reset_bin_flush_stats();
+
+    if (draw_and_validate(context, m, shaderId, fboId, colorId) != 0)
+    {
+        retCode = -1;
+    }
+    else if (context.bin_flush_counts().numCapacityFlushes == 0 || context.bin_flush_counts().numCoverageFlushes != 0)
+    {
+        std::cerr << "Bins were not flushed when reaching capacity." << std::endl;
+        retCode = -1;
+    }
+
+    // Each thread covering a quarter of the screen should flush early
+    context.bin_flush_policy(SL_BIN_FLUSH_ADAPTIVE);
+    context.bin_capacity(0);
+    context.bin_coverage_limit(1.f);
+    context.reset_bin_flush_stats();
+
+    if (draw_and_validate(context, m, shaderId, fboId, colorId) != 0)
+    {
+        retCode = -1;
+    }
+    else if (context.bin_flush_counts().numCoverageFlushes == 0 || context.bin_flush_counts().numCapacityFlushes != 0)
+    {
+        std::cerr << "Bins were not flushed after covering the screen." << std::endl;
+        retCode = -1;
+    }
+
+    return retCode;
+}
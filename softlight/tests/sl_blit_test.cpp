@@ -0,0 +1,106 @@
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Texture.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Blit a floating-point checkerboard into 8-bit textures
+-----------------------------------------------------------------------------*/
+constexpr uint16_t SRC_SIZE = 64;
+constexpr uint16_t DST_SIZE = SRC_SIZE / 2;
+
+
+
+/*-------------------------------------
+ * Verify every texel of a blitted texture
+-------------------------------------*/
+template <typename expected_func>
+int verify_texels(const SL_Texture& tex, const char* pName, expected_func&& expected)
+{
+    for (uint16_t y = 0; y < tex.height(); ++y)
+    {
+        for (uint16_t x = 0; x < tex.width(); ++x)
+        {
+            const SL_ColorRGBA8 c = tex.texel<SL_ColorRGBA8>(x, y);
+            const SL_ColorRGBA8 e = expected(x, y);
+
+            if (c[0] != e[0] || c[1] != e[1] || c[2] != e[2] || c[3] != e[3])
+            {
+                std::cerr
+                    << pName << " blit produced (" << (unsigned)c[0] << ", " << (unsigned)c[1] << ", " << (unsigned)c[2] << ", " << (unsigned)c[3]
+                    << ") at (" << x << ", " << y << "), expected ("
+                    << (unsigned)e[0] << ", " << (unsigned)e[1] << ", " << (unsigned)e[2] << ", " << (unsigned)e[3] << ")." << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+int main()
+{
+    SL_Context context;
+    context.num_threads(4);
+
+    const size_t srcId     = context.create_texture();
+    const size_t nearestId = context.create_texture();
+    const size_t linearId  = context.create_texture();
+    const size_t boxId     = context.create_texture();
+
+    SL_Texture& src = context.texture(srcId);
+
+    if (src.init(SL_COLOR_RGBA_FLOAT, SRC_SIZE, SRC_SIZE, 1) != 0
+    || context.texture(nearestId).init(SL_COLOR_RGBA_8U, SRC_SIZE, SRC_SIZE, 1) != 0
+    || context.texture(linearId).init(SL_COLOR_RGBA_8U, DST_SIZE, DST_SIZE, 1) != 0
+    || context.texture(boxId).init(SL_COLOR_RGBA_8U, DST_SIZE, DST_SIZE, 1) != 0)
+    {
+        std::cerr << "Unable to initialize the blit textures." << std::endl;
+        return -1;
+    }
+
+    // Values outside of [0, 1] must saturate when converted to 8 bits.
+    for (uint16_t y = 0; y < SRC_SIZE; ++y)
+    {
+        for (uint16_t x = 0; x < SRC_SIZE; ++x)
+        {
+            const float c = ((x + y) & 1) ? 0.f : 1.f;
+            src.texel<math::vec4>(x, y) = math::vec4{c, c, c * 2.f, 1.f};
+        }
+    }
+
+    context.blit(nearestId, srcId);
+    context.blit(linearId, srcId, SL_BLIT_FILTER_BILINEAR);
+    context.blit(boxId, srcId, SL_BLIT_FILTER_BOX);
+
+    // Blits flip textures vertically
+    const auto&& nearest = [](uint16_t x, uint16_t y) noexcept->SL_ColorRGBA8
+    {
+        const uint8_t c = ((x + (SRC_SIZE - 1u - y)) & 1) ? 0 : 255;
+        return SL_ColorRGBA8{c, c, c, 255};
+    };
+
+    // Every filtered texel covers an equal amount of black and white texels
+    const auto&& filtered = [](uint16_t, uint16_t) noexcept->SL_ColorRGBA8
+    {
+        return SL_ColorRGBA8{127, 127, 255, 255};
+    };
+
+    if (verify_texels(context.texture(nearestId), "Nearest", nearest) != 0
+    || verify_texels(context.texture(linearId), "Bilinear", filtered) != 0
+    || verify_texels(context.texture(boxId), "Box", filtered) != 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+
+#include <cstdlib> // std::abs()
+#include <cstring> // std::memcmp()
+#include <iostream>
+
+#include "softlight/SL_ColorBlock.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test constants
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+// Dimensions which are not a multiple of the block size
+constexpr uint16_t TEST_TEX_WIDTH  = 61;
+constexpr uint16_t TEST_TEX_HEIGHT = 37;
+
+// Smooth gradients lose at most a few bits per channel
+constexpr int TEST_MAX_COLOR_ERROR = 16;
+constexpr int TEST_MAX_VALUE_ERROR = 4;
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Fill a texture with smooth gradients. Alpha crosses 128 halfway across.
+-----------------------------------------------------------------------------*/
+void fill_gradient(SL_Texture& tex)
+{
+    uint8_t* const pTexels = reinterpret_cast<uint8_t*>(tex.data());
+    const unsigned numChannels = tex.channels();
+
+    for (uint16_t y = 0; y < tex.height(); ++y)
+    {
+        for (uint16_t x = 0; x < tex.width(); ++x)
+        {
+            const uint8_t channels[4] = {
+                (uint8_t)(x * 4u),
+                (uint8_t)(y * 6u),
+                (uint8_t)((x + y) * 2u),
+                (uint8_t)(x * 255u / (tex.width() - 1u))
+            };
+
+            for (unsigned c = 0; c < numChannels; ++c)
+            {
+                pTexels[(x + tex.width() * y) * numChannels + c] = channels[c];
+            }
+        }
+    }
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Compare a compressed texture to its source and its decompressed texels
+-----------------------------------------------------------------------------*/
+template <typename block_type>
+int check_blocks(const SL_Texture& src, const SL_Texture& compressed, const SL_Texture& decompressed, int maxError)
+{
+    typedef typename block_type::color_type color_type;
+
+    const unsigned numChannels = src.channels();
+    const uint8_t* const pSrc = reinterpret_cast<const uint8_t*>(src.data());
+    const color_type* const pDecompressed = reinterpret_cast<const color_type*>(decompressed.data());
+
+    for (uint16_t y = 0; y < src.height(); ++y)
+    {
+        for (uint16_t x = 0; x < src.width(); ++x)
+        {
+            const color_type texel = sl_block_texel<block_type>(compressed.view(), x, y);
+            const uint8_t* const pTexel = reinterpret_cast<const uint8_t*>(&texel);
+
+            // Full-block decoding must match single-texel decoding exactly
+            if (std::memcmp(&texel, pDecompressed + x + src.width() * y, sizeof(color_type)) != 0)
+            {
+                std::cerr << "Mismatched block decoding at " << x << 'x' << y << '.' << std::endl;
+                return -1;
+            }
+
+            for (unsigned c = 0; c < numChannels; ++c)
+            {
+                const int expected = pSrc[(x + src.width() * y) * numChannels + c];
+                if (std::abs(expected - (int)pTexel[c]) > maxError)
+                {
+                    std::cerr << "Texel " << x << 'x' << y << ':' << c << " differs by " << std::abs(expected - (int)pTexel[c]) << '.' << std::endl;
+                    return -2;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Compress a texture, decompress it, and validate the results
+-----------------------------------------------------------------------------*/
+template <typename block_type>
+int test_format(SL_Context& context, SL_ColorDataType srcType, SL_ColorDataType blockType, int maxError)
+{
+    const size_t srcId = context.create_texture();
+    const size_t blockId = context.create_texture();
+    const size_t outId = context.create_texture();
+    int ret = 0;
+
+    SL_Texture& src = context.texture(srcId);
+    if (src.init(srcType, TEST_TEX_WIDTH, TEST_TEX_HEIGHT) != 0)
+    {
+        std::cerr << "Unable to initialize a source texture." << std::endl;
+        return -1;
+    }
+
+    fill_gradient(src);
+
+    if (context.compress_texture(blockId, srcId, blockType, SL_TexelOrder::ORDERED) != 0)
+    {
+        std::cerr << "Unable to compress a texture." << std::endl;
+        return -2;
+    }
+
+    if (context.decompress_texture(outId, blockId, SL_TexelOrder::ORDERED) != 0)
+    {
+        std::cerr << "Unable to decompress a texture." << std::endl;
+        return -3;
+    }
+
+    const SL_Texture& compressed = context.texture(blockId);
+    ret = check_blocks<block_type>(src, compressed, context.texture(outId), maxError);
+
+    // Serial compression must produce the same blocks as parallel compression
+    if (ret == 0 && blockType == sl_block_compressed_color_for(srcType))
+    {
+        SL_Texture serial = src;
+        const size_t numBlocks = ((TEST_TEX_WIDTH + 3u) / 4u) * ((TEST_TEX_HEIGHT + 3u) / 4u);
+
+        if (sl_texture_compress(serial, SL_TexelOrder::ORDERED) != 0
+        || serial.type() != blockType
+        || std::memcmp(serial.data(), compressed.data(), numBlocks * sizeof(block_type)) != 0)
+        {
+            std::cerr << "Serial compression does not match parallel compression." << std::endl;
+            ret = -4;
+        }
+    }
+
+    // Samplers decode the same texels
+    if (ret == 0)
+    {
+        const typename block_type::color_type nearest = sl_sample_nearest_block<block_type, SL_WrapMode::EDGE>(compressed, 0.5f, 0.5f);
+        const typename block_type::color_type expected = sl_block_texel<block_type>(compressed.view(), TEST_TEX_WIDTH/2, TEST_TEX_HEIGHT/2);
+
+        if (std::memcmp(&nearest, &expected, sizeof(nearest)) != 0)
+        {
+            std::cerr << "Invalid nearest-neighbor sample." << std::endl;
+            ret = -5;
+        }
+    }
+
+    context.destroy_texture(outId);
+    context.destroy_texture(blockId);
+    context.destroy_texture(srcId);
+
+    return ret;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * BC1 blocks with transparent texels use the 3-color palette
+-----------------------------------------------------------------------------*/
+int test_bc1_alpha()
+{
+    SL_ColorRGBA8 texels[16];
+    SL_ColorRGBA8 decoded[16];
+    SL_BlockBC1 block;
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        texels[i] = SL_ColorRGBA8{(uint8_t)(i * 16u), (uint8_t)128, (uint8_t)(255u - i * 16u), (uint8_t)((i & 1u) ? 255u : 0u)};
+    }
+
+    sl_encode_block(texels, block);
+    sl_decode_block(block, decoded);
+
+    if (block.color0 > block.color1)
+    {
+        std::cerr << "BC1 blocks with alpha must use the 3-color palette." << std::endl;
+        return -1;
+    }
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        if ((decoded[i].v[3] == 0) != (texels[i].v[3] == 0))
+        {
+            std::cerr << "Invalid BC1 alpha at texel " << i << '.' << std::endl;
+            return -2;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ *
+-----------------------------------------------------------------------------*/
+int main()
+{
+    SL_Context context;
+    context.num_threads(4);
+
+    int ret = test_bc1_alpha();
+
+    if (ret == 0)
+    {
+        ret = test_format<SL_BlockBC1>(context, SL_COLOR_RGB_8U, SL_COLOR_BC1, TEST_MAX_COLOR_ERROR);
+    }
+
+    if (ret == 0)
+    {
+        ret = test_format<SL_BlockBC3>(context, SL_COLOR_RGBA_8U, SL_COLOR_BC3, TEST_MAX_COLOR_ERROR);
+    }
+
+    if (ret == 0)
+    {
+        ret = test_format<SL_BlockBC4>(context, SL_COLOR_R_8U, SL_COLOR_BC4, TEST_MAX_VALUE_ERROR);
+    }
+
+    if (ret == 0)
+    {
+        ret = test_format<SL_BlockBC5>(context, SL_COLOR_RG_8U, SL_COLOR_BC5, TEST_MAX_VALUE_ERROR);
+    }
+
+    // Block-compressed textures can't be rendered to or mipmapped
+    if (ret == 0)
+    {
+        SL_Texture tex;
+        if (tex.init(SL_COLOR_BC1, TEST_TEX_WIDTH, TEST_TEX_HEIGHT) != 0 || tex.init_mips() == 0)
+        {
+            std::cerr << "Block-compressed textures should not support mips." << std::endl;
+            ret = -6;
+        }
+    }
+
+    if (ret == 0)
+    {
+        std::cout << "Block compression succeeded." << std::endl;
+    }
+
+    return ret;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <memory>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_CommandBuffer.hpp"
+#include "softlight/SL_CommandQueue.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_UniformBuffer.hpp"
+
+
+
+int main()
+{
+    constexpr uint16_t fboWidth  = 64;
+    constexpr uint16_t fboHeight = 48;
+    constexpr unsigned numFrames = 8;
+    int                retCode   = 0;
+
+    SL_Context context;
+    context.num_threads(2);
+
+    const size_t colorId = context.create_texture();
+    const size_t depthId = context.create_texture();
+    const size_t fboId   = context.create_framebuffer();
+    const size_t uboId   = context.create_ubo();
+
+    SL_Texture&     texColor = context.texture(colorId);
+    SL_Texture&     texDepth = context.texture(depthId);
+    SL_Framebuffer& fbo      = context.framebuffer(fboId);
+
+    if (texColor.init(SL_COLOR_R_FLOAT, fboWidth, fboHeight, 1) != 0
+    || texDepth.init(SL_COLOR_R_FLOAT, fboWidth, fboHeight, 1) != 0
+    || fbo.reserve_color_buffers(1) != 0
+    || fbo.attach_color_buffer(0, texColor.view()) != 0
+    || fbo.attach_depth_buffer(texDepth.view()) != 0)
+    {
+        std::cerr << "Unable to initialize a framebuffer." << std::endl;
+        return -1;
+    }
+
+    SL_CommandBuffer cmds;
+    std::shared_ptr<SL_Fence> fence;
+
+    for (unsigned i = 0; i < numFrames; ++i)
+    {
+        cmds.clear();
+        const double val = (double)i / (double)numFrames;
+        cmds.clear_framebuffer(fboId, 0, ls::math::vec4_t<double>{val, 0.0, 0.0, 1.0}, val);
+        cmds.update_uniforms<unsigned>(uboId, i);
+
+        // The recorded data is copied, allowing the command buffer to be reused
+        fence = context.submit(cmds);
+    }
+
+    fence->wait();
+
+    if (!fence->signaled())
+    {
+        std::cerr << "Fence was not signaled after waiting." << std::endl;
+        retCode = -1;
+    }
+
+    const float    lastColor = texColor.texel<float>(fboWidth-1, fboHeight-1);
+    const float    lastDepth = texDepth.texel<float>(0, 0);
+    const unsigned lastUbo   = *context.ubo(uboId).as<unsigned>();
+    const float    lastVal   = (float)(numFrames-1) / (float)numFrames;
+
+    if (lastColor != lastVal || lastDepth != lastVal || lastUbo != numFrames-1)
+    {
+        std::cerr << "Submissions executed out of order: " << lastColor << ", " << lastDepth << ", " << lastUbo << std::endl;
+        retCode = -1;
+    }
+
+    // Immediate commands must wait for all pending submissions
+    cmds.clear();
+    cmds.clear_color_buffer(fboId, 0, ls::math::vec4_t<double>{0.25, 0.0, 0.0, 1.0});
+    context.submit(cmds);
+    context.clear_color_buffer(fboId, 0, ls::math::vec4_t<double>{0.5, 0.0, 0.0, 1.0});
+
+    if (texColor.texel<float>(0, 0) != 0.5f)
+    {
+        std::cerr << "Immediate clear did not wait for pending submissions." << std::endl;
+        retCode = -1;
+    }
+
+    context.finish();
+
+    return retCode;
+}
@@ -0,0 +1,98 @@
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+
+
+int main()
+{
+    constexpr uint16_t fboWidth  = 96;
+    constexpr uint16_t fboHeight = 64;
+    int                retCode   = 0;
+
+    SL_Context context;
+    context.num_threads(4);
+
+    const size_t colorId  = context.create_texture();
+    const size_t depthId  = context.create_texture();
+    const size_t fboId    = context.create_framebuffer();
+    const size_t vaoId    = context.create_vao();
+    const size_t vboId    = context.create_vbo();
+
+    SL_FragmentShader fragShader = sl_test_frag_shader(SL_BLEND_ADDITIVE, SL_DEPTH_MASK_ON, SL_DEPTH_TEST_LESS_THAN);
+    fragShader.neverDiscards = true;
+
+    const size_t shaderId = context.create_shader(sl_test_vert_shader(), fragShader);
+
+    if (sl_test_init_framebuffer(context, fboId, colorId, depthId, fboWidth, fboHeight) != 0)
+    {
+        return -1;
+    }
+
+    const SL_Texture& texColor = context.texture(colorId);
+
+    // Two screen-covering triangles, drawn back-to-front, so every pixel
+    // would normally be shaded twice.
+    const math::vec4 verts[6] = {
+        {-1.f, -1.f, 0.5f, 1.f},
+        { 3.f, -1.f, 0.5f, 1.f},
+        {-1.f,  3.f, 0.5f, 1.f},
+
+        {-1.f, -1.f, -0.5f, 1.f},
+        { 3.f, -1.f, -0.5f, 1.f},
+        {-1.f,  3.f, -0.5f, 1.f}
+    };
+
+    if (sl_test_init_vertices(context, vaoId, vboId, verts, 6) != 0)
+    {
+        return -1;
+    }
+
+    SL_Mesh meshes[2];
+    meshes[0].elementBegin = 0;
+    meshes[0].elementEnd   = 3;
+    meshes[0].vaoId        = vaoId;
+    meshes[0].mode         = RENDER_MODE_TRIANGLES;
+
+    meshes[1]              = meshes[0];
+    meshes[1].elementBegin = 3;
+    meshes[1].elementEnd   = 6;
+
+    context.clear_framebuffer(fboId, 0, math::vec4_t<double>{0.0}, 1.0);
+    context.draw_prepassed(meshes, 2, shaderId, fboId);
+
+    for (uint16_t y = 0; y < fboHeight && retCode == 0; ++y)
+    {
+        for (uint16_t x = 0; x < fboWidth; ++x)
+        {
+            const float count = texColor.texel<float>(x, y);
+
+            if (count != 1.f)
+            {
+                std::cerr << "Pixel (" << x << ", " << y << ") was shaded " << count << " times." << std::endl;
+                retCode = -1;
+                break;
+            }
+        }
+    }
+
+    // The shader's own state must be left untouched
+    const SL_PipelineState& pipeline = context.shader(shaderId).pipelineState;
+    if (pipeline.depth_test() != SL_DEPTH_TEST_LESS_THAN || pipeline.depth_mask() != SL_DEPTH_MASK_ON)
+    {
+        std::cerr << "The prepass modified the shader's pipeline state." << std::endl;
+        retCode = -1;
+    }
+
+    return retCode;
+}
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <vector>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Draw many small meshes, of alternating render modes, in a single call
+-----------------------------------------------------------------------------*/
+constexpr uint16_t FBO_WIDTH  = 64;
+constexpr uint16_t FBO_HEIGHT = 48;
+constexpr unsigned NUM_TRIS   = 256;
+constexpr unsigned NUM_POINTS = 256;
+
+
+
+int main()
+{
+    SL_Context context;
+    context.num_threads(4);
+
+    const size_t colorId  = context.create_texture();
+    const size_t depthId  = context.create_texture();
+    const size_t fboId    = context.create_framebuffer();
+    const size_t vaoId    = context.create_vao();
+    const size_t vboId    = context.create_vbo();
+    const size_t shaderId = context.create_shader(sl_test_vert_shader(), sl_test_frag_shader(SL_BLEND_ADDITIVE, SL_DEPTH_MASK_OFF, SL_DEPTH_TEST_OFF));
+
+    if (sl_test_init_framebuffer(context, fboId, colorId, depthId, FBO_WIDTH, FBO_HEIGHT) != 0)
+    {
+        return -1;
+    }
+
+    const SL_Texture& texColor = context.texture(colorId);
+
+    // One triangle which covers the entire screen, followed by a set of
+    // points placed at pixel centers.
+    std::vector<math::vec4> verts;
+    verts.push_back(math::vec4{-1.f, -1.f, 0.f, 1.f});
+    verts.push_back(math::vec4{ 3.f, -1.f, 0.f, 1.f});
+    verts.push_back(math::vec4{-1.f,  3.f, 0.f, 1.f});
+
+    for (unsigned i = 0; i < NUM_POINTS; ++i)
+    {
+        const float x = ((float)(i % FBO_WIDTH) + 0.5f) / (float)FBO_WIDTH;
+        const float y = ((float)(i / FBO_WIDTH) + 0.5f) / (float)FBO_HEIGHT;
+        verts.push_back(math::vec4{x * 2.f - 1.f, y * 2.f - 1.f, 0.f, 1.f});
+    }
+
+    if (sl_test_init_vertices(context, vaoId, vboId, verts.data(), verts.size()) != 0)
+    {
+        return -1;
+    }
+
+    // Interleave triangle and point meshes
+    std::vector<SL_Mesh> meshes;
+
+    for (unsigned i = 0; i < NUM_TRIS + NUM_POINTS; ++i)
+    {
+        SL_Mesh m;
+        m.vaoId = vaoId;
+
+        if (i & 1u)
+        {
+            m.elementBegin = 3u + (i >> 1u);
+            m.elementEnd   = m.elementBegin + 1u;
+            m.mode         = RENDER_MODE_POINTS;
+        }
+        else
+        {
+            m.elementBegin = 0;
+            m.elementEnd   = 3;
+            m.mode         = RENDER_MODE_TRIANGLES;
+        }
+
+        meshes.push_back(m);
+    }
+
+    context.clear_color_buffer(fboId, 0, math::vec4_t<double>{0.0});
+    context.draw_multiple(meshes.data(), meshes.size(), shaderId, fboId);
+
+    double total = 0.0;
+
+    for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+        {
+            const float count = texColor.texel<float>(x, y);
+
+            if (count < (float)NUM_TRIS)
+            {
+                std::cerr << "Pixel (" << x << ", " << y << ") was shaded " << count << " times." << std::endl;
+                return -1;
+            }
+
+            total += count;
+        }
+    }
+
+    const double expected = (double)NUM_TRIS * (double)FBO_WIDTH * (double)FBO_HEIGHT + (double)NUM_POINTS;
+
+    if (total != expected)
+    {
+        std::cerr << "Invalid number of shaded fragments: " << total << " (expected " << expected << ")." << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
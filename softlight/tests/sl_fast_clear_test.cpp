@@ -0,0 +1,138 @@
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Draw into one corner of a fast-cleared framebuffer, then verify only the
+ * tiles which were rendered to are cleared until the framebuffer is
+ * resolved.
+-----------------------------------------------------------------------------*/
+constexpr uint16_t FBO_WIDTH   = 256;
+constexpr uint16_t FBO_HEIGHT  = 128;
+constexpr float    STALE_VALUE = 7.f;
+constexpr float    CLEAR_COLOR = 0.25f;
+constexpr float    CLEAR_DEPTH = 1.f;
+
+
+
+int main()
+{
+    SL_Context context;
+    context.num_threads(4);
+
+    const size_t colorId  = context.create_texture();
+    const size_t depthId  = context.create_texture();
+    const size_t fboId    = context.create_framebuffer();
+    const size_t vaoId    = context.create_vao();
+    const size_t vboId    = context.create_vbo();
+    const size_t shaderId = context.create_shader(sl_test_vert_shader(), sl_test_frag_shader(SL_BLEND_OFF, SL_DEPTH_MASK_OFF, SL_DEPTH_TEST_OFF));
+
+    SL_Texture&     texColor = context.texture(colorId);
+    SL_Texture&     texDepth = context.texture(depthId);
+    SL_Framebuffer& fbo      = context.framebuffer(fboId);
+
+    if (sl_test_init_framebuffer(context, fboId, colorId, depthId, FBO_WIDTH, FBO_HEIGHT) != 0
+    || fbo.fast_clears(true) != 0)
+    {
+        std::cerr << "Unable to enable fast clears." << std::endl;
+        return -1;
+    }
+
+    // A small triangle in the corner of the screen, within a single tile
+    const math::vec4 verts[] = {
+        math::vec4{-1.f,    -1.f,    0.f, 1.f},
+        math::vec4{-0.875f, -1.f,    0.f, 1.f},
+        math::vec4{-1.f,    -0.875f, 0.f, 1.f}
+    };
+
+    if (sl_test_init_vertices(context, vaoId, vboId, verts, 3) != 0)
+    {
+        return -1;
+    }
+
+    SL_Mesh m;
+    m.vaoId        = vaoId;
+    m.elementBegin = 0;
+    m.elementEnd   = 3;
+    m.mode         = RENDER_MODE_TRIANGLES;
+
+    for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+        {
+            texColor.texel<float>(x, y) = STALE_VALUE;
+            texDepth.texel<float>(x, y) = STALE_VALUE;
+        }
+    }
+
+    context.clear_framebuffer(fboId, 0, math::vec4_t<double>{CLEAR_COLOR}, CLEAR_DEPTH);
+    context.draw(m, shaderId, fboId);
+
+    // Tiles which were never rendered to retain their previous contents
+    unsigned numShaded = 0;
+
+    for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+        {
+            const float c = texColor.texel<float>(x, y);
+            const float d = texDepth.texel<float>(x, y);
+            const bool  inTile = x < SL_RASTER_TILE_SIZE;
+
+            if (c == 1.f)
+            {
+                ++numShaded;
+            }
+
+            if (!inTile && (c != STALE_VALUE || d != STALE_VALUE))
+            {
+                std::cerr << "Untouched pixel (" << x << ", " << y << ") was cleared before being resolved." << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    if (!numShaded)
+    {
+        std::cerr << "No pixels were rendered." << std::endl;
+        return -1;
+    }
+
+    // Every remaining pixel must now match the clear values
+    context.resolve_framebuffer(fboId);
+
+    for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+        {
+            const float c = texColor.texel<float>(x, y);
+            const float d = texDepth.texel<float>(x, y);
+
+            if ((c != CLEAR_COLOR && c != 1.f) || d != CLEAR_DEPTH)
+            {
+                std::cerr << "Pixel (" << x << ", " << y << ") was not cleared: " << c << ", " << d << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    if (fbo.get_fast_clears().pending())
+    {
+        std::cerr << "Clears are still pending after being resolved." << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
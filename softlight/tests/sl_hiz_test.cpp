@@ -0,0 +1,65 @@
+#include <iostream>
+#include <vector>
+
+#include "softlight/SL_HiZBuffer.hpp"
+#include "softlight/SL_ShaderUtil.hpp" // SL_DepthFunc*
+#include "softlight/SL_Texture.hpp"
+
+
+
+int main()
+{
+    constexpr uint16_t fboWidth  = 100;
+    constexpr uint16_t fboHeight = 70;
+    int                retCode   = 0;
+
+    std::vector<float> texels(fboWidth * fboHeight, 1.f);
+    SL_TextureView     depthBuf;
+    SL_HiZBuffer       hiZ;
+
+    sl_texture_view_from_buffer(depthBuf, fboWidth, fboHeight, 1, SL_COLOR_R_FLOAT, texels.data());
+
+    if (hiZ.init(fboWidth, fboHeight) != 0)
+    {
+        std::cerr << "Unable to initialize a depth hierarchy." << std::endl;
+        return -1;
+    }
+
+    std::cout << fboWidth << 'x' << fboHeight << " depth buffer contains " << hiZ.blocks_x() << 'x' << hiZ.blocks_y() << " blocks." << std::endl;
+
+    // Newly allocated hierarchies must never reject anything
+    if (SL_HiZRejectFunc<SL_DepthFuncLT>{}(1.f, 1.f, hiZ.block(0, 0)) || SL_HiZRejectFunc<SL_DepthFuncGT>{}(0.f, 0.f, hiZ.tile(0, 0)))
+    {
+        std::cerr << "Invalidated depth ranges rejected a primitive." << std::endl;
+        retCode = -1;
+    }
+
+    hiZ.clear(1.f);
+
+    // Place a single occluder in the block at (1, 1)
+    texels[9 + fboWidth * 10] = 0.25f;
+    hiZ.update_tile<float>(depthBuf, 0, 0, 0x01ull << (1 + 1 * (SL_RASTER_TILE_SIZE >> SL_HIZ_BLOCK_SHIFT)));
+
+    const SL_DepthRange& occluded = hiZ.block(1, 1);
+    const SL_DepthRange& tile     = hiZ.tile(0, 0);
+
+    if (occluded.minDepth != 0.25f || occluded.maxDepth != 1.f || tile.minDepth != 0.25f || tile.maxDepth != 1.f)
+    {
+        std::cerr << "Invalid depth range after update: [" << occluded.minDepth << ", " << occluded.maxDepth << ']' << std::endl;
+        retCode = -1;
+    }
+
+    if (!SL_HiZRejectFunc<SL_DepthFuncLT>{}(1.f, 1.f, hiZ.block(0, 0)) || SL_HiZRejectFunc<SL_DepthFuncLT>{}(0.5f, 1.f, occluded))
+    {
+        std::cerr << "Invalid less-than rejection test." << std::endl;
+        retCode = -1;
+    }
+
+    if (!SL_HiZRejectFunc<SL_DepthFuncGT>{}(0.25f, 1.f, hiZ.block(0, 0)) || SL_HiZRejectFunc<SL_DepthFuncNE>{}(1.f, 1.f, hiZ.block(0, 0)))
+    {
+        std::cerr << "Invalid greater-than rejection test." << std::endl;
+        retCode = -1;
+    }
+
+    return retCode;
+}
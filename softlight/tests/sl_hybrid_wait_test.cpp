@@ -0,0 +1,54 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include "softlight/SL_HybridWait.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Pass a counter back and forth between two threads, forcing both to park
+ * on every exchange.
+-----------------------------------------------------------------------------*/
+int main()
+{
+    constexpr unsigned numExchanges = 1000;
+
+    SL_HybridWait         waitSignal;
+    std::atomic<unsigned> counter{0};
+
+    std::thread worker{[&]() noexcept -> void
+    {
+        for (unsigned i = 1; i < numExchanges*2u; i += 2u)
+        {
+            waitSignal.wait([&]() noexcept -> bool
+            {
+                return counter.load(std::memory_order_acquire) != i;
+            }, 0);
+
+            counter.store(i+1u, std::memory_order_release);
+            waitSignal.notify_all();
+        }
+    }};
+
+    for (unsigned i = 0; i < numExchanges*2u; i += 2u)
+    {
+        counter.store(i+1u, std::memory_order_release);
+        waitSignal.notify_all();
+
+        waitSignal.wait([&]() noexcept -> bool
+        {
+            return counter.load(std::memory_order_acquire) != i+2u;
+        }, 0);
+    }
+
+    worker.join();
+
+    if (counter.load() != numExchanges*2u)
+    {
+        std::cerr << "Invalid counter value: " << counter.load() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Sampler.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+int main()
+{
+    constexpr uint16_t texWidth  = 64;
+    constexpr uint16_t texHeight = 32;
+    int                retCode   = 0;
+
+    SL_Context  context;
+    context.num_threads(4);
+
+    const std::size_t texId = context.create_texture();
+    SL_Texture&       tex   = context.texture(texId);
+
+    if (tex.init(SL_COLOR_R_FLOAT, texWidth, texHeight) != 0)
+    {
+        std::cerr << "Unable to initialize a texture." << std::endl;
+        return -1;
+    }
+
+    // Alternating columns of 0 and 1 should average to 0.5 in every mip
+    SL_ColorRType<float>* const pTexels = reinterpret_cast<SL_ColorRType<float>*>(tex.data());
+    for (uint16_t y = 0; y < texHeight; ++y)
+    {
+        for (uint16_t x = 0; x < texWidth; ++x)
+        {
+            pTexels[x + texWidth * y] = SL_ColorRType<float>{(x & 1u) ? 1.f : 0.f};
+        }
+    }
+
+    if (context.generate_mips(texId, SL_MIP_FILTER_BOX, SL_TexelOrder::ORDERED) != 0)
+    {
+        std::cerr << "Unable to generate a mip chain." << std::endl;
+        return -1;
+    }
+
+    if (tex.num_mips() != sl_calc_mip_levels(texWidth, texHeight))
+    {
+        std::cerr << "Invalid number of mip levels: " << tex.num_mips() << std::endl;
+        retCode = -1;
+    }
+
+    for (uint16_t level = 1; level < tex.num_mips(); ++level)
+    {
+        const SL_TextureView& mip = tex.mip(level);
+        const float           val = reinterpret_cast<const SL_ColorRType<float>*>(mip.pTexels)[0].r;
+
+        std::cout << "Mip " << level << ": " << mip.width << 'x' << mip.height << " = " << val << std::endl;
+
+        if (val != 0.5f)
+        {
+            std::cerr << "Invalid box-filtered texel at level " << level << '.' << std::endl;
+            retCode = -1;
+        }
+    }
+
+    // A texel footprint of 4x4 texels should select the third level
+    const float lod = sl_calc_mip_lod(tex, 4.f/texWidth, 0.f, 0.f, 4.f/texHeight);
+    if (lod != 2.f)
+    {
+        std::cerr << "Invalid level-of-detail: " << lod << std::endl;
+        retCode = -1;
+    }
+
+    const float sample = sl_sample_mipmap<SL_ColorRType<float>, SL_WrapMode::EDGE>(tex, 0.5f, 0.5f, lod).r;
+    if (sample != 0.5f)
+    {
+        std::cerr << "Invalid trilinear sample: " << sample << std::endl;
+        retCode = -1;
+    }
+
+    return retCode;
+}
@@ -0,0 +1,151 @@
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Draw a triangle with a diagonal edge into a multisampled framebuffer, then
+ * verify that pixels along the edge are partially covered once the samples
+ * have been resolved.
+-----------------------------------------------------------------------------*/
+constexpr uint16_t FBO_WIDTH   = 128;
+constexpr uint16_t FBO_HEIGHT  = 128;
+constexpr uint16_t FBO_SAMPLES = 4;
+
+
+
+int main()
+{
+    SL_Context context;
+    context.num_threads(4);
+
+    const size_t colorId   = context.create_texture();
+    const size_t depthId   = context.create_texture();
+    const size_t resolveId = context.create_texture();
+    const size_t fboId     = context.create_framebuffer();
+    const size_t vaoId     = context.create_vao();
+    const size_t vboId     = context.create_vbo();
+    const size_t shaderId  = context.create_shader(sl_test_vert_shader(), sl_test_frag_shader(SL_BLEND_OFF, SL_DEPTH_MASK_ON, SL_DEPTH_TEST_LESS_THAN));
+
+    SL_Texture&     texColor   = context.texture(colorId);
+    SL_Texture&     texDepth   = context.texture(depthId);
+    SL_Texture&     texResolve = context.texture(resolveId);
+    SL_Framebuffer& fbo        = context.framebuffer(fboId);
+
+    if (sl_test_init_framebuffer(context, fboId, colorId, depthId, FBO_WIDTH, FBO_HEIGHT, FBO_SAMPLES) != 0
+    || texResolve.init(SL_COLOR_R_FLOAT, FBO_WIDTH, FBO_HEIGHT, 1) != 0
+    || fbo.valid() != 0)
+    {
+        std::cerr << "Unable to initialize a multisampled framebuffer." << std::endl;
+        return -1;
+    }
+
+    if (fbo.num_samples() != FBO_SAMPLES)
+    {
+        std::cerr << "Invalid sample count: " << fbo.num_samples() << std::endl;
+        return -1;
+    }
+
+    // The lower-left half of the screen
+    const math::vec4 verts[] = {
+        math::vec4{-1.f, -1.f, 0.f, 1.f},
+        math::vec4{ 1.f, -1.f, 0.f, 1.f},
+        math::vec4{-1.f,  1.f, 0.f, 1.f}
+    };
+
+    if (sl_test_init_vertices(context, vaoId, vboId, verts, 3) != 0)
+    {
+        return -1;
+    }
+
+    SL_Mesh m;
+    m.vaoId        = vaoId;
+    m.elementBegin = 0;
+    m.elementEnd   = 3;
+    m.mode         = RENDER_MODE_TRIANGLES;
+
+    context.clear_framebuffer(fboId, 0, math::vec4_t<double>{0.0}, 1.0);
+    context.draw(m, shaderId, fboId);
+
+    if (context.resolve_samples(fboId, 0, resolveId) != 0)
+    {
+        std::cerr << "Unable to resolve a multisampled framebuffer." << std::endl;
+        return -1;
+    }
+
+    unsigned numFull    = 0;
+    unsigned numPartial = 0;
+    unsigned numEmpty   = 0;
+
+    for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+        {
+            const float c = texResolve.texel<float>(x, y);
+
+            if (c < 0.f || c > 1.f)
+            {
+                std::cerr << "Resolved pixel (" << x << ", " << y << ") is out of range: " << c << std::endl;
+                return -1;
+            }
+
+            // Pixels far from the diagonal edge are either fully inside or
+            // fully outside the triangle.
+            const int dist = (int)x + (int)y - (int)FBO_WIDTH;
+
+            if (dist < -2 && c != 1.f)
+            {
+                std::cerr << "Interior pixel (" << x << ", " << y << ") is not fully covered: " << c << std::endl;
+                return -1;
+            }
+
+            if (dist > 2 && c != 0.f)
+            {
+                std::cerr << "Exterior pixel (" << x << ", " << y << ") was rendered: " << c << std::endl;
+                return -1;
+            }
+
+            numFull    += c == 1.f;
+            numEmpty   += c == 0.f;
+            numPartial += c > 0.f && c < 1.f;
+        }
+    }
+
+    if (!numFull || !numEmpty || !numPartial)
+    {
+        std::cerr << "Edges were not anti-aliased: " << numFull << " full, " << numPartial << " partial, " << numEmpty << " empty." << std::endl;
+        return -1;
+    }
+
+    // Every covered sample must have been written to the depth buffer
+    for (uint16_t s = 0; s < FBO_SAMPLES; ++s)
+    {
+        for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+        {
+            for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+            {
+                const float c = texColor.texel<float>(x, y, s);
+                const float d = texDepth.texel<float>(x, y, s);
+
+                if ((c == 1.f) == (d == 1.f))
+                {
+                    std::cerr << "Sample " << s << " of pixel (" << x << ", " << y << ") has mismatched color and depth: " << c << ", " << d << std::endl;
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
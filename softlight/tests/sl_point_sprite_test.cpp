@@ -0,0 +1,101 @@
+#include <iostream>
+#include <vector>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+constexpr uint16_t FBO_WIDTH  = 64;
+constexpr uint16_t FBO_HEIGHT = 48;
+constexpr unsigned POINT_SIZE = 3;
+constexpr unsigned POINT_STEP = 4;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Draw a grid of non-overlapping point sprites and verify each one covers
+ * exactly POINT_SIZE * POINT_SIZE pixels.
+-----------------------------------------------------------------------------*/
+int main()
+{
+    SL_Context context;
+    context.num_threads(4);
+
+    const size_t colorId  = context.create_texture();
+    const size_t depthId  = context.create_texture();
+    const size_t fboId    = context.create_framebuffer();
+    const size_t vaoId    = context.create_vao();
+    const size_t vboId    = context.create_vbo();
+    const size_t shaderId = context.create_shader(sl_test_vert_shader((float)POINT_SIZE), sl_test_frag_shader(SL_BLEND_ADDITIVE, SL_DEPTH_MASK_OFF, SL_DEPTH_TEST_OFF));
+
+    if (sl_test_init_framebuffer(context, fboId, colorId, depthId, FBO_WIDTH, FBO_HEIGHT) != 0)
+    {
+        return -1;
+    }
+
+    const SL_Texture& texColor = context.texture(colorId);
+
+    // Sprites are centered on pixels so each one spans a single pixel in
+    // every direction around its center.
+    std::vector<math::vec4> verts;
+
+    for (unsigned y = 1; y + 1 < FBO_HEIGHT; y += POINT_STEP)
+    {
+        for (unsigned x = 1; x + 1 < FBO_WIDTH; x += POINT_STEP)
+        {
+            const float px = ((float)x + 0.5f) / (float)FBO_WIDTH;
+            const float py = ((float)y + 0.5f) / (float)FBO_HEIGHT;
+            verts.push_back(math::vec4{px * 2.f - 1.f, py * 2.f - 1.f, 0.f, 1.f});
+        }
+    }
+
+    if (sl_test_init_vertices(context, vaoId, vboId, verts.data(), verts.size()) != 0)
+    {
+        return -1;
+    }
+
+    SL_Mesh m;
+    m.vaoId        = vaoId;
+    m.elementBegin = 0;
+    m.elementEnd   = verts.size();
+    m.mode         = RENDER_MODE_POINTS;
+
+    context.clear_color_buffer(fboId, 0, math::vec4_t<double>{0.0});
+    context.draw(m, shaderId, fboId);
+
+    double total = 0.0;
+
+    for (uint16_t y = 0; y < FBO_HEIGHT; ++y)
+    {
+        for (uint16_t x = 0; x < FBO_WIDTH; ++x)
+        {
+            const float count = texColor.texel<float>(x, y);
+
+            if (count > 1.f)
+            {
+                std::cerr << "Pixel (" << x << ", " << y << ") was shaded " << count << " times." << std::endl;
+                return -1;
+            }
+
+            total += count;
+        }
+    }
+
+    const double expected = (double)verts.size() * (double)(POINT_SIZE * POINT_SIZE);
+
+    if (total != expected)
+    {
+        std::cerr << "Invalid number of shaded fragments: " << total << " (expected " << expected << ")." << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+
+#include <cstring> // std::memcmp()
+#include <fstream>
+#include <iostream>
+
+#include "lightsky/utils/Pointer.h"
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_ImgFilePPM.hpp"
+#include "softlight/SL_Texture.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Test constants
+-----------------------------------------------------------------------------*/
+namespace
+{
+
+// Dimensions which are not a multiple of the swizzled chunk size
+constexpr sl_lowp_t TEST_IMG_WIDTH  = 67;
+constexpr sl_lowp_t TEST_IMG_HEIGHT = 29;
+
+constexpr char TEST_IMG_PATH[]       = "sl_ppm_loader_test.ppm";
+constexpr char TEST_TRUNCATED_PATH[] = "sl_ppm_loader_test_truncated.ppm";
+
+} // end anonymous namespace
+
+
+
+/*-----------------------------------------------------------------------------
+ * Compare a texture's texels to the image it was loaded from
+-----------------------------------------------------------------------------*/
+template <SL_TexelOrder order>
+int check_texels(const SL_Texture& tex, const SL_ColorRGB8* pImg)
+{
+    if (tex.width() != TEST_IMG_WIDTH || tex.height() != TEST_IMG_HEIGHT || tex.type() != SL_COLOR_RGB_8U)
+    {
+        std::cerr << "Invalid texture dimensions or type." << std::endl;
+        return -1;
+    }
+
+    const SL_ColorRGB8* const pTexels = reinterpret_cast<const SL_ColorRGB8*>(tex.data());
+
+    for (sl_lowp_t y = 0; y < TEST_IMG_HEIGHT; ++y)
+    {
+        for (sl_lowp_t x = 0; x < TEST_IMG_WIDTH; ++x)
+        {
+            const SL_ColorRGB8& expected = pImg[x + TEST_IMG_WIDTH * y];
+            const SL_ColorRGB8& texel = pTexels[sl_texel_index<order>(tex.view(), (uint_fast32_t)x, (uint_fast32_t)y)];
+
+            if (std::memcmp(&expected, &texel, sizeof(SL_ColorRGB8)) != 0)
+            {
+                std::cerr << "Mismatched texel at " << x << 'x' << y << '.' << std::endl;
+                return -2;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ *
+-----------------------------------------------------------------------------*/
+int main()
+{
+    ls::utils::Pointer<SL_ColorRGB8[]> img{new SL_ColorRGB8[TEST_IMG_WIDTH * TEST_IMG_HEIGHT]};
+
+    for (sl_lowp_t y = 0; y < TEST_IMG_HEIGHT; ++y)
+    {
+        for (sl_lowp_t x = 0; x < TEST_IMG_WIDTH; ++x)
+        {
+            img[x + TEST_IMG_WIDTH * y] = SL_ColorRGB8{(uint8_t)(x * 3), (uint8_t)(y * 7), (uint8_t)(x ^ y)};
+        }
+    }
+
+    if (sl_img_save_ppm(TEST_IMG_WIDTH, TEST_IMG_HEIGHT, img.get(), TEST_IMG_PATH) != 0)
+    {
+        std::cerr << "Unable to save a PPM image." << std::endl;
+        return -1;
+    }
+
+    if (!sl_img_is_ppm(TEST_IMG_PATH))
+    {
+        std::cerr << "PPM file extension not detected." << std::endl;
+        return -2;
+    }
+
+    // Decoding directly into a texture must match the saved image in both
+    // texel orders.
+    SL_Texture tex;
+
+    if (sl_img_load_ppm(tex, TEST_IMG_PATH, SL_TexelOrder::ORDERED) != 0
+    || check_texels<SL_TexelOrder::ORDERED>(tex, img.get()) != 0)
+    {
+        std::cerr << "Unable to decode a PPM image into an ordered texture." << std::endl;
+        return -3;
+    }
+
+    if (sl_img_load_ppm(tex, TEST_IMG_PATH, SL_TexelOrder::SWIZZLED) != 0
+    || check_texels<SL_TexelOrder::SWIZZLED>(tex, img.get()) != 0)
+    {
+        std::cerr << "Unable to decode a PPM image into a swizzled texture." << std::endl;
+        return -4;
+    }
+
+    // Failed loads leave the texture unmodified
+    std::ofstream truncated{TEST_TRUNCATED_PATH, std::ofstream::out | std::ofstream::binary};
+    truncated << "P6\n" << TEST_IMG_WIDTH << ' ' << TEST_IMG_HEIGHT << "\n255\n";
+    truncated.write(reinterpret_cast<const char*>(img.get()), 16);
+    truncated.close();
+
+    if (sl_img_load_ppm(tex, TEST_TRUNCATED_PATH) != -3
+    || sl_img_load_ppm(tex, "sl_ppm_loader_test_missing.ppm") != -1
+    || check_texels<SL_TexelOrder::SWIZZLED>(tex, img.get()) != 0)
+    {
+        std::cerr << "Invalid PPM files were not rejected." << std::endl;
+        return -5;
+    }
+
+    std::cout << "PPM loading succeeded." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_ShaderUtil.hpp"
+#include "softlight/SL_Texture.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Alpha-tested shader which discards a checkerboard of 4x4 pixel cells
+-----------------------------------------------------------------------------*/
+inline bool _sl_is_discarded(uint16_t x, uint16_t y)
+{
+    return (((x >> 2) ^ (y >> 2)) & 1) != 0;
+}
+
+
+
+bool _sl_discard_frag_shader(SL_FragmentParam& fragParam)
+{
+    if (_sl_is_discarded(fragParam.coord.x, fragParam.coord.y))
+    {
+        return false;
+    }
+
+    fragParam.pOutputs[0] = math::vec4{1.f};
+    return true;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ *
+-----------------------------------------------------------------------------*/
+int main()
+{
+    constexpr uint16_t fboWidth  = 96;
+    constexpr uint16_t fboHeight = 64;
+    int                retCode   = 0;
+
+    SL_Context context;
+    context.num_threads(4);
+
+    SL_FragmentShader fragShader = sl_test_frag_shader(SL_BLEND_ADDITIVE, SL_DEPTH_MASK_ON, SL_DEPTH_TEST_LESS_THAN);
+    fragShader.shader = _sl_discard_frag_shader;
+
+    const size_t colorId  = context.create_texture();
+    const size_t depthId  = context.create_texture();
+    const size_t fboId    = context.create_framebuffer();
+    const size_t vaoId    = context.create_vao();
+    const size_t vboId    = context.create_vbo();
+    const size_t shaderId = context.create_shader(sl_test_vert_shader(), fragShader);
+
+    if (sl_test_init_framebuffer(context, fboId, colorId, depthId, fboWidth, fboHeight) != 0)
+    {
+        return -1;
+    }
+
+    const SL_Texture& texColor = context.texture(colorId);
+
+    // Two screen-covering triangles, drawn back-to-front. The far triangle
+    // must remain visible through the holes of the near one.
+    const math::vec4 verts[6] = {
+        {-1.f, -1.f, 0.5f, 1.f},
+        { 3.f, -1.f, 0.5f, 1.f},
+        {-1.f,  3.f, 0.5f, 1.f},
+
+        {-1.f, -1.f, -0.5f, 1.f},
+        { 3.f, -1.f, -0.5f, 1.f},
+        {-1.f,  3.f, -0.5f, 1.f}
+    };
+
+    if (sl_test_init_vertices(context, vaoId, vboId, verts, 6) != 0)
+    {
+        return -1;
+    }
+
+    SL_Mesh meshes[2];
+    meshes[0].elementBegin = 0;
+    meshes[0].elementEnd   = 3;
+    meshes[0].vaoId        = vaoId;
+    meshes[0].mode         = RENDER_MODE_TRIANGLES;
+
+    meshes[1]              = meshes[0];
+    meshes[1].elementBegin = 3;
+    meshes[1].elementEnd   = 6;
+
+    context.clear_framebuffer(fboId, 0, math::vec4_t<double>{0.0}, 1.0);
+    context.draw_prepassed(meshes, 2, shaderId, fboId);
+
+    for (uint16_t y = 0; y < fboHeight && retCode == 0; ++y)
+    {
+        for (uint16_t x = 0; x < fboWidth; ++x)
+        {
+            const float count    = texColor.texel<float>(x, y);
+            const float expected = _sl_is_discarded(x, y) ? 1.f : 2.f;
+
+            if (count != expected)
+            {
+                std::cerr << "Pixel (" << x << ", " << y << ") was shaded " << count << " times, expected " << expected << '.' << std::endl;
+                retCode = -1;
+                break;
+            }
+        }
+    }
+
+    return retCode;
+}
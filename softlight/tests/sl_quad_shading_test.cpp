@@ -0,0 +1,167 @@
+#include <iostream>
+
+#include "lightsky/math/vec2.h"
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_Shader.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shader which outputs the screen-space derivatives of its texture coordinates
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Vertex Shader
+--------------------------------------*/
+math::vec4 _quad_vert_shader_impl(SL_VertexParam& param)
+{
+    const math::vec4& pos = *(param.pVbo->element<const math::vec4>(param.pVao->offset(0, param.vertId)));
+
+    // Texture coordinates span [0, 1] across the visible screen
+    param.pVaryings[0] = math::vec4{pos[0]*0.5f + 0.5f, pos[1]*0.5f + 0.5f, 0.f, 0.f};
+
+    return pos;
+}
+
+
+
+SL_VertexShader quad_vert_shader()
+{
+    SL_VertexShader shader;
+    shader.numVaryings = 1;
+    shader.cullMode    = SL_CULL_OFF;
+    shader.shader      = _quad_vert_shader_impl;
+
+    return shader;
+}
+
+
+
+/*--------------------------------------
+ * Fragment Shader
+--------------------------------------*/
+bool _quad_frag_shader_impl(SL_FragmentParam&)
+{
+    return false;
+}
+
+
+
+uint32_t _quad_frag_shader_quads(SL_FragmentQuadParam& quadParam)
+{
+    for (unsigned l = 0; l < 4; ++l)
+    {
+        const math::vec4&& dUVdx = quadParam.dFdx(0, l);
+        const math::vec4&& dUVdy = quadParam.dFdy(0, l);
+
+        quadParam.pOutputs[l][0] = math::vec4{dUVdx[0], dUVdy[1], 0.f, 1.f};
+    }
+
+    return quadParam.laneMask;
+}
+
+
+
+SL_FragmentShader quad_frag_shader()
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 1;
+    shader.numOutputs  = 1;
+    shader.blend       = SL_BLEND_OFF;
+    shader.depthMask   = SL_DEPTH_MASK_OFF;
+    shader.depthTest   = SL_DEPTH_TEST_OFF;
+    shader.shader      = _quad_frag_shader_impl;
+    shader.quadShader  = _quad_frag_shader_quads;
+
+    return shader;
+}
+
+
+
+int main()
+{
+    constexpr uint16_t fboWidth  = 64;
+    constexpr uint16_t fboHeight = 48;
+    int                retCode   = 0;
+
+    SL_Context context;
+    context.num_threads(3);
+
+    const size_t colorId  = context.create_texture();
+    const size_t depthId  = context.create_texture();
+    const size_t fboId    = context.create_framebuffer();
+    const size_t vaoId    = context.create_vao();
+    const size_t vboId    = context.create_vbo();
+    const size_t shaderId = context.create_shader(quad_vert_shader(), quad_frag_shader());
+
+    SL_Texture&     texColor = context.texture(colorId);
+    SL_Texture&     texDepth = context.texture(depthId);
+    SL_Framebuffer& fbo      = context.framebuffer(fboId);
+
+    if (texColor.init(SL_COLOR_RG_FLOAT, fboWidth, fboHeight, 1) != 0
+    || texDepth.init(SL_COLOR_R_FLOAT, fboWidth, fboHeight, 1) != 0
+    || fbo.reserve_color_buffers(1) != 0
+    || fbo.attach_color_buffer(0, texColor.view()) != 0
+    || fbo.attach_depth_buffer(texDepth.view()) != 0)
+    {
+        std::cerr << "Unable to initialize a framebuffer." << std::endl;
+        return -1;
+    }
+
+    // A single triangle which covers the entire screen
+    const math::vec4 verts[3] = {
+        {-1.f, -1.f, 0.f, 1.f},
+        { 3.f, -1.f, 0.f, 1.f},
+        {-1.f,  3.f, 0.f, 1.f}
+    };
+
+    SL_VertexBuffer& vbo = context.vbo(vboId);
+    if (vbo.init(sizeof(verts)) != 0)
+    {
+        std::cerr << "Unable to initialize a vertex buffer." << std::endl;
+        return -1;
+    }
+    vbo.assign(verts, 0, sizeof(verts));
+
+    SL_VertexArray& vao = context.vao(vaoId);
+    vao.set_vertex_buffer(vboId);
+    vao.set_num_bindings(1);
+    vao.set_binding(0, 0, sizeof(math::vec4), SL_Dimension::VERTEX_DIMENSION_4, SL_DataType::VERTEX_DATA_FLOAT);
+
+    SL_Mesh m;
+    m.elementBegin = 0;
+    m.elementEnd   = 3;
+    m.vaoId        = vaoId;
+    m.mode         = RENDER_MODE_TRIANGLES;
+
+    context.clear_color_buffer(fboId, 0, math::vec4_t<double>{-1.0});
+    context.draw(m, shaderId, fboId);
+
+    const float expectedX = 1.f / (float)fboWidth;
+    const float expectedY = 1.f / (float)fboHeight;
+
+    for (uint16_t y = 0; y < fboHeight && retCode == 0; ++y)
+    {
+        for (uint16_t x = 0; x < fboWidth; ++x)
+        {
+            const math::vec2& texel = texColor.texel<math::vec2>(x, y);
+
+            if (math::abs(texel[0] - expectedX) > 1e-4f || math::abs(math::abs(texel[1]) - expectedY) > 1e-4f)
+            {
+                std::cerr << "Invalid derivative at (" << x << ", " << y << "): " << texel[0] << ", " << texel[1] << std::endl;
+                retCode = -1;
+                break;
+            }
+        }
+    }
+
+    return retCode;
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+
+#include "softlight/SL_ShaderUtil.hpp" // sl_raster_tile_owner()
+
+
+
+int main()
+{
+    constexpr int numThreads = 7;
+    constexpr int fboWidth   = 1280;
+    constexpr int fboHeight  = 720;
+    const int     tilesX     = sl_num_raster_tiles<int>(fboWidth);
+    const int     tilesY     = sl_num_raster_tiles<int>(fboHeight);
+    int           retCode    = 0;
+
+    std::cout << fboWidth << 'x' << fboHeight << " framebuffer contains " << tilesX << 'x' << tilesY << " tiles:";
+
+    for (int ty = 0; ty < tilesY; ++ty)
+    {
+        std::cout << "\n\t";
+
+        for (int tx = 0; tx < tilesX; ++tx)
+        {
+            const int owner = sl_raster_tile_owner<int>(tx, ty, tilesX, numThreads);
+            std::cout << owner << ' ';
+
+            // Every thread must agree on which tiles it owns
+            for (int t = 0; t < numThreads; ++t)
+            {
+                const int offset = sl_raster_tile_offset<int>(tx, ty, tilesX, numThreads, t);
+                const int nextOwner = sl_raster_tile_owner<int>(tx+offset, ty, tilesX, numThreads);
+
+                if (nextOwner != t || (offset == 0) != (owner == t))
+                {
+                    std::cerr << "\nInvalid tile offset for thread " << t << " at tile (" << tx << ", " << ty << "): " << offset << std::endl;
+                    retCode = -1;
+                }
+            }
+        }
+    }
+
+    std::cout << std::endl;
+
+    return retCode;
+}
@@ -0,0 +1,164 @@
+
+#include <cstdio> // std::remove()
+#include <cstring> // std::memcmp()
+#include <iostream>
+
+#include "softlight/SL_Animation.hpp"
+#include "softlight/SL_AnimationChannel.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_IndexBuffer.hpp"
+#include "softlight/SL_Mesh.hpp"
+#include "softlight/SL_SceneFileCache.hpp"
+#include "softlight/SL_SceneFileLoader.hpp"
+#include "softlight/SL_SceneGraph.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Compare two scene graphs
+-----------------------------------------------------------------------------*/
+int compare_scenes(const SL_SceneGraph& a, const SL_SceneGraph& b)
+{
+    if (a.mNodes.size() != b.mNodes.size()
+    || a.mMeshes.size() != b.mMeshes.size()
+    || a.mMaterials.size() != b.mMaterials.size()
+    || a.mCameras.size() != b.mCameras.size()
+    || a.mBoneOffsets.size() != b.mBoneOffsets.size()
+    || a.mAnimations.size() != b.mAnimations.size()
+    || a.mNodeAnims.size() != b.mNodeAnims.size()
+    || a.mContext.textures().size() != b.mContext.textures().size())
+    {
+        std::cerr << "Mismatched scene sizes." << std::endl;
+        return -1;
+    }
+
+    for (size_t i = 0; i < a.mNodes.size(); ++i)
+    {
+        if (a.mNodes[i].type != b.mNodes[i].type
+        || a.mNodes[i].dataId != b.mNodes[i].dataId
+        || a.mNodeParentIds[i] != b.mNodeParentIds[i]
+        || a.mNodeNames[i] != b.mNodeNames[i])
+        {
+            std::cerr << "Mismatched node " << i << '.' << std::endl;
+            return -2;
+        }
+    }
+
+    for (size_t i = 0; i < a.mMeshes.size(); ++i)
+    {
+        if (a.mMeshes[i].vaoId != b.mMeshes[i].vaoId
+        || a.mMeshes[i].elementBegin != b.mMeshes[i].elementBegin
+        || a.mMeshes[i].elementEnd != b.mMeshes[i].elementEnd)
+        {
+            std::cerr << "Mismatched mesh " << i << '.' << std::endl;
+            return -3;
+        }
+    }
+
+    const SL_AlignedVector<SL_VertexBuffer>& vbosA = a.mContext.vbos();
+    const SL_AlignedVector<SL_VertexBuffer>& vbosB = b.mContext.vbos();
+    for (size_t i = 0; i < vbosA.size(); ++i)
+    {
+        if (vbosA[i].num_bytes() != vbosB[i].num_bytes()
+        || std::memcmp(vbosA[i].data(), vbosB[i].data(), vbosA[i].num_bytes()) != 0)
+        {
+            std::cerr << "Mismatched VBO " << i << '.' << std::endl;
+            return -4;
+        }
+    }
+
+    const SL_AlignedVector<SL_IndexBuffer>& ibosA = a.mContext.ibos();
+    const SL_AlignedVector<SL_IndexBuffer>& ibosB = b.mContext.ibos();
+    for (size_t i = 0; i < ibosA.size(); ++i)
+    {
+        if (ibosA[i].count() != ibosB[i].count()
+        || ibosA[i].type() != ibosB[i].type()
+        || std::memcmp(ibosA[i].data(), ibosB[i].data(), ibosA[i].num_bytes()) != 0)
+        {
+            std::cerr << "Mismatched IBO " << i << '.' << std::endl;
+            return -5;
+        }
+    }
+
+    for (size_t i = 0; i < a.mNodeAnims.size(); ++i)
+    {
+        for (size_t j = 0; j < a.mNodeAnims[i].size(); ++j)
+        {
+            const SL_AnimationChannel& c0 = a.mNodeAnims[i][j];
+            const SL_AnimationChannel& c1 = b.mNodeAnims[i][j];
+
+            if (c0.mPosFrames.size() != c1.mPosFrames.size()
+            || c0.mOrientFrames.size() != c1.mOrientFrames.size()
+            || c0.mPosFrames.end_time() != c1.mPosFrames.end_time())
+            {
+                std::cerr << "Mismatched animation channel " << i << ':' << j << '.' << std::endl;
+                return -6;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ *
+-----------------------------------------------------------------------------*/
+int main()
+{
+    const std::string sceneFile = "testdata/bob/Bob.md5mesh";
+    const std::string cacheFile = "sl_scene_cache_test.slc";
+
+    std::remove(cacheFile.c_str());
+
+    // The first load imports the scene and writes a cache
+    SL_SceneFileLoader importer;
+    if (!importer.load(sceneFile, cacheFile))
+    {
+        std::cerr << "Unable to import " << sceneFile << '.' << std::endl;
+        return -1;
+    }
+
+    // The second load must come from the cache
+    SL_SceneFileCache cache;
+    SL_SceneGraph cachedGraph;
+    std::vector<SL_VaoGroup> vaoGroups;
+    std::unordered_map<std::string, const SL_Texture*> texPaths;
+
+    const SL_SceneCacheStatus status = cache.load(cacheFile, sceneFile, sl_default_scene_load_opts(), cachedGraph, vaoGroups, texPaths);
+    if (status != SL_SCENE_CACHE_SUCCESS)
+    {
+        std::cerr << "Unable to load the scene cache: " << (int)status << std::endl;
+        return -2;
+    }
+
+    // Buffers keep the mapping alive after the cache is unloaded
+    cache.unload();
+
+    int ret = compare_scenes(importer.data(), cachedGraph);
+    if (ret == 0 && vaoGroups.size() != importer.vao_types().size())
+    {
+        std::cerr << "Mismatched VAO groups." << std::endl;
+        ret = -7;
+    }
+
+    // Different load options invalidate the cache
+    SL_SceneLoadOpts opts = sl_default_scene_load_opts();
+    opts.packUvs = !opts.packUvs;
+    if (ret == 0 && cache.load(cacheFile, sceneFile, opts, cachedGraph, vaoGroups, texPaths) != SL_SCENE_CACHE_STALE)
+    {
+        std::cerr << "A cache with different load options was accepted." << std::endl;
+        ret = -8;
+    }
+
+    std::remove(cacheFile.c_str());
+
+    if (ret == 0)
+    {
+        std::cout << "Scene cache matches the imported scene." << std::endl;
+    }
+
+    return ret;
+}
@@ -0,0 +1,61 @@
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "softlight/SL_TaskQueue.hpp"
+
+
+
+/*-----------------------------------------------------------------------------
+ * Place every task into the first thread's range so the remaining threads
+ * must steal, then verify each task was processed exactly once.
+-----------------------------------------------------------------------------*/
+int main()
+{
+    constexpr uint32_t numThreads = 4;
+    constexpr uint32_t numTasks   = 100000;
+
+    std::unique_ptr<SL_TaskRange[]> ranges{new SL_TaskRange[numThreads]};
+    std::unique_ptr<std::atomic<uint32_t>[]> counts{new std::atomic<uint32_t>[numTasks]};
+
+    for (uint32_t i = 0; i < numTasks; ++i)
+    {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+
+    ranges[0].reset(0, numTasks);
+
+    std::vector<std::thread> threads;
+
+    for (uint32_t threadId = 0; threadId < numThreads; ++threadId)
+    {
+        threads.emplace_back([&, threadId]() noexcept -> void
+        {
+            uint32_t rangeId;
+            uint32_t taskId;
+
+            while (sl_acquire_task(ranges.get(), numThreads, threadId, rangeId, taskId))
+            {
+                counts[taskId].fetch_add(1u, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    for (uint32_t i = 0; i < numTasks; ++i)
+    {
+        if (counts[i].load() != 1u)
+        {
+            std::cerr << "Task " << i << " was processed " << counts[i].load() << " times." << std::endl;
+            return -1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+
+#include <iostream>
+
+#include "lightsky/math/vec4.h"
+
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Framebuffer.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_VertexArray.hpp"
+#include "softlight/SL_VertexBuffer.hpp"
+
+#include "sl_test_fixtures.hpp"
+
+namespace math = ls::math;
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shader which writes a constant value
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Vertex Shader
+--------------------------------------*/
+math::vec4 _sl_test_vert_shader_impl(SL_VertexParam& param)
+{
+    return *(param.pVbo->element<const math::vec4>(param.pVao->offset(0, param.vertId)));
+}
+
+
+
+SL_VertexShader sl_test_vert_shader(float pointSize)
+{
+    SL_VertexShader shader;
+    shader.numVaryings = 0;
+    shader.cullMode    = SL_CULL_OFF;
+    shader.pointSize   = pointSize;
+    shader.shader      = _sl_test_vert_shader_impl;
+
+    return shader;
+}
+
+
+
+/*--------------------------------------
+ * Fragment Shader
+--------------------------------------*/
+bool _sl_test_frag_shader_impl(SL_FragmentParam& fragParam)
+{
+    fragParam.pOutputs[0] = math::vec4{1.f};
+    return true;
+}
+
+
+
+SL_FragmentShader sl_test_frag_shader(SL_BlendMode blend, SL_DepthMask depthMask, SL_DepthTest depthTest)
+{
+    SL_FragmentShader shader;
+    shader.numVaryings = 0;
+    shader.numOutputs  = 1;
+    shader.blend       = blend;
+    shader.depthMask   = depthMask;
+    shader.depthTest   = depthTest;
+    shader.shader      = _sl_test_frag_shader_impl;
+
+    return shader;
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Framebuffer & vertex setup
+-----------------------------------------------------------------------------*/
+/*--------------------------------------
+ * Color & depth buffers
+--------------------------------------*/
+int sl_test_init_framebuffer(
+    SL_Context& context,
+    size_t fboId,
+    size_t colorId,
+    size_t depthId,
+    uint16_t width,
+    uint16_t height,
+    uint16_t numSamples)
+{
+    SL_Texture&     texColor = context.texture(colorId);
+    SL_Texture&     texDepth = context.texture(depthId);
+    SL_Framebuffer& fbo      = context.framebuffer(fboId);
+
+    if (texColor.init(SL_COLOR_R_FLOAT, width, height, numSamples) != 0
+    || texDepth.init(SL_COLOR_R_FLOAT, width, height, numSamples) != 0
+    || fbo.reserve_color_buffers(1) != 0
+    || fbo.attach_color_buffer(0, texColor.view()) != 0
+    || fbo.attach_depth_buffer(texDepth.view()) != 0)
+    {
+        std::cerr << "Unable to initialize a framebuffer." << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+/*--------------------------------------
+ * Vertex positions
+--------------------------------------*/
+int sl_test_init_vertices(
+    SL_Context& context,
+    size_t vaoId,
+    size_t vboId,
+    const math::vec4* pVerts,
+    size_t numVerts)
+{
+    SL_VertexBuffer& vbo = context.vbo(vboId);
+    if (vbo.init(numVerts * sizeof(math::vec4)) != 0)
+    {
+        std::cerr << "Unable to initialize a vertex buffer." << std::endl;
+        return -1;
+    }
+    vbo.assign(pVerts, 0, numVerts * sizeof(math::vec4));
+
+    SL_VertexArray& vao = context.vao(vaoId);
+    vao.set_vertex_buffer(vboId);
+    vao.set_num_bindings(1);
+    vao.set_binding(0, 0, sizeof(math::vec4), SL_Dimension::VERTEX_DIMENSION_4, SL_DataType::VERTEX_DATA_FLOAT);
+
+    return 0;
+}
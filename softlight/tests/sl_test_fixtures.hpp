@@ -0,0 +1,58 @@
+#ifndef SL_TEST_FIXTURES_HPP
+#define SL_TEST_FIXTURES_HPP
+
+#include <cstdint>
+#include <cstdlib> // size_t
+
+#include "softlight/SL_PipelineState.hpp"
+#include "softlight/SL_Shader.hpp"
+
+class SL_Context;
+
+namespace ls
+{
+namespace math
+{
+template <typename T>
+union vec4_t;
+}
+}
+
+
+
+/*-----------------------------------------------------------------------------
+ * Shaders which write 1.0 to every fragment of untransformed vec4 positions.
+ * Additive blending counts the number of times each pixel was shaded.
+-----------------------------------------------------------------------------*/
+SL_VertexShader sl_test_vert_shader(float pointSize = 1.f);
+
+SL_FragmentShader sl_test_frag_shader(SL_BlendMode blend, SL_DepthMask depthMask, SL_DepthTest depthTest);
+
+
+
+/*-----------------------------------------------------------------------------
+ * Framebuffer & vertex setup
+-----------------------------------------------------------------------------*/
+// Initialize a single-channel float color & depth buffer, then attach both to
+// a framebuffer. Returns 0 on success.
+int sl_test_init_framebuffer(
+    SL_Context& context,
+    size_t fboId,
+    size_t colorId,
+    size_t depthId,
+    uint16_t width,
+    uint16_t height,
+    uint16_t numSamples = 1);
+
+// Upload vec4 positions into a vertex buffer and bind them to attribute 0 of
+// a vertex array. Returns 0 on success.
+int sl_test_init_vertices(
+    SL_Context& context,
+    size_t vaoId,
+    size_t vboId,
+    const ls::math::vec4_t<float>* pVerts,
+    size_t numVerts);
+
+
+
+#endif /* SL_TEST_FIXTURES_HPP */
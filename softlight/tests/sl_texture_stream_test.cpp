@@ -0,0 +1,74 @@
+
+#include <iostream>
+
+#include "softlight/SL_Color.hpp"
+#include "softlight/SL_Context.hpp"
+#include "softlight/SL_Texture.hpp"
+#include "softlight/SL_TextureStreamer.hpp"
+
+
+
+int main()
+{
+    SL_Context context;
+    SL_TextureStreamer streamer{context, 2};
+
+    const SL_ColorRGBA8 placeholder{255, 0, 255, 255};
+    const size_t earthId   = streamer.request("testdata/earth.png", SL_COLOR_RGBA_8U, &placeholder, SL_TexelOrder::SWIZZLED);
+    const size_t missingId = streamer.request("testdata/missing.png");
+
+    if (earthId == SL_TEXTURE_STREAM_INVALID_HANDLE || missingId == SL_TEXTURE_STREAM_INVALID_HANDLE)
+    {
+        std::cerr << "Unable to request a streamed texture." << std::endl;
+        return -1;
+    }
+
+    // Textures are usable as soon as they are requested
+    const SL_Texture* pEarth = streamer.texture(earthId);
+    if (!pEarth || pEarth->width() != 1 || pEarth->height() != 1)
+    {
+        std::cerr << "A placeholder texture was not bound." << std::endl;
+        return -2;
+    }
+
+    if (pEarth->texel<SL_ColorRGBA8>(0, 0) != placeholder)
+    {
+        std::cerr << "The placeholder texel was not initialized." << std::endl;
+        return -3;
+    }
+
+    streamer.wait();
+
+    if (streamer.status(earthId) != SL_TEXTURE_STREAM_DECODED || streamer.status(missingId) != SL_TEXTURE_STREAM_FAILED)
+    {
+        std::cerr << "Unexpected texture status after decoding." << std::endl;
+        return -4;
+    }
+
+    // Decoded images are only bound during an update
+    if (pEarth->width() != 1 || streamer.update() != 1 || streamer.update() != 0)
+    {
+        std::cerr << "Decoded textures were not bound during an update." << std::endl;
+        return -5;
+    }
+
+    if (streamer.status(earthId) != SL_TEXTURE_STREAM_RESIDENT
+    || streamer.texture(earthId) != pEarth
+    || streamer.texture_id(earthId) != 0
+    || pEarth->width() <= 1
+    || pEarth->height() <= 1)
+    {
+        std::cerr << "The streamed texture is not resident." << std::endl;
+        return -6;
+    }
+
+    if (streamer.texture(missingId)->width() != 1)
+    {
+        std::cerr << "A failed texture lost its placeholder." << std::endl;
+        return -7;
+    }
+
+    std::cout << "Streamed a " << pEarth->width() << 'x' << pEarth->height() << " texture." << std::endl;
+
+    return 0;
+}